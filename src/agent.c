@@ -0,0 +1,225 @@
+/**
+ * @file agent.c
+ * @brief Implémentation de l'agent de collecte distant
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "agent.h"
+#include "commandes.h"
+#include "network.h"
+#include "scanner.h"
+#include "signaux.h"
+#include "table.h"
+#include "utilisateurs.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Fonctions privées */
+
+/**
+ * @brief Convertit des ticks locaux (_SC_CLK_TCK) en ticks distants.
+ */
+static unsigned long long convertir_ticks(unsigned long long ticks,
+                                          long clk_tck) {
+  return clk_tck == REMOTE_TICKS_PAR_SECONDE
+             ? ticks
+             : ticks * REMOTE_TICKS_PAR_SECONDE / (unsigned long long)clk_tck;
+}
+
+/**
+ * @brief Uptime en ticks distants (0 si /proc/uptime est illisible).
+ */
+static unsigned long long lire_uptime(void) {
+  FILE *f = fopen("/proc/uptime", "r");
+  double uptime = 0.0;
+
+  if (f == NULL) {
+    return 0;
+  }
+  if (fscanf(f, "%lf", &uptime) != 1) {
+    uptime = 0.0;
+  }
+  fclose(f);
+  return (unsigned long long)(uptime * REMOTE_TICKS_PAR_SECONDE);
+}
+
+/**
+ * @brief Écrit la commande d'un processus sur une seule ligne : ligne de
+ *        commande, ou "[nom]" comme 'ps' pour un thread noyau.
+ */
+static void ecrire_commande(FILE *sortie, const char *ligne,
+                            const processus_t *proc) {
+  const char *c;
+
+  if (ligne == NULL || ligne[0] == '\0') {
+    fputc('[', sortie);
+    ligne = proc->nom_commande;
+  }
+  for (c = ligne; *c != '\0'; c++) {
+    fputc((unsigned char)*c < ' ' ? ' ' : *c, sortie);
+  }
+  if (ligne == proc->nom_commande) {
+    fputc(']', sortie);
+  }
+  fputc('\n', sortie);
+}
+
+/**
+ * @brief Rafraîchit la table et écrit un instantané complet.
+ * @return int : 0 en cas de succès, -1 si le client a disparu.
+ */
+static int envoyer_instantane(table_processus_t *table, scanner_t *scanner,
+                              commandes_t *commandes, long clk_tck,
+                              int nb_coeurs) {
+  processus_t *liste;
+  char utilisateur[MAX_USER_LEN];
+  int nb = 0;
+
+  if (table_processus_rafraichir(table, scanner) != 0) {
+    /* Table inchangée : l'instantané précédent est renvoyé */
+    fprintf(stderr, "AVERTISSEMENT: agent: lecture de /proc incomplete\n");
+  }
+  liste = table_processus_liste(table);
+  commandes_nouvelle_generation(commandes);
+  for (processus_t *p = liste; p != NULL; p = p->suivant) {
+    nb++;
+  }
+
+  printf("D %llu %d %d\n", lire_uptime(), nb_coeurs, nb);
+  for (processus_t *p = liste; p != NULL; p = p->suivant) {
+    cache_utilisateurs_copier_nom(p->uid, utilisateur, sizeof(utilisateur));
+    printf("%d %d %d %d %c %u %d %llu %llu %llu %ld %ld %s ", p->pid,
+           p->ppid, p->pgrp, p->session, p->etat, (unsigned int)p->uid,
+           p->nb_threads, convertir_ticks(p->starttime, clk_tck),
+           convertir_ticks((unsigned long long)p->utime, clk_tck),
+           convertir_ticks((unsigned long long)p->stime, clk_tck),
+           p->vmem_size / 1024, p->rss_ko,
+           utilisateur[0] != '\0' ? utilisateur : "?");
+    ecrire_commande(stdout, commandes_lire(commandes, p), p);
+  }
+  printf("F\n");
+  return fflush(stdout) == 0 && !ferror(stdout) ? 0 : -1;
+}
+
+/**
+ * @brief Requête "K" : lit les PID du lot, l'envoie et écrit le résultat.
+ * @return int : 0 en cas de succès, -1 si la requête est invalide ou si le
+ *               client a disparu.
+ */
+static int executer_signaux(const char *requete, signaux_locaux_t *signaux,
+                            lot_signaux_t *lot, long clk_tck) {
+  char ligne[64];
+  pid_t *pids;
+  unsigned long long *starttimes;
+  int signal, portee, nb;
+
+  if (sscanf(requete, "K %d %d %d", &signal, &portee, &nb) != 3 ||
+      portee < 0 || portee >= PORTEE_NB || nb <= 0 ||
+      nb > AGENT_SIGNAUX_MAX) {
+    return -1;
+  }
+  pids = malloc((size_t)nb * sizeof(pid_t));
+  starttimes = malloc((size_t)nb * sizeof(unsigned long long));
+  if (pids == NULL || starttimes == NULL) {
+    free(pids);
+    free(starttimes);
+    return -1;
+  }
+
+  for (int i = 0; i < nb; i++) {
+    if (fgets(ligne, sizeof(ligne), stdin) == NULL ||
+        sscanf(ligne, "%d %llu", &pids[i], &starttimes[i]) != 2) {
+      free(pids);
+      free(starttimes);
+      return -1;
+    }
+  }
+  if (lot_signaux_preparer(lot, pids, NULL, nb, signal,
+                           (portee_signal_t)portee) != 0) {
+    free(pids);
+    free(starttimes);
+    return -1;
+  }
+  /* Dates en ticks distants : vérifiables si l'unité locale est la même */
+  for (int i = 0; i < nb; i++) {
+    lot_signaux_dater(lot, pids[i],
+                      clk_tck == REMOTE_TICKS_PAR_SECONDE ? starttimes[i]
+                                                          : 0);
+  }
+  free(pids);
+  free(starttimes);
+
+  signaux_envoyer(signaux, lot);
+  printf("R %d\n", lot->nb_atteints);
+  for (int i = 0; i < lot->nb; i++) {
+    printf("%d %d\n", lot->pids[i], lot->erreurs[i]);
+  }
+  printf("F\n");
+  return fflush(stdout) == 0 && !ferror(stdout) ? 0 : -1;
+}
+
+/* Fonctions publiques */
+
+int agent_executer(void) {
+  table_processus_t table;
+  scanner_t scanner;
+  commandes_t commandes;
+  signaux_locaux_t signaux;
+  lot_signaux_t lot;
+  char requete[64];
+  long clk_tck = sysconf(_SC_CLK_TCK);
+  long nb_coeurs = sysconf(_SC_NPROCESSORS_ONLN);
+  int retour = EXIT_SUCCESS;
+  int erreur;
+
+  /* Client disparu : l'écriture échoue au lieu de tuer l'agent */
+  signal(SIGPIPE, SIG_IGN);
+  setvbuf(stdout, NULL, _IOFBF, AGENT_TAMPON_SORTIE);
+
+  if (commandes_init(&commandes) != 0) {
+    fprintf(stderr, "ERREUR: agent: /proc inaccessible\n");
+    return EXIT_FAILURE;
+  }
+  table_processus_init(&table);
+  scanner_init(&scanner, 0);
+  signaux_init(&signaux);
+  signaux_exclure_ancetres(&signaux);
+  lot_signaux_init(&lot);
+  if (clk_tck <= 0) {
+    clk_tck = REMOTE_TICKS_PAR_SECONDE;
+  }
+
+  printf("%s %d\n", AGENT_SALUT, AGENT_VERSION);
+  fflush(stdout);
+
+  while (fgets(requete, sizeof(requete), stdin) != NULL) {
+    if (requete[0] == 'Q') {
+      break;
+    }
+    if (requete[0] == 'S') {
+      erreur = envoyer_instantane(&table, &scanner, &commandes, clk_tck,
+                                  nb_coeurs > 0 ? (int)nb_coeurs : 1);
+    } else if (requete[0] == 'K') {
+      erreur = executer_signaux(requete, &signaux, &lot, clk_tck);
+    } else {
+      continue;
+    }
+    if (erreur != 0) {
+      retour = EXIT_FAILURE;
+      break;
+    }
+  }
+
+  lot_signaux_liberer(&lot);
+  signaux_liberer(&signaux);
+  scanner_liberer(&scanner);
+  table_processus_liberer(&table);
+  commandes_liberer(&commandes);
+  cache_utilisateurs_liberer();
+  return retour;
+}
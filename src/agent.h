@@ -0,0 +1,46 @@
+/**
+ * @file agent.h
+ * @brief Agent de collecte distant (my_htop --agent)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Lancé une fois par hôte sur un canal SSH qui reste ouvert, l'agent garde
+ * sa table de processus d'un échantillon à l'autre (lectures de /proc
+ * incrémentales, lignes de commande en cache) et répond à chaque requête
+ * par un instantané sur le même canal : ni 'ps' ni nouveau canal à chaque
+ * rafraîchissement. Les lots de signaux passent par ce canal et sont
+ * envoyés comme par la source locale (signaux.h : pidfd, dates vérifiées,
+ * portées gelées).
+ *
+ * Protocole (texte, un enregistrement par ligne) :
+ *   agent  -> "MY_HTOP_AGENT <version>" au démarrage
+ *   client -> "S" : instantané ; "Q" ou fin du flux : arrêt
+ *   agent  -> "D <uptime> <coeurs> <nb>", nb lignes de processus, puis "F"
+ *   client -> "K <signal> <portee> <nb>" puis nb lignes "<pid> <starttime>"
+ *             (starttime 0 : non vérifiée)
+ *   agent  -> "R <atteints>", nb lignes "<pid> <errno>", puis "F"
+ * Une ligne de processus :
+ *   pid ppid pgrp session etat uid threads starttime utime stime vsz_ko
+ *   rss_ko utilisateur commande
+ * Dates et temps CPU en ticks distants (REMOTE_TICKS_PAR_SECONDE). Le
+ * client analyse ces lignes au fil de leur réception (flux.h).
+ */
+
+#ifndef AGENT_H
+#define AGENT_H
+
+#define AGENT_SALUT "MY_HTOP_AGENT"
+#define AGENT_VERSION 2
+#define AGENT_COMMANDE_DEFAUT "my_htop --agent" /* Binaire dans le PATH
+                                                   distant */
+#define AGENT_TAMPON_SORTIE (256 * 1024)
+#define AGENT_SIGNAUX_MAX 65536 /* PID par requête "K" */
+
+/**
+ * @brief Boucle de l'agent : lit les requêtes sur stdin et écrit les
+ *        instantanés sur stdout jusqu'à "Q" ou la fin de stdin.
+ * @return int : EXIT_SUCCESS, ou EXIT_FAILURE si /proc est inaccessible
+ *               ou si le client a disparu.
+ */
+int agent_executer(void);
+
+#endif /* AGENT_H */
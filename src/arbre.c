@@ -0,0 +1,547 @@
+/**
+ * @file arbre.c
+ * @brief Implémentation de la vue arborescente des processus
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "arbre.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ARBRE_TAILLE_INDEX_INITIALE 1024
+
+/* Fonctions privées */
+
+static unsigned int hacher_pid(pid_t pid, int taille) {
+  return ((unsigned int)pid * 2654435761u) & (unsigned int)(taille - 1);
+}
+
+/**
+ * @brief Garantit la capacité d'un tableau (doublement).
+ */
+static int reserver(void **tableau, int *capacite, int nb,
+                    size_t taille_element) {
+  int nouvelle = *capacite ? *capacite : 256;
+  void *agrandi;
+
+  if (nb <= *capacite) {
+    return 0;
+  }
+  while (nouvelle < nb) {
+    nouvelle *= 2;
+  }
+  agrandi = realloc(*tableau, (size_t)nouvelle * taille_element);
+  if (agrandi == NULL) {
+    return -1;
+  }
+  *tableau = agrandi;
+  *capacite = nouvelle;
+  return 0;
+}
+
+/**
+ * @brief Retourne la case d'index contenant le PID, ou -1.
+ */
+static int index_trouver(const arbre_t *arbre, pid_t pid) {
+  unsigned int masque = (unsigned int)(arbre->taille_index - 1);
+  unsigned int i = hacher_pid(pid, arbre->taille_index);
+
+  while (arbre->index[i] != -1) {
+    if (arbre->noeuds[arbre->index[i]].pid == pid) {
+      return (int)i;
+    }
+    i = (i + 1) & masque;
+  }
+  return -1;
+}
+
+static void index_inserer(arbre_t *arbre, int n) {
+  unsigned int masque = (unsigned int)(arbre->taille_index - 1);
+  unsigned int i = hacher_pid(arbre->noeuds[n].pid, arbre->taille_index);
+
+  while (arbre->index[i] != -1) {
+    i = (i + 1) & masque;
+  }
+  arbre->index[i] = n;
+}
+
+/**
+ * @brief Supprime une case (sondage linéaire avec décalage arrière).
+ */
+static void index_supprimer(arbre_t *arbre, int case_vide) {
+  unsigned int masque = (unsigned int)(arbre->taille_index - 1);
+  unsigned int i = (unsigned int)case_vide;
+  unsigned int j = i;
+
+  for (;;) {
+    j = (j + 1) & masque;
+    if (arbre->index[j] == -1) {
+      break;
+    }
+    unsigned int k =
+        hacher_pid(arbre->noeuds[arbre->index[j]].pid, arbre->taille_index);
+    /* Déplacer j vers i si sa position d'origine k n'est pas dans ]i, j] */
+    if ((i <= j) ? (k <= i || k > j) : (k <= i && k > j)) {
+      arbre->index[i] = arbre->index[j];
+      i = j;
+    }
+  }
+  arbre->index[i] = -1;
+}
+
+/**
+ * @brief Agrandit l'index pour 'nb' PID (taux de remplissage <= 1/2) et
+ *        réinsère les nœuds vivants.
+ */
+static int index_reserver(arbre_t *arbre, int nb) {
+  int taille = arbre->taille_index;
+  int *index;
+
+  if (nb * 2 <= taille) {
+    return 0;
+  }
+  while (nb * 2 > taille) {
+    taille *= 2;
+  }
+  index = malloc(sizeof(int) * (size_t)taille);
+  if (index == NULL) {
+    return -1;
+  }
+
+  free(arbre->index);
+  arbre->index = index;
+  arbre->taille_index = taille;
+  memset(arbre->index, 0xff, sizeof(int) * (size_t)taille);
+  for (int n = 1; n < arbre->nb_noeuds; n++) {
+    if (arbre->noeuds[n].vu != 0) {
+      index_inserer(arbre, n);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Retire un nœud de la liste des enfants de son parent.
+ */
+static void detacher(arbre_t *arbre, int n) {
+  arbre_noeud_t *noeud = &arbre->noeuds[n];
+
+  if (noeud->parent >= 0) {
+    arbre_noeud_t *parent = &arbre->noeuds[noeud->parent];
+    if (noeud->frere_precedent >= 0) {
+      arbre->noeuds[noeud->frere_precedent].frere_suivant =
+          noeud->frere_suivant;
+    } else {
+      parent->premier_enfant = noeud->frere_suivant;
+    }
+    if (noeud->frere_suivant >= 0) {
+      arbre->noeuds[noeud->frere_suivant].frere_precedent =
+          noeud->frere_precedent;
+    } else {
+      parent->dernier_enfant = noeud->frere_precedent;
+    }
+  }
+  noeud->parent = -1;
+  noeud->frere_precedent = -1;
+  noeud->frere_suivant = -1;
+  arbre->structure_modifiee = 1;
+}
+
+/**
+ * @brief Ajoute un nœud en dernier enfant de 'parent'.
+ */
+static void attacher(arbre_t *arbre, int n, int parent) {
+  arbre_noeud_t *noeud = &arbre->noeuds[n];
+  arbre_noeud_t *p = &arbre->noeuds[parent];
+
+  noeud->parent = parent;
+  noeud->frere_precedent = p->dernier_enfant;
+  noeud->frere_suivant = -1;
+  if (p->dernier_enfant >= 0) {
+    arbre->noeuds[p->dernier_enfant].frere_suivant = n;
+  } else {
+    p->premier_enfant = n;
+  }
+  p->dernier_enfant = n;
+  arbre->structure_modifiee = 1;
+}
+
+/**
+ * @brief Crée le nœud d'un processus apparu (à rattacher).
+ */
+static int creer_noeud(arbre_t *arbre, const processus_t *proc, int ligne) {
+  int n = arbre->libre;
+  arbre_noeud_t *noeud;
+
+  if (n >= 0) {
+    arbre->libre = arbre->noeuds[n].frere_suivant;
+  } else {
+    n = arbre->nb_noeuds++;
+  }
+
+  noeud = &arbre->noeuds[n];
+  memset(noeud, 0, sizeof(*noeud));
+  noeud->pid = proc->pid;
+  noeud->ppid = proc->ppid;
+  noeud->starttime = proc->starttime;
+  noeud->ligne = ligne;
+  noeud->parent = -1;
+  noeud->premier_enfant = -1;
+  noeud->dernier_enfant = -1;
+  noeud->frere_precedent = -1;
+  noeud->frere_suivant = -1;
+  index_inserer(arbre, n);
+  arbre->a_rattacher[arbre->nb_a_rattacher++] = n;
+  arbre->nb_vivants++;
+  return n;
+}
+
+/**
+ * @brief Retire le nœud d'un processus disparu ; ses enfants sont à
+ *        rattacher (le noyau leur a donné un autre parent).
+ */
+static void retirer_noeud(arbre_t *arbre, int n, int case_index) {
+  int enfant = arbre->noeuds[n].premier_enfant;
+
+  while (enfant >= 0) {
+    int suivant = arbre->noeuds[enfant].frere_suivant;
+    detacher(arbre, enfant);
+    arbre->a_rattacher[arbre->nb_a_rattacher++] = enfant;
+    enfant = suivant;
+  }
+  arbre->noeuds[n].premier_enfant = -1;
+  arbre->noeuds[n].dernier_enfant = -1;
+  detacher(arbre, n);
+  index_supprimer(arbre, case_index);
+
+  arbre->noeuds[n].vu = 0;
+  arbre->noeuds[n].frere_suivant = arbre->libre;
+  arbre->libre = n;
+  arbre->nb_vivants--;
+}
+
+/**
+ * @brief Nœud du PPID d'un nœud, ou racine virtuelle (PPID 0, parent
+ *        absent, ou lien qui formerait un cycle : PID réutilisé entre deux
+ *        lectures).
+ */
+static int chercher_parent(const arbre_t *arbre, int n) {
+  pid_t ppid = arbre->noeuds[n].ppid;
+  int case_index;
+
+  if (ppid <= 0 || ppid == arbre->noeuds[n].pid) {
+    return 0;
+  }
+  case_index = index_trouver(arbre, ppid);
+  if (case_index < 0) {
+    return 0;
+  }
+  for (int a = arbre->index[case_index]; a > 0; a = arbre->noeuds[a].parent) {
+    if (a == n) {
+      return 0;
+    }
+  }
+  return arbre->index[case_index];
+}
+
+/**
+ * @brief Rattache un nœud détaché à son parent.
+ */
+static void rattacher(arbre_t *arbre, int n) {
+  arbre_noeud_t *noeud = &arbre->noeuds[n];
+  int parent = chercher_parent(arbre, n);
+
+  attacher(arbre, n, parent);
+  noeud->provisoire = parent == 0 && noeud->ppid > 0 &&
+                      noeud->ppid != noeud->pid;
+  arbre->nb_rattachements++;
+}
+
+/**
+ * @brief Refait l'ordre d'affichage (parcours en profondeur sans pile),
+ *        les profondeurs et la taille de chaque sous-arbre.
+ */
+static void parcourir(arbre_t *arbre) {
+  arbre_noeud_t *noeuds = arbre->noeuds;
+  int n = noeuds[0].premier_enfant;
+  int profondeur = 0;
+
+  arbre->nb_ordre = 0;
+  noeuds[0].nb_descendants = 0;
+  while (n > 0) {
+    arbre->ordre[arbre->nb_ordre++] = n;
+    noeuds[n].profondeur = profondeur;
+    noeuds[n].nb_descendants = 0;
+
+    if (noeuds[n].premier_enfant >= 0) {
+      n = noeuds[n].premier_enfant;
+      profondeur++;
+      continue;
+    }
+    while (n > 0 && noeuds[n].frere_suivant < 0) {
+      n = noeuds[n].parent;
+      profondeur--;
+    }
+    if (n > 0) {
+      n = noeuds[n].frere_suivant;
+    }
+  }
+
+  /* Un descendant est toujours placé après son ancêtre */
+  for (int i = arbre->nb_ordre - 1; i >= 0; i--) {
+    arbre_noeud_t *noeud = &noeuds[arbre->ordre[i]];
+    noeuds[noeud->parent].nb_descendants += 1 + noeud->nb_descendants;
+  }
+
+  arbre->structure_modifiee = 0;
+  arbre->nb_parcours++;
+}
+
+/* Fonctions publiques */
+
+int arbre_init(arbre_t *arbre) {
+  memset(arbre, 0, sizeof(*arbre));
+  arbre->index = malloc(sizeof(int) * ARBRE_TAILLE_INDEX_INITIALE);
+  if (arbre->index == NULL) {
+    return -1;
+  }
+  arbre->taille_index = ARBRE_TAILLE_INDEX_INITIALE;
+  arbre_oublier(arbre);
+  return 0;
+}
+
+void arbre_liberer(arbre_t *arbre) {
+  free(arbre->noeuds);
+  free(arbre->index);
+  free(arbre->a_rattacher);
+  free(arbre->ordre);
+  free(arbre->retenues);
+  memset(arbre, 0, sizeof(*arbre));
+}
+
+void arbre_oublier(arbre_t *arbre) {
+  if (arbre->index != NULL) {
+    memset(arbre->index, 0xff, sizeof(int) * (size_t)arbre->taille_index);
+  }
+  arbre->nb_noeuds = 0;
+  arbre->libre = -1;
+  arbre->nb_vivants = 0;
+  arbre->nb_ordre = 0;
+  arbre->integration = 0;
+  arbre->structure_modifiee = 1;
+}
+
+int arbre_integrer(arbre_t *arbre, processus_t *liste) {
+  int nb = compter_processus(liste);
+  int ligne = 0;
+
+  /* Tout est réservé d'avance : les passages suivants n'échouent pas */
+  if (arbre->index == NULL ||
+      index_reserver(arbre, arbre->nb_vivants + nb) != 0 ||
+      reserver((void **)&arbre->noeuds, &arbre->capacite_noeuds,
+               arbre->nb_noeuds + nb + 1, sizeof(arbre_noeud_t)) != 0 ||
+      reserver((void **)&arbre->a_rattacher, &arbre->capacite_a_rattacher,
+               arbre->nb_noeuds + nb + 1, sizeof(int)) != 0 ||
+      reserver((void **)&arbre->ordre, &arbre->capacite_ordre,
+               arbre->nb_vivants + nb, sizeof(int)) != 0) {
+    arbre_oublier(arbre);
+    return -1;
+  }
+
+  if (arbre->nb_noeuds == 0) {
+    /* Racine virtuelle : parent des processus sans parent connu */
+    memset(&arbre->noeuds[0], 0, sizeof(arbre_noeud_t));
+    arbre->noeuds[0].parent = -1;
+    arbre->noeuds[0].premier_enfant = -1;
+    arbre->noeuds[0].dernier_enfant = -1;
+    arbre->noeuds[0].frere_precedent = -1;
+    arbre->noeuds[0].frere_suivant = -1;
+    arbre->nb_noeuds = 1;
+  }
+  arbre->integration++;
+  if (arbre->integration == 0) {
+    arbre->integration = 1;
+  }
+  arbre->nb_a_rattacher = 0;
+
+  /* 1. Processus vivants : nœud retrouvé par son PID, ou créé */
+  for (processus_t *p = liste; p != NULL && ligne < nb; p = p->suivant) {
+    int case_index = index_trouver(arbre, p->pid);
+    int n = case_index >= 0 ? arbre->index[case_index] : -1;
+
+    if (n >= 0 && arbre->noeuds[n].vu == arbre->integration) {
+      ligne++; /* PID en double dans la collecte */
+      continue;
+    }
+    if (n >= 0 && arbre->noeuds[n].starttime != p->starttime) {
+      /* PID réutilisé : autre processus */
+      retirer_noeud(arbre, n, case_index);
+      n = -1;
+    }
+    if (n < 0) {
+      n = creer_noeud(arbre, p, ligne);
+    } else if (arbre->noeuds[n].ppid != p->ppid) {
+      /* Parent terminé (rattaché à init ou à un « subreaper »), ou
+         reparenté par ptrace */
+      arbre->noeuds[n].ppid = p->ppid;
+      detacher(arbre, n);
+      arbre->a_rattacher[arbre->nb_a_rattacher++] = n;
+    }
+
+    arbre_noeud_t *noeud = &arbre->noeuds[n];
+    noeud->vu = arbre->integration;
+    noeud->ligne = ligne++;
+    noeud->cpu_total = p->cpu_percent;
+    noeud->rss_total_ko = p->rss_ko;
+  }
+
+  /* 2. Processus disparus */
+  for (int n = 1; n < arbre->nb_noeuds; n++) {
+    if (arbre->noeuds[n].vu != 0 &&
+        arbre->noeuds[n].vu != arbre->integration) {
+      retirer_noeud(arbre, n, index_trouver(arbre, arbre->noeuds[n].pid));
+    }
+  }
+
+  /* 3. Liens des seuls nœuds créés, reparentés ou orphelins */
+  for (int i = 0; i < arbre->nb_a_rattacher; i++) {
+    int n = arbre->a_rattacher[i];
+    if (arbre->noeuds[n].vu == arbre->integration &&
+        arbre->noeuds[n].parent < 0) {
+      rattacher(arbre, n);
+    }
+  }
+
+  /* Sous la racine faute de parent : celui-ci a pu apparaître depuis */
+  for (int n = 1; n < arbre->nb_noeuds; n++) {
+    if (arbre->noeuds[n].vu == arbre->integration &&
+        arbre->noeuds[n].provisoire && chercher_parent(arbre, n) != 0) {
+      detacher(arbre, n);
+      rattacher(arbre, n);
+    }
+  }
+
+  if (arbre->structure_modifiee) {
+    parcourir(arbre);
+  }
+
+  /* 4. Totaux : chaque sous-arbre remonte vers son parent */
+  for (int i = arbre->nb_ordre - 1; i >= 0; i--) {
+    arbre_noeud_t *noeud = &arbre->noeuds[arbre->ordre[i]];
+    if (noeud->parent > 0) {
+      arbre->noeuds[noeud->parent].cpu_total += noeud->cpu_total;
+      arbre->noeuds[noeud->parent].rss_total_ko += noeud->rss_total_ko;
+    }
+  }
+  return 0;
+}
+
+processus_t *arbre_construire_vue(arbre_t *arbre, processus_t *liste,
+                                  const uint32_t *retenues, int nb_retenues,
+                                  snapshot_t *vue) {
+  int nb = compter_processus(liste);
+
+  if (liste == NULL) {
+    return NULL;
+  }
+  if (snapshot_reserver(vue, arbre->nb_ordre) != 0) {
+    return liste;
+  }
+  if (retenues != NULL) {
+    if (reserver((void **)&arbre->retenues, &arbre->capacite_retenues,
+                 nb > 0 ? nb : 1, 1) != 0) {
+      return liste;
+    }
+    memset(arbre->retenues, 0, (size_t)nb);
+    for (int i = 0; i < nb_retenues; i++) {
+      if ((int)retenues[i] < nb) {
+        arbre->retenues[retenues[i]] = 1;
+      }
+    }
+  }
+
+  snapshot_reinitialiser(vue);
+  for (int i = 0; i < arbre->nb_ordre; i++) {
+    const arbre_noeud_t *noeud = &arbre->noeuds[arbre->ordre[i]];
+
+    if (noeud->ligne >= nb) {
+      continue;
+    }
+    if (retenues != NULL) {
+      /* Les correspondances restent visibles sous un nœud replié */
+      if (arbre->retenues[noeud->ligne]) {
+        memcpy(snapshot_ajouter(vue),
+               get_processus_at_index(liste, noeud->ligne),
+               sizeof(processus_t));
+      }
+      continue;
+    }
+
+    memcpy(snapshot_ajouter(vue), get_processus_at_index(liste, noeud->ligne),
+           sizeof(processus_t));
+    if (noeud->replie) {
+      i += noeud->nb_descendants;
+    }
+  }
+  return snapshot_finaliser(vue);
+}
+
+const arbre_noeud_t *arbre_chercher(const arbre_t *arbre, pid_t pid) {
+  int case_index;
+
+  if (arbre->index == NULL || arbre->nb_vivants == 0) {
+    return NULL;
+  }
+  case_index = index_trouver(arbre, pid);
+  return case_index >= 0 ? &arbre->noeuds[arbre->index[case_index]] : NULL;
+}
+
+int arbre_replier(arbre_t *arbre, pid_t pid, int replie) {
+  arbre_noeud_t *noeud = (arbre_noeud_t *)arbre_chercher(arbre, pid);
+
+  if (noeud == NULL || noeud->premier_enfant < 0) {
+    return -1;
+  }
+  noeud->replie = replie;
+  return 0;
+}
+
+void arbre_dessiner(const arbre_t *arbre, const arbre_noeud_t *noeud,
+                    char *dest, size_t taille) {
+  int replie = noeud->replie && noeud->premier_enfant >= 0;
+  int colonnes = noeud->profondeur - 1;
+  size_t longueur;
+  size_t position;
+
+  if (taille < 4) {
+    if (taille > 0) {
+      dest[0] = '\0';
+    }
+    return;
+  }
+  if (noeud->profondeur == 0) {
+    memcpy(dest, replie ? "+ " : "", replie ? 3 : 1);
+    return;
+  }
+
+  /* Les niveaux les plus hauts sont omis si le tampon est trop petit */
+  if ((size_t)colonnes > (taille - 4) / 2) {
+    colonnes = (int)((taille - 4) / 2);
+  }
+  longueur = (size_t)colonnes * 2 + 3;
+  dest[longueur] = '\0';
+  dest[longueur - 3] = noeud->frere_suivant >= 0 ? '|' : '`';
+  dest[longueur - 2] = replie ? '+' : '-';
+  dest[longueur - 1] = ' ';
+
+  /* Une barre par ancêtre qui a encore des frères en dessous */
+  position = longueur - 3;
+  for (int a = noeud->parent; colonnes > 0 && a > 0;
+       a = arbre->noeuds[a].parent, colonnes--) {
+    position -= 2;
+    dest[position] = arbre->noeuds[a].frere_suivant >= 0 ? '|' : ' ';
+    dest[position + 1] = ' ';
+  }
+}
@@ -0,0 +1,155 @@
+/**
+ * @file arbre.h
+ * @brief Vue arborescente des processus (liens parent/enfant par PPID)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * L'arbre garde un nœud par processus d'une collecte à l'autre, retrouvé
+ * par une table de hachage des PID : chaque intégration est en O(n) et ne
+ * touche aux liens que des processus apparus, disparus ou rattachés à un
+ * autre parent. Le parcours en profondeur (ordre d'affichage, profondeurs,
+ * tailles des sous-arbres) n'est refait que si la structure a changé ;
+ * sinon seuls les totaux CPU/RSS des sous-arbres sont recalculés, en un
+ * passage à rebours de l'ordre précédent.
+ *
+ * L'état replié d'un nœud suit le processus (PID et date de démarrage).
+ */
+
+#ifndef ARBRE_H
+#define ARBRE_H
+
+#include "process.h"
+#include "snapshot.h"
+#include <stdint.h>
+
+#define ARBRE_PREFIXE_MAX 64 /* Dessin de l'arborescence (colonne COMMAND) */
+
+/**
+ * @brief Nœud d'un processus. Les enfants forment une liste doublement
+ *        chaînée, dans leur ordre d'apparition.
+ */
+typedef struct arbre_noeud {
+  pid_t pid;
+  pid_t ppid;                   /* PPID du dernier rattachement */
+  unsigned long long starttime;
+  unsigned int vu;              /* Dernière intégration (0 : nœud libre) */
+  int ligne;                    /* Ligne dans la collecte intégrée */
+  int parent;                   /* 0 : racine virtuelle, -1 : à rattacher */
+  int premier_enfant;           /* -1 : aucun */
+  int dernier_enfant;
+  int frere_precedent;
+  int frere_suivant;            /* Aussi chaînage des nœuds libres */
+  int replie;                   /* 1 : descendants masqués */
+  int provisoire;               /* 1 : sous la racine faute de parent
+                                   (PPID absent de la collecte, ou cycle) */
+  int profondeur;               /* 0 : processus sans parent connu */
+  int nb_descendants;
+  float cpu_total;              /* CPU du sous-arbre, nœud compris */
+  long rss_total_ko;
+} arbre_noeud_t;
+
+/**
+ * @brief Arbre d'une machine (l'onglet affiché).
+ */
+typedef struct arbre {
+  arbre_noeud_t *noeuds;        /* [0] : racine virtuelle */
+  int nb_noeuds;                /* Nœuds utilisés ou libérés */
+  int capacite_noeuds;
+  int libre;                    /* Premier nœud libre (-1 : aucun) */
+  int *index;                   /* Hachage PID -> nœud (-1 si vide) */
+  int taille_index;             /* Puissance de 2 */
+  int nb_vivants;
+  unsigned int integration;
+
+  int *a_rattacher;             /* Nœuds sans parent après l'intégration */
+  int nb_a_rattacher;
+  int capacite_a_rattacher;
+
+  int *ordre;                   /* Parcours en profondeur (hors racine) */
+  int nb_ordre;
+  int capacite_ordre;
+  int structure_modifiee;       /* 1 : ordre à refaire */
+
+  unsigned char *retenues;      /* Lignes retenues par le filtre */
+  int capacite_retenues;
+
+  /* Statistiques */
+  unsigned long nb_rattachements;
+  unsigned long nb_parcours;    /* Parcours en profondeur refaits */
+} arbre_t;
+
+/**
+ * @brief Initialise un arbre vide.
+ * @param arbre : Arbre à initialiser.
+ * @return int : 0 en cas de succès, -1 en cas d'erreur mémoire.
+ */
+int arbre_init(arbre_t *arbre);
+
+/**
+ * @brief Libère un arbre.
+ * @param arbre : Arbre à libérer.
+ */
+void arbre_liberer(arbre_t *arbre);
+
+/**
+ * @brief Oublie tous les nœuds (la prochaine liste vient d'une autre
+ *        machine).
+ * @param arbre : Arbre concerné.
+ */
+void arbre_oublier(arbre_t *arbre);
+
+/**
+ * @brief Intègre une nouvelle collecte : met à jour les nœuds existants,
+ *        crée ceux des processus apparus, retire ceux des disparus et
+ *        rattache les nœuds concernés, puis recalcule les totaux.
+ * @param arbre : Arbre concerné.
+ * @param liste : Collecte complète (ordre de la source, sans threads).
+ * @return int : 0 en cas de succès, -1 en cas d'erreur mémoire (l'arbre
+ *               est alors oublié).
+ */
+int arbre_integrer(arbre_t *arbre, processus_t *liste);
+
+/**
+ * @brief Construit la vue arborescente de la dernière collecte intégrée.
+ *        Les descendants d'un nœud replié sont masqués, sauf filtre actif.
+ * @param arbre : Arbre concerné.
+ * @param liste : Collecte passée à arbre_integrer().
+ * @param retenues : Lignes retenues par le filtre (NULL : toutes).
+ * @param nb_retenues : Nombre de lignes retenues.
+ * @param vue : Snapshot recevant la vue.
+ * @return processus_t* : Vue arborescente (NULL si aucune ligne), 'liste'
+ *         elle-même si la mémoire manque.
+ */
+processus_t *arbre_construire_vue(arbre_t *arbre, processus_t *liste,
+                                  const uint32_t *retenues, int nb_retenues,
+                                  snapshot_t *vue);
+
+/**
+ * @brief Cherche le nœud d'un processus.
+ * @param arbre : Arbre concerné.
+ * @param pid : PID cherché.
+ * @return const arbre_noeud_t* : Nœud, ou NULL si absent.
+ */
+const arbre_noeud_t *arbre_chercher(const arbre_t *arbre, pid_t pid);
+
+/**
+ * @brief Replie ou déplie le sous-arbre d'un processus.
+ * @param arbre : Arbre concerné.
+ * @param pid : PID du processus.
+ * @param replie : 1 pour replier, 0 pour déplier.
+ * @return int : 0 en cas de succès, -1 si le processus n'a pas d'enfant.
+ */
+int arbre_replier(arbre_t *arbre, pid_t pid, int replie);
+
+/**
+ * @brief Dessine l'arborescence devant le nom d'un processus
+ *        ("|  |- ", "`+ " pour un sous-arbre replié).
+ * @param arbre : Arbre concerné.
+ * @param noeud : Nœud du processus.
+ * @param dest : Tampon de destination.
+ * @param taille : Taille du tampon (les niveaux les plus hauts sont
+ *                 omis s'il est trop petit).
+ */
+void arbre_dessiner(const arbre_t *arbre, const arbre_noeud_t *noeud,
+                    char *dest, size_t taille);
+
+#endif /* ARBRE_H */
@@ -0,0 +1,646 @@
+/**
+ * @file bench.c
+ * @brief Implémentation des micro-benchmarks
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "bench.h"
+#include "filtre.h"
+#include "flux.h"
+#include "network.h"
+#include "procfs.h"
+#include "scanner.h"
+#include "tri.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define BENCH_MAX_PIDS 65536
+#define BENCH_TRI_PROCESSUS 30000 /* Hôte chargé */
+#define BENCH_TRI_LIGNES 60       /* Un écran */
+#define BENCH_FILTRE_PROCESSUS 100000
+#define BENCH_PS_PROCESSUS 50000 /* Sortie 'ps' d'un hôte très chargé */
+#define BENCH_PS_LECTURE 4096    /* Octets par lecture du canal */
+
+/* Fonctions privées */
+
+static double maintenant_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Liste les PID présents dans /proc.
+ */
+static int lister_pids(pid_t *pids, int max) {
+  DIR *dir = opendir(PROC_DIR);
+  struct dirent *entree;
+  int nb = 0;
+
+  if (dir == NULL) {
+    return -1;
+  }
+
+  while ((entree = readdir(dir)) != NULL && nb < max) {
+    if (isdigit((unsigned char)entree->d_name[0])) {
+      pids[nb++] = (pid_t)atoi(entree->d_name);
+    }
+  }
+
+  closedir(dir);
+  return nb;
+}
+
+/**
+ * @brief Ancien chemin : fopen/fscanf/fclose puis stat() sur /proc/[PID].
+ */
+static int lecture_ancienne(pid_t pid, processus_t *proc) {
+  char path[256];
+  struct stat st;
+  FILE *file;
+
+  snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+  file = fopen(path, "r");
+  if (!file) {
+    return -1;
+  }
+
+  int fields_read = fscanf(
+      file,
+      "%d %s %c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lld %lld %*d %*d "
+      "%*d %*d %*d %*d %ld %ld",
+      &proc->pid, proc->nom_commande, &proc->etat, &proc->utime, &proc->stime,
+      &proc->vmem_size, &proc->rss_ko);
+  fclose(file);
+
+  if (fields_read != 7) {
+    return -1;
+  }
+
+  snprintf(path, sizeof(path), "/proc/%d", pid);
+  return stat(path, &st);
+}
+
+/**
+ * @brief Mesure une passe complète de lecture pour chaque implémentation.
+ */
+static void bench_lecture_stat(pid_t *pids, int nb_pids, int iterations) {
+  processus_t proc;
+  procfs_lecteur_t lecteur;
+  uid_t uid;
+  int lus_ancien = 0;
+  int lus_nouveau = 0;
+  double debut, duree_ancien, duree_nouveau;
+
+  debut = maintenant_ns();
+  for (int it = 0; it < iterations; it++) {
+    for (int i = 0; i < nb_pids; i++) {
+      lus_ancien += (lecture_ancienne(pids[i], &proc) == 0);
+    }
+  }
+  duree_ancien = maintenant_ns() - debut;
+
+  if (procfs_ouvrir(&lecteur) != 0) {
+    fprintf(stderr, "ERREUR: Impossible d'ouvrir /proc\n");
+    return;
+  }
+  debut = maintenant_ns();
+  for (int it = 0; it < iterations; it++) {
+    for (int i = 0; i < nb_pids; i++) {
+      lus_nouveau += (procfs_lire_stat(&lecteur, pids[i], &proc, &uid) == 0);
+    }
+  }
+  duree_nouveau = maintenant_ns() - debut;
+  procfs_fermer(&lecteur);
+
+  printf("Lecture /proc/[PID]/stat (+ UID), %d processus x %d passes:\n",
+         nb_pids, iterations);
+  printf("  fopen/fscanf + stat()   : %8.0f ns/processus (%d lus)\n",
+         duree_ancien / (nb_pids * (double)iterations), lus_ancien);
+  printf("  openat/read + scanner   : %8.0f ns/processus (%d lus)\n",
+         duree_nouveau / (nb_pids * (double)iterations), lus_nouveau);
+}
+
+/**
+ * @brief Mesure uniquement l'analyse d'une ligne stat déjà en mémoire.
+ */
+static void bench_analyse_stat(int iterations) {
+  const char *ligne =
+      "12345 (kworker/3:1) S 1 12345 12345 0 -1 4194560 123456 0 12 0 "
+      "98765 4321 0 0 20 0 42 0 1234567 3456789012 123456 "
+      "18446744073709551615 1 1 0 0 0 0 0 4096 1260 0 0 0 17 3 0 0 0 0 0\n";
+  size_t len = strlen(ligne);
+  processus_t proc;
+  int valides_sscanf = 0;
+  int valides_scanner = 0;
+  int tours = iterations * 100000;
+  double debut, duree_sscanf, duree_scanner;
+
+  debut = maintenant_ns();
+  for (int i = 0; i < tours; i++) {
+    valides_sscanf += (sscanf(ligne,
+                       "%d %s %c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lld "
+                       "%lld %*d %*d %*d %*d %*d %*d %ld %ld",
+                       &proc.pid, proc.nom_commande, &proc.etat, &proc.utime,
+                       &proc.stime, &proc.vmem_size, &proc.rss_ko) == 7);
+  }
+  duree_sscanf = maintenant_ns() - debut;
+
+  debut = maintenant_ns();
+  for (int i = 0; i < tours; i++) {
+    valides_scanner += (procfs_parser_stat(ligne, len, 4, &proc) == 0);
+  }
+  duree_scanner = maintenant_ns() - debut;
+
+  printf("Analyse seule d'une ligne stat en memoire, %d tours:\n", tours);
+  printf("  sscanf                  : %8.1f ns/ligne (%d/%d valides)\n",
+         duree_sscanf / tours, valides_sscanf, tours);
+  printf("  scanner procfs          : %8.1f ns/ligne (%d/%d valides, nom: "
+         "\"%s\")\n",
+         duree_scanner / tours, valides_scanner, tours, proc.nom_commande);
+
+  /* Nom de commande contenant espaces et parenthèses */
+  const char *ligne_piege =
+      "4242 (Web Content (x)) R 1 4242 4242 0 -1 0 0 0 0 0 7 3 0 0 20 0 1 0 "
+      "99 1024 16\n";
+  int ok_sscanf = (sscanf(ligne_piege, "%d %s %c", &proc.pid,
+                          proc.nom_commande, &proc.etat) == 3 &&
+                   proc.etat == 'R');
+  int ok_scanner =
+      (procfs_parser_stat(ligne_piege, strlen(ligne_piege), 4, &proc) == 0 &&
+       strcmp(proc.nom_commande, "Web Content (x)") == 0 && proc.etat == 'R');
+  printf("  nom \"Web Content (x)\"  : sscanf %s, scanner %s\n",
+         ok_sscanf ? "OK" : "ECHEC", ok_scanner ? "OK" : "ECHEC");
+}
+
+/**
+ * @brief Mesure le parcours complet de /proc selon le nombre de threads.
+ */
+static void bench_scanner(int iterations) {
+  int max_threads = scanner_threads_automatique() * 2;
+  double reference = 0.0;
+  snapshot_t dest;
+
+  if (max_threads < 8) {
+    max_threads = 8;
+  }
+  if (max_threads > SCANNER_MAX_THREADS) {
+    max_threads = SCANNER_MAX_THREADS;
+  }
+
+  snapshot_init(&dest);
+  printf("Parcours complet de /proc (scanner), %d passes par mesure:\n",
+         iterations);
+
+  for (int nb_threads = 1; nb_threads <= max_threads; nb_threads *= 2) {
+    scanner_t scanner;
+    double debut, duree;
+
+    scanner_init(&scanner, nb_threads);
+    scanner.seuil_parallele = 0; /* Forcer le parallélisme pour la mesure */
+    scanner_collecter(&scanner, &dest); /* Démarrage des threads */
+
+    debut = maintenant_ns();
+    for (int it = 0; it < iterations; it++) {
+      scanner_collecter(&scanner, &dest);
+    }
+    duree = (maintenant_ns() - debut) / iterations;
+    if (nb_threads == 1) {
+      reference = duree;
+    }
+
+    printf("  %2d thread(s)            : %8.2f ms/parcours, %6.0f "
+           "ns/processus, x%.2f (%d processus)\n",
+           nb_threads, duree / 1e6, duree / (dest.nb ? dest.nb : 1),
+           reference / duree, dest.nb);
+    scanner_liberer(&scanner);
+  }
+
+  printf("  (parcours mono-thread automatique sous %d PID)\n",
+         SCANNER_SEUIL_PARALLELE);
+  snapshot_liberer(&dest);
+}
+
+/**
+ * @brief Remplit une liste synthétique ; 'variation' % des processus
+ *        changent de CPU depuis l'appel précédent.
+ */
+static processus_t *generer_liste_tri(snapshot_t *liste, int variation) {
+  snapshot_reinitialiser(liste);
+  for (int i = 0; i < BENCH_TRI_PROCESSUS; i++) {
+    processus_t *p = snapshot_ajouter(liste);
+    if (p == NULL) {
+      break;
+    }
+    memset(p, 0, sizeof(*p));
+    p->pid = i + 1;
+    p->cpu_percent = (float)((i * 7919) % 1000) / 10.0f;
+    if (rand() % 100 < variation) {
+      p->cpu_percent = (float)(rand() % 1000) / 10.0f;
+    }
+  }
+  return snapshot_finaliser(liste);
+}
+
+/**
+ * @brief Compare le tri complet, la sélection des premières lignes et la
+ *        correction de l'ordre précédent (tri par CPU).
+ */
+static void bench_tri(int iterations) {
+  snapshot_t liste, vue;
+  tri_t tri;
+  double complet = 0.0, selection = 0.0, reutilisation = 0.0;
+
+  snapshot_init(&liste);
+  snapshot_init(&vue);
+  tri_init(&tri, TRI_CPU, 1);
+  srand(1);
+
+  for (int it = 0; it < iterations; it++) {
+    processus_t *p = generer_liste_tri(&liste, 0);
+    double debut = maintenant_ns();
+    tri_appliquer(&tri, p, BENCH_TRI_PROCESSUS, &vue);
+    complet += maintenant_ns() - debut;
+
+    tri_oublier(&tri);
+    debut = maintenant_ns();
+    tri_appliquer(&tri, p, BENCH_TRI_LIGNES, &vue);
+    selection += maintenant_ns() - debut;
+
+    /* Rafraîchissement suivant : quelques valeurs ont changé */
+    p = generer_liste_tri(&liste, 2);
+    debut = maintenant_ns();
+    tri_appliquer(&tri, p, BENCH_TRI_LIGNES, &vue);
+    reutilisation += maintenant_ns() - debut;
+    tri_oublier(&tri);
+  }
+
+  printf("Tri par CPU, %d processus, %d lignes affichees, %d passes:\n",
+         BENCH_TRI_PROCESSUS, BENCH_TRI_LIGNES, iterations);
+  printf("  tri complet             : %8.2f ms\n",
+         complet / iterations / 1e6);
+  printf("  premieres lignes        : %8.2f ms\n",
+         selection / iterations / 1e6);
+  printf("  ordre precedent corrige : %8.2f ms (%lu/%d reutilise)\n",
+         reutilisation / iterations / 1e6, tri.nb_reutilisations,
+         iterations);
+  printf("  (copie contigue de la vue comprise)\n");
+
+  tri_liberer(&tri);
+  snapshot_liberer(&liste);
+  snapshot_liberer(&vue);
+}
+
+/**
+ * @brief Remplit une liste synthétique façon 'ps -eo args' (nom = ligne de
+ *        commande, comme pour un hôte distant).
+ */
+static processus_t *generer_liste_filtre(snapshot_t *liste) {
+  static const char *noms[] = {"nginx", "postgres", "python3", "sshd",
+                               "java", "node", "redis-server", "bash"};
+  static const char *utilisateurs[] = {"root", "www-data", "postgres",
+                                       "alice", "bob"};
+
+  snapshot_reinitialiser(liste);
+  for (int i = 0; i < BENCH_FILTRE_PROCESSUS; i++) {
+    processus_t *p = snapshot_ajouter(liste);
+    const char *nom = noms[(i * 7) % 8];
+    if (p == NULL) {
+      break;
+    }
+    memset(p, 0, sizeof(*p));
+    p->pid = i + 1;
+    snprintf(p->utilisateur, sizeof(p->utilisateur), "%s",
+             utilisateurs[i % 5]);
+    snprintf(p->nom_commande, sizeof(p->nom_commande),
+             "/usr/bin/%s --worker=%d --conf /etc/%s/%d.conf", nom, i % 64,
+             nom, i % 7);
+  }
+  return snapshot_finaliser(liste);
+}
+
+/**
+ * @brief Mesure la construction de l'index (faite par le thread de la
+ *        source) et le filtrage d'une frappe (vue copiée comprise).
+ */
+static void bench_filtre(int iterations) {
+  static const struct {
+    const char *motif;
+    filtre_mode_t mode;
+  } requetes[] = {
+      {"worker=17 ", FILTRE_SOUS_CHAINE},
+      {"redis", FILTRE_SOUS_CHAINE},
+      {"po", FILTRE_PREFIXE},
+      {"^/usr/bin/py.*3\\.conf$", FILTRE_REGEX},
+      {"e", FILTRE_SOUS_CHAINE},
+  };
+  int nb_requetes = (int)(sizeof(requetes) / sizeof(requetes[0]));
+  snapshot_t liste, vue;
+  index_texte_t index;
+  filtre_t filtre;
+  processus_t *p;
+  double construction = 0.0;
+
+  snapshot_init(&liste);
+  snapshot_init(&vue);
+  index_texte_init(&index);
+  filtre_init(&filtre);
+  p = generer_liste_filtre(&liste);
+
+  for (int it = 0; it < iterations; it++) {
+    double debut = maintenant_ns();
+    index_texte_construire(&index, p, NULL, NULL);
+    construction += maintenant_ns() - debut;
+  }
+  printf("Filtre, %d processus, %d passes:\n", BENCH_FILTRE_PROCESSUS,
+         iterations);
+  printf("  construction de l'index          : %8.2f ms (thread de la source)\n",
+         construction / iterations / 1e6);
+
+  for (int r = 0; r < nb_requetes; r++) {
+    double duree = 0.0;
+    int nb = 0;
+
+    filtre_definir(&filtre, requetes[r].motif, requetes[r].mode);
+    for (int it = 0; it < iterations; it++) {
+      double debut = maintenant_ns();
+      filtre_appliquer(&filtre, p, &index, &vue, &nb);
+      duree += maintenant_ns() - debut;
+    }
+    printf("  %-11s %-22s: %8.2f ms (%d lignes)\n",
+           filtre_nom_mode(requetes[r].mode), requetes[r].motif,
+           duree / iterations / 1e6, nb);
+  }
+  printf("  (%lu recherches sans table sur %lu)\n", filtre.nb_parcours,
+         filtre.nb_recherches);
+
+  filtre_liberer(&filtre);
+  index_texte_liberer(&index);
+  snapshot_liberer(&liste);
+  snapshot_liberer(&vue);
+}
+
+/**
+ * @brief Enregistre la sortie d'une commande locale puis répète ses lignes
+ *        de processus jusqu'à BENCH_PS_PROCESSUS (en-têtes conservés).
+ * @return char* : Sortie (à libérer), ou NULL en cas d'erreur.
+ */
+static char *enregistrer_sortie_ps(const char *commande, int nb_entetes,
+                                   size_t *taille) {
+  FILE *ps = popen(commande, "r");
+  char *brut = NULL, *sortie, *corps;
+  size_t taille_brut = 0, capacite = 0, taille_corps, longueur;
+  int nb_lignes = 0;
+
+  if (ps == NULL) {
+    return NULL;
+  }
+  for (;;) {
+    if (capacite - taille_brut < BENCH_PS_LECTURE) {
+      char *nouveau = realloc(brut, capacite + 65536);
+      if (nouveau == NULL) {
+        break;
+      }
+      brut = nouveau;
+      capacite += 65536;
+    }
+    size_t lus = fread(brut + taille_brut, 1, BENCH_PS_LECTURE, ps);
+    if (lus == 0) {
+      break;
+    }
+    taille_brut += lus;
+  }
+  pclose(ps);
+  if (brut == NULL || taille_brut == 0 || brut[taille_brut - 1] != '\n') {
+    free(brut);
+    return NULL;
+  }
+
+  /* Corps : tout ce qui suit les en-têtes */
+  corps = brut;
+  for (int i = 0; i < nb_entetes && corps != NULL; i++) {
+    corps = memchr(corps, '\n', taille_brut - (size_t)(corps - brut));
+    corps = corps != NULL ? corps + 1 : NULL;
+  }
+  if (corps == NULL || corps == brut + taille_brut) {
+    free(brut);
+    return NULL;
+  }
+  taille_corps = taille_brut - (size_t)(corps - brut);
+  for (const char *c = corps; c < brut + taille_brut; c++) {
+    nb_lignes += (*c == '\n');
+  }
+
+  longueur = (size_t)(corps - brut);
+  sortie = malloc(longueur +
+                  taille_corps * (BENCH_PS_PROCESSUS / nb_lignes + 1) + 1);
+  if (sortie == NULL) {
+    free(brut);
+    return NULL;
+  }
+  memcpy(sortie, brut, longueur);
+  for (int n = 0; n < BENCH_PS_PROCESSUS; n += nb_lignes) {
+    memcpy(sortie + longueur, corps, taille_corps);
+    longueur += taille_corps;
+  }
+  sortie[longueur] = '\0';
+  free(brut);
+  *taille = longueur;
+  return sortie;
+}
+
+/**
+ * @brief Ancien chemin : réception par realloc + strcat, copie par strdup
+ *        puis découpage par strtok et sscanf (format COMMANDE_PS_DELTA).
+ */
+static int reception_ancienne(const char *sortie, size_t taille,
+                              snapshot_t *dest) {
+  char buffer[BENCH_PS_LECTURE];
+  char *output = NULL;
+  int output_size = 0;
+  char *output_copy, *line;
+  double uptime;
+  int nb_coeurs;
+
+  for (size_t pos = 0; pos < taille; pos += BENCH_PS_LECTURE - 1) {
+    int nbytes = (int)(taille - pos < BENCH_PS_LECTURE - 1
+                           ? taille - pos
+                           : BENCH_PS_LECTURE - 1);
+    memcpy(buffer, sortie + pos, (size_t)nbytes); /* ssh_channel_read */
+    buffer[nbytes] = '\0';
+    char *new_output = realloc(output, output_size + nbytes + 1);
+    if (new_output == NULL) {
+      free(output);
+      return -1;
+    }
+    output = new_output;
+    if (output_size == 0) {
+      output[0] = '\0';
+    }
+    strcat(output, buffer);
+    output_size += nbytes;
+  }
+
+  output_copy = strdup(output);
+  free(output);
+  if (output_copy == NULL) {
+    return -1;
+  }
+  snapshot_reinitialiser(dest);
+  line = strtok(output_copy, "\n");
+  if (line == NULL || sscanf(line, "%lf", &uptime) != 1 ||
+      (line = strtok(NULL, "\n")) == NULL ||
+      sscanf(line, "%d", &nb_coeurs) != 1) {
+    free(output_copy);
+    return -1;
+  }
+  line = strtok(NULL, "\n"); /* En-tête de ps */
+  while (line != NULL && (line = strtok(NULL, "\n")) != NULL) {
+    processus_t *proc = snapshot_ajouter(dest);
+    long vsz, rss;
+    long long cpu_secondes, age_secondes;
+    char stat[16];
+
+    if (proc == NULL ||
+        sscanf(line, "%31s %d %d %15s %ld %ld %lld %lld %255[^\n]",
+               proc->utilisateur, &proc->pid, &proc->ppid, stat, &vsz, &rss,
+               &cpu_secondes, &age_secondes, proc->nom_commande) < 8) {
+      snapshot_annuler_dernier(dest);
+    }
+  }
+  free(output_copy);
+  return dest->nb;
+}
+
+/**
+ * @brief Nouveau chemin : lignes analysées à la réception, directement
+ *        dans le snapshot.
+ */
+static int reception_flux(flux_lignes_t *flux, const char *sortie,
+                          size_t taille, flux_format_t format,
+                          snapshot_t *dest) {
+  flux_analyse_t analyse;
+  int etat = FLUX_CONTINUER;
+
+  flux_analyse_commencer(&analyse, dest, format);
+  flux_commencer(flux, flux_analyser_ligne, &analyse);
+  for (size_t pos = 0; pos < taille && etat == FLUX_CONTINUER;
+       pos += BENCH_PS_LECTURE) {
+    size_t disponible;
+    char *zone = flux_zone(flux, &disponible);
+    size_t nb = taille - pos < BENCH_PS_LECTURE ? taille - pos
+                                                : BENCH_PS_LECTURE;
+
+    if (zone == NULL) {
+      return -1;
+    }
+    memcpy(zone, sortie + pos, nb); /* ssh_channel_read */
+    etat = flux_valider(flux, nb);
+  }
+  return flux_analyse_terminer(&analyse, flux_terminer(flux)) != NULL
+             ? dest->nb
+             : -1;
+}
+
+/**
+ * @brief Compare la réception d'une sortie 'ps' distante (enregistrée sur
+ *        cette machine, répétée jusqu'à BENCH_PS_PROCESSUS lignes).
+ */
+static void bench_reception_distante(int iterations) {
+  static const struct {
+    const char *nom;
+    const char *commande;
+    int nb_entetes;
+    flux_format_t format;
+  } formats[] = {
+      {"ps -eo (delta)", COMMANDE_PS_DELTA, 3, FLUX_PS_DELTA},
+      {"ps aux", "ps aux", 1, FLUX_PS_AUX},
+  };
+  flux_lignes_t flux;
+  snapshot_t dest;
+
+  flux_init(&flux);
+  snapshot_init(&dest);
+  printf("Reception d'une sortie ps distante, lectures de %d octets:\n",
+         BENCH_PS_LECTURE);
+
+  for (int f = 0; f < 2; f++) {
+    size_t taille;
+    char *sortie = enregistrer_sortie_ps(formats[f].commande,
+                                         formats[f].nb_entetes, &taille);
+    double debut, duree;
+    int nb = 0;
+
+    if (sortie == NULL) {
+      printf("  %-15s : sortie indisponible\n", formats[f].nom);
+      continue;
+    }
+    printf("  %-15s : %.1f Mo enregistres\n", formats[f].nom,
+           (double)taille / 1e6);
+
+    /* Quadratique : une seule passe suffit à le montrer */
+    if (formats[f].format == FLUX_PS_DELTA) {
+      debut = maintenant_ns();
+      nb = reception_ancienne(sortie, taille, &dest);
+      duree = maintenant_ns() - debut;
+      printf("    realloc+strcat+strtok : %8.2f ms (%d processus, 1 passe)\n",
+             duree / 1e6, nb);
+    }
+
+    debut = maintenant_ns();
+    for (int it = 0; it < iterations; it++) {
+      nb = reception_flux(&flux, sortie, taille, formats[f].format, &dest);
+    }
+    duree = (maintenant_ns() - debut) / iterations;
+    printf("    flux (sur place)      : %8.2f ms (%d processus, %.0f Mo/s, "
+           "tampon %zu Ko)\n",
+           duree / 1e6, nb, (double)taille / (duree / 1e9) / 1e6,
+           flux.capacite / 1024);
+    free(sortie);
+  }
+
+  flux_liberer(&flux);
+  snapshot_liberer(&dest);
+}
+
+/* Fonctions publiques */
+
+int bench_executer(int iterations) {
+  pid_t *pids = malloc(sizeof(pid_t) * BENCH_MAX_PIDS);
+  int nb_pids;
+
+  if (pids == NULL) {
+    perror("Erreur d'allocation memoire");
+    return EXIT_FAILURE;
+  }
+
+  nb_pids = lister_pids(pids, BENCH_MAX_PIDS);
+  if (nb_pids <= 0) {
+    fprintf(stderr, "ERREUR: Impossible de lire /proc\n");
+    free(pids);
+    return EXIT_FAILURE;
+  }
+
+  printf("=== MY_HTOP - Benchmarks de collecte ===\n\n");
+  bench_lecture_stat(pids, nb_pids, iterations);
+  printf("\n");
+  bench_analyse_stat(iterations);
+  printf("\n");
+  bench_scanner(iterations);
+  printf("\n");
+  bench_tri(iterations);
+  printf("\n");
+  bench_filtre(iterations);
+  printf("\n");
+  bench_reception_distante(iterations);
+
+  free(pids);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,20 @@
+/**
+ * @file bench.h
+ * @brief Micro-benchmarks des chemins de collecte
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Ce module mesure le coût par processus des différentes implémentations
+ * de collecte, afin de comparer l'ancien et le nouveau chemin.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+/**
+ * @brief Lance l'ensemble des benchmarks et affiche les résultats.
+ * @param iterations : Nombre de passes sur /proc par mesure.
+ * @return int : EXIT_SUCCESS ou EXIT_FAILURE.
+ */
+int bench_executer(int iterations);
+
+#endif /* BENCH_H */
@@ -0,0 +1,140 @@
+/**
+ * @file boucle.c
+ * @brief Implémentation de la boucle d'événements (poll, timerfd, signalfd)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "boucle.h"
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#define FD_CLAVIER 0
+#define FD_MINUTEUR 1
+#define FD_SIGNAUX 2
+#define FD_SOURCE 3
+
+/* Fonctions privées */
+
+/**
+ * @brief Vide le signalfd et traduit les signaux reçus en événements.
+ */
+static int lire_signaux(boucle_t *boucle) {
+  struct signalfd_siginfo info;
+  int evenements = 0;
+
+  while (read(boucle->signal_fd, &info, sizeof(info)) == sizeof(info)) {
+    if (info.ssi_signo == SIGWINCH) {
+      evenements |= BOUCLE_REDIMENSION;
+    } else {
+      evenements |= BOUCLE_ARRET;
+    }
+  }
+  return evenements;
+}
+
+/* Fonctions publiques */
+
+int boucle_init(boucle_t *boucle, int delai_ms) {
+  struct itimerspec periode;
+  sigset_t masque;
+
+  memset(boucle, 0, sizeof(*boucle));
+  boucle->delai_ms = delai_ms;
+  boucle->minuteur_fd = -1;
+  boucle->signal_fd = -1;
+
+  sigemptyset(&masque);
+  sigaddset(&masque, SIGWINCH);
+  sigaddset(&masque, SIGINT);
+  sigaddset(&masque, SIGTERM);
+  sigaddset(&masque, SIGHUP);
+  if (sigprocmask(SIG_BLOCK, &masque, &boucle->masque_precedent) != 0) {
+    return -1;
+  }
+
+  boucle->signal_fd = signalfd(-1, &masque, SFD_NONBLOCK | SFD_CLOEXEC);
+  boucle->minuteur_fd =
+      timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (boucle->signal_fd < 0 || boucle->minuteur_fd < 0) {
+    int erreur = errno;
+    boucle_liberer(boucle);
+    errno = erreur;
+    return -1;
+  }
+
+  /* Période fixe : les rafraîchissements ne dérivent pas avec leur durée */
+  periode.it_interval.tv_sec = delai_ms / 1000;
+  periode.it_interval.tv_nsec = (long)(delai_ms % 1000) * 1000000L;
+  periode.it_value = periode.it_interval;
+  if (timerfd_settime(boucle->minuteur_fd, 0, &periode, NULL) != 0) {
+    int erreur = errno;
+    boucle_liberer(boucle);
+    errno = erreur;
+    return -1;
+  }
+
+  /* Une entrée qui n'est pas un terminal (/dev/null) serait toujours prête */
+  boucle->fds[FD_CLAVIER].fd = isatty(STDIN_FILENO) ? STDIN_FILENO : -1;
+  boucle->fds[FD_MINUTEUR].fd = boucle->minuteur_fd;
+  boucle->fds[FD_SIGNAUX].fd = boucle->signal_fd;
+  boucle->fds[FD_SOURCE].fd = -1;
+  for (int i = 0; i < NB_FDS; i++) {
+    boucle->fds[i].events = POLLIN;
+  }
+  return 0;
+}
+
+void boucle_liberer(boucle_t *boucle) {
+  if (boucle->minuteur_fd >= 0) {
+    close(boucle->minuteur_fd);
+    boucle->minuteur_fd = -1;
+  }
+  if (boucle->signal_fd >= 0) {
+    close(boucle->signal_fd);
+    boucle->signal_fd = -1;
+    sigprocmask(SIG_SETMASK, &boucle->masque_precedent, NULL);
+  }
+}
+
+void boucle_surveiller_source(boucle_t *boucle, int fd) {
+  boucle->fds[FD_SOURCE].fd = fd;
+}
+
+int boucle_attendre(boucle_t *boucle, int attente_max_ms) {
+  int evenements = 0;
+  int pret;
+
+  do {
+    pret = poll(boucle->fds, NB_FDS, attente_max_ms);
+  } while (pret < 0 && errno == EINTR);
+  if (pret <= 0) {
+    return 0;
+  }
+
+  if (boucle->fds[FD_CLAVIER].revents & POLLIN) {
+    evenements |= BOUCLE_CLAVIER;
+  } else if (boucle->fds[FD_CLAVIER].revents & (POLLHUP | POLLERR | POLLNVAL)) {
+    evenements |= BOUCLE_ARRET; /* Terminal fermé */
+  }
+  if (boucle->fds[FD_MINUTEUR].revents & POLLIN) {
+    uint64_t expirations;
+    /* Plusieurs périodes manquées ne donnent qu'un rafraîchissement */
+    if (read(boucle->minuteur_fd, &expirations, sizeof(expirations)) ==
+        sizeof(expirations)) {
+      evenements |= BOUCLE_MINUTEUR;
+    }
+  }
+  if (boucle->fds[FD_SIGNAUX].revents & POLLIN) {
+    evenements |= lire_signaux(boucle);
+  }
+  if (boucle->fds[FD_SOURCE].revents & POLLIN) {
+    evenements |= BOUCLE_SOURCE;
+  }
+  return evenements;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file boucle.h
+ * @brief Boucle d'événements : clavier, minuteur de rafraîchissement, signaux
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * La boucle principale dort dans poll() sur l'entrée standard, un timerfd
+ * monotone qui cadence les rafraîchissements à la milliseconde, un signalfd
+ * qui reçoit SIGWINCH, SIGINT, SIGTERM et SIGHUP, et un descripteur de
+ * source (fin de collecte). Le processus ne se réveille que lorsqu'il y a
+ * quelque chose à faire, et une touche est traitée dès sa frappe.
+ */
+
+#ifndef BOUCLE_H
+#define BOUCLE_H
+
+#include <poll.h>
+#include <signal.h>
+
+#define BOUCLE_DELAI_DEFAUT_MS 2000 /* Rafraîchissement par défaut */
+#define BOUCLE_DELAI_MIN_MS 20      /* Bornes acceptées pour -d */
+#define BOUCLE_DELAI_MAX_MS 3600000
+
+#define NB_FDS 4 /* Clavier, minuteur, signaux, source */
+
+/* Événements renvoyés par boucle_attendre (combinables) */
+#define BOUCLE_CLAVIER 0x1     /* Touche(s) en attente sur l'entrée standard */
+#define BOUCLE_MINUTEUR 0x2    /* Rafraîchissement dû */
+#define BOUCLE_REDIMENSION 0x4 /* Terminal redimensionné (SIGWINCH) */
+#define BOUCLE_ARRET 0x8       /* SIGINT, SIGTERM ou SIGHUP reçu */
+#define BOUCLE_SOURCE 0x10     /* Descripteur de source lisible */
+
+/**
+ * @brief Descripteurs surveillés par la boucle.
+ */
+typedef struct boucle {
+  int minuteur_fd;          /* timerfd (CLOCK_MONOTONIC) */
+  int signal_fd;            /* signalfd des signaux bloqués */
+  sigset_t masque_precedent; /* Restauré par boucle_liberer */
+  int delai_ms;             /* Période du minuteur */
+  struct pollfd fds[NB_FDS];
+} boucle_t;
+
+/**
+ * @brief Crée le minuteur et le signalfd, et bloque les signaux surveillés.
+ *
+ * À appeler avant de créer des threads : ils héritent du masque et ne
+ * reçoivent donc pas ces signaux à la place du signalfd.
+ *
+ * @param boucle : Boucle à initialiser.
+ * @param delai_ms : Période de rafraîchissement en millisecondes.
+ * @return int : 0 en cas de succès, -1 en cas d'erreur (errno renseigné).
+ */
+int boucle_init(boucle_t *boucle, int delai_ms);
+
+/**
+ * @brief Ferme les descripteurs et restaure le masque de signaux.
+ * @param boucle : Boucle à libérer.
+ */
+void boucle_liberer(boucle_t *boucle);
+
+/**
+ * @brief Surveille un descripteur supplémentaire (BOUCLE_SOURCE), que
+ *        l'appelant doit vider à chaque réveil.
+ * @param boucle : Boucle concernée.
+ * @param fd : Descripteur (-1 pour ne plus en surveiller).
+ */
+void boucle_surveiller_source(boucle_t *boucle, int fd);
+
+/**
+ * @brief Attend le prochain événement.
+ * @param boucle : Boucle concernée.
+ * @param attente_max_ms : Attente maximale (-1 : illimitée).
+ * @return int : Événements survenus (BOUCLE_*), 0 si l'attente a expiré.
+ */
+int boucle_attendre(boucle_t *boucle, int attente_max_ms);
+
+#endif /* BOUCLE_H */
@@ -0,0 +1,396 @@
+/**
+ * @file collecteur.c
+ * @brief Implémentation du moteur de collecte
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "collecteur.h"
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Fonctions privées */
+
+/**
+ * @brief Délai accordé à une collecte avant que la source soit périmée.
+ */
+static long long echeance_ms(const collecteur_poste_t *poste) {
+  int periode = poste->source->periode_ms;
+
+  return periode > COLLECTEUR_ECHEANCE_MIN_MS ? periode
+                                              : COLLECTEUR_ECHEANCE_MIN_MS;
+}
+
+/**
+ * @brief Attend sur la condition jusqu'à l'instant 'limite_ms' (monotone).
+ */
+static void attendre_jusqua(collecteur_t *collecteur, long long limite_ms) {
+  struct timespec limite;
+
+  limite.tv_sec = limite_ms / 1000;
+  limite.tv_nsec = (long)(limite_ms % 1000) * 1000000L;
+  pthread_cond_timedwait(&collecteur->cond, &collecteur->verrou, &limite);
+}
+
+/**
+ * @brief Prévient la boucle d'événements de l'interface.
+ */
+static void notifier(collecteur_t *collecteur) {
+  uint64_t un = 1;
+
+  if (write(collecteur->evenement_fd, &un, sizeof(un)) != sizeof(un)) {
+    /* Compteur saturé : une notification est déjà en attente */
+  }
+}
+
+/**
+ * @brief Fixe la prochaine collecte périodique après une collecte terminée
+ *        à 'fin' (verrou tenu).
+ *
+ * La cadence reste calée sur la période ; les périodes manquées pendant
+ * une collecte trop longue sont mises en attente dans la limite de
+ * max_en_vol, les autres sont abandonnées.
+ */
+static void planifier(collecteur_poste_t *poste, long long fin) {
+  long long periode = poste->source->periode_ms;
+
+  if (poste->debut_ms < poste->prochaine_ms) {
+    /* Collecte demandée : la cadence repart de cette collecte */
+    poste->prochaine_ms = poste->debut_ms + periode;
+  } else {
+    poste->prochaine_ms += periode;
+  }
+
+  if (poste->prochaine_ms <= fin) {
+    long long manquees = (fin - poste->prochaine_ms) / periode + 1;
+    long long places = poste->source->max_en_vol - 1 - poste->en_vol;
+
+    if (places > 0) {
+      poste->en_vol += (int)(manquees < places ? manquees : places);
+    }
+    poste->prochaine_ms += manquees * periode;
+  }
+}
+
+/**
+ * @brief Envoie le lot confié au poste (verrou tenu, relâché pendant
+ *        l'envoi), puis demande une collecte qui en montre l'effet.
+ */
+static void envoyer_lot(collecteur_poste_t *poste) {
+  collecteur_t *collecteur = poste->collecteur;
+  source_t *source = poste->source;
+  lot_signaux_t *lot = poste->lot;
+
+  /* Les résultats de chaque PID sont dans le lot, même en cas d'échec */
+  pthread_mutex_unlock(&collecteur->verrou);
+  source->ops->envoyer_signaux(source->donnees, lot);
+  pthread_mutex_lock(&collecteur->verrou);
+
+  poste->lot = NULL;
+  poste->lot_envoye = 1;
+  if (poste->en_vol < source->max_en_vol) {
+    poste->en_vol++;
+  }
+  pthread_mutex_unlock(&collecteur->verrou);
+  notifier(collecteur);
+  pthread_mutex_lock(&collecteur->verrou);
+}
+
+static void *boucle_poste(void *arg) {
+  collecteur_poste_t *poste = arg;
+  collecteur_t *collecteur = poste->collecteur;
+  source_t *source = poste->source;
+
+  pthread_mutex_lock(&collecteur->verrou);
+  for (;;) {
+    /* Attendre une demande, un lot ou l'échéance de la période */
+    while (!collecteur->arret && poste->en_vol == 0 && poste->lot == NULL) {
+      if (collecteur_maintenant_ms() >= poste->prochaine_ms) {
+        poste->en_vol = 1;
+        break;
+      }
+      attendre_jusqua(collecteur, poste->prochaine_ms);
+    }
+    if (collecteur->arret) {
+      break;
+    }
+    if (poste->lot != NULL) {
+      envoyer_lot(poste);
+      continue;
+    }
+
+    poste->en_cours = 1;
+    poste->debut_ms = collecteur_maintenant_ms();
+    int ecriture = poste->ecriture;
+    int indexer = collecteur->indexer;
+    pthread_mutex_unlock(&collecteur->verrou);
+
+    /* Hors verrou : la collecte peut durer (parcours de /proc, SSH) */
+    collecte_t *dest = &poste->tampons[ecriture];
+    int retour = source->ops->collecter(source->donnees, dest);
+    if (retour != 0 || !indexer ||
+        index_texte_construire(&dest->index, dest->liste,
+                               source->ops->ligne_commande,
+                               source->donnees) != 0) {
+      /* L'interface se rabat sur un index sans lignes de commande */
+      index_texte_invalider(&dest->index);
+    }
+    long long fin = collecteur_maintenant_ms();
+    dest->instant_ms = fin;
+
+    pthread_mutex_lock(&collecteur->verrou);
+    poste->en_cours = 0;
+    poste->en_vol--;
+    poste->termine++;
+    poste->echec = retour != 0;
+    poste->derniere_duree_ms = fin - poste->debut_ms;
+    planifier(poste, fin);
+    if (retour == 0) {
+      poste->ecriture = poste->pret;
+      poste->pret = ecriture;
+      poste->nouveau = 1;
+      collecteur->nb_collectes++;
+    }
+    pthread_cond_broadcast(&collecteur->cond);
+    pthread_mutex_unlock(&collecteur->verrou);
+
+    /* Aussi en cas d'échec : l'interface affiche la source périmée */
+    notifier(collecteur);
+    pthread_mutex_lock(&collecteur->verrou);
+  }
+  pthread_mutex_unlock(&collecteur->verrou);
+  return NULL;
+}
+
+/* Fonctions publiques */
+
+void collecteur_init(collecteur_t *collecteur) {
+  memset(collecteur, 0, sizeof(*collecteur));
+  collecteur->evenement_fd = -1;
+}
+
+int collecteur_ajouter(collecteur_t *collecteur, source_t *source) {
+  if (collecteur->nb_postes >= COLLECTEUR_MAX_SOURCES) {
+    return -1;
+  }
+
+  int numero = collecteur->nb_postes++;
+  collecteur_poste_t *poste = &collecteur->postes[numero];
+  memset(poste, 0, sizeof(*poste));
+  poste->collecteur = collecteur;
+  poste->source = source;
+  for (int t = 0; t < 3; t++) {
+    snapshot_init(&poste->tampons[t].arene);
+    index_texte_init(&poste->tampons[t].index);
+    poste->tampons[t].nb_ephemeres = -1;
+  }
+  poste->ecriture = 0;
+  poste->pret = 1;
+  poste->lecture = 2;
+  if (source->max_en_vol < 1) {
+    source->max_en_vol = 1;
+  }
+  return numero;
+}
+
+int collecteur_demarrer(collecteur_t *collecteur) {
+  pthread_condattr_t attributs;
+  long long debut = collecteur_maintenant_ms();
+
+  collecteur->evenement_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (collecteur->evenement_fd < 0) {
+    return -1;
+  }
+  pthread_condattr_init(&attributs);
+  pthread_condattr_setclock(&attributs, CLOCK_MONOTONIC);
+  pthread_mutex_init(&collecteur->verrou, NULL);
+  pthread_cond_init(&collecteur->cond, &attributs);
+  pthread_condattr_destroy(&attributs);
+
+  /* Première collecte immédiate pour toutes les sources */
+  for (int i = 0; i < collecteur->nb_postes; i++) {
+    collecteur->postes[i].prochaine_ms = debut;
+    if (pthread_create(&collecteur->postes[i].thread, NULL, boucle_poste,
+                       &collecteur->postes[i]) != 0) {
+      return -1;
+    }
+    collecteur->nb_demarres++;
+  }
+
+  /* L'interface démarre avec des données, sans attendre un hôte muet ni
+     une connexion */
+  pthread_mutex_lock(&collecteur->verrou);
+  for (;;) {
+    long long maintenant = collecteur_maintenant_ms();
+    long long limite = 0;
+
+    for (int i = 0; i < collecteur->nb_postes; i++) {
+      const collecteur_poste_t *poste = &collecteur->postes[i];
+      long long echeance = debut + echeance_ms(poste);
+      if (poste->termine == 0 && maintenant < echeance &&
+          !source_peut(poste->source, SOURCE_CAP_CONNEXION) &&
+          (limite == 0 || echeance < limite)) {
+        limite = echeance;
+      }
+    }
+    if (limite == 0) {
+      break;
+    }
+    attendre_jusqua(collecteur, limite);
+  }
+  pthread_mutex_unlock(&collecteur->verrou);
+  return 0;
+}
+
+void collecteur_arreter(collecteur_t *collecteur) {
+  if (collecteur->evenement_fd >= 0) {
+    pthread_mutex_lock(&collecteur->verrou);
+    collecteur->arret = 1;
+    pthread_cond_broadcast(&collecteur->cond);
+    pthread_mutex_unlock(&collecteur->verrou);
+
+    for (int i = 0; i < collecteur->nb_demarres; i++) {
+      pthread_join(collecteur->postes[i].thread, NULL);
+    }
+    collecteur->nb_demarres = 0;
+
+    close(collecteur->evenement_fd);
+    collecteur->evenement_fd = -1;
+    pthread_mutex_destroy(&collecteur->verrou);
+    pthread_cond_destroy(&collecteur->cond);
+  }
+
+  for (int i = 0; i < collecteur->nb_postes; i++) {
+    for (int t = 0; t < 3; t++) {
+      snapshot_liberer(&collecteur->postes[i].tampons[t].arene);
+      index_texte_liberer(&collecteur->postes[i].tampons[t].index);
+      collecteur->postes[i].tampons[t].liste = NULL;
+    }
+  }
+  collecteur->nb_postes = 0;
+}
+
+void collecteur_demander(collecteur_t *collecteur, int poste) {
+  pthread_mutex_lock(&collecteur->verrou);
+  for (int i = 0; i < collecteur->nb_postes; i++) {
+    collecteur_poste_t *p = &collecteur->postes[i];
+    if ((poste < 0 || poste == i) && p->en_vol < p->source->max_en_vol) {
+      p->en_vol++;
+    }
+  }
+  pthread_cond_broadcast(&collecteur->cond);
+  pthread_mutex_unlock(&collecteur->verrou);
+}
+
+void collecteur_changer_periode(collecteur_t *collecteur, int poste,
+                                int periode_ms) {
+  collecteur_poste_t *p = &collecteur->postes[poste];
+
+  pthread_mutex_lock(&collecteur->verrou);
+  if (p->source->periode_ms != periode_ms) {
+    p->source->periode_ms = periode_ms;
+    /* Une collecte en cours sera replanifiée à sa fin avec la période */
+    if (!p->en_cours && p->termine > 0) {
+      p->prochaine_ms = p->debut_ms + periode_ms;
+      pthread_cond_broadcast(&collecteur->cond);
+    }
+  }
+  pthread_mutex_unlock(&collecteur->verrou);
+}
+
+void collecteur_indexer(collecteur_t *collecteur, int actif) {
+  pthread_mutex_lock(&collecteur->verrou);
+  collecteur->indexer = actif;
+  pthread_mutex_unlock(&collecteur->verrou);
+}
+
+int collecteur_signaler(collecteur_t *collecteur, int poste,
+                        lot_signaux_t *lot) {
+  collecteur_poste_t *p = &collecteur->postes[poste];
+  int retour = -1;
+
+  if (!source_peut(p->source, SOURCE_CAP_SIGNAUX)) {
+    return -1;
+  }
+  pthread_mutex_lock(&collecteur->verrou);
+  if (p->lot == NULL && !p->lot_envoye) {
+    p->lot = lot;
+    pthread_cond_broadcast(&collecteur->cond);
+    retour = 0;
+  }
+  pthread_mutex_unlock(&collecteur->verrou);
+  return retour;
+}
+
+int collecteur_lot_envoye(collecteur_t *collecteur, int poste) {
+  collecteur_poste_t *p = &collecteur->postes[poste];
+  int envoye;
+
+  pthread_mutex_lock(&collecteur->verrou);
+  envoye = p->lot_envoye;
+  p->lot_envoye = 0;
+  pthread_mutex_unlock(&collecteur->verrou);
+  return envoye;
+}
+
+void collecteur_vider(collecteur_t *collecteur) {
+  uint64_t compteur;
+
+  /* Une publication ultérieure réarmera la notification */
+  if (read(collecteur->evenement_fd, &compteur, sizeof(compteur)) < 0) {
+    /* Rien en attente */
+  }
+}
+
+collecte_t *collecteur_recuperer(collecteur_t *collecteur, int poste) {
+  collecteur_poste_t *p = &collecteur->postes[poste];
+  int nouveau;
+
+  pthread_mutex_lock(&collecteur->verrou);
+  nouveau = p->nouveau;
+  if (nouveau) {
+    int tmp = p->lecture;
+    p->lecture = p->pret;
+    p->pret = tmp;
+    p->nouveau = 0;
+  }
+  pthread_mutex_unlock(&collecteur->verrou);
+
+  return nouveau ? &p->tampons[p->lecture] : NULL;
+}
+
+int collecteur_perime(collecteur_t *collecteur, int poste) {
+  collecteur_poste_t *p = &collecteur->postes[poste];
+  long long maintenant = collecteur_maintenant_ms();
+  int perime;
+
+  pthread_mutex_lock(&collecteur->verrou);
+  perime = p->echec ||
+           (p->en_cours && maintenant - p->debut_ms > echeance_ms(p));
+  pthread_mutex_unlock(&collecteur->verrou);
+  return perime;
+}
+
+int collecteur_echec(collecteur_t *collecteur, int poste) {
+  int echec;
+
+  pthread_mutex_lock(&collecteur->verrou);
+  echec = collecteur->postes[poste].echec;
+  pthread_mutex_unlock(&collecteur->verrou);
+  return echec;
+}
+
+int collecteur_descripteur(const collecteur_t *collecteur) {
+  return collecteur->evenement_fd;
+}
+
+long long collecteur_maintenant_ms(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file collecteur.h
+ * @brief Moteur de collecte : un thread par source, chacune à sa cadence
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Chaque source (locale, SSH, ...) a son propre thread (« poste ») qui la
+ * collecte à sa propre période, sans limite commune : une source locale
+ * peut se rafraîchir toutes les 250 ms pendant qu'un hôte lointain l'est
+ * toutes les 10 s, et un hôte lent ne retarde jamais les autres.
+ *
+ * Trois tampons par poste tournent entre trois rôles : le poste écrit dans
+ * le sien puis l'échange avec le tampon « prêt » ; l'interface échange le
+ * sien avec le tampon « prêt » quand elle est prévenue par l'eventfd commun.
+ * Aucun des deux ne copie ni n'attend l'autre, et l'interface affiche
+ * toujours la dernière collecte complète de chaque source.
+ *
+ * Sur demande (filtre de recherche actif), le poste indexe aussi chaque
+ * collecte avant de la publier : la recherche ne coûte alors à
+ * l'interface que la lecture de l'index.
+ *
+ * Les signaux passent aussi par le poste : un lot confié à un poste part
+ * de son thread avant sa prochaine collecte, qui suit aussitôt pour
+ * montrer l'effet. Les lots de plusieurs hôtes partent donc en même temps,
+ * sans bloquer l'interface, qui lit les résultats à la notification.
+ *
+ * Une source dont la collecte dépasse son échéance (sa période, au moins
+ * COLLECTEUR_ECHEANCE_MIN_MS) ou échoue est « périmée » : son dernier
+ * instantané reste affiché.
+ */
+
+#ifndef COLLECTEUR_H
+#define COLLECTEUR_H
+
+#include "source.h"
+#include <pthread.h>
+
+#define COLLECTEUR_MAX_SOURCES 33     /* 1 locale + 32 distantes max */
+#define COLLECTEUR_ECHEANCE_MIN_MS 500 /* Échéance minimale d'une collecte */
+
+struct collecteur;
+
+/**
+ * @brief Thread d'une source et ses trois tampons.
+ */
+typedef struct collecteur_poste {
+  struct collecteur *collecteur;
+  source_t *source;
+  pthread_t thread;
+
+  /* Protégés par le verrou du collecteur */
+  int en_vol;               /* Collectes demandées non terminées */
+  int en_cours;             /* 1 : collecte en cours */
+  int nouveau;              /* 1 : 'pret' n'a pas encore été récupéré */
+  int echec;                /* 1 : la dernière collecte a échoué */
+  int termine;              /* Collectes terminées (succès ou échec) */
+  long long debut_ms;       /* Début de la collecte en cours */
+  long long prochaine_ms;   /* Prochaine collecte périodique */
+  long long derniere_duree_ms;
+  lot_signaux_t *lot;       /* Lot à envoyer (NULL : aucun) */
+  int lot_envoye;           /* 1 : lot traité, résultats non lus */
+
+  /* Triple tampon : le poste écrit, l'interface lit, 'pret' est échangé */
+  collecte_t tampons[3];
+  int ecriture;
+  int pret;
+  int lecture;
+} collecteur_poste_t;
+
+/**
+ * @brief Moteur de collecte.
+ */
+typedef struct collecteur {
+  collecteur_poste_t postes[COLLECTEUR_MAX_SOURCES];
+  int nb_postes;
+  int nb_demarres;          /* Threads créés */
+  int arret;
+  int indexer;              /* 1 : indexer chaque collecte */
+  pthread_mutex_t verrou;
+  pthread_cond_t cond;      /* Horloge monotone */
+  int evenement_fd;         /* eventfd signalé à chaque publication */
+  unsigned long nb_collectes;
+} collecteur_t;
+
+/**
+ * @brief Initialise un collecteur sans source.
+ * @param collecteur : Collecteur à initialiser.
+ */
+void collecteur_init(collecteur_t *collecteur);
+
+/**
+ * @brief Ajoute une source (avant collecteur_demarrer).
+ * @param collecteur : Collecteur concerné.
+ * @param source : Source (doit rester valide jusqu'à collecteur_arreter).
+ * @return int : Numéro du poste, ou -1 si le maximum est atteint.
+ */
+int collecteur_ajouter(collecteur_t *collecteur, source_t *source);
+
+/**
+ * @brief Démarre un thread par source et attend leur première collecte,
+ *        chacune au plus jusqu'à son échéance (sauf pour les sources qui
+ *        se connectent, SOURCE_CAP_CONNEXION).
+ * @param collecteur : Collecteur concerné.
+ * @return int : 0 en cas de succès, -1 si l'eventfd ou un thread n'ont pu
+ *               être créés.
+ */
+int collecteur_demarrer(collecteur_t *collecteur);
+
+/**
+ * @brief Arrête les threads (après leur collecte en cours) et libère les
+ *        tampons.
+ * @param collecteur : Collecteur concerné.
+ */
+void collecteur_arreter(collecteur_t *collecteur);
+
+/**
+ * @brief Demande une collecte immédiate, dans la limite des collectes en vol.
+ * @param collecteur : Collecteur concerné.
+ * @param poste : Numéro du poste (-1 : tous).
+ */
+void collecteur_demander(collecteur_t *collecteur, int poste);
+
+/**
+ * @brief Change la période d'un poste démarré. La prochaine collecte
+ *        périodique est recalée sur le début de la dernière collecte ; si
+ *        elle est déjà due, elle part aussitôt.
+ * @param collecteur : Collecteur concerné.
+ * @param poste : Numéro du poste.
+ * @param periode_ms : Nouvelle période (> 0).
+ */
+void collecteur_changer_periode(collecteur_t *collecteur, int poste,
+                                int periode_ms);
+
+/**
+ * @brief Active ou non l'index de recherche des prochaines collectes.
+ * @param collecteur : Collecteur concerné.
+ * @param actif : 1 pour indexer, 0 sinon.
+ */
+void collecteur_indexer(collecteur_t *collecteur, int actif);
+
+/**
+ * @brief Confie un lot de signaux à un poste, qui l'envoie avant sa
+ *        prochaine collecte. Le lot appartient au poste jusqu'à ce que
+ *        collecteur_lot_envoye le rende.
+ * @param collecteur : Collecteur concerné.
+ * @param poste : Numéro du poste.
+ * @param lot : Lot préparé.
+ * @return int : 0 en cas de succès, -1 si le poste a déjà un lot en cours
+ *               ou ne sait pas envoyer de signaux.
+ */
+int collecteur_signaler(collecteur_t *collecteur, int poste,
+                        lot_signaux_t *lot);
+
+/**
+ * @brief Indique si le lot confié à un poste a été envoyé (une seule fois
+ *        par lot) ; ses résultats sont alors dans lot->erreurs.
+ * @param collecteur : Collecteur concerné.
+ * @param poste : Numéro du poste.
+ * @return int : 1 si le lot est envoyé (il revient à l'appelant), 0 sinon.
+ */
+int collecteur_lot_envoye(collecteur_t *collecteur, int poste);
+
+/**
+ * @brief Vide la notification de l'eventfd (avant de récupérer les postes).
+ * @param collecteur : Collecteur concerné.
+ */
+void collecteur_vider(collecteur_t *collecteur);
+
+/**
+ * @brief Récupère la dernière collecte publiée d'un poste.
+ *
+ * Le tampon rendu auparavant retourne au poste : sa liste ne doit plus
+ * être utilisée.
+ *
+ * @param collecteur : Collecteur concerné.
+ * @param poste : Numéro du poste.
+ * @return collecte_t* : Nouvelle collecte, ou NULL si rien de nouveau.
+ */
+collecte_t *collecteur_recuperer(collecteur_t *collecteur, int poste);
+
+/**
+ * @brief Indique si un poste est périmé (en retard ou en échec).
+ * @param collecteur : Collecteur concerné.
+ * @param poste : Numéro du poste.
+ * @return int : 1 si périmé, 0 sinon.
+ */
+int collecteur_perime(collecteur_t *collecteur, int poste);
+
+/**
+ * @brief Indique si la dernière collecte terminée d'un poste a échoué.
+ * @param collecteur : Collecteur concerné.
+ * @param poste : Numéro du poste.
+ * @return int : 1 si elle a échoué, 0 sinon.
+ */
+int collecteur_echec(collecteur_t *collecteur, int poste);
+
+/**
+ * @brief Descripteur à surveiller : lisible quand une collecte est publiée.
+ * @param collecteur : Collecteur concerné.
+ * @return int : Descripteur (eventfd).
+ */
+int collecteur_descripteur(const collecteur_t *collecteur);
+
+/**
+ * @brief Horloge monotone en millisecondes (même origine que instant_ms).
+ * @return long long : Millisecondes.
+ */
+long long collecteur_maintenant_ms(void);
+
+#endif /* COLLECTEUR_H */
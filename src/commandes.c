@@ -0,0 +1,131 @@
+/**
+ * @file commandes.c
+ * @brief Implémentation du cache des lignes de commande locales
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#include "commandes.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define COMMANDES_TAILLE_MIN 128
+
+/* Fonctions privées */
+
+static unsigned int hacher_pid(pid_t pid, int taille) {
+  return ((unsigned int)pid * 2654435761u) & (unsigned int)(taille - 1);
+}
+
+/**
+ * @brief Empreinte du nom de commande (FNV-1a), qui change à un exec.
+ */
+static unsigned int empreinte_nom(const char *nom) {
+  unsigned int h = 2166136261u;
+
+  for (const unsigned char *c = (const unsigned char *)nom; *c != '\0'; c++) {
+    h = (h ^ *c) * 16777619u;
+  }
+  return h;
+}
+
+/**
+ * @brief Retourne l'entrée de 'pid', ou la case libre où l'insérer.
+ */
+static commande_entree_t *trouver_case(commande_entree_t *entrees, int taille,
+                                       pid_t pid) {
+  unsigned int masque = (unsigned int)(taille - 1);
+  unsigned int i = hacher_pid(pid, taille);
+
+  while (entrees[i].vue != 0 && entrees[i].pid != pid) {
+    i = (i + 1) & masque;
+  }
+  return &entrees[i];
+}
+
+/**
+ * @brief Reconstruit la table avec les seuls processus vus pendant la
+ *        génération courante ou la précédente, en l'agrandissant si eux
+ *        seuls la remplissent déjà à moitié.
+ */
+static int reorganiser(commandes_t *commandes) {
+  int vivants = 0;
+  int taille = COMMANDES_TAILLE_MIN;
+  commande_entree_t *entrees;
+
+  for (int i = 0; i < commandes->taille; i++) {
+    if (commandes->entrees[i].vue != 0 &&
+        commandes->entrees[i].vue + 1 >= commandes->generation) {
+      vivants++;
+    }
+  }
+  while (taille < (vivants + 1) * 4) {
+    taille *= 2;
+  }
+
+  entrees = calloc((size_t)taille, sizeof(commande_entree_t));
+  if (entrees == NULL) {
+    return -1;
+  }
+  for (int i = 0; i < commandes->taille; i++) {
+    const commande_entree_t *e = &commandes->entrees[i];
+    if (e->vue != 0 && e->vue + 1 >= commandes->generation) {
+      *trouver_case(entrees, taille, e->pid) = *e;
+    }
+  }
+
+  free(commandes->entrees);
+  commandes->entrees = entrees;
+  commandes->taille = taille;
+  commandes->nb = vivants;
+  return 0;
+}
+
+/* Fonctions publiques */
+
+int commandes_init(commandes_t *commandes) {
+  memset(commandes, 0, sizeof(*commandes));
+  commandes->generation = 1;
+  return procfs_ouvrir(&commandes->lecteur);
+}
+
+void commandes_liberer(commandes_t *commandes) {
+  procfs_fermer(&commandes->lecteur);
+  free(commandes->entrees);
+  commandes->entrees = NULL;
+  commandes->taille = 0;
+  commandes->nb = 0;
+}
+
+void commandes_nouvelle_generation(commandes_t *commandes) {
+  commandes->generation++;
+}
+
+const char *commandes_lire(commandes_t *commandes, const processus_t *proc) {
+  unsigned int empreinte = empreinte_nom(proc->nom_commande);
+  commande_entree_t *e;
+
+  if ((commandes->nb + 1) * 2 > commandes->taille &&
+      reorganiser(commandes) != 0) {
+    return NULL;
+  }
+
+  e = trouver_case(commandes->entrees, commandes->taille, proc->pid);
+  if (e->vue == 0 || e->starttime != proc->starttime ||
+      e->empreinte != empreinte) {
+    if (e->vue == 0) {
+      commandes->nb++;
+    }
+    e->pid = proc->pid;
+    e->starttime = proc->starttime;
+    e->empreinte = empreinte;
+    /* Un processus disparu garde une ligne vide jusqu'à sa sortie du cache */
+    if (commandes->lecteur.proc_fd < 0 ||
+        procfs_lire_cmdline(&commandes->lecteur, proc->pid, e->ligne,
+                            sizeof(e->ligne)) != 0) {
+      e->ligne[0] = '\0';
+    }
+    commandes->nb_lectures++;
+  }
+  e->vue = commandes->generation;
+  return e->ligne;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file commandes.h
+ * @brief Lignes de commande locales gardées d'une collecte à l'autre
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * La ligne de commande d'un processus ne change qu'à un exec (qui change
+ * aussi son nom) : elle est lue une fois dans /proc/<pid>/cmdline puis
+ * gardée tant que le triplet (PID, date de démarrage, nom) est vu. Indexer
+ * toutes les lignes de commande ne coûte donc qu'une lecture par nouveau
+ * processus, et non une par processus et par rafraîchissement.
+ */
+
+#ifndef COMMANDES_H
+#define COMMANDES_H
+
+#include "process.h"
+#include "procfs.h"
+
+/**
+ * @brief Ligne de commande d'un processus.
+ */
+typedef struct commande_entree {
+  pid_t pid;
+  unsigned long long starttime;
+  unsigned int empreinte;   /* Hachage du nom de commande */
+  unsigned int vue;         /* Dernière génération où le processus a été vu
+                               (0 : case libre) */
+  char ligne[MAX_CMD_LEN];  /* Vide : processus noyau ou disparu */
+} commande_entree_t;
+
+/**
+ * @brief Cache PID -> ligne de commande (sondage linéaire).
+ */
+typedef struct commandes {
+  commande_entree_t *entrees;
+  int taille;               /* Puissance de 2 */
+  int nb;                   /* Cases occupées */
+  unsigned int generation;
+  procfs_lecteur_t lecteur;
+  unsigned long nb_lectures; /* Lectures de /proc effectuées */
+} commandes_t;
+
+/**
+ * @brief Initialise un cache vide.
+ * @param commandes : Cache à initialiser.
+ * @return int : 0 en cas de succès, -1 si /proc est inaccessible.
+ */
+int commandes_init(commandes_t *commandes);
+
+/**
+ * @brief Libère le cache.
+ * @param commandes : Cache à libérer.
+ */
+void commandes_liberer(commandes_t *commandes);
+
+/**
+ * @brief Ouvre une génération (une collecte) ; les processus qui n'ont pas
+ *        été vus pendant la précédente sont oubliés quand la place manque.
+ * @param commandes : Cache concerné.
+ */
+void commandes_nouvelle_generation(commandes_t *commandes);
+
+/**
+ * @brief Ligne de commande d'un processus, lue dans /proc si elle n'est pas
+ *        connue.
+ * @param commandes : Cache concerné.
+ * @param proc : Processus de la génération courante.
+ * @return const char* : Ligne de commande (vide si inconnue), ou NULL en
+ *         cas d'erreur mémoire.
+ */
+const char *commandes_lire(commandes_t *commandes, const processus_t *proc);
+
+#endif /* COMMANDES_H */
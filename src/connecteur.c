@@ -0,0 +1,350 @@
+/**
+ * @file connecteur.c
+ * @brief Implémentation du suivi des processus par le connecteur proc
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "connecteur.h"
+#include <errno.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* Message d'abonnement : en-tête netlink + en-tête connecteur + opération */
+#define TAILLE_ABONNEMENT                                                      \
+  NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))
+
+/* Fonctions privées */
+
+static unsigned int hacher_pid(pid_t pid, int taille) {
+  return ((unsigned int)pid * 2654435761u) & (unsigned int)(taille - 1);
+}
+
+/**
+ * @brief Envoie l'opération d'abonnement ou de désabonnement.
+ */
+static int envoyer_operation(int fd, enum proc_cn_mcast_op operation) {
+  char tampon[TAILLE_ABONNEMENT] __attribute__((aligned(NLMSG_ALIGNTO)));
+  struct nlmsghdr *nl = (struct nlmsghdr *)tampon;
+  struct cn_msg *cn = NLMSG_DATA(nl);
+
+  memset(tampon, 0, sizeof(tampon));
+  nl->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(operation));
+  nl->nlmsg_type = NLMSG_DONE;
+  nl->nlmsg_pid = 0;
+
+  cn->id.idx = CN_IDX_PROC;
+  cn->id.val = CN_VAL_PROC;
+  cn->len = sizeof(operation);
+  memcpy(cn->data, &operation, sizeof(operation));
+
+  return send(fd, nl, nl->nlmsg_len, 0) < 0 ? -1 : 0;
+}
+
+/**
+ * @brief Retourne la case de 'pid' pour la génération courante (créée si absente).
+ */
+static connecteur_case_t *case_obtenir(connecteur_t *connecteur, pid_t pid) {
+  /* Agrandir au-delà d'un taux de remplissage de 1/2 */
+  if ((connecteur->nb_cases + 1) * 2 > connecteur->taille_cases) {
+    int taille = connecteur->taille_cases ? connecteur->taille_cases * 2 : 256;
+    connecteur_case_t *cases = calloc((size_t)taille, sizeof(connecteur_case_t));
+    if (cases == NULL) {
+      return NULL;
+    }
+    for (int i = 0; i < connecteur->taille_cases; i++) {
+      connecteur_case_t *ancienne = &connecteur->cases[i];
+      if (ancienne->generation != connecteur->generation) {
+        continue;
+      }
+      unsigned int j = hacher_pid(ancienne->pid, taille);
+      while (cases[j].generation == connecteur->generation) {
+        j = (j + 1) & (unsigned int)(taille - 1);
+      }
+      cases[j] = *ancienne;
+    }
+    free(connecteur->cases);
+    connecteur->cases = cases;
+    connecteur->taille_cases = taille;
+  }
+
+  unsigned int masque = (unsigned int)(connecteur->taille_cases - 1);
+  unsigned int i = hacher_pid(pid, connecteur->taille_cases);
+  while (connecteur->cases[i].generation == connecteur->generation) {
+    if (connecteur->cases[i].pid == pid) {
+      return &connecteur->cases[i];
+    }
+    i = (i + 1) & masque;
+  }
+
+  connecteur->cases[i].pid = pid;
+  connecteur->cases[i].etat = 0;
+  connecteur->cases[i].generation = connecteur->generation;
+  connecteur->nb_cases++;
+  return &connecteur->cases[i];
+}
+
+/**
+ * @brief Recherche la case de 'pid' dans la génération courante.
+ */
+static const connecteur_case_t *case_chercher(const connecteur_t *connecteur,
+                                              pid_t pid) {
+  if (connecteur->nb_cases == 0) {
+    return NULL;
+  }
+
+  unsigned int masque = (unsigned int)(connecteur->taille_cases - 1);
+  unsigned int i = hacher_pid(pid, connecteur->taille_cases);
+  while (connecteur->cases[i].generation == connecteur->generation) {
+    if (connecteur->cases[i].pid == pid) {
+      return &connecteur->cases[i];
+    }
+    i = (i + 1) & masque;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Met à jour l'ensemble selon un événement du noyau.
+ */
+static void traiter_evenement(connecteur_t *connecteur,
+                              const struct proc_event *evenement) {
+  connecteur_case_t *c;
+
+  connecteur->total_evenements++;
+
+  switch (evenement->what) {
+  case PROC_EVENT_FORK:
+    /* Création de thread : même groupe que le parent, ignorée */
+    if (evenement->event_data.fork.child_pid !=
+        evenement->event_data.fork.child_tgid) {
+      return;
+    }
+    c = case_obtenir(connecteur, evenement->event_data.fork.child_tgid);
+    if (c == NULL) {
+      connecteur->resynchroniser = 1;
+      return;
+    }
+    /* PID réutilisé dans l'intervalle : le précédent était éphémère */
+    if (c->etat == CONNECTEUR_NE_MORT) {
+      connecteur->ephemeres_en_cours++;
+    }
+    c->etat = CONNECTEUR_NE;
+    break;
+
+  case PROC_EVENT_EXIT:
+    /* Fin d'un thread secondaire : le processus reste vivant */
+    if (evenement->event_data.exit.process_pid !=
+        evenement->event_data.exit.process_tgid) {
+      return;
+    }
+    c = case_obtenir(connecteur, evenement->event_data.exit.process_tgid);
+    if (c == NULL) {
+      connecteur->resynchroniser = 1;
+      return;
+    }
+    c->etat = (c->etat == CONNECTEUR_NE) ? CONNECTEUR_NE_MORT : CONNECTEUR_MORT;
+    break;
+
+  default:
+    /* exec, changement d'identité... : relus avec /proc/[PID]/stat */
+    break;
+  }
+}
+
+/* Fonctions publiques */
+
+void connecteur_init(connecteur_t *connecteur) {
+  memset(connecteur, 0, sizeof(*connecteur));
+  connecteur->fd = -1;
+  connecteur->generation = 1;
+}
+
+int connecteur_ouvrir(connecteur_t *connecteur) {
+  struct sockaddr_nl adresse;
+  int taille = CONNECTEUR_TAILLE_RECEPTION;
+  int fd;
+
+  fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+              NETLINK_CONNECTOR);
+  if (fd < 0) {
+    return -1;
+  }
+
+  memset(&adresse, 0, sizeof(adresse));
+  adresse.nl_family = AF_NETLINK;
+  adresse.nl_groups = CN_IDX_PROC;
+  adresse.nl_pid = 0; /* Attribué par le noyau */
+
+  if (bind(fd, (struct sockaddr *)&adresse, sizeof(adresse)) < 0 ||
+      envoyer_operation(fd, PROC_CN_MCAST_LISTEN) < 0) {
+    int erreur = errno;
+    close(fd);
+    errno = erreur;
+    return -1;
+  }
+
+  /* Absorber les rafales de fork sans perte (échec non bloquant) */
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &taille, sizeof(taille));
+
+  connecteur->fd = fd;
+  connecteur->resynchroniser = 1; /* Le premier rafraîchissement liste /proc */
+  return 0;
+}
+
+void connecteur_fermer(connecteur_t *connecteur) {
+  if (connecteur->fd >= 0) {
+    envoyer_operation(connecteur->fd, PROC_CN_MCAST_IGNORE);
+    close(connecteur->fd);
+    connecteur->fd = -1;
+  }
+
+  free(connecteur->cases);
+  free(connecteur->pids);
+  connecteur->cases = NULL;
+  connecteur->pids = NULL;
+  connecteur->taille_cases = 0;
+  connecteur->nb_cases = 0;
+  connecteur->capacite_pids = 0;
+}
+
+int connecteur_actif(const connecteur_t *connecteur) {
+  return connecteur->fd >= 0;
+}
+
+int connecteur_lire(connecteur_t *connecteur) {
+  char tampon[8192] __attribute__((aligned(NLMSG_ALIGNTO)));
+  int nb_evenements = 0;
+
+  if (connecteur->fd < 0) {
+    return -1;
+  }
+
+  for (;;) {
+    ssize_t lus = recv(connecteur->fd, tampon, sizeof(tampon), 0);
+    if (lus < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      if (errno == ENOBUFS) {
+        /* File du noyau débordée : l'ensemble n'est plus fiable */
+        connecteur->resynchroniser = 1;
+        continue;
+      }
+      return -1;
+    }
+    if (lus == 0) {
+      break;
+    }
+
+    int reste = (int)lus;
+    for (struct nlmsghdr *nl = (struct nlmsghdr *)tampon; NLMSG_OK(nl, reste);
+         nl = NLMSG_NEXT(nl, reste)) {
+      if (nl->nlmsg_type == NLMSG_NOOP) {
+        continue;
+      }
+      if (nl->nlmsg_type == NLMSG_ERROR || nl->nlmsg_type == NLMSG_OVERRUN) {
+        connecteur->resynchroniser = 1;
+        continue;
+      }
+
+      const struct cn_msg *cn = NLMSG_DATA(nl);
+      if (cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC ||
+          cn->len < sizeof(struct proc_event)) {
+        continue;
+      }
+      /* La charge utile suit un en-tête de 20 octets : copie alignée */
+      struct proc_event evenement;
+      memcpy(&evenement, cn->data, sizeof(evenement));
+      traiter_evenement(connecteur, &evenement);
+      nb_evenements++;
+    }
+  }
+
+  return nb_evenements;
+}
+
+int connecteur_reconciliation_due(const connecteur_t *connecteur,
+                                  time_t maintenant) {
+  return connecteur->resynchroniser ||
+         maintenant - connecteur->derniere_reconciliation >=
+             CONNECTEUR_PERIODE_RECONCILIATION;
+}
+
+const pid_t *connecteur_pids(connecteur_t *connecteur,
+                             const processus_t *vivants, int *nb) {
+  int nb_pids = 0;
+
+  *nb = 0;
+  for (const processus_t *p = vivants; p != NULL; p = p->suivant) {
+    if (nb_pids == connecteur->capacite_pids) {
+      int capacite =
+          connecteur->capacite_pids ? connecteur->capacite_pids * 2 : 1024;
+      pid_t *pids = realloc(connecteur->pids, sizeof(pid_t) * capacite);
+      if (pids == NULL) {
+        return NULL;
+      }
+      connecteur->pids = pids;
+      connecteur->capacite_pids = capacite;
+    }
+    /* PID touché pendant l'intervalle : traité avec les cases ci-dessous */
+    if (case_chercher(connecteur, p->pid) == NULL) {
+      connecteur->pids[nb_pids++] = p->pid;
+    }
+  }
+
+  for (int i = 0; i < connecteur->taille_cases; i++) {
+    const connecteur_case_t *c = &connecteur->cases[i];
+    if (c->generation != connecteur->generation || c->etat != CONNECTEUR_NE) {
+      continue;
+    }
+    if (nb_pids == connecteur->capacite_pids) {
+      int capacite =
+          connecteur->capacite_pids ? connecteur->capacite_pids * 2 : 1024;
+      pid_t *pids = realloc(connecteur->pids, sizeof(pid_t) * capacite);
+      if (pids == NULL) {
+        return NULL;
+      }
+      connecteur->pids = pids;
+      connecteur->capacite_pids = capacite;
+    }
+    connecteur->pids[nb_pids++] = c->pid;
+  }
+
+  *nb = nb_pids;
+  return connecteur->pids;
+}
+
+void connecteur_fin_intervalle(connecteur_t *connecteur, int reconcilie,
+                               time_t maintenant) {
+  int nb_ephemeres = connecteur->ephemeres_en_cours;
+
+  for (int i = 0; i < connecteur->taille_cases; i++) {
+    const connecteur_case_t *c = &connecteur->cases[i];
+    if (c->generation == connecteur->generation &&
+        c->etat == CONNECTEUR_NE_MORT) {
+      nb_ephemeres++;
+    }
+  }
+
+  connecteur->nb_ephemeres = nb_ephemeres;
+  connecteur->ephemeres_en_cours = 0;
+  connecteur->total_ephemeres += (unsigned long)nb_ephemeres;
+  connecteur->generation++;
+  connecteur->nb_cases = 0;
+
+  if (reconcilie) {
+    connecteur->resynchroniser = 0;
+    connecteur->derniere_reconciliation = maintenant;
+    connecteur->nb_reconciliations++;
+  }
+}
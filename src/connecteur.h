@@ -0,0 +1,130 @@
+/**
+ * @file connecteur.h
+ * @brief Suivi des créations et fins de processus via le connecteur proc
+ *        (netlink) du noyau
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Abonné aux événements fork/exec/exit, le connecteur tient à jour
+ * l'ensemble des processus sans relister /proc : seuls les PID déjà connus
+ * et ceux nés depuis le dernier rafraîchissement sont relus. Un parcours
+ * complet de /proc (réconciliation) n'a lieu que périodiquement ou après
+ * une perte d'événements. Les processus nés et terminés entre deux
+ * rafraîchissements sont comptés (éphémères).
+ *
+ * L'abonnement requiert CAP_NET_ADMIN (root) ; en cas d'échec, l'appelant
+ * revient au parcours périodique de /proc.
+ */
+
+#ifndef CONNECTEUR_H
+#define CONNECTEUR_H
+
+#include "process.h"
+#include <sys/types.h>
+#include <time.h>
+
+#define CONNECTEUR_PERIODE_RECONCILIATION 30 /* Secondes entre deux parcours complets */
+#define CONNECTEUR_TAILLE_RECEPTION (1024 * 1024) /* SO_RCVBUF demandé */
+
+/* État d'un PID touché pendant l'intervalle */
+#define CONNECTEUR_NE 1      /* Né pendant l'intervalle, vivant */
+#define CONNECTEUR_NE_MORT 2 /* Né et terminé pendant l'intervalle (éphémère) */
+#define CONNECTEUR_MORT 3    /* Processus déjà connu, terminé */
+
+/**
+ * @brief Case de la table des PID vus pendant l'intervalle.
+ */
+typedef struct connecteur_case {
+  pid_t pid;
+  unsigned char etat;      /* CONNECTEUR_NE, CONNECTEUR_NE_MORT, CONNECTEUR_MORT */
+  unsigned int generation; /* Case valide si égale à la génération courante */
+} connecteur_case_t;
+
+/**
+ * @brief État du connecteur proc.
+ */
+typedef struct connecteur {
+  int fd;                 /* Socket netlink, -1 si inactif */
+  int resynchroniser;     /* 1 : événements perdus, parcours complet requis */
+  time_t derniere_reconciliation;
+
+  /* PID touchés depuis le dernier rafraîchissement (vidés par génération) */
+  connecteur_case_t *cases;
+  int taille_cases;       /* Puissance de 2 */
+  int nb_cases;
+  unsigned int generation;
+
+  /* Liste des PID à relire, réutilisée */
+  pid_t *pids;
+  int capacite_pids;
+
+  /* Compteurs */
+  int ephemeres_en_cours;          /* Éphémères déjà repérés dans l'intervalle */
+  int nb_ephemeres;                /* Éphémères du dernier intervalle */
+  unsigned long total_ephemeres;
+  unsigned long total_evenements;
+  unsigned long nb_reconciliations;
+} connecteur_t;
+
+/**
+ * @brief Initialise un connecteur inactif (aucune allocation).
+ * @param connecteur : Connecteur à initialiser.
+ */
+void connecteur_init(connecteur_t *connecteur);
+
+/**
+ * @brief Ouvre la socket netlink et s'abonne aux événements proc.
+ * @param connecteur : Connecteur concerné.
+ * @return int : 0 en cas de succès, -1 sinon (errno renseigné).
+ */
+int connecteur_ouvrir(connecteur_t *connecteur);
+
+/**
+ * @brief Se désabonne, ferme la socket et libère la mémoire.
+ * @param connecteur : Connecteur à fermer.
+ */
+void connecteur_fermer(connecteur_t *connecteur);
+
+/**
+ * @brief Indique si le connecteur est abonné.
+ * @param connecteur : Connecteur concerné.
+ * @return int : 1 si actif, 0 sinon.
+ */
+int connecteur_actif(const connecteur_t *connecteur);
+
+/**
+ * @brief Consomme tous les événements en attente (non bloquant).
+ * @param connecteur : Connecteur concerné.
+ * @return int : Nombre d'événements traités, -1 si la socket est en erreur.
+ */
+int connecteur_lire(connecteur_t *connecteur);
+
+/**
+ * @brief Indique si le prochain rafraîchissement doit relister /proc.
+ * @param connecteur : Connecteur concerné.
+ * @param maintenant : Heure courante.
+ * @return int : 1 si un parcours complet est nécessaire.
+ */
+int connecteur_reconciliation_due(const connecteur_t *connecteur,
+                                  time_t maintenant);
+
+/**
+ * @brief Construit la liste des PID à relire : processus connus encore
+ *        vivants, plus ceux nés pendant l'intervalle.
+ * @param connecteur : Connecteur concerné.
+ * @param vivants : Processus connus (liste de la table).
+ * @param nb : Reçoit le nombre de PID.
+ * @return const pid_t* : Liste (appartient au connecteur), NULL si erreur mémoire.
+ */
+const pid_t *connecteur_pids(connecteur_t *connecteur,
+                             const processus_t *vivants, int *nb);
+
+/**
+ * @brief Clôt l'intervalle : compte les éphémères et vide les PID touchés.
+ * @param connecteur : Connecteur concerné.
+ * @param reconcilie : 1 si /proc vient d'être relisté entièrement.
+ * @param maintenant : Heure courante.
+ */
+void connecteur_fin_intervalle(connecteur_t *connecteur, int reconcilie,
+                               time_t maintenant);
+
+#endif /* CONNECTEUR_H */
@@ -0,0 +1,261 @@
+/**
+ * @file cpu.c
+ * @brief Implémentation du moteur CPU par intervalle
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "cpu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Fonctions privées */
+
+static unsigned int hacher_pid(pid_t pid, int taille) {
+  return ((unsigned int)pid * 2654435761u) & (unsigned int)(taille - 1);
+}
+
+static cpu_historique_entree_t *historique_chercher(cpu_historique_t *hist,
+                                                    pid_t pid) {
+  if (hist->taille == 0) {
+    return NULL;
+  }
+
+  unsigned int masque = (unsigned int)(hist->taille - 1);
+  unsigned int i = hacher_pid(pid, hist->taille);
+
+  while (hist->cases[i].pid != 0) {
+    if (hist->cases[i].pid == pid) {
+      return &hist->cases[i];
+    }
+    i = (i + 1) & masque;
+  }
+  return NULL;
+}
+
+static void historique_inserer(cpu_historique_t *hist, pid_t pid,
+                               unsigned long long starttime, long long ticks) {
+  unsigned int masque = (unsigned int)(hist->taille - 1);
+  unsigned int i = hacher_pid(pid, hist->taille);
+
+  while (hist->cases[i].pid != 0 && hist->cases[i].pid != pid) {
+    i = (i + 1) & masque;
+  }
+  if (hist->cases[i].pid == 0) {
+    hist->nb++;
+  }
+  hist->cases[i].pid = pid;
+  hist->cases[i].starttime = starttime;
+  hist->cases[i].ticks = ticks;
+}
+
+/**
+ * @brief Vide l'historique en garantissant une capacité d'au moins 2 * nb.
+ */
+static int historique_preparer(cpu_historique_t *hist, int nb) {
+  if (nb * 2 > hist->taille) {
+    int taille = hist->taille ? hist->taille : 1024;
+    while (nb * 2 > taille) {
+      taille *= 2;
+    }
+    cpu_historique_entree_t *cases =
+        realloc(hist->cases, sizeof(cpu_historique_entree_t) * taille);
+    if (cases == NULL) {
+      return -1;
+    }
+    hist->cases = cases;
+    hist->taille = taille;
+  }
+
+  memset(hist->cases, 0, sizeof(cpu_historique_entree_t) * hist->taille);
+  hist->nb = 0;
+  return 0;
+}
+
+static float pourcentage_occupe(const cpu_compteurs_t *avant,
+                                const cpu_compteurs_t *apres) {
+  unsigned long long total = apres->total - avant->total;
+  unsigned long long inactif = apres->inactif - avant->inactif;
+
+  if (apres->total <= avant->total || inactif > total) {
+    return 0.0f;
+  }
+  return (float)(total - inactif) * 100.0f / (float)total;
+}
+
+/* Fonctions publiques */
+
+void moteur_cpu_init(moteur_cpu_t *moteur) {
+  memset(moteur, 0, sizeof(*moteur));
+  moteur->nb_coeurs = 1;
+}
+
+void moteur_cpu_liberer(moteur_cpu_t *moteur) {
+  free(moteur->precedent.cases);
+  free(moteur->courant.cases);
+  moteur_cpu_init(moteur);
+}
+
+int moteur_cpu_echantillonner_local(moteur_cpu_t *moteur) {
+  char ligne[512];
+  FILE *file;
+  int nb_coeurs = 0;
+  double uptime;
+
+  /* /proc/uptime : date de l'échantillon en ticks depuis le boot */
+  file = fopen("/proc/uptime", "r");
+  if (file == NULL) {
+    return -1;
+  }
+  if (fscanf(file, "%lf", &uptime) != 1) {
+    fclose(file);
+    return -1;
+  }
+  fclose(file);
+
+  /* /proc/stat : compteurs globaux et par cœur */
+  file = fopen("/proc/stat", "r");
+  if (file == NULL) {
+    return -1;
+  }
+
+  moteur->global_precedent = moteur->global;
+  memcpy(moteur->coeurs_precedents, moteur->coeurs, sizeof(moteur->coeurs));
+
+  while (fgets(ligne, sizeof(ligne), file) != NULL) {
+    unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
+    int numero = -1;
+    cpu_compteurs_t *cible;
+
+    if (strncmp(ligne, "cpu", 3) != 0) {
+      break;
+    }
+
+    steal = 0;
+    if (ligne[3] == ' ') {
+      if (sscanf(ligne + 3, "%llu %llu %llu %llu %llu %llu %llu %llu", &user,
+                 &nice, &system, &idle, &iowait, &irq, &softirq, &steal) < 7) {
+        continue;
+      }
+      cible = &moteur->global;
+    } else {
+      if (sscanf(ligne + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu",
+                 &numero, &user, &nice, &system, &idle, &iowait, &irq,
+                 &softirq, &steal) < 8 ||
+          numero < 0 || numero >= CPU_MAX_COEURS) {
+        continue;
+      }
+      cible = &moteur->coeurs[numero];
+      if (numero + 1 > nb_coeurs) {
+        nb_coeurs = numero + 1;
+      }
+    }
+
+    cible->total = user + nice + system + idle + iowait + irq + softirq + steal;
+    cible->inactif = idle + iowait;
+  }
+  fclose(file);
+
+  if (nb_coeurs == 0) {
+    nb_coeurs = 1;
+  }
+  moteur->nb_coeurs = nb_coeurs;
+  moteur->debut_intervalle = moteur->maintenant;
+  moteur->maintenant = (unsigned long long)(uptime * sysconf(_SC_CLK_TCK));
+  moteur->nb_echantillons++;
+
+  if (moteur->nb_echantillons >= 2) {
+    moteur->ticks_par_coeur =
+        (double)(moteur->global.total - moteur->global_precedent.total) /
+        nb_coeurs;
+    moteur->utilisation_globale =
+        pourcentage_occupe(&moteur->global_precedent, &moteur->global);
+    for (int i = 0; i < nb_coeurs; i++) {
+      moteur->utilisation_coeurs[i] = pourcentage_occupe(
+          &moteur->coeurs_precedents[i], &moteur->coeurs[i]);
+    }
+  }
+
+  return 0;
+}
+
+void moteur_cpu_echantillonner_distant(moteur_cpu_t *moteur,
+                                       unsigned long long uptime_ticks,
+                                       int nb_coeurs) {
+  moteur->nb_coeurs = (nb_coeurs > 0) ? nb_coeurs : 1;
+  moteur->debut_intervalle = moteur->maintenant;
+  moteur->maintenant = uptime_ticks;
+  moteur->nb_echantillons++;
+
+  if (moteur->nb_echantillons >= 2 &&
+      moteur->maintenant > moteur->debut_intervalle) {
+    moteur->ticks_par_coeur =
+        (double)(moteur->maintenant - moteur->debut_intervalle);
+  } else {
+    moteur->ticks_par_coeur = 0.0;
+  }
+}
+
+void moteur_cpu_calculer(moteur_cpu_t *moteur, processus_t *liste) {
+  int nb = 0;
+  processus_t *courant;
+
+  for (courant = liste; courant != NULL; courant = courant->suivant) {
+    nb++;
+  }
+  if (historique_preparer(&moteur->courant, nb) != 0) {
+    return;
+  }
+
+  for (courant = liste; courant != NULL; courant = courant->suivant) {
+    long long ticks = courant->utime + courant->stime;
+    long long delta = 0;
+    cpu_historique_entree_t *avant =
+        historique_chercher(&moteur->precedent, courant->pid);
+    unsigned long long tol = moteur->tolerance_starttime;
+
+    if (avant != NULL && avant->starttime + tol >= courant->starttime &&
+        courant->starttime + tol >= avant->starttime) {
+      /* Même processus qu'à l'échantillon précédent */
+      delta = ticks - avant->ticks;
+    } else if (moteur->nb_echantillons >= 2 &&
+               courant->starttime + tol >= moteur->debut_intervalle) {
+      /* Né pendant l'intervalle (ou PID réutilisé) : tous ses ticks comptent */
+      delta = ticks;
+    }
+
+    if (delta < 0) {
+      delta = 0;
+    }
+
+    if (moteur->ticks_par_coeur > 0.0) {
+      courant->cpu_percent =
+          (float)((double)delta * 100.0 / moteur->ticks_par_coeur);
+    } else {
+      courant->cpu_percent = 0.0f;
+    }
+    courant->cpu_percent_machine = courant->cpu_percent / moteur->nb_coeurs;
+
+    historique_inserer(&moteur->courant, courant->pid, courant->starttime,
+                       ticks);
+  }
+
+  /* L'échantillon courant devient la référence du prochain intervalle */
+  cpu_historique_t tmp = moteur->precedent;
+  moteur->precedent = moteur->courant;
+  moteur->courant = tmp;
+}
+
+void moteur_cpu_copier_utilisation(const moteur_cpu_t *moteur,
+                                   cpu_utilisation_t *dest) {
+  /* Un hôte distant peut annoncer plus de cœurs que le tableau local */
+  dest->nb_coeurs = moteur->nb_coeurs < CPU_MAX_COEURS ? moteur->nb_coeurs
+                                                       : CPU_MAX_COEURS;
+  dest->nb_echantillons = moteur->nb_echantillons;
+  dest->globale = moteur->utilisation_globale;
+  memcpy(dest->coeurs, moteur->utilisation_coeurs,
+         sizeof(float) * (size_t)dest->nb_coeurs);
+}
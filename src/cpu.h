@@ -0,0 +1,125 @@
+/**
+ * @file cpu.h
+ * @brief Moteur de calcul de l'utilisation CPU par intervalle
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Ce module conserve les compteurs de ticks de l'échantillon précédent
+ * (par processus et pour le système) et en déduit le pourcentage CPU
+ * réellement consommé pendant le dernier intervalle.
+ */
+
+#ifndef CPU_H
+#define CPU_H
+
+#include "process.h"
+
+#define CPU_MAX_COEURS 256
+
+/**
+ * @brief Compteurs cumulés d'un CPU (ou de la machine) lus dans /proc/stat.
+ */
+typedef struct cpu_compteurs {
+  unsigned long long total;   /* Somme de tous les états */
+  unsigned long long inactif; /* idle + iowait */
+} cpu_compteurs_t;
+
+/**
+ * @brief Mémoire d'un processus entre deux échantillons.
+ */
+typedef struct cpu_historique_entree {
+  pid_t pid; /* 0 si case vide */
+  unsigned long long starttime;
+  long long ticks;
+} cpu_historique_entree_t;
+
+/**
+ * @brief Historique par processus (table de hachage).
+ */
+typedef struct cpu_historique {
+  cpu_historique_entree_t *cases;
+  int taille; /* Puissance de 2 */
+  int nb;
+} cpu_historique_t;
+
+/**
+ * @brief État du moteur CPU pour une source (machine locale ou distante).
+ */
+typedef struct moteur_cpu {
+  int nb_coeurs;
+  int nb_echantillons;           /* Nombre d'échantillons système pris */
+  double ticks_par_coeur;        /* Ticks écoulés par cœur sur l'intervalle */
+  unsigned long long debut_intervalle; /* Ticks depuis le boot au précédent échantillon */
+  unsigned long long maintenant;       /* Ticks depuis le boot à l'échantillon courant */
+  unsigned long long tolerance_starttime; /* Écart toléré sur starttime (ticks) */
+
+  /* Utilisation système (local uniquement) */
+  cpu_compteurs_t global, global_precedent;
+  cpu_compteurs_t coeurs[CPU_MAX_COEURS], coeurs_precedents[CPU_MAX_COEURS];
+  float utilisation_globale;              /* En % de la machine */
+  float utilisation_coeurs[CPU_MAX_COEURS]; /* En % de chaque cœur */
+
+  /* Ticks par processus : échantillon précédent et en cours de construction */
+  cpu_historique_t precedent;
+  cpu_historique_t courant;
+} moteur_cpu_t;
+
+/**
+ * @brief Utilisation système d'un intervalle, copiable hors du moteur.
+ */
+typedef struct cpu_utilisation {
+  int nb_coeurs;
+  int nb_echantillons;              /* < 2 : pas encore d'intervalle */
+  float globale;                    /* En % de la machine */
+  float coeurs[CPU_MAX_COEURS];     /* En % de chaque cœur */
+} cpu_utilisation_t;
+
+/**
+ * @brief Initialise un moteur CPU.
+ * @param moteur : Moteur à initialiser.
+ */
+void moteur_cpu_init(moteur_cpu_t *moteur);
+
+/**
+ * @brief Libère la mémoire d'un moteur CPU.
+ * @param moteur : Moteur à libérer.
+ */
+void moteur_cpu_liberer(moteur_cpu_t *moteur);
+
+/**
+ * @brief Prend un échantillon système local (/proc/stat et /proc/uptime).
+ * @param moteur : Moteur concerné.
+ * @return int : 0 en cas de succès, -1 en cas d'erreur.
+ */
+int moteur_cpu_echantillonner_local(moteur_cpu_t *moteur);
+
+/**
+ * @brief Prend un échantillon système pour une machine distante.
+ * @param moteur : Moteur concerné.
+ * @param uptime_ticks : Uptime distant converti en ticks.
+ * @param nb_coeurs : Nombre de cœurs distants.
+ */
+void moteur_cpu_echantillonner_distant(moteur_cpu_t *moteur,
+                                       unsigned long long uptime_ticks,
+                                       int nb_coeurs);
+
+/**
+ * @brief Calcule cpu_percent et cpu_percent_machine pour chaque processus.
+ *
+ * Un processus déjà vu (même PID et même starttime) est mesuré sur la
+ * différence de ses ticks ; un processus né pendant l'intervalle compte
+ * tous ses ticks ; un PID réutilisé est traité comme un nouveau processus.
+ *
+ * @param moteur : Moteur échantillonné pour cet intervalle.
+ * @param liste : Liste des processus à mettre à jour.
+ */
+void moteur_cpu_calculer(moteur_cpu_t *moteur, processus_t *liste);
+
+/**
+ * @brief Copie l'utilisation système du dernier intervalle.
+ * @param moteur : Moteur concerné.
+ * @param dest : Copie à remplir.
+ */
+void moteur_cpu_copier_utilisation(const moteur_cpu_t *moteur,
+                                   cpu_utilisation_t *dest);
+
+#endif /* CPU_H */
@@ -0,0 +1,148 @@
+/**
+ * @file details.c
+ * @brief Implémentation du chargement à la demande des champs coûteux
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#include "details.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Fonctions privées */
+
+static unsigned int hacher_pid(pid_t pid, int taille) {
+  return ((unsigned int)pid * 2654435761u) & (unsigned int)(taille - 1);
+}
+
+/**
+ * @brief Retourne l'entrée de 'pid' dans la génération courante, ou la case
+ *        libre où l'insérer.
+ */
+static details_processus_t *trouver_case(details_processus_t *entrees,
+                                         int taille, unsigned int generation,
+                                         pid_t pid) {
+  unsigned int masque = (unsigned int)(taille - 1);
+  unsigned int i = hacher_pid(pid, taille);
+
+  while (entrees[i].generation == generation && entrees[i].pid != pid) {
+    i = (i + 1) & masque;
+  }
+  return &entrees[i];
+}
+
+/**
+ * @brief Double la table quand elle est à moitié pleine.
+ */
+static int agrandir(cache_details_t *cache) {
+  int taille = cache->taille ? cache->taille * 2 : 128;
+  details_processus_t *entrees =
+      calloc((size_t)taille, sizeof(details_processus_t));
+
+  if (entrees == NULL) {
+    return -1;
+  }
+  for (int i = 0; i < cache->taille; i++) {
+    if (cache->entrees[i].generation == cache->generation) {
+      *trouver_case(entrees, taille, cache->generation,
+                    cache->entrees[i].pid) = cache->entrees[i];
+    }
+  }
+
+  free(cache->entrees);
+  cache->entrees = entrees;
+  cache->taille = taille;
+  return 0;
+}
+
+/* Fonctions publiques */
+
+int details_init(cache_details_t *cache) {
+  memset(cache, 0, sizeof(*cache));
+  cache->generation = 1;
+  return procfs_ouvrir(&cache->lecteur);
+}
+
+void details_liberer(cache_details_t *cache) {
+  procfs_fermer(&cache->lecteur);
+  free(cache->entrees);
+  cache->entrees = NULL;
+  cache->taille = 0;
+  cache->nb = 0;
+}
+
+void details_nouvelle_generation(cache_details_t *cache) {
+  cache->generation++;
+  cache->nb = 0;
+}
+
+const details_processus_t *details_charger(cache_details_t *cache,
+                                           processus_t *proc, int niveaux) {
+  details_processus_t *d;
+
+  /* Le propriétaire est résolu par le cache des noms, sans lire /proc */
+  if ((niveaux & DETAILS_PROPRIETAIRE) && proc->utilisateur[0] == '\0') {
+    recuperer_nom_utilisateur(proc->uid, proc->utilisateur, MAX_USER_LEN);
+  }
+
+  if ((cache->nb + 1) * 2 > cache->taille && agrandir(cache) != 0) {
+    return NULL;
+  }
+
+  d = trouver_case(cache->entrees, cache->taille, cache->generation, proc->pid);
+  if (d->generation != cache->generation || d->starttime != proc->starttime) {
+    if (d->generation != cache->generation) {
+      cache->nb++;
+    }
+    d->pid = proc->pid;
+    d->starttime = proc->starttime;
+    d->generation = cache->generation;
+    d->niveaux = 0;
+    d->ligne_commande[0] = '\0';
+    d->status.nb_threads = -1;
+    d->status.vm_swap_ko = -1;
+    d->status.vm_pic_ko = -1;
+  }
+  d->niveaux |= niveaux & DETAILS_PROPRIETAIRE;
+
+  /* Un processus disparu garde des champs vides : pas de nouvelle tentative */
+  if ((niveaux & DETAILS_CMDLINE) && !(d->niveaux & DETAILS_CMDLINE)) {
+    procfs_lire_cmdline(&cache->lecteur, proc->pid, d->ligne_commande,
+                        sizeof(d->ligne_commande));
+    d->niveaux |= DETAILS_CMDLINE;
+    cache->nb_chargements++;
+  }
+  if ((niveaux & DETAILS_STATUS) && !(d->niveaux & DETAILS_STATUS)) {
+    procfs_lire_status(&cache->lecteur, proc->pid, &d->status);
+    d->niveaux |= DETAILS_STATUS;
+    cache->nb_chargements++;
+  }
+
+  return d;
+}
+
+void details_charger_plage(cache_details_t *cache, processus_t *head,
+                           int debut, int nb, int niveaux) {
+  processus_t *courant = get_processus_at_index(head, debut);
+
+  for (int i = 0; courant != NULL && i < nb; i++) {
+    /* Un thread affiche son propre nom : seul le propriétaire est utile */
+    details_charger(cache, courant,
+                    courant->est_thread ? (niveaux & DETAILS_PROPRIETAIRE)
+                                        : niveaux);
+    courant = courant->suivant;
+  }
+}
+
+const details_processus_t *details_chercher(const cache_details_t *cache,
+                                            const processus_t *proc) {
+  if (cache->nb == 0) {
+    return NULL;
+  }
+
+  const details_processus_t *d =
+      trouver_case(cache->entrees, cache->taille, cache->generation, proc->pid);
+  if (d->generation != cache->generation || d->starttime != proc->starttime) {
+    return NULL;
+  }
+  return d;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file details.h
+ * @brief Champs coûteux des processus, chargés à la demande
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * La collecte est découpée en niveaux. Le niveau de base (PID, état, temps
+ * CPU, mémoire) est lu pour tous les processus par le scanner, ce qui suffit
+ * aux totaux et au tri. Les niveaux coûteux (propriétaire, ligne de commande,
+ * champs de status) ne sont chargés que pour les lignes visibles ou trouvées
+ * par la recherche, et mis en cache pour la génération courante : leur coût
+ * dépend du nombre de lignes affichées et non du nombre de PID.
+ */
+
+#ifndef DETAILS_H
+#define DETAILS_H
+
+#include "process.h"
+#include "procfs.h"
+
+#define DETAILS_TAILLE_CMDLINE 512
+
+/* Niveaux de collecte (combinables) */
+#define DETAILS_PROPRIETAIRE 0x1 /* Nom d'utilisateur */
+#define DETAILS_CMDLINE 0x2      /* Ligne de commande complète */
+#define DETAILS_STATUS 0x4       /* Threads, swap, pic de RSS */
+#define DETAILS_TOUS (DETAILS_PROPRIETAIRE | DETAILS_CMDLINE | DETAILS_STATUS)
+
+/**
+ * @brief Champs coûteux d'un processus pour une génération.
+ */
+typedef struct details_processus {
+  pid_t pid;
+  unsigned long long starttime;
+  unsigned int generation; /* Entrée valide si égale à celle du cache */
+  int niveaux;             /* Niveaux chargés (DETAILS_*) */
+  char ligne_commande[DETAILS_TAILLE_CMDLINE];
+  procfs_status_t status;
+} details_processus_t;
+
+/**
+ * @brief Cache des niveaux coûteux, vidé à chaque génération.
+ */
+typedef struct cache_details {
+  details_processus_t *entrees; /* Hachage PID -> détails (sondage linéaire) */
+  int taille;                   /* Puissance de 2 */
+  int nb;                       /* Entrées de la génération courante */
+  unsigned int generation;
+  procfs_lecteur_t lecteur;
+  unsigned long nb_chargements; /* Lectures de /proc effectuées */
+} cache_details_t;
+
+/**
+ * @brief Initialise un cache vide.
+ * @param cache : Cache à initialiser.
+ * @return int : 0 en cas de succès, -1 si /proc est inaccessible.
+ */
+int details_init(cache_details_t *cache);
+
+/**
+ * @brief Libère le cache.
+ * @param cache : Cache à libérer.
+ */
+void details_liberer(cache_details_t *cache);
+
+/**
+ * @brief Invalide toutes les entrées (nouvelle génération de processus).
+ * @param cache : Cache concerné.
+ */
+void details_nouvelle_generation(cache_details_t *cache);
+
+/**
+ * @brief Charge les niveaux demandés pour un processus s'ils ne le sont pas.
+ *
+ * Le niveau propriétaire renseigne directement proc->utilisateur.
+ *
+ * @param cache : Cache concerné.
+ * @param proc : Processus (ligne de la génération courante).
+ * @param niveaux : Niveaux souhaités (DETAILS_*).
+ * @return const details_processus_t* : Détails, ou NULL en cas d'erreur mémoire.
+ */
+const details_processus_t *details_charger(cache_details_t *cache,
+                                           processus_t *proc, int niveaux);
+
+/**
+ * @brief Charge les niveaux demandés pour une plage de lignes.
+ * @param cache : Cache concerné.
+ * @param head : Liste des processus.
+ * @param debut : Index de la première ligne.
+ * @param nb : Nombre de lignes.
+ * @param niveaux : Niveaux souhaités (DETAILS_*).
+ */
+void details_charger_plage(cache_details_t *cache, processus_t *head,
+                           int debut, int nb, int niveaux);
+
+/**
+ * @brief Retourne les détails déjà chargés d'un processus (sans lecture).
+ * @param cache : Cache concerné.
+ * @param proc : Processus recherché.
+ * @return const details_processus_t* : Détails, ou NULL si non chargés.
+ */
+const details_processus_t *details_chercher(const cache_details_t *cache,
+                                            const processus_t *proc);
+
+#endif /* DETAILS_H */
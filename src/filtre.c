@@ -0,0 +1,383 @@
+/**
+ * @file filtre.c
+ * @brief Implémentation du filtre de recherche des processus
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _GNU_SOURCE
+
+#include "filtre.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Fonctions privées */
+
+/**
+ * @brief Minuscule ASCII, comme le texte de l'index.
+ */
+static char minuscule(char c) {
+  return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+/**
+ * @brief Termine une séquence littérale de la regex : gardée (séparée des
+ *        autres par '\n') si elle fournit au moins un trigramme.
+ */
+static void garder_sequence(char *litteraux, size_t taille,
+                            const char *sequence, size_t n) {
+  size_t longueur = strlen(litteraux);
+  size_t separateur = longueur > 0 ? 1 : 0;
+
+  if (n < 3 || longueur + separateur + n + 1 > taille) {
+    return;
+  }
+  if (separateur) {
+    litteraux[longueur++] = '\n';
+  }
+  memcpy(litteraux + longueur, sequence, n);
+  litteraux[longueur + n] = '\0';
+}
+
+/**
+ * @brief Extrait les séquences littérales que toute ligne acceptée par la
+ *        regex contient. Renonce (aucune séquence) devant une alternative
+ *        ou un groupe, qui peuvent les rendre facultatives.
+ */
+static void extraire_litteraux(const char *motif, char *litteraux,
+                               size_t taille) {
+  char courant[FILTRE_TAILLE_MOTIF];
+  size_t n = 0;
+
+  litteraux[0] = '\0';
+  if (strpbrk(motif, "|()") != NULL) {
+    return;
+  }
+
+  for (const char *c = motif;; c++) {
+    int fin_sequence = 0;
+
+    if (*c == '*' || *c == '?' || *c == '{') {
+      /* Le caractère précédent est facultatif (ou répété) */
+      if (n > 0) {
+        n--;
+      }
+      if (*c == '{') {
+        while (c[1] != '\0' && *c != '}') {
+          c++;
+        }
+      }
+      fin_sequence = 1;
+    } else if (*c == '\0' || *c == '+' || *c == '.' || *c == '^' ||
+               *c == '$') {
+      fin_sequence = 1;
+    } else if (*c == '\\') {
+      /* '\.' est un point ; '\w', '\s', '\b'... sont des classes */
+      if (c[1] != '\0' && !isalnum((unsigned char)c[1]) &&
+          n + 1 < sizeof(courant)) {
+        c++;
+        courant[n++] = minuscule(*c);
+      } else {
+        fin_sequence = 1;
+        if (c[1] != '\0') {
+          c++;
+        }
+      }
+    } else if (*c == '[') {
+      /* Classe : sauter jusqu'au ']' fermant (']' en tête est littéral) */
+      const char *f = c + 1;
+      if (*f == '^') {
+        f++;
+      }
+      if (*f == ']') {
+        f++;
+      }
+      while (*f != '\0' && *f != ']') {
+        f++;
+      }
+      c = *f != '\0' ? f : f - 1;
+      fin_sequence = 1;
+    } else if (n + 1 < sizeof(courant)) {
+      courant[n++] = minuscule(*c);
+    }
+
+    if (fin_sequence) {
+      garder_sequence(litteraux, taille, courant, n);
+      n = 0;
+      if (*c == '\0') {
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Vérifie une ligne candidate sur son texte.
+ */
+static int verifier(const filtre_t *filtre, const char *texte,
+                    size_t longueur) {
+  switch (filtre->mode) {
+  case FILTRE_SOUS_CHAINE:
+    return memmem(texte, longueur, filtre->cle, filtre->longueur) != NULL;
+  case FILTRE_PREFIXE:
+    for (size_t j = 0; j + filtre->longueur <= longueur; j++) {
+      if ((j == 0 || texte[j - 1] == '\n') &&
+          memcmp(texte + j, filtre->cle, filtre->longueur) == 0) {
+        return 1;
+      }
+    }
+    return 0;
+  default:
+    return regexec(&filtre->regex, texte, 0, NULL, 0) == 0;
+  }
+}
+
+/**
+ * @brief Position de 'ligne' dans un seau croissant, cherchée à partir de
+ *        la position précédente (recherche exponentielle puis dichotomique).
+ * @return int : 1 si le seau contient la ligne.
+ */
+static int seau_contient(const uint32_t *seau, int nb, int *position,
+                         uint32_t ligne) {
+  int bas = *position;
+  int haut = bas;
+  int pas = 1;
+
+  while (haut < nb && seau[haut] < ligne) {
+    bas = haut + 1;
+    haut += pas;
+    pas *= 2;
+  }
+  if (haut > nb) {
+    haut = nb;
+  }
+  while (bas < haut) {
+    int milieu = bas + (haut - bas) / 2;
+    if (seau[milieu] < ligne) {
+      bas = milieu + 1;
+    } else {
+      haut = milieu;
+    }
+  }
+  *position = bas;
+  return bas < nb && seau[bas] == ligne;
+}
+
+/**
+ * @brief Range dans filtre->resultats les lignes candidates : seau du
+ *        préfixe, ou intersection des seaux des trigrammes du motif, du
+ *        plus court au plus long.
+ * @return int : Nombre de candidats, -1 si aucune table ne s'applique
+ *               (toutes les lignes), -2 en cas d'erreur mémoire.
+ */
+static int candidats(filtre_t *filtre, const index_texte_t *index) {
+  const char *cle = filtre->mode == FILTRE_REGEX ? filtre->litteraux
+                                                 : filtre->cle;
+  const uint32_t *seaux[FILTRE_TAILLE_MOTIF];
+  int tailles[FILTRE_TAILLE_MOTIF];
+  size_t longueur = strlen(cle);
+  int nb_seaux = 0;
+  int nb;
+
+  if (filtre->mode == FILTRE_PREFIXE) {
+    if (longueur < 2) {
+      return -1;
+    }
+    seaux[nb_seaux] = index_texte_prefixe(index, cle, &tailles[nb_seaux]);
+    nb_seaux++;
+  } else {
+    /* Chaque trigramme du motif (de chaque littéral de la regex) est
+       obligatoire ; seaux triés par taille (insertion : au plus une
+       centaine) */
+    for (size_t i = 0; i + 3 <= longueur; i++) {
+      int n;
+      if (memchr(cle + i, '\n', 3) != NULL) {
+        continue;
+      }
+      const uint32_t *seau = index_texte_trigramme(index, cle + i, &n);
+      int j = nb_seaux++;
+      while (j > 0 && tailles[j - 1] > n) {
+        seaux[j] = seaux[j - 1];
+        tailles[j] = tailles[j - 1];
+        j--;
+      }
+      seaux[j] = seau;
+      tailles[j] = n;
+    }
+    if (nb_seaux == 0) {
+      return -1;
+    }
+  }
+
+  if (tailles[0] > filtre->capacite_resultats) {
+    uint32_t *resultats =
+        realloc(filtre->resultats, (size_t)tailles[0] * sizeof(uint32_t));
+    if (resultats == NULL) {
+      return -2;
+    }
+    filtre->resultats = resultats;
+    filtre->capacite_resultats = tailles[0];
+  }
+  memcpy(filtre->resultats, seaux[0], (size_t)tailles[0] * sizeof(uint32_t));
+  nb = tailles[0];
+
+  /* Les seaux suivants ne font que réduire les candidats : inutile une
+     fois qu'il en reste peu à vérifier */
+  for (int k = 1; k < nb_seaux && nb > FILTRE_CANDIDATS_SUFFISANTS; k++) {
+    int position = 0;
+    int gardes = 0;
+    for (int i = 0; i < nb; i++) {
+      if (seau_contient(seaux[k], tailles[k], &position,
+                        filtre->resultats[i])) {
+        filtre->resultats[gardes++] = filtre->resultats[i];
+      }
+    }
+    nb = gardes;
+  }
+  return nb;
+}
+
+/* Fonctions publiques */
+
+void filtre_init(filtre_t *filtre) {
+  memset(filtre, 0, sizeof(*filtre));
+  filtre->mode = FILTRE_SOUS_CHAINE;
+  index_texte_init(&filtre->secours);
+}
+
+void filtre_liberer(filtre_t *filtre) {
+  filtre_desactiver(filtre);
+  free(filtre->resultats);
+  filtre->resultats = NULL;
+  filtre->capacite_resultats = 0;
+  index_texte_liberer(&filtre->secours);
+}
+
+void filtre_desactiver(filtre_t *filtre) {
+  if (filtre->regex_compilee) {
+    regfree(&filtre->regex);
+    filtre->regex_compilee = 0;
+  }
+  filtre->actif = 0;
+}
+
+int filtre_definir(filtre_t *filtre, const char *motif, filtre_mode_t mode) {
+  size_t i;
+
+  filtre_desactiver(filtre);
+  filtre->mode = mode;
+  snprintf(filtre->motif, sizeof(filtre->motif), "%s", motif);
+  for (i = 0; filtre->motif[i] != '\0'; i++) {
+    filtre->cle[i] = minuscule(filtre->motif[i]);
+  }
+  filtre->cle[i] = '\0';
+  filtre->longueur = i;
+  if (filtre->longueur == 0) {
+    return 0;
+  }
+
+  if (mode == FILTRE_REGEX) {
+    /* REG_NEWLINE : ^ et $ s'ancrent sur chaque champ de la ligne */
+    if (regcomp(&filtre->regex, filtre->motif,
+                REG_EXTENDED | REG_ICASE | REG_NOSUB | REG_NEWLINE) != 0) {
+      return -1;
+    }
+    filtre->regex_compilee = 1;
+    extraire_litteraux(filtre->motif, filtre->litteraux,
+                       sizeof(filtre->litteraux));
+  }
+
+  filtre->actif = 1;
+  return 0;
+}
+
+int filtre_chercher(filtre_t *filtre, processus_t *liste,
+                    const index_texte_t *index) {
+  int tout_parcourir;
+  int nb_lignes;
+  int nb = 0;
+
+  if (index == NULL || !index->valide ||
+      index->nb != compter_processus(liste)) {
+    /* Collecte faite avant l'activation de l'index (ou mémoire manquante) */
+    if (index_texte_construire(&filtre->secours, liste, NULL, NULL) != 0) {
+      return -1;
+    }
+    index = &filtre->secours;
+  }
+
+  nb_lignes = candidats(filtre, index);
+  if (nb_lignes == -2) {
+    return -1;
+  }
+  tout_parcourir = nb_lignes < 0;
+  if (tout_parcourir) {
+    nb_lignes = index->nb;
+    filtre->nb_parcours++;
+    if (nb_lignes > filtre->capacite_resultats) {
+      uint32_t *resultats =
+          realloc(filtre->resultats, (size_t)nb_lignes * sizeof(uint32_t));
+      if (resultats == NULL) {
+        return -1;
+      }
+      filtre->resultats = resultats;
+      filtre->capacite_resultats = nb_lignes;
+    }
+  }
+
+  /* Vérification sur le texte (collisions, motif complet, regex) */
+  for (int i = 0; i < nb_lignes; i++) {
+    int ligne = tout_parcourir ? i : (int)filtre->resultats[i];
+    size_t longueur;
+    const char *texte = index_texte_ligne(index, ligne, &longueur);
+
+    if (verifier(filtre, texte, longueur)) {
+      filtre->resultats[nb++] = (uint32_t)ligne;
+    }
+  }
+
+  filtre->nb_recherches++;
+  return nb;
+}
+
+processus_t *filtre_appliquer(filtre_t *filtre, processus_t *liste,
+                              const index_texte_t *index, snapshot_t *vue,
+                              int *nb_trouves) {
+  int nb;
+
+  *nb_trouves = -1;
+  if (!filtre->actif || liste == NULL) {
+    return liste;
+  }
+
+  nb = filtre_chercher(filtre, liste, index);
+  if (nb == compter_processus(liste)) {
+    /* Tout correspond (motif court) : pas de copie */
+    *nb_trouves = nb;
+    return liste;
+  }
+  if (nb < 0 || snapshot_reserver(vue, nb) != 0) {
+    return liste;
+  }
+
+  snapshot_reinitialiser(vue);
+  for (int i = 0; i < nb; i++) {
+    memcpy(snapshot_ajouter(vue),
+           get_processus_at_index(liste, (int)filtre->resultats[i]),
+           sizeof(processus_t));
+  }
+  *nb_trouves = nb;
+  return snapshot_finaliser(vue);
+}
+
+const char *filtre_nom_mode(filtre_mode_t mode) {
+  switch (mode) {
+  case FILTRE_PREFIXE:
+    return "prefixe";
+  case FILTRE_REGEX:
+    return "regex";
+  default:
+    return "sous-chaine";
+  }
+}
@@ -0,0 +1,121 @@
+/**
+ * @file filtre.h
+ * @brief Filtre de recherche des processus (sous-chaîne, préfixe, regex)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Le filtre porte sur le PID, l'utilisateur, le nom de commande et la
+ * ligne de commande complète, sans distinction de casse. Il s'appuie sur
+ * l'index construit avec la collecte : les candidats sont lus dans une
+ * table de trigrammes (sous-chaîne, et regex dont un littéral de trois
+ * caractères est obligatoire) ou de préfixes, puis vérifiés sur leur texte.
+ * Seuls les motifs trop courts, ou les regex sans littéral, parcourent
+ * toutes les lignes.
+ */
+
+#ifndef FILTRE_H
+#define FILTRE_H
+
+#include "index_texte.h"
+#include "process.h"
+#include "snapshot.h"
+#include <regex.h>
+
+#define FILTRE_TAILLE_MOTIF 128
+#define FILTRE_CANDIDATS_SUFFISANTS 64 /* Intersection arrêtée en dessous */
+
+/**
+ * @brief Modes de correspondance.
+ */
+typedef enum filtre_mode {
+  FILTRE_SOUS_CHAINE = 0, /* Le motif apparaît dans un champ */
+  FILTRE_PREFIXE,         /* Un champ commence par le motif */
+  FILTRE_REGEX,           /* Regex étendue (^ et $ : bornes d'un champ) */
+  FILTRE_NB_MODES
+} filtre_mode_t;
+
+/**
+ * @brief Filtre actif et tableaux de travail réutilisés.
+ */
+typedef struct filtre {
+  int actif;
+  filtre_mode_t mode;
+  int toutes_machines;              /* 1 : correspondances de chaque onglet */
+  char motif[FILTRE_TAILLE_MOTIF];  /* Tel que saisi */
+  char cle[FILTRE_TAILLE_MOTIF];    /* En minuscules */
+  size_t longueur;
+  regex_t regex;
+  int regex_compilee;
+  char litteraux[FILTRE_TAILLE_MOTIF]; /* Séquences (séparées par '\n')
+                                          présentes dans toute ligne
+                                          acceptée par la regex */
+
+  uint32_t *resultats;              /* Lignes retenues (croissantes) */
+  int capacite_resultats;
+  index_texte_t secours;            /* Index d'une liste arrivée sans le sien */
+
+  unsigned long nb_recherches;
+  unsigned long nb_parcours;        /* Recherches sans table utilisable */
+} filtre_t;
+
+/**
+ * @brief Initialise un filtre inactif.
+ * @param filtre : Filtre à initialiser.
+ */
+void filtre_init(filtre_t *filtre);
+
+/**
+ * @brief Libère les ressources d'un filtre.
+ * @param filtre : Filtre à libérer.
+ */
+void filtre_liberer(filtre_t *filtre);
+
+/**
+ * @brief Définit le motif et le mode (motif vide : filtre inactif).
+ * @param filtre : Filtre concerné.
+ * @param motif : Motif saisi.
+ * @param mode : Mode de correspondance.
+ * @return int : 0 en cas de succès, -1 si la regex est invalide (le filtre
+ *               devient inactif).
+ */
+int filtre_definir(filtre_t *filtre, const char *motif, filtre_mode_t mode);
+
+/**
+ * @brief Désactive le filtre.
+ * @param filtre : Filtre concerné.
+ */
+void filtre_desactiver(filtre_t *filtre);
+
+/**
+ * @brief Cherche les lignes d'une liste qui correspondent au filtre.
+ * @param filtre : Filtre actif.
+ * @param liste : Liste des processus.
+ * @param index : Index de la liste (NULL ou invalide : index de secours
+ *                construit sans les lignes de commande).
+ * @return int : Nombre de lignes retenues (dans filtre->resultats), ou -1
+ *               en cas d'erreur mémoire.
+ */
+int filtre_chercher(filtre_t *filtre, processus_t *liste,
+                    const index_texte_t *index);
+
+/**
+ * @brief Construit la vue filtrée d'une liste (ordre de la liste conservé).
+ * @param filtre : Filtre concerné.
+ * @param liste : Liste des processus.
+ * @param index : Index de la liste (voir filtre_chercher).
+ * @param vue : Snapshot recevant la vue.
+ * @param nb_trouves : Reçoit le nombre de lignes retenues (-1 : erreur).
+ * @return processus_t* : Vue filtrée (NULL si aucune ligne), 'liste'
+ *         elle-même si le filtre est inactif ou si la mémoire manque.
+ */
+processus_t *filtre_appliquer(filtre_t *filtre, processus_t *liste,
+                              const index_texte_t *index, snapshot_t *vue,
+                              int *nb_trouves);
+
+/**
+ * @brief Libellé d'un mode ("sous-chaine", "prefixe", "regex").
+ * @param mode : Mode.
+ * @return const char* : Libellé.
+ */
+const char *filtre_nom_mode(filtre_mode_t mode);
+
+#endif /* FILTRE_H */
@@ -0,0 +1,802 @@
+/**
+ * @file flux.c
+ * @brief Implémentation de la réception en flux des sorties distantes
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "flux.h"
+#include "network.h"
+#include "procfs.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FLUX_CAPACITE_INITIALE (4 * FLUX_LECTURE)
+
+/* Fonctions privées */
+
+static const char *sauter_blancs(const char *p) {
+  while (*p == ' ' || *p == '\t') {
+    p++;
+  }
+  return p;
+}
+
+static int fin_de_champ(char c) { return c == ' ' || c == '\t' || c == '\0'; }
+
+/**
+ * @brief Lit un entier décimal (signe '-' accepté) et avance le curseur.
+ * @return int : 0 en cas de succès, -1 si le champ n'est pas un entier.
+ */
+static int lire_entier(const char **curseur, long long *valeur) {
+  const char *p = sauter_blancs(*curseur);
+  int negatif = (*p == '-');
+  long long v = 0;
+
+  p += negatif;
+  if (*p < '0' || *p > '9') {
+    return -1;
+  }
+  while (*p >= '0' && *p <= '9') {
+    v = v * 10 + (*p - '0');
+    p++;
+  }
+  if (!fin_de_champ(*p)) {
+    return -1;
+  }
+  *valeur = negatif ? -v : v;
+  *curseur = p;
+  return 0;
+}
+
+/**
+ * @brief Lit un décimal "123.45" (point décimal quelle que soit la locale).
+ * @return int : 0 en cas de succès, -1 sinon.
+ */
+static int lire_reel(const char **curseur, double *valeur) {
+  const char *p = sauter_blancs(*curseur);
+  double v = 0.0;
+  double echelle = 0.1;
+
+  if (*p < '0' || *p > '9') {
+    return -1;
+  }
+  while (*p >= '0' && *p <= '9') {
+    v = v * 10.0 + (*p - '0');
+    p++;
+  }
+  if (*p == '.') {
+    for (p++; *p >= '0' && *p <= '9'; p++) {
+      v += (*p - '0') * echelle;
+      echelle /= 10.0;
+    }
+  }
+  if (!fin_de_champ(*p)) {
+    return -1;
+  }
+  *valeur = v;
+  *curseur = p;
+  return 0;
+}
+
+/**
+ * @brief Copie un champ (tronqué à la taille de 'dest') et avance le
+ *        curseur ; 'dest' peut être NULL pour l'ignorer.
+ * @return int : 0 en cas de succès, -1 si la ligne est finie.
+ */
+static int lire_mot(const char **curseur, char *dest, size_t taille) {
+  const char *p = sauter_blancs(*curseur);
+  const char *debut = p;
+  size_t longueur;
+
+  while (!fin_de_champ(*p)) {
+    p++;
+  }
+  longueur = (size_t)(p - debut);
+  if (longueur == 0) {
+    return -1;
+  }
+  if (dest != NULL) {
+    if (longueur >= taille) {
+      longueur = taille - 1;
+    }
+    memcpy(dest, debut, longueur);
+    dest[longueur] = '\0';
+  }
+  *curseur = p;
+  return 0;
+}
+
+/**
+ * @brief Copie la fin de la ligne (commande, espaces compris).
+ */
+static void copier_reste(const char *p, const char *fin, char *dest,
+                         size_t taille) {
+  size_t longueur;
+
+  p = sauter_blancs(p);
+  longueur = p < fin ? (size_t)(fin - p) : 0;
+  if (longueur >= taille) {
+    longueur = taille - 1;
+  }
+  memcpy(dest, p, longueur);
+  dest[longueur] = '\0';
+}
+
+/**
+ * @brief Champs absents des formats distants.
+ */
+static void initialiser_processus(processus_t *proc) {
+  proc->ppid = 0;
+  proc->pgrp = 0;
+  proc->session = 0;
+  proc->uid = 0;
+  proc->nb_threads = 0;
+  proc->est_thread = 0;
+  proc->starttime = 0;
+  proc->utime = 0;
+  proc->stime = 0;
+  proc->cpu_percent = 0.0f;
+  proc->cpu_percent_machine = 0.0f;
+}
+
+/**
+ * @brief Ligne de 'ps aux' :
+ *        USER PID %CPU %MEM VSZ RSS TTY STAT START TIME COMMAND
+ */
+static int lire_ps_aux(const char *ligne, const char *fin,
+                       processus_t *proc) {
+  const char *p = ligne;
+  long long pid, vsz, rss;
+  double cpu, mem;
+  char stat[16];
+
+  if (lire_mot(&p, proc->utilisateur, sizeof(proc->utilisateur)) != 0 ||
+      lire_entier(&p, &pid) != 0 || lire_reel(&p, &cpu) != 0 ||
+      lire_reel(&p, &mem) != 0 || lire_entier(&p, &vsz) != 0 ||
+      lire_entier(&p, &rss) != 0 || lire_mot(&p, NULL, 0) != 0 ||
+      lire_mot(&p, stat, sizeof(stat)) != 0) {
+    return -1;
+  }
+
+  /* START et TIME, puis la commande (éventuellement absente) */
+  proc->nom_commande[0] = '\0';
+  if (lire_mot(&p, NULL, 0) == 0 && lire_mot(&p, NULL, 0) == 0) {
+    copier_reste(p, fin, proc->nom_commande, sizeof(proc->nom_commande));
+  }
+
+  initialiser_processus(proc);
+  proc->pid = (pid_t)pid;
+  proc->tgid = proc->pid;
+  proc->cpu_percent = (float)cpu;
+  proc->cpu_percent_machine = (float)cpu;
+  proc->vmem_size = (long)vsz;
+  proc->rss_ko = (long)rss;
+  proc->etat = stat[0];
+  return 0;
+}
+
+/**
+ * @brief Ligne de 'ps -eo' de COMMANDE_PS_DELTA :
+ *        USER PID PPID STAT VSZ RSS TIME(s) ELAPSED(s) COMMAND
+ */
+static int lire_ps_delta(const char *ligne, const char *fin,
+                         unsigned long long uptime_ticks, processus_t *proc) {
+  const char *p = ligne;
+  long long pid, ppid, vsz, rss, cpu_secondes, age_secondes, age_ticks;
+  char stat[16];
+
+  if (lire_mot(&p, proc->utilisateur, sizeof(proc->utilisateur)) != 0 ||
+      lire_entier(&p, &pid) != 0 || lire_entier(&p, &ppid) != 0 ||
+      lire_mot(&p, stat, sizeof(stat)) != 0 || lire_entier(&p, &vsz) != 0 ||
+      lire_entier(&p, &rss) != 0 || lire_entier(&p, &cpu_secondes) != 0 ||
+      lire_entier(&p, &age_secondes) != 0) {
+    return -1;
+  }
+  copier_reste(p, fin, proc->nom_commande, sizeof(proc->nom_commande));
+
+  initialiser_processus(proc);
+  age_ticks = age_secondes * REMOTE_TICKS_PAR_SECONDE;
+  proc->pid = (pid_t)pid;
+  proc->tgid = proc->pid;
+  proc->ppid = (pid_t)ppid;
+  proc->vmem_size = (long)vsz;
+  proc->rss_ko = (long)rss;
+  proc->etat = stat[0];
+  proc->starttime = (age_ticks < (long long)uptime_ticks)
+                        ? uptime_ticks - (unsigned long long)age_ticks
+                        : 0;
+  proc->utime = cpu_secondes * REMOTE_TICKS_PAR_SECONDE;
+  return 0;
+}
+
+/**
+ * @brief Ligne de processus de l'agent (voir agent.h).
+ */
+static int lire_agent(const char *ligne, const char *fin,
+                      processus_t *proc) {
+  const char *p = ligne;
+  long long pid, ppid, pgrp, session, uid, threads, starttime, utime, stime,
+      vsz, rss;
+  char etat[4];
+
+  if (lire_entier(&p, &pid) != 0 || lire_entier(&p, &ppid) != 0 ||
+      lire_entier(&p, &pgrp) != 0 || lire_entier(&p, &session) != 0 ||
+      lire_mot(&p, etat, sizeof(etat)) != 0 || lire_entier(&p, &uid) != 0 ||
+      lire_entier(&p, &threads) != 0 || lire_entier(&p, &starttime) != 0 ||
+      lire_entier(&p, &utime) != 0 || lire_entier(&p, &stime) != 0 ||
+      lire_entier(&p, &vsz) != 0 || lire_entier(&p, &rss) != 0 ||
+      lire_mot(&p, proc->utilisateur, sizeof(proc->utilisateur)) != 0) {
+    return -1;
+  }
+  copier_reste(p, fin, proc->nom_commande, sizeof(proc->nom_commande));
+
+  initialiser_processus(proc);
+  proc->pid = (pid_t)pid;
+  proc->tgid = proc->pid;
+  proc->ppid = (pid_t)ppid;
+  proc->pgrp = (pid_t)pgrp;
+  proc->session = (pid_t)session;
+  proc->etat = etat[0];
+  proc->uid = (uid_t)uid;
+  proc->nb_threads = (int)threads;
+  proc->starttime = (unsigned long long)starttime;
+  proc->utime = utime;
+  proc->stime = stime;
+  proc->vmem_size = (long)vsz;
+  proc->rss_ko = (long)rss;
+  return 0;
+}
+
+/**
+ * @brief Convertit des ticks distants (CLK_TCK de l'hôte) en
+ *        REMOTE_TICKS_PAR_SECONDE.
+ */
+static unsigned long long convertir_ticks(unsigned long long ticks,
+                                          long clk_tck) {
+  return clk_tck == REMOTE_TICKS_PAR_SECONDE
+             ? ticks
+             : ticks * REMOTE_TICKS_PAR_SECONDE / (unsigned long long)clk_tck;
+}
+
+/**
+ * @brief Nombre de chiffres décimaux d'un PID.
+ */
+static int compter_chiffres(long long pid) {
+  int nb = 1;
+
+  while (pid >= 10) {
+    pid /= 10;
+    nb++;
+  }
+  return nb;
+}
+
+/**
+ * @brief Compare deux PID dans l'ordre où le shell développe [0-9]* sous
+ *        LC_ALL=C (ordre des octets : "10" avant "9").
+ *
+ * Sans passer par le texte : le plus court est complété de zéros à droite
+ * jusqu'à la longueur de l'autre, ce qui compare les chiffres communs ; à
+ * égalité, l'un est préfixe de l'autre et le plus court passe devant.
+ */
+static int comparer_ordre_chemins(long long a, long long b) {
+  int chiffres_a = compter_chiffres(a);
+  int chiffres_b = compter_chiffres(b);
+  long long aligne_a = a;
+  long long aligne_b = b;
+
+  for (int i = chiffres_a; i < chiffres_b; i++) {
+    aligne_a *= 10;
+  }
+  for (int i = chiffres_b; i < chiffres_a; i++) {
+    aligne_b *= 10;
+  }
+  if (aligne_a != aligne_b) {
+    return aligne_a < aligne_b ? -1 : 1;
+  }
+  return (chiffres_a > chiffres_b) - (chiffres_a < chiffres_b);
+}
+
+/**
+ * @brief Retrouve un processus de la section "S" par son PID.
+ *
+ * Chaque section développe à nouveau le motif [0-9]* de /proc, dans le
+ * même ordre (COMMANDE_PROCFS impose LC_ALL=C) ; un processus apparu entre
+ * deux sections n'est pas dans "S".
+ * Le curseur avance donc sans revenir en arrière : la jointure est
+ * linéaire.
+ * @return int : Indice dans l'arène, ou -1 si absent.
+ */
+static int chercher_procfs(flux_analyse_t *analyse, long long pid) {
+  const snapshot_t *dest = analyse->dest;
+
+  if (pid < 0 || pid > INT_MAX) {
+    return -1;
+  }
+  while (analyse->curseur < dest->nb) {
+    int ordre =
+        comparer_ordre_chemins(dest->elements[analyse->curseur].pid, pid);
+    if (ordre == 0) {
+      return analyse->curseur;
+    }
+    if (ordre > 0) {
+      return -1;
+    }
+    analyse->curseur++;
+  }
+  return -1;
+}
+
+/**
+ * @brief Lit le préfixe "PID/fichier:" que 'grep' ajoute à chaque ligne
+ *        d'un fichier /proc/[PID]/fichier.
+ * @return const char* : Début des données, ou NULL sans préfixe valide.
+ */
+static const char *lire_prefixe(const char *ligne, const char *suffixe,
+                                long long *pid) {
+  const char *p = ligne;
+  size_t longueur = strlen(suffixe);
+
+  for (*pid = 0; *p >= '0' && *p <= '9' && p - ligne < 10; p++) {
+    *pid = *pid * 10 + (*p - '0');
+  }
+  if (p == ligne || strncmp(p, suffixe, longueur) != 0) {
+    return NULL;
+  }
+  return p + longueur;
+}
+
+/**
+ * @brief Remplace les caractères de contrôle par des espaces (nom et ligne
+ *        de commande viennent du processus distant).
+ */
+static void remplacer_controles(char *texte) {
+  for (; *texte != '\0'; texte++) {
+    if ((unsigned char)*texte < ' ') {
+      *texte = ' ';
+    }
+  }
+}
+
+/**
+ * @brief Ligne marquant le début de la section suivante : "S", "U" puis
+ *        "C" suivis du jeton de la requête, dans cet ordre seulement.
+ */
+static int est_section_suivante(const flux_analyse_t *analyse,
+                                const char *ligne, const char *fin) {
+  size_t longueur = strlen(analyse->jeton);
+  char suivante;
+
+  switch (analyse->section) {
+  case 0:
+    suivante = 'S';
+    break;
+  case 'S':
+    suivante = 'U';
+    break;
+  case 'U':
+    suivante = 'C';
+    break;
+  default:
+    return 0;
+  }
+  return longueur > 0 && ligne[0] == suivante && ligne[1] == ' ' &&
+         (size_t)(fin - ligne) == longueur + 2 &&
+         memcmp(ligne + 2, analyse->jeton, longueur) == 0;
+}
+
+/**
+ * @brief Ligne stat de la section "S", analysée par procfs_parser_stat()
+ *        comme en local. Un '\n' dans le nom coupe la ligne : le début est
+ *        gardé puis complété par la ligne suivante du même fichier.
+ * @return int : FLUX_CONTINUER, ou FLUX_ERREUR (mémoire insuffisante).
+ */
+static int lire_stat_procfs(flux_analyse_t *analyse, const char *ligne,
+                            const char *fin) {
+  char jointe[FLUX_TAILLE_FRAGMENT + 1024];
+  const char *texte;
+  processus_t *proc;
+  long long pid;
+  size_t longueur;
+
+  texte = lire_prefixe(ligne, "/stat:", &pid);
+  if (texte == NULL) {
+    analyse->nb_invalides++;
+    return FLUX_CONTINUER;
+  }
+  longueur = (size_t)(fin - texte);
+  if (pid == analyse->pid_fragment) {
+    longueur = (size_t)snprintf(jointe, sizeof(jointe), "%s %s",
+                                analyse->fragment, texte);
+    if (longueur >= sizeof(jointe)) {
+      longueur = 0;
+    }
+    texte = jointe;
+  }
+  analyse->pid_fragment = -1;
+
+  proc = snapshot_ajouter(analyse->dest);
+  if (proc == NULL) {
+    return FLUX_ERREUR;
+  }
+  initialiser_processus(proc);
+  if (longueur == 0 ||
+      procfs_parser_stat(texte, longueur, analyse->page_ko, proc) != 0 ||
+      proc->pid != (pid_t)pid) {
+    snapshot_annuler_dernier(analyse->dest);
+    if (longueur > 0 && longueur < sizeof(analyse->fragment)) {
+      memcpy(analyse->fragment, texte, longueur);
+      analyse->fragment[longueur] = '\0';
+      analyse->pid_fragment = pid;
+    } else {
+      analyse->nb_invalides++;
+    }
+    return FLUX_CONTINUER;
+  }
+
+  /* "[nom]" comme 'ps' tant qu'aucune ligne de commande n'est reçue */
+  remplacer_controles(proc->nom_commande);
+  longueur = strlen(proc->nom_commande);
+  if (longueur > sizeof(proc->nom_commande) - 3) {
+    longueur = sizeof(proc->nom_commande) - 3;
+  }
+  memmove(proc->nom_commande + 1, proc->nom_commande, longueur);
+  proc->nom_commande[0] = '[';
+  proc->nom_commande[longueur + 1] = ']';
+  proc->nom_commande[longueur + 2] = '\0';
+
+  snprintf(proc->utilisateur, sizeof(proc->utilisateur), "?");
+  proc->starttime = convertir_ticks(proc->starttime, analyse->clk_tck);
+  proc->utime = (long long)convertir_ticks((unsigned long long)proc->utime,
+                                           analyse->clk_tck);
+  proc->stime = (long long)convertir_ticks((unsigned long long)proc->stime,
+                                           analyse->clk_tck);
+  return FLUX_CONTINUER;
+}
+
+/**
+ * @brief Ligne de la section "C" : ligne de commande d'un processus, les
+ *        arguments séparés par des espaces. Un argument contenant '\n'
+ *        donne plusieurs lignes du même fichier, mises bout à bout.
+ */
+static void lire_commande_procfs(flux_analyse_t *analyse, const char *ligne,
+                                 const char *fin) {
+  const char *texte;
+  processus_t *proc;
+  long long pid;
+  size_t longueur;
+  int indice;
+
+  texte = lire_prefixe(ligne, "/cmdline:", &pid);
+  if (texte == NULL || (indice = chercher_procfs(analyse, pid)) < 0) {
+    return;
+  }
+  while (fin > texte && fin[-1] == ' ') {
+    fin--;
+  }
+  if (fin == texte) {
+    return;
+  }
+
+  proc = &analyse->dest->elements[indice];
+  if (analyse->commande != indice) {
+    /* Première ligne : remplace "[nom]" */
+    copier_reste(texte, fin, proc->nom_commande, sizeof(proc->nom_commande));
+    analyse->commande = indice;
+  } else {
+    longueur = strlen(proc->nom_commande);
+    if (longueur + 1 < sizeof(proc->nom_commande)) {
+      proc->nom_commande[longueur] = ' ';
+      copier_reste(texte, fin, proc->nom_commande + longueur + 1,
+                   sizeof(proc->nom_commande) - longueur - 1);
+    }
+  }
+  remplacer_controles(proc->nom_commande);
+}
+
+/**
+ * @brief Ligne de la sortie de COMMANDE_PROCFS (après l'en-tête).
+ *
+ * Seule la ligne "S", "U" ou "C" attendue, suivie du jeton de la requête,
+ * change de section ; les lignes lues dans /proc commencent toutes par un
+ * PID et ne peuvent pas en tenir lieu.
+ * "S" : "PID/stat:" puis la ligne stat ; "U" : "PID UID utilisateur" ;
+ * "C" : "PID/cmdline:" puis la ligne de commande (absente pour un thread
+ * noyau, qui garde "[nom]").
+ * @return int : FLUX_CONTINUER, ou FLUX_ERREUR (mémoire insuffisante, ou
+ *               ligne hors section).
+ */
+static int lire_procfs(flux_analyse_t *analyse, const char *ligne,
+                       const char *fin) {
+  const char *p = ligne;
+  long long pid, uid;
+  processus_t *proc;
+  int indice;
+
+  if (est_section_suivante(analyse, ligne, fin)) {
+    if (analyse->pid_fragment >= 0) {
+      analyse->nb_invalides++;
+      analyse->pid_fragment = -1;
+    }
+    analyse->section = ligne[0];
+    analyse->curseur = 0;
+    analyse->commande = -1;
+    return FLUX_CONTINUER;
+  }
+
+  switch (analyse->section) {
+  case 'S':
+    return lire_stat_procfs(analyse, ligne, fin);
+  case 'U':
+    if (lire_entier(&p, &pid) == 0 && lire_entier(&p, &uid) == 0 &&
+        (indice = chercher_procfs(analyse, pid)) >= 0) {
+      proc = &analyse->dest->elements[indice];
+      proc->uid = (uid_t)uid;
+      lire_mot(&p, proc->utilisateur, sizeof(proc->utilisateur));
+    }
+    break;
+  case 'C':
+    lire_commande_procfs(analyse, ligne, fin);
+    break;
+  default:
+    return FLUX_ERREUR;
+  }
+  return FLUX_CONTINUER;
+}
+
+/**
+ * @brief Lignes d'en-tête de chaque format.
+ * @return int : 1 si la ligne était un en-tête, 0 sinon, -1 si invalide.
+ */
+static int lire_entete(flux_analyse_t *analyse, const char *ligne) {
+  const char *p = ligne;
+  long long nb_coeurs, nb, ticks;
+  double uptime;
+
+  switch (analyse->format) {
+  case FLUX_PS_AUX:
+    return analyse->num_ligne == 1;
+  case FLUX_PS_DELTA:
+    if (analyse->num_ligne == 1) {
+      /* /proc/uptime : "secondes inactif" */
+      if (lire_reel(&p, &uptime) != 0) {
+        return -1;
+      }
+      analyse->uptime_ticks =
+          (unsigned long long)(uptime * REMOTE_TICKS_PAR_SECONDE);
+      return 1;
+    }
+    if (analyse->num_ligne == 2) {
+      if (lire_entier(&p, &nb_coeurs) != 0 || nb_coeurs <= 0) {
+        return -1;
+      }
+      analyse->nb_coeurs = (int)nb_coeurs;
+      return 1;
+    }
+    return analyse->num_ligne == 3; /* En-tête de ps */
+  case FLUX_PROCFS:
+    if (analyse->section != 0) {
+      return 0;
+    }
+    if (analyse->num_ligne == 1) {
+      if (lire_reel(&p, &uptime) != 0) {
+        return -1;
+      }
+      analyse->uptime_ticks =
+          (unsigned long long)(uptime * REMOTE_TICKS_PAR_SECONDE);
+      return 1;
+    }
+    /* Cœurs, taille de page (octets) et CLK_TCK, puis la section "S" */
+    if (analyse->num_ligne <= 4) {
+      if (lire_entier(&p, &nb) != 0 || nb <= 0 || nb > INT_MAX) {
+        return -1;
+      }
+      if (analyse->num_ligne == 2) {
+        analyse->nb_coeurs = (int)nb;
+      } else if (analyse->num_ligne == 3) {
+        analyse->page_ko = nb >= 1024 ? (long)(nb / 1024) : 1;
+      } else {
+        analyse->clk_tck = (long)nb;
+      }
+      return 1;
+    }
+    return 0;
+  case FLUX_AGENT:
+    if (analyse->num_ligne == 1) {
+      /* "D <uptime> <coeurs> <nb>" : l'arène est réservée d'un coup */
+      if (p[0] != 'D' || (p++, lire_entier(&p, &ticks) != 0) ||
+          lire_entier(&p, &nb_coeurs) != 0 || lire_entier(&p, &nb) != 0 ||
+          ticks < 0 || nb_coeurs <= 0 || nb < 0 || nb > INT_MAX) {
+        return -1;
+      }
+      analyse->uptime_ticks = (unsigned long long)ticks;
+      analyse->nb_coeurs = (int)nb_coeurs;
+      return snapshot_reserver(analyse->dest, (int)nb) == 0 ? 1 : -1;
+    }
+    return 0;
+  }
+  return -1;
+}
+
+/* Fonctions publiques */
+
+void flux_init(flux_lignes_t *flux) {
+  memset(flux, 0, sizeof(*flux));
+}
+
+void flux_liberer(flux_lignes_t *flux) {
+  free(flux->tampon);
+  flux_init(flux);
+}
+
+void flux_commencer(flux_lignes_t *flux, flux_traiter_ligne_t traiter,
+                    void *contexte) {
+  flux->taille = 0;
+  flux->examine = 0;
+  flux->traiter = traiter;
+  flux->contexte = contexte;
+  flux->etat = FLUX_CONTINUER;
+  flux->reste = 0;
+}
+
+char *flux_zone(flux_lignes_t *flux, size_t *disponible) {
+  /* Place pour une lecture, plus le '\0' d'une dernière ligne sans '\n' */
+  if (flux->capacite - flux->taille < FLUX_LECTURE + 1) {
+    size_t capacite = flux->capacite > 0 ? flux->capacite * 2
+                                         : FLUX_CAPACITE_INITIALE;
+    char *tampon;
+
+    while (capacite - flux->taille < FLUX_LECTURE + 1) {
+      capacite *= 2;
+    }
+    tampon = realloc(flux->tampon, capacite);
+    if (tampon == NULL) {
+      return NULL;
+    }
+    flux->tampon = tampon;
+    flux->capacite = capacite;
+  }
+  *disponible = flux->capacite - flux->taille - 1;
+  return flux->tampon + flux->taille;
+}
+
+int flux_valider(flux_lignes_t *flux, size_t nb) {
+  size_t debut = 0;
+  char *fin_ligne;
+
+  if (flux->etat != FLUX_CONTINUER) {
+    return flux->etat;
+  }
+  flux->taille += nb;
+
+  /* Seuls les octets nouveaux sont parcourus */
+  while (flux->etat == FLUX_CONTINUER &&
+         (fin_ligne = memchr(flux->tampon + flux->examine, '\n',
+                             flux->taille - flux->examine)) != NULL) {
+    *fin_ligne = '\0';
+    flux->etat = flux->traiter(flux->contexte, flux->tampon + debut,
+                               (size_t)(fin_ligne - flux->tampon) - debut);
+    debut = (size_t)(fin_ligne - flux->tampon) + 1;
+    flux->examine = debut;
+  }
+
+  if (flux->etat != FLUX_CONTINUER) {
+    flux->reste = flux->taille - debut;
+    flux->taille = 0;
+    flux->examine = 0;
+    return flux->etat;
+  }
+
+  /* La ligne incomplète revient au début du tampon */
+  if (debut > 0) {
+    memmove(flux->tampon, flux->tampon + debut, flux->taille - debut);
+    flux->taille -= debut;
+  }
+  flux->examine = flux->taille;
+  return flux->etat;
+}
+
+int flux_pousser(flux_lignes_t *flux, const char *donnees, size_t nb) {
+  while (nb > 0 && flux->etat == FLUX_CONTINUER) {
+    size_t disponible;
+    char *zone = flux_zone(flux, &disponible);
+
+    if (zone == NULL) {
+      flux->etat = FLUX_ERREUR;
+      break;
+    }
+    if (disponible > nb) {
+      disponible = nb;
+    }
+    memcpy(zone, donnees, disponible);
+    flux_valider(flux, disponible);
+    donnees += disponible;
+    nb -= disponible;
+  }
+  return flux->etat;
+}
+
+int flux_terminer(flux_lignes_t *flux) {
+  if (flux->etat == FLUX_CONTINUER && flux->taille > 0) {
+    flux->tampon[flux->taille] = '\0';
+    flux->etat = flux->traiter(flux->contexte, flux->tampon, flux->taille);
+  }
+  flux->taille = 0;
+  flux->examine = 0;
+  return flux->etat;
+}
+
+void flux_analyse_commencer(flux_analyse_t *analyse, snapshot_t *dest,
+                            flux_format_t format) {
+  snapshot_reinitialiser(dest);
+  analyse->dest = dest;
+  analyse->format = format;
+  analyse->num_ligne = 0;
+  analyse->nb_invalides = 0;
+  analyse->uptime_ticks = 0;
+  analyse->nb_coeurs = 0;
+  analyse->page_ko = 4;
+  analyse->clk_tck = REMOTE_TICKS_PAR_SECONDE;
+  analyse->jeton[0] = '\0';
+  analyse->section = 0;
+  analyse->curseur = 0;
+  analyse->commande = -1;
+  analyse->pid_fragment = -1;
+  analyse->fragment[0] = '\0';
+}
+
+int flux_analyser_ligne(void *contexte, char *ligne, size_t longueur) {
+  flux_analyse_t *analyse = contexte;
+  const char *fin = ligne + longueur;
+  processus_t *proc;
+  int entete, invalide;
+
+  analyse->num_ligne++;
+  entete = lire_entete(analyse, ligne);
+  if (entete != 0) {
+    return entete > 0 ? FLUX_CONTINUER : FLUX_ERREUR;
+  }
+  if (analyse->format == FLUX_AGENT && ligne[0] == 'F' && longueur == 1) {
+    return FLUX_FIN;
+  }
+  if (analyse->format == FLUX_PROCFS) {
+    return longueur > 0 ? lire_procfs(analyse, ligne, fin) : FLUX_CONTINUER;
+  }
+
+  proc = snapshot_ajouter(analyse->dest);
+  if (proc == NULL) {
+    return FLUX_ERREUR;
+  }
+  switch (analyse->format) {
+  case FLUX_PS_AUX:
+    invalide = lire_ps_aux(ligne, fin, proc);
+    break;
+  case FLUX_PS_DELTA:
+    invalide = lire_ps_delta(ligne, fin, analyse->uptime_ticks, proc);
+    break;
+  default:
+    invalide = lire_agent(ligne, fin, proc);
+    break;
+  }
+  if (invalide) {
+    snapshot_annuler_dernier(analyse->dest);
+    analyse->nb_invalides++;
+  }
+  return FLUX_CONTINUER;
+}
+
+processus_t *flux_analyse_terminer(flux_analyse_t *analyse, int etat) {
+  /* L'agent termine chaque réponse par "F" ; 'ps' par la fin du canal */
+  if (etat == FLUX_ERREUR ||
+      (analyse->format == FLUX_AGENT && etat != FLUX_FIN) ||
+      (analyse->format == FLUX_PS_DELTA && analyse->num_ligne < 2) ||
+      (analyse->format == FLUX_PROCFS && analyse->section == 0)) {
+    snapshot_reinitialiser(analyse->dest);
+    return NULL;
+  }
+  return snapshot_finaliser(analyse->dest);
+}
@@ -0,0 +1,180 @@
+/**
+ * @file flux.h
+ * @brief Réception en flux des sorties distantes (ps, agent)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Les octets reçus d'un canal sont lus directement dans le tampon du flux ;
+ * chaque ligne complète est analysée sur place dès son arrivée, et seule
+ * la ligne incomplète en fin de tampon est ramenée au début avant la
+ * lecture suivante. La sortie n'est jamais recopiée en entier : le coût
+ * est linéaire en taille et le tampon, réutilisé d'une commande à l'autre,
+ * reste de l'ordre d'une lecture.
+ *
+ * Les analyseurs de lignes écrivent les processus directement dans un
+ * snapshot fourni par l'appelant.
+ */
+
+#ifndef FLUX_H
+#define FLUX_H
+
+#include "snapshot.h"
+#include <stddef.h>
+
+#define FLUX_LECTURE 16384 /* Place libre garantie avant chaque lecture */
+#define FLUX_TAILLE_JETON 40   /* Jeton des lignes de section (FLUX_PROCFS) */
+#define FLUX_TAILLE_FRAGMENT 64 /* Début d'une ligne stat coupée */
+
+#define FLUX_CONTINUER 0   /* Retours d'un traitement de ligne */
+#define FLUX_FIN 1         /* Réponse complète (lignes suivantes ignorées) */
+#define FLUX_ERREUR -1
+
+/**
+ * @brief Traitement d'une ligne complète, terminée par '\0' à la place du
+ *        '\n' ; elle peut être modifiée sur place.
+ * @return int : FLUX_CONTINUER, FLUX_FIN ou FLUX_ERREUR.
+ */
+typedef int (*flux_traiter_ligne_t)(void *contexte, char *ligne,
+                                    size_t longueur);
+
+/**
+ * @brief Découpage en lignes d'un flux d'octets.
+ */
+typedef struct flux_lignes {
+  char *tampon;        /* Ligne incomplète puis octets reçus */
+  size_t taille;       /* Octets présents */
+  size_t capacite;
+  size_t examine;      /* Octets déjà parcourus sans '\n' */
+
+  flux_traiter_ligne_t traiter;
+  void *contexte;
+  int etat;            /* FLUX_CONTINUER, FLUX_FIN ou FLUX_ERREUR */
+  size_t reste;        /* Octets reçus après la ligne qui a terminé le
+                          flux (ignorés) */
+} flux_lignes_t;
+
+/**
+ * @brief Formats de sortie distants.
+ */
+typedef enum {
+  FLUX_PS_AUX,   /* 'ps aux' (en-tête, %CPU moyen sur la vie) */
+  FLUX_PS_DELTA, /* Uptime, cœurs, puis 'ps -eo ...,times,etimes,args' */
+  FLUX_AGENT,    /* Instantané de l'agent ("D ...", lignes, "F") */
+  FLUX_PROCFS    /* /proc brut (COMMANDE_PROCFS) : uptime, cœurs, taille de
+                    page, CLK_TCK, puis les sections "S <jeton>" (lignes
+                    stat), "U <jeton>" (propriétaires) et "C <jeton>"
+                    (lignes de commande) ; les lignes de /proc sont
+                    préfixées de "PID/fichier:" */
+} flux_format_t;
+
+/**
+ * @brief Analyse d'une sortie de processus vers un snapshot.
+ */
+typedef struct flux_analyse {
+  snapshot_t *dest;
+  flux_format_t format;
+  int num_ligne;                  /* Lignes reçues */
+  int nb_invalides;               /* Lignes de processus ignorées */
+
+  /* Métadonnées (FLUX_PS_DELTA, FLUX_AGENT, FLUX_PROCFS) */
+  unsigned long long uptime_ticks; /* Ticks distants (1/100 s) */
+  int nb_coeurs;                  /* 0 : inconnu */
+
+  /* FLUX_PROCFS */
+  long page_ko;                   /* Taille d'une page distante (Ko) */
+  long clk_tck;                   /* Ticks par seconde distants */
+  char jeton[FLUX_TAILLE_JETON];  /* Tiré par l'appelant pour chaque
+                                     requête (vide : sections refusées) */
+  char section;                   /* 'S', 'U', 'C' (0 : en-tête) */
+  int curseur;                    /* Jointure par PID dans l'ordre des
+                                     chemins de /proc */
+  int commande;                   /* Processus dont la ligne de commande
+                                     est en cours (-1 : aucun) */
+  long long pid_fragment;         /* PID de 'fragment' (-1 : aucun) */
+  char fragment[FLUX_TAILLE_FRAGMENT]; /* Ligne stat coupée par un '\n'
+                                          du nom, en attente de sa suite */
+} flux_analyse_t;
+
+/**
+ * @brief Initialise un flux vide (aucune allocation).
+ * @param flux : Flux à initialiser.
+ */
+void flux_init(flux_lignes_t *flux);
+
+/**
+ * @brief Libère le tampon d'un flux.
+ * @param flux : Flux à libérer.
+ */
+void flux_liberer(flux_lignes_t *flux);
+
+/**
+ * @brief Prépare le flux pour une nouvelle réponse (tampon conservé).
+ * @param flux : Flux concerné.
+ * @param traiter : Traitement de chaque ligne.
+ * @param contexte : Argument du traitement.
+ */
+void flux_commencer(flux_lignes_t *flux, flux_traiter_ligne_t traiter,
+                    void *contexte);
+
+/**
+ * @brief Zone où lire les octets suivants (au moins FLUX_LECTURE octets).
+ * @param flux : Flux concerné.
+ * @param disponible : Reçoit la taille de la zone.
+ * @return char* : Zone d'écriture, ou NULL en cas d'erreur mémoire.
+ */
+char *flux_zone(flux_lignes_t *flux, size_t *disponible);
+
+/**
+ * @brief Analyse les 'nb' octets écrits dans la zone : chaque ligne
+ *        complète est traitée, la ligne incomplète est conservée.
+ * @param flux : Flux concerné.
+ * @param nb : Octets écrits dans la zone de flux_zone().
+ * @return int : État du flux (FLUX_CONTINUER, FLUX_FIN ou FLUX_ERREUR).
+ */
+int flux_valider(flux_lignes_t *flux, size_t nb);
+
+/**
+ * @brief Copie puis analyse des octets (flux_zone() + flux_valider()).
+ * @param flux : Flux concerné.
+ * @param donnees : Octets reçus.
+ * @param nb : Nombre d'octets.
+ * @return int : État du flux.
+ */
+int flux_pousser(flux_lignes_t *flux, const char *donnees, size_t nb);
+
+/**
+ * @brief Fin du flux : traite la dernière ligne si elle n'a pas de '\n'.
+ * @param flux : Flux concerné.
+ * @return int : État du flux.
+ */
+int flux_terminer(flux_lignes_t *flux);
+
+/**
+ * @brief Prépare l'analyse d'une sortie (snapshot remis à zéro).
+ * @param analyse : Analyse à préparer.
+ * @param dest : Snapshot destination.
+ * @param format : Format de la sortie.
+ */
+void flux_analyse_commencer(flux_analyse_t *analyse, snapshot_t *dest,
+                            flux_format_t format);
+
+/**
+ * @brief Traitement de ligne (flux_traiter_ligne_t) d'une analyse : la
+ *        ligne est convertie en processus dans le snapshot.
+ * @param contexte : flux_analyse_t.
+ * @param ligne : Ligne reçue.
+ * @param longueur : Longueur de la ligne.
+ * @return int : FLUX_CONTINUER, FLUX_FIN ("F" de l'agent) ou FLUX_ERREUR
+ *               (en-tête invalide, mémoire insuffisante).
+ */
+int flux_analyser_ligne(void *contexte, char *ligne, size_t longueur);
+
+/**
+ * @brief Termine une analyse : chaîne les processus reçus.
+ * @param analyse : Analyse concernée.
+ * @param etat : État final du flux.
+ * @return processus_t* : Tête de liste dans le snapshot, ou NULL si la
+ *                        sortie est incomplète, invalide ou vide.
+ */
+processus_t *flux_analyse_terminer(flux_analyse_t *analyse, int etat);
+
+#endif /* FLUX_H */
@@ -0,0 +1,300 @@
+/**
+ * @file index_texte.c
+ * @brief Implémentation de l'index de recherche d'un instantané
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "index_texte.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Fonctions privées */
+
+/**
+ * @brief Garantit la capacité d'un tableau (doublement).
+ */
+static int reserver(void **tableau, size_t *capacite, size_t nb,
+                    size_t taille_element) {
+  size_t nouvelle = *capacite ? *capacite : 1024;
+  void *agrandi;
+
+  if (nb <= *capacite) {
+    return 0;
+  }
+  while (nouvelle < nb) {
+    nouvelle *= 2;
+  }
+  agrandi = realloc(*tableau, nouvelle * taille_element);
+  if (agrandi == NULL) {
+    return -1;
+  }
+  *tableau = agrandi;
+  *capacite = nouvelle;
+  return 0;
+}
+
+static unsigned int seau_trigramme(unsigned char a, unsigned char b,
+                                   unsigned char c) {
+  uint32_t cle = ((uint32_t)a << 16) | ((uint32_t)b << 8) | c;
+
+  return (cle * 2654435761u) >> 16;
+}
+
+/**
+ * @brief Seau d'un début de champ ; un champ d'un caractère a un second
+ *        caractère nul.
+ */
+static unsigned int seau_prefixe(unsigned char a, unsigned char b) {
+  if (b == '\n' || b == '\0') {
+    b = 0;
+  }
+  return ((unsigned int)a << 8) | b;
+}
+
+/**
+ * @brief Ajoute un champ en minuscules au texte (place déjà réservée).
+ */
+static void ajouter_champ(index_texte_t *index, const char *champ,
+                          char separateur) {
+  char *dest = index->texte + index->taille_texte;
+
+  /* Minuscules ASCII : les octets UTF-8 restent tels quels */
+  for (const char *c = champ; *c != '\0'; c++) {
+    char octet = *c;
+    if (octet >= 'A' && octet <= 'Z') {
+      octet = (char)(octet - 'A' + 'a');
+    } else if (octet == '\n') {
+      octet = ' ';
+    }
+    *dest++ = octet;
+  }
+  *dest++ = separateur;
+  index->taille_texte = (size_t)(dest - index->texte);
+}
+
+/**
+ * @brief Ajoute la ligne d'un processus au texte.
+ */
+static int ajouter_ligne(index_texte_t *index, processus_t *proc,
+                         index_commande_fn commande, void *donnees) {
+  const char *ligne = commande != NULL ? commande(donnees, proc) : NULL;
+  char pid[16];
+  size_t besoin;
+
+  if (proc->utilisateur[0] == '\0') {
+    recuperer_nom_utilisateur(proc->uid, proc->utilisateur, MAX_USER_LEN);
+  }
+  /* La ligne de commande n'ajoute rien si elle se réduit au nom */
+  if (ligne != NULL && (ligne[0] == '\0' ||
+                        strcmp(ligne, proc->nom_commande) == 0)) {
+    ligne = NULL;
+  }
+
+  snprintf(pid, sizeof(pid), "%d", proc->pid);
+  besoin = index->taille_texte + strlen(pid) + strlen(proc->utilisateur) +
+           strlen(proc->nom_commande) + (ligne ? strlen(ligne) : 0) + 4;
+  if (reserver((void **)&index->texte, &index->capacite_texte, besoin, 1) !=
+      0) {
+    return -1;
+  }
+
+  ajouter_champ(index, pid, '\n');
+  ajouter_champ(index, proc->utilisateur, '\n');
+  if (ligne != NULL) {
+    ajouter_champ(index, proc->nom_commande, '\n');
+    ajouter_champ(index, ligne, '\0');
+  } else {
+    ajouter_champ(index, proc->nom_commande, '\0');
+  }
+  return 0;
+}
+
+/**
+ * @brief Compte (entrees == NULL) ou range les lignes de chaque seau de
+ *        trigrammes, une fois par ligne et par seau.
+ */
+static void parcourir_trigrammes(index_texte_t *index, uint32_t *seaux,
+                                 uint32_t *entrees, uint32_t tampon) {
+  for (int i = 0; i < index->nb; i++) {
+    const unsigned char *t = (const unsigned char *)index->texte;
+    uint32_t fin = index->debuts[i + 1] - 1;
+
+    for (uint32_t j = index->debuts[i]; j + 2 < fin; j++) {
+      if (t[j] == '\n' || t[j + 1] == '\n' || t[j + 2] == '\n') {
+        continue;
+      }
+      unsigned int s = seau_trigramme(t[j], t[j + 1], t[j + 2]);
+      if (index->marques[s] == tampon + (uint32_t)i) {
+        continue;
+      }
+      index->marques[s] = tampon + (uint32_t)i;
+      if (entrees == NULL) {
+        seaux[s + 1]++;
+      } else {
+        entrees[seaux[s]++] = (uint32_t)i;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Compte (entrees == NULL) ou range les lignes de chaque seau de
+ *        préfixes.
+ */
+static void parcourir_prefixes(index_texte_t *index, uint32_t *seaux,
+                               uint32_t *entrees, uint32_t tampon) {
+  for (int i = 0; i < index->nb; i++) {
+    const unsigned char *t = (const unsigned char *)index->texte;
+    const unsigned char *champ = t + index->debuts[i];
+    const unsigned char *fin = t + index->debuts[i + 1] - 1;
+
+    /* D'un champ au suivant : seuls les débuts de champ comptent */
+    for (; champ < fin; champ++) {
+      const unsigned char *suivant =
+          memchr(champ, '\n', (size_t)(fin - champ));
+      if (*champ != '\n') {
+        unsigned int s = seau_prefixe(champ[0], champ[1]);
+        if (index->marques[s] != tampon + (uint32_t)i) {
+          index->marques[s] = tampon + (uint32_t)i;
+          if (entrees == NULL) {
+            seaux[s + 1]++;
+          } else {
+            entrees[seaux[s]++] = (uint32_t)i;
+          }
+        }
+      }
+      if (suivant == NULL) {
+        break;
+      }
+      champ = suivant;
+    }
+  }
+}
+
+/**
+ * @brief Construit une table de seaux en deux passes (comptage puis
+ *        rangement) : les lignes d'un seau sont contiguës et croissantes.
+ */
+static int construire_seaux(index_texte_t *index, uint32_t **seaux,
+                            uint32_t **entrees, size_t *capacite,
+                            void (*parcourir)(index_texte_t *, uint32_t *,
+                                              uint32_t *, uint32_t)) {
+  uint32_t total;
+
+  if (*seaux == NULL) {
+    *seaux = malloc((INDEX_NB_SEAUX + 1) * sizeof(uint32_t));
+    if (*seaux == NULL) {
+      return -1;
+    }
+  }
+
+  /* Les marques des deux passes diffèrent : pas de remise à zéro entre */
+  memset(*seaux, 0, (INDEX_NB_SEAUX + 1) * sizeof(uint32_t));
+  memset(index->marques, 0, INDEX_NB_SEAUX * sizeof(uint32_t));
+  parcourir(index, *seaux, NULL, 1);
+  for (int s = 0; s < INDEX_NB_SEAUX; s++) {
+    (*seaux)[s + 1] += (*seaux)[s];
+  }
+
+  total = (*seaux)[INDEX_NB_SEAUX];
+  if (reserver((void **)entrees, capacite, total ? total : 1,
+               sizeof(uint32_t)) != 0) {
+    return -1;
+  }
+  parcourir(index, *seaux, *entrees, (uint32_t)index->nb + 1);
+
+  /* Chaque début a avancé jusqu'au seau suivant : décaler d'un cran */
+  for (int s = INDEX_NB_SEAUX; s > 0; s--) {
+    (*seaux)[s] = (*seaux)[s - 1];
+  }
+  (*seaux)[0] = 0;
+  return 0;
+}
+
+/* Fonctions publiques */
+
+void index_texte_init(index_texte_t *index) {
+  memset(index, 0, sizeof(*index));
+}
+
+void index_texte_liberer(index_texte_t *index) {
+  free(index->texte);
+  free(index->debuts);
+  free(index->seaux_trigrammes);
+  free(index->trigrammes);
+  free(index->seaux_prefixes);
+  free(index->prefixes);
+  free(index->marques);
+  index_texte_init(index);
+}
+
+void index_texte_invalider(index_texte_t *index) { index->valide = 0; }
+
+int index_texte_construire(index_texte_t *index, processus_t *liste,
+                           index_commande_fn commande, void *donnees) {
+  size_t capacite_debuts = (size_t)index->capacite_debuts;
+  int nb = compter_processus(liste);
+
+  index->valide = 0;
+  index->nb = 0;
+  index->taille_texte = 0;
+  if (reserver((void **)&index->debuts, &capacite_debuts, (size_t)nb + 1,
+               sizeof(uint32_t)) != 0) {
+    return -1;
+  }
+  index->capacite_debuts = (int)capacite_debuts;
+  if (index->marques == NULL) {
+    index->marques = malloc(INDEX_NB_SEAUX * sizeof(uint32_t));
+    if (index->marques == NULL) {
+      return -1;
+    }
+  }
+
+  for (processus_t *p = liste; p != NULL && index->nb < nb; p = p->suivant) {
+    index->debuts[index->nb] = (uint32_t)index->taille_texte;
+    if (ajouter_ligne(index, p, commande, donnees) != 0) {
+      return -1;
+    }
+    index->nb++;
+  }
+  index->debuts[index->nb] = (uint32_t)index->taille_texte;
+
+  if (construire_seaux(index, &index->seaux_trigrammes, &index->trigrammes,
+                       &index->capacite_trigrammes,
+                       parcourir_trigrammes) != 0 ||
+      construire_seaux(index, &index->seaux_prefixes, &index->prefixes,
+                       &index->capacite_prefixes, parcourir_prefixes) != 0) {
+    return -1;
+  }
+
+  index->valide = 1;
+  return 0;
+}
+
+const char *index_texte_ligne(const index_texte_t *index, int ligne,
+                              size_t *longueur) {
+  *longueur = index->debuts[ligne + 1] - index->debuts[ligne] - 1;
+  return index->texte + index->debuts[ligne];
+}
+
+const uint32_t *index_texte_trigramme(const index_texte_t *index,
+                                      const char *trigramme, int *nb) {
+  unsigned int s = seau_trigramme((unsigned char)trigramme[0],
+                                  (unsigned char)trigramme[1],
+                                  (unsigned char)trigramme[2]);
+
+  *nb = (int)(index->seaux_trigrammes[s + 1] - index->seaux_trigrammes[s]);
+  return index->trigrammes + index->seaux_trigrammes[s];
+}
+
+const uint32_t *index_texte_prefixe(const index_texte_t *index,
+                                    const char *prefixe, int *nb) {
+  unsigned int s =
+      seau_prefixe((unsigned char)prefixe[0], (unsigned char)prefixe[1]);
+
+  *nb = (int)(index->seaux_prefixes[s + 1] - index->seaux_prefixes[s]);
+  return index->prefixes + index->seaux_prefixes[s];
+}
@@ -0,0 +1,118 @@
+/**
+ * @file index_texte.h
+ * @brief Index de recherche d'un instantané de processus
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Chaque ligne indexée est le texte « pid\nutilisateur\ncommande\nligne de
+ * commande » en minuscules, stocké dans un tampon unique. Deux tables
+ * d'entrées (listes de lignes croissantes, rangées contiguës) réduisent une
+ * recherche à quelques candidats, vérifiés ensuite sur leur texte :
+ *  - trigrammes : un seau par trigramme haché (les collisions ne donnent
+ *    que des candidats en trop) ;
+ *  - préfixes : un seau par couple des deux premiers caractères d'un champ.
+ *
+ * L'index est construit par le thread de la source, avec la collecte qu'il
+ * décrit : l'interface filtre sans relire ni reformater les lignes.
+ */
+
+#ifndef INDEX_TEXTE_H
+#define INDEX_TEXTE_H
+
+#include "process.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define INDEX_NB_SEAUX 65536 /* Trigrammes hachés, couples de préfixe */
+
+/**
+ * @brief Fournit la ligne de commande complète d'un processus, si la source
+ *        la connaît (NULL sinon).
+ */
+typedef const char *(*index_commande_fn)(void *donnees,
+                                         const processus_t *proc);
+
+/**
+ * @brief Index d'une liste de processus.
+ */
+typedef struct index_texte {
+  int valide;                  /* 0 : à reconstruire avant usage */
+  int nb;                      /* Lignes indexées (ordre de la liste) */
+
+  char *texte;                 /* Lignes en minuscules, terminées par '\0' */
+  size_t taille_texte;
+  size_t capacite_texte;
+  uint32_t *debuts;            /* Début de chaque ligne (nb + 1) */
+  int capacite_debuts;
+
+  uint32_t *seaux_trigrammes;  /* Début de chaque seau (INDEX_NB_SEAUX + 1) */
+  uint32_t *trigrammes;        /* Lignes de chaque seau */
+  size_t capacite_trigrammes;
+  uint32_t *seaux_prefixes;
+  uint32_t *prefixes;
+  size_t capacite_prefixes;
+
+  uint32_t *marques;           /* Dernière ligne vue par seau (construction) */
+} index_texte_t;
+
+/**
+ * @brief Initialise un index vide (aucune allocation).
+ * @param index : Index à initialiser.
+ */
+void index_texte_init(index_texte_t *index);
+
+/**
+ * @brief Libère les tableaux d'un index.
+ * @param index : Index à libérer.
+ */
+void index_texte_liberer(index_texte_t *index);
+
+/**
+ * @brief Marque l'index comme ne décrivant plus sa liste.
+ * @param index : Index concerné.
+ */
+void index_texte_invalider(index_texte_t *index);
+
+/**
+ * @brief Indexe une liste. Les noms d'utilisateur manquants (listes
+ *        locales) sont résolus au passage dans la liste.
+ * @param index : Index à (re)construire.
+ * @param liste : Liste des processus.
+ * @param commande : Source des lignes de commande (NULL : nom seul).
+ * @param donnees : Argument de 'commande'.
+ * @return int : 0 en cas de succès, -1 en cas d'erreur mémoire (index
+ *               invalide).
+ */
+int index_texte_construire(index_texte_t *index, processus_t *liste,
+                           index_commande_fn commande, void *donnees);
+
+/**
+ * @brief Texte indexé d'une ligne.
+ * @param index : Index valide.
+ * @param ligne : Numéro de la ligne (0 <= ligne < nb).
+ * @param longueur : Reçoit la longueur du texte (sans le '\0').
+ * @return const char* : Texte en minuscules.
+ */
+const char *index_texte_ligne(const index_texte_t *index, int ligne,
+                              size_t *longueur);
+
+/**
+ * @brief Lignes pouvant contenir un trigramme.
+ * @param index : Index valide.
+ * @param trigramme : Trois caractères en minuscules.
+ * @param nb : Reçoit le nombre de lignes.
+ * @return const uint32_t* : Lignes croissantes (sur-ensemble exact).
+ */
+const uint32_t *index_texte_trigramme(const index_texte_t *index,
+                                      const char *trigramme, int *nb);
+
+/**
+ * @brief Lignes dont un champ commence par deux caractères.
+ * @param index : Index valide.
+ * @param prefixe : Deux caractères en minuscules.
+ * @param nb : Reçoit le nombre de lignes.
+ * @return const uint32_t* : Lignes croissantes.
+ */
+const uint32_t *index_texte_prefixe(const index_texte_t *index,
+                                    const char *prefixe, int *nb);
+
+#endif /* INDEX_TEXTE_H */
@@ -7,7 +7,14 @@
  * commande. Supporte les modes local et réseau.
  */
 
+#define _DEFAULT_SOURCE
+
+#include "agent.h"
+#include "bench.h"
 #include "manager.h"
+#include "utilisateurs.h"
+#include <errno.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -29,6 +36,23 @@ void afficher_aide(void) {
   printf("  -h, --help                     Affiche cette aide\n");
   printf("  --dry-run                      Test l'acces aux processus sans "
          "affichage\n");
+  printf("  --bench [passes]               Mesure le cout de collecte par "
+         "processus\n");
+  printf("  --agent                        Agent de collecte (lance par "
+         "my_htop sur les hotes distants)\n");
+  printf("  -d, --delay <ms>               Periode de rafraichissement en "
+         "millisecondes (defaut: %d, %d-%d)\n",
+         BOUCLE_DELAI_DEFAUT_MS, BOUCLE_DELAI_MIN_MS, BOUCLE_DELAI_MAX_MS);
+  printf("  -j, --threads <n>              Threads de lecture de /proc "
+         "(defaut: coeurs en ligne, max %d)\n",
+         SCANNER_THREADS_DEFAUT_MAX);
+  printf("  --netlink                      Suivi des processus par le "
+         "connecteur proc (root)\n");
+  printf("  --uid-ttl <secondes>           Duree de vie du cache des noms "
+         "d'utilisateur (defaut: %d, 0 = illimite)\n",
+         UTILISATEURS_TTL_DEFAUT);
+  printf("  --sort <cle>[:asc|:desc]       Tri initial: cpu (defaut), mem, "
+         "time, pid, user ou aucun\n");
   printf("\n");
   printf("Mode local (par defaut):\n");
   printf("  Sans options, affiche les processus de la machine locale\n");
@@ -44,6 +68,18 @@ void afficher_aide(void) {
       "  -t, --connexion-type <type>    Type: ssh ou telnet (defaut: ssh)\n");
   printf("  -P, --port <port>              Port de connexion\n");
   printf("  -a, --all                      Affiche local + distant\n");
+  printf("  -b, --background <ms>          Periode des onglets en arriere-plan "
+         "(defaut: %d x la periode), doublee tant qu'ils sont stables\n",
+         CADENCE_FOND_FACTEUR);
+  printf("  --agent-cmd <commande>         Commande distante de l'agent "
+         "(defaut: \"%s\", \"\" = sans agent)\n",
+         AGENT_COMMANDE_DEFAUT);
+  printf("  --connect-timeout <secondes>   Delai de connexion SSH par hote "
+         "(defaut: %d)\n",
+         SSH_DELAI_CONNEXION_S);
+  printf("  --auth-timeout <secondes>      Delai d'authentification SSH "
+         "(defaut: %d)\n",
+         SSH_DELAI_AUTH_S);
   printf("\n");
   printf("Raccourcis clavier:\n");
   printf("  F1 ou h                        Afficher l'aide\n");
@@ -55,6 +91,8 @@ void afficher_aide(void) {
   printf("  F8 ou c                        Redemarrer/Reprendre (SIGCONT)\n");
   printf("  Fleches haut/bas               Navigation\n");
   printf("  Page Up/Down                   Navigation rapide\n");
+  printf("  < / >                          Colonne de tri precedente/suivante\n");
+  printf("  r ou R                         Inverser le sens du tri\n");
   printf("  q ou Q                         Quitter\n");
   printf("\n");
   printf("Note: Certaines actions necessitent des droits root (sudo)\n");
@@ -89,6 +127,18 @@ char *lire_mot_de_passe(const char *prompt) {
   return password;
 }
 
+/**
+ * @brief Affiche les compteurs du cache des noms d'utilisateur.
+ */
+void afficher_stats_cache_utilisateurs(void) {
+  cache_utilisateurs_stats_t stats;
+
+  cache_utilisateurs_statistiques(&stats);
+  printf("Cache utilisateurs: %lu succes, %lu echecs, %lu invalidations, "
+         "%d entrees\n",
+         stats.succes, stats.echecs, stats.invalidations, stats.nb_entrees);
+}
+
 /**
  * @brief Mode dry-run : teste l'accès aux processus locaux et distants.
  */
@@ -106,6 +156,7 @@ int mode_dry_run(int has_network, network_config_t *config) {
   nb_processus = compter_processus(liste);
   printf("Succes: %d processus locaux detectes\n", nb_processus);
   liberer_liste_processus(liste);
+  afficher_stats_cache_utilisateurs();
 
   /* Test distant */
   if (has_network) {
@@ -113,19 +164,24 @@ int mode_dry_run(int has_network, network_config_t *config) {
       printf("\nTest connexion a %s (%s)...\n", config->hosts[i].nom,
              config->hosts[i].adresse);
       if (connect_ssh(&config->hosts[i]) != 0) {
-        fprintf(stderr, "ERREUR: Impossible de se connecter a %s\n",
-                config->hosts[i].nom);
+        fprintf(stderr, "ERREUR: Impossible de se connecter a %s (%s)\n",
+                config->hosts[i].nom, config->hosts[i].erreur);
         continue;
       }
 
       liste = get_remote_processes(&config->hosts[i]);
       if (liste == NULL) {
-        fprintf(stderr, "ERREUR: Impossible de recuperer les processus de %s\n",
-                config->hosts[i].nom);
+        fprintf(stderr,
+                "ERREUR: Impossible de recuperer les processus de %s (%s)\n",
+                config->hosts[i].nom, config->hosts[i].erreur);
         disconnect_ssh(&config->hosts[i]);
         continue;
       }
 
+      if (config->hosts[i].erreur[0] != '\0') {
+        fprintf(stderr, "AVERTISSEMENT: %s: %s\n", config->hosts[i].nom,
+                config->hosts[i].erreur);
+      }
       nb_processus = compter_processus(liste);
       printf("Succes: %d processus detectes sur %s\n", nb_processus,
              config->hosts[i].nom);
@@ -143,7 +199,7 @@ int mode_dry_run(int has_network, network_config_t *config) {
 int main(int argc, char *argv[]) {
   manager_state_t manager_state;
   network_config_t network_config;
-  remote_host_t single_host;
+  remote_host_t *single_host = &network_config.hosts[0];
   int retour;
 
   /* Variables pour le parsing */
@@ -156,6 +212,15 @@ int main(int argc, char *argv[]) {
   int all_mode = 0;
   int is_dry_run = 0;
   int has_network = 0;
+  int nb_threads = 0;
+  int delai_ms = 0;
+  int delai_fond_ms = 0;
+  int use_netlink = 0;
+  const char *commande_agent = NULL;
+  int delai_connexion_s = 0;
+  int delai_auth_s = 0;
+  tri_cle_t tri_cle = TRI_CPU;
+  int tri_decroissant = tri_decroissant_defaut(TRI_CPU);
 
   /* Parsing des arguments */
   for (int i = 1; i < argc; i++) {
@@ -164,6 +229,123 @@ int main(int argc, char *argv[]) {
       return EXIT_SUCCESS;
     } else if (strcmp(argv[i], "--dry-run") == 0) {
       is_dry_run = 1;
+    } else if (strcmp(argv[i], "--bench") == 0) {
+      int passes = 5;
+      if (i + 1 < argc && argv[i + 1][0] != '-') {
+        passes = atoi(argv[++i]);
+        if (passes <= 0) {
+          fprintf(stderr, "ERREUR: Nombre de passes invalide: %s\n", argv[i]);
+          return EXIT_FAILURE;
+        }
+      }
+      return bench_executer(passes);
+    } else if (strcmp(argv[i], "--agent") == 0) {
+      return agent_executer();
+    } else if (strcmp(argv[i], "--agent-cmd") == 0) {
+      if (i + 1 < argc) {
+        commande_agent = argv[++i];
+        if (strlen(commande_agent) >= MAX_COMMANDE_AGENT) {
+          fprintf(stderr, "ERREUR: Commande d'agent trop longue\n");
+          return EXIT_FAILURE;
+        }
+      } else {
+        fprintf(stderr, "ERREUR: %s requiert un argument\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    } else if (strcmp(argv[i], "--connect-timeout") == 0 ||
+               strcmp(argv[i], "--auth-timeout") == 0) {
+      if (i + 1 < argc) {
+        int delai = atoi(argv[i + 1]);
+        if (delai <= 0) {
+          fprintf(stderr, "ERREUR: Delai invalide: %s\n", argv[i + 1]);
+          return EXIT_FAILURE;
+        }
+        if (strcmp(argv[i], "--connect-timeout") == 0) {
+          delai_connexion_s = delai;
+        } else {
+          delai_auth_s = delai;
+        }
+        i++;
+      } else {
+        fprintf(stderr, "ERREUR: %s requiert un argument\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    } else if (strcmp(argv[i], "-d") == 0 ||
+               strcmp(argv[i], "--delay") == 0) {
+      if (i + 1 < argc) {
+        delai_ms = atoi(argv[++i]);
+        if (delai_ms < BOUCLE_DELAI_MIN_MS || delai_ms > BOUCLE_DELAI_MAX_MS) {
+          fprintf(stderr, "ERREUR: Delai invalide: %s (%d-%d ms)\n", argv[i],
+                  BOUCLE_DELAI_MIN_MS, BOUCLE_DELAI_MAX_MS);
+          return EXIT_FAILURE;
+        }
+      } else {
+        fprintf(stderr, "ERREUR: %s requiert un argument\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    } else if (strcmp(argv[i], "-b") == 0 ||
+               strcmp(argv[i], "--background") == 0) {
+      if (i + 1 < argc) {
+        delai_fond_ms = atoi(argv[++i]);
+        if (delai_fond_ms < BOUCLE_DELAI_MIN_MS ||
+            delai_fond_ms > BOUCLE_DELAI_MAX_MS) {
+          fprintf(stderr, "ERREUR: Delai invalide: %s (%d-%d ms)\n", argv[i],
+                  BOUCLE_DELAI_MIN_MS, BOUCLE_DELAI_MAX_MS);
+          return EXIT_FAILURE;
+        }
+      } else {
+        fprintf(stderr, "ERREUR: %s requiert un argument\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    } else if (strcmp(argv[i], "-j") == 0 ||
+               strcmp(argv[i], "--threads") == 0) {
+      if (i + 1 < argc) {
+        nb_threads = atoi(argv[++i]);
+        if (nb_threads <= 0 || nb_threads > SCANNER_MAX_THREADS) {
+          fprintf(stderr, "ERREUR: Nombre de threads invalide: %s (1-%d)\n",
+                  argv[i], SCANNER_MAX_THREADS);
+          return EXIT_FAILURE;
+        }
+      } else {
+        fprintf(stderr, "ERREUR: %s requiert un argument\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    } else if (strcmp(argv[i], "--netlink") == 0) {
+      use_netlink = 1;
+    } else if (strcmp(argv[i], "--uid-ttl") == 0) {
+      if (i + 1 < argc) {
+        int ttl = atoi(argv[++i]);
+        if (ttl < 0) {
+          fprintf(stderr, "ERREUR: Duree invalide: %s\n", argv[i]);
+          return EXIT_FAILURE;
+        }
+        cache_utilisateurs_configurer_ttl(ttl);
+      } else {
+        fprintf(stderr, "ERREUR: %s requiert un argument\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    } else if (strcmp(argv[i], "--sort") == 0) {
+      if (i + 1 < argc) {
+        char nom[32];
+        char *sens;
+        strncpy(nom, argv[++i], sizeof(nom) - 1);
+        nom[sizeof(nom) - 1] = '\0';
+        sens = strchr(nom, ':');
+        if (sens != NULL) {
+          *sens++ = '\0';
+        }
+        if (tri_cle_depuis_nom(nom, &tri_cle) != 0 ||
+            (sens != NULL && strcmp(sens, "asc") != 0 &&
+             strcmp(sens, "desc") != 0)) {
+          fprintf(stderr, "ERREUR: Tri invalide: %s\n", argv[i]);
+          return EXIT_FAILURE;
+        }
+        tri_decroissant = sens != NULL ? strcmp(sens, "desc") == 0
+                                       : tri_decroissant_defaut(tri_cle);
+      } else {
+        fprintf(stderr, "ERREUR: %s requiert un argument\n", argv[i]);
+        return EXIT_FAILURE;
+      }
     } else if (strcmp(argv[i], "-c") == 0 ||
                strcmp(argv[i], "--remote-config") == 0) {
       if (i + 1 < argc) {
@@ -253,6 +435,9 @@ int main(int argc, char *argv[]) {
   /* Configuration réseau */
   init_network_config(&network_config);
 
+  /* Canal ou connexion coupés : l'écriture échoue au lieu de tuer my_htop */
+  signal(SIGPIPE, SIG_IGN);
+
   if (config_file != NULL) {
     /* Mode fichier de configuration */
     check_config_file_permissions(config_file);
@@ -262,13 +447,14 @@ int main(int argc, char *argv[]) {
     has_network = 1;
   } else if (remote_server != NULL) {
     /* Mode serveur unique */
-    strncpy(single_host.nom, remote_server, MAX_HOSTNAME_LEN - 1);
-    single_host.nom[MAX_HOSTNAME_LEN - 1] = '\0';
-    strncpy(single_host.adresse, remote_server, MAX_HOSTNAME_LEN - 1);
-    single_host.adresse[MAX_HOSTNAME_LEN - 1] = '\0';
-    single_host.port = (port > 0) ? port : DEFAULT_SSH_PORT;
-    single_host.type = conn_type;
-    single_host.session = NULL;
+    strncpy(single_host->nom, remote_server, MAX_HOSTNAME_LEN - 1);
+    single_host->nom[MAX_HOSTNAME_LEN - 1] = '\0';
+    strncpy(single_host->adresse, remote_server, MAX_HOSTNAME_LEN - 1);
+    single_host->adresse[MAX_HOSTNAME_LEN - 1] = '\0';
+    single_host->port = (port > 0) ? port : DEFAULT_SSH_PORT;
+    single_host->type = conn_type;
+    single_host->periode_ms = 0;
+    init_remote_host(single_host);
 
     /* Demander username si manquant */
     if (username == NULL) {
@@ -278,21 +464,41 @@ int main(int argc, char *argv[]) {
       user_buffer[strcspn(user_buffer, "\n")] = '\0';
       username = user_buffer;
     }
-    strncpy(single_host.username, username, MAX_USERNAME_LEN - 1);
-    single_host.username[MAX_USERNAME_LEN - 1] = '\0';
+    strncpy(single_host->username, username, MAX_USERNAME_LEN - 1);
+    single_host->username[MAX_USERNAME_LEN - 1] = '\0';
 
     /* Demander password si manquant */
     if (password == NULL) {
       password = lire_mot_de_passe("Mot de passe: ");
     }
-    strncpy(single_host.password, password, MAX_PASSWORD_LEN - 1);
-    single_host.password[MAX_PASSWORD_LEN - 1] = '\0';
+    strncpy(single_host->password, password, MAX_PASSWORD_LEN - 1);
+    single_host->password[MAX_PASSWORD_LEN - 1] = '\0';
 
-    network_config.hosts[0] = single_host;
     network_config.nb_hosts = 1;
     has_network = 1;
   }
 
+  /* Commande de l'agent et délais : les mêmes pour tous les hôtes */
+  for (int i = 0; i < network_config.nb_hosts; i++) {
+    if (commande_agent != NULL) {
+      snprintf(network_config.hosts[i].commande_agent,
+               sizeof(network_config.hosts[i].commande_agent), "%s",
+               commande_agent);
+    }
+    if (delai_connexion_s > 0) {
+      network_config.hosts[i].delai_connexion_s = delai_connexion_s;
+    }
+    if (delai_auth_s > 0) {
+      network_config.hosts[i].delai_auth_s = delai_auth_s;
+    }
+  }
+
+  /* Avant les connexions, établies en parallèle par les threads des hôtes */
+  if (has_network && ssh_init() != SSH_OK) {
+    fprintf(stderr, "ERREUR: Initialisation de libssh impossible\n");
+    return EXIT_FAILURE;
+  }
+
   /* Mode dry-run */
   if (is_dry_run) {
     return mode_dry_run(has_network, &network_config);
@@ -300,6 +506,18 @@ int main(int argc, char *argv[]) {
 
   /* Lancement du programme */
   manager_init(&manager_state);
+  scanner_configurer_threads(&manager_state.locale.scanner, nb_threads);
+  if (delai_ms > 0) {
+    manager_state.delai_ms = delai_ms;
+  }
+  manager_state.delai_fond_ms = delai_fond_ms;
+  tri_configurer(&manager_state.tri, tri_cle, tri_decroissant);
+  if (use_netlink && manager_activer_connecteur(&manager_state) != 0) {
+    fprintf(stderr,
+            "AVERTISSEMENT: Connecteur proc indisponible (%s), "
+            "parcours periodique de /proc\n",
+            strerror(errno));
+  }
 
   if (has_network) {
     retour = manager_run_network(&manager_state, &network_config,
@@ -309,12 +527,26 @@ int main(int argc, char *argv[]) {
   }
 
   manager_cleanup(&manager_state);
+  if (has_network) {
+    ssh_finalize();
+  }
 
   /* Message de fin */
   printf("\n========================================\n");
   printf("  MY_HTOP termine proprement\n");
   printf("  Cycles d'actualisation: %d\n", manager_state.cycles);
+  printf("  ");
+  afficher_stats_cache_utilisateurs();
+  if (use_netlink) {
+    const connecteur_t *connecteur = &manager_state.locale.connecteur;
+    printf("  Connecteur proc: %lu evenements, %lu ephemeres, "
+           "%lu reconciliations\n",
+           connecteur->total_evenements, connecteur->total_ephemeres,
+           connecteur->nb_reconciliations);
+  }
   printf("========================================\n\n");
 
+  cache_utilisateurs_liberer();
+
   return retour;
 }
\ No newline at end of file
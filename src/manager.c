@@ -16,45 +16,1422 @@
 #include <time.h>
 #include <unistd.h>
 
+/* Fonctions privées */
+
+/**
+ * @brief Vue locale d'une liste (triée ou non), avec les threads des
+ *        processus dépliés en mode threads.
+ */
+static processus_t *publier_vue_locale(manager_state_t *state,
+                                       processus_t *liste) {
+  if (state->mode_threads) {
+    return taches_construire_vue(&state->taches_local, liste,
+                                 &state->snapshot_local);
+  }
+  /* La collecte appartient à l'interface jusqu'au prochain échange */
+  return liste;
+}
+
+/**
+ * @brief Relit smaps_rollup dans la limite du budget : ligne sélectionnée,
+ *        lignes visibles, puis les autres processus à tour de rôle.
+ */
+static void mesurer_memoire(manager_state_t *state, processus_t *liste) {
+  memoire_rafraichir(
+      &state->memoire_local, liste,
+      get_processus_at_index(liste, state->ui_state.selected_index),
+      get_processus_at_index(liste, state->ui_state.scroll_offset),
+      ui_nb_lignes_visibles());
+}
+
+/**
+ * @brief PID du processus sélectionné dans l'onglet affiché (processus
+ *        d'appartenance pour une ligne de thread), 0 si aucun.
+ */
+static pid_t pid_selectionne(manager_state_t *state) {
+  processus_t *selection = get_processus_at_index(
+      state->machines[state->machine_courante].liste_processus,
+      state->ui_state.selected_index);
+
+  if (selection == NULL) {
+    return 0;
+  }
+  return selection->est_thread ? selection->tgid : selection->pid;
+}
+
+/**
+ * @brief Date de démarrage d'un processus (hors lignes de threads) de la
+ *        dernière collecte d'une machine.
+ * @return unsigned long long : Sa date, ou 0 s'il n'y figure plus.
+ */
+static unsigned long long date_demarrage(const machine_info_t *machine,
+                                         pid_t pid) {
+  for (const processus_t *p = machine->liste_brute; p != NULL;
+       p = p->suivant) {
+    if (p->pid == pid && !p->est_thread) {
+      return p->starttime;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Sélectionne la ligne du processus 'pid' (hors lignes de threads)
+ *        dans l'onglet affiché, à la même hauteur d'écran.
+ */
+static void selectionner_pid(manager_state_t *state, pid_t pid) {
+  processus_t *liste = state->machines[state->machine_courante].liste_processus;
+  int ecart = state->ui_state.selected_index - state->ui_state.scroll_offset;
+  int index = 0;
+
+  for (processus_t *p = liste; p != NULL; p = p->suivant) {
+    if (p->pid == pid && !p->est_thread) {
+      state->ui_state.selected_index = index;
+      state->ui_state.scroll_offset = index - ecart > 0 ? index - ecart : 0;
+      return;
+    }
+    index++;
+  }
+}
+
+/**
+ * @brief Vue arborescente de l'onglet affiché ; avec un filtre, seules
+ *        les correspondances restent, à leur place dans l'arbre.
+ */
+static processus_t *publier_vue_arbre(manager_state_t *state,
+                                      machine_info_t *machine) {
+  const uint32_t *retenues = NULL;
+  int nb = 0;
+
+  if (machine->liste_brute == NULL) {
+    return NULL;
+  }
+  if (state->filtre.actif) {
+    nb = filtre_chercher(&state->filtre, machine->liste_brute, machine->index);
+    if (nb >= 0) {
+      retenues = state->filtre.resultats;
+      machine->nb_trouves = nb;
+    }
+  }
+  return arbre_construire_vue(&state->arbre, machine->liste_brute, retenues,
+                              nb, &state->snapshot_arbre);
+}
+
+/**
+ * @brief Publie la vue d'une machine : filtrée puis triée si son onglet
+ *        est affiché (les lignes visibles, et celles jusqu'au processus
+ *        suivi, dans l'ordre complet), ou arborescente en mode arbre,
+ *        threads dépliés pour la machine locale. La sélection
+ *        suit 'suivi' (0 : sélection inchangée).
+ */
+static void publier_vue(manager_state_t *state, int index, pid_t suivi) {
+  machine_info_t *machine = &state->machines[index];
+  processus_t *vue = machine->liste_brute;
+  int courante = index == state->machine_courante;
+  int arbre = courante && state->mode_arbre;
+
+  /* Filtre : vue de l'onglet affiché, simple décompte pour les autres en
+     recherche sur toutes les machines */
+  machine->nb_trouves = -1;
+  if (arbre) {
+    vue = publier_vue_arbre(state, machine);
+  } else if (state->filtre.actif && vue != NULL) {
+    if (courante) {
+      vue = filtre_appliquer(&state->filtre, vue, machine->index,
+                             &state->snapshot_filtre, &machine->nb_trouves);
+    } else if (state->filtre.toutes_machines) {
+      machine->nb_trouves =
+          filtre_chercher(&state->filtre, vue, machine->index);
+    }
+  }
+
+  if (courante && !arbre && vue != NULL) {
+    int nb_visibles = ui_nb_lignes_visibles();
+    int nb_min = state->ui_state.scroll_offset + nb_visibles;
+    int rang = suivi > 0 ? tri_rang(&state->tri, vue, suivi) : -1;
+
+    if (rang >= 0 && rang + nb_visibles > nb_min) {
+      nb_min = rang + nb_visibles;
+    }
+    vue = tri_appliquer(&state->tri, vue, nb_min, &state->snapshot_tri);
+  }
+
+  if (machine->is_local) {
+    vue = publier_vue_locale(state, vue);
+    state->liste_processus = vue;
+  }
+  machine->liste_processus = vue;
+
+  if (courante && suivi > 0) {
+    selectionner_pid(state, suivi);
+  }
+}
+
+/**
+ * @brief Intègre la collecte de l'onglet affiché dans l'arbre ; quitte le
+ *        mode arbre si la mémoire manque.
+ */
+static void integrer_arbre(manager_state_t *state) {
+  machine_info_t *machine = &state->machines[state->machine_courante];
+
+  if (arbre_integrer(&state->arbre, machine->liste_brute) != 0) {
+    state->mode_arbre = 0;
+    state->ui_state.arbre = NULL;
+    ui_afficher_message(&state->ui_state,
+                        "ERREUR: Memoire insuffisante (vue arborescente)", 1);
+  }
+}
+
+/**
+ * @brief Active ou désactive la vue arborescente (mode threads quitté).
+ */
+static void basculer_mode_arbre(manager_state_t *state) {
+  pid_t pid = pid_selectionne(state);
+
+  state->mode_arbre = !state->mode_arbre;
+  if (state->mode_arbre) {
+    state->mode_threads = 0;
+    state->ui_state.taches = NULL;
+    state->ui_state.arbre = &state->arbre;
+    arbre_oublier(&state->arbre);
+    integrer_arbre(state);
+    if (state->mode_arbre) {
+      ui_afficher_message(&state->ui_state,
+                          "Vue arborescente active (+/- : deplier/replier)",
+                          0);
+    }
+  } else {
+    state->ui_state.arbre = NULL;
+    tri_oublier(&state->tri);
+    ui_afficher_message(&state->ui_state, "Vue arborescente desactivee", 0);
+  }
+
+  publier_vue(state, state->machine_courante, pid);
+}
+
+/**
+ * @brief Active ou désactive le mode threads (vue locale, vue
+ *        arborescente quittée).
+ */
+static void basculer_mode_threads(manager_state_t *state) {
+  pid_t pid = pid_selectionne(state);
+
+  state->mode_threads = !state->mode_threads;
+  if (state->mode_threads) {
+    state->mode_arbre = 0;
+    state->ui_state.arbre = NULL;
+    taches_rafraichir(&state->taches_local, state->liste_collectee,
+                      state->ui_state.cpu != NULL ? state->ui_state.cpu->nb_coeurs
+                                                  : 1);
+    state->ui_state.taches = &state->taches_local;
+    ui_afficher_message(&state->ui_state,
+                        "Mode threads active (+/- : deplier/replier)", 0);
+  } else {
+    state->ui_state.taches = NULL;
+    ui_afficher_message(&state->ui_state, "Mode threads desactive", 0);
+  }
+
+  publier_vue(state, state->machine_courante, pid);
+}
+
+/**
+ * @brief Affiche ou masque les colonnes PSS/USS/SWAP (vue locale).
+ */
+static void basculer_mode_memoire(manager_state_t *state) {
+  if (state->memoire_local.lecteur.proc_fd < 0) {
+    ui_afficher_message(&state->ui_state, "ERREUR: /proc inaccessible", 1);
+    return;
+  }
+
+  state->mode_memoire = !state->mode_memoire;
+  if (state->mode_memoire) {
+    mesurer_memoire(state, state->liste_processus);
+    state->ui_state.memoire = &state->memoire_local;
+    ui_afficher_message(&state->ui_state,
+                        "Colonnes PSS/USS/SWAP actives (* : mesure ancienne)",
+                        0);
+  } else {
+    state->ui_state.memoire = NULL;
+    ui_afficher_message(&state->ui_state, "Colonnes PSS/USS/SWAP masquees", 0);
+  }
+}
+
+/**
+ * @brief Déplie ou replie les threads du processus sélectionné, ou son
+ *        sous-arbre en mode arbre.
+ */
+static void deplier_selection(manager_state_t *state, int deplie) {
+  processus_t *selection = get_processus_at_index(
+      state->machines[state->machine_courante].liste_processus,
+      state->ui_state.selected_index);
+
+  if (state->mode_arbre) {
+    if (selection == NULL) {
+      return;
+    }
+    if (arbre_replier(&state->arbre, selection->pid, !deplie) != 0) {
+      ui_afficher_message(&state->ui_state, "Processus sans enfant", 1);
+      return;
+    }
+    publier_vue(state, state->machine_courante, selection->pid);
+    return;
+  }
+  if (!state->mode_threads) {
+    ui_afficher_message(&state->ui_state, "Mode threads inactif (touche t)", 1);
+    return;
+  }
+  if (selection == NULL) {
+    return;
+  }
+
+  pid_t pid = selection->tgid;
+  if (taches_deplier(&state->taches_local, selection, deplie) != 0) {
+    ui_afficher_message(&state->ui_state, "Processus mono-thread", 1);
+    return;
+  }
+
+  publier_vue(state, state->machine_courante, pid);
+}
+
+/**
+ * @brief Charge les niveaux coûteux (propriétaire, ligne de commande,
+ *        status) des seules lignes locales visibles.
+ */
+static void charger_lignes_visibles(manager_state_t *state,
+                                    processus_t *liste) {
+  int nb_visibles = ui_nb_lignes_visibles();
+
+  if (state->ui_state.details == NULL || nb_visibles <= 0) {
+    return;
+  }
+  details_charger_plage(&state->details_local, liste,
+                        state->ui_state.scroll_offset, nb_visibles,
+                        DETAILS_TOUS);
+
+  /* Lignes apparues par défilement depuis le dernier rafraîchissement */
+  if (state->ui_state.memoire != NULL) {
+    memoire_completer(
+        &state->memoire_local,
+        get_processus_at_index(liste, state->ui_state.scroll_offset),
+        nb_visibles);
+  }
+}
+
+
+/**
+ * @brief Attente maximale avant que le message affiché n'expire (-1 : aucun).
+ */
+static int attente_message_ms(const ui_state_t *ui) {
+  if (ui->message_buffer[0] == '\0') {
+    return -1;
+  }
+
+  time_t reste = ui->message_time + MESSAGE_DISPLAY_DURATION - time(NULL);
+  return reste > 0 ? (int)reste * 1000 : 0;
+}
+
+/**
+ * @brief Applique côté interface la génération locale d'une collecte :
+ *        bilan, threads et champs coûteux.
+ */
+static void appliquer_collecte_locale(manager_state_t *state,
+                                      const collecte_t *collecte) {
+  state->ui_state.nb_ajoutes = collecte->nb_ajoutes;
+  state->ui_state.nb_termines = collecte->nb_termines;
+  state->ui_state.nb_modifies = collecte->nb_modifies;
+  state->ui_state.nb_ephemeres = collecte->nb_ephemeres;
+  state->ui_state.cpu = &collecte->cpu;
+  state->ui_state.instant_collecte_ms = collecte->instant_ms;
+  state->liste_collectee = collecte->liste;
+
+  if (state->mode_threads) {
+    taches_rafraichir(&state->taches_local, collecte->liste,
+                      collecte->cpu.nb_coeurs);
+  }
+
+  /* Les champs coûteux chargés pour la génération précédente sont périmés */
+  details_nouvelle_generation(&state->details_local);
+}
+
+static unsigned int hacher_pid(pid_t pid, int taille) {
+  return ((unsigned int)pid * 2654435761u) & (unsigned int)(taille - 1);
+}
+
+/**
+ * @brief Insère un PID dans une table de hachage de PID.
+ * @return int : 1 si le PID est ajouté, 0 s'il y était déjà.
+ */
+static int inserer_pid(pid_t *table, int taille, pid_t pid) {
+  unsigned int masque = (unsigned int)(taille - 1);
+  unsigned int i = hacher_pid(pid, taille);
+
+  while (table[i] != 0) {
+    if (table[i] == pid) {
+      return 0;
+    }
+    i = (i + 1) & masque;
+  }
+  table[i] = pid;
+  return 1;
+}
+
+static int contient_pid(const pid_t *table, int taille, pid_t pid) {
+  unsigned int masque = (unsigned int)(taille - 1);
+  unsigned int i = hacher_pid(pid, taille);
+
+  while (table[i] != 0) {
+    if (table[i] == pid) {
+      return 1;
+    }
+    i = (i + 1) & masque;
+  }
+  return 0;
+}
+
+/**
+ * @brief Agrandit les deux tables de PID pour 'nb' processus ; les PID de
+ *        la collecte précédente sont réinsérés.
+ * @return int : 0 en cas de succès, -1 si la mémoire manque.
+ */
+static int agrandir_pids(machine_info_t *machine, int nb) {
+  int taille = machine->taille_pids ? machine->taille_pids : 1024;
+  pid_t *anciens = machine->pids;
+  pid_t *pids, *courants;
+
+  while (nb * 2 > taille) {
+    taille *= 2;
+  }
+  pids = calloc((size_t)taille, sizeof(pid_t));
+  courants = malloc((size_t)taille * sizeof(pid_t));
+  if (pids == NULL || courants == NULL) {
+    free(pids);
+    free(courants);
+    return -1;
+  }
+  for (int i = 0; i < machine->taille_pids; i++) {
+    if (anciens[i] != 0) {
+      inserer_pid(pids, taille, anciens[i]);
+    }
+  }
+  free(anciens);
+  free(machine->pids_courants);
+  machine->pids = pids;
+  machine->pids_courants = courants;
+  machine->taille_pids = taille;
+  return 0;
+}
+
+/**
+ * @brief Compte les PID apparus ou disparus depuis la collecte précédente
+ *        de la machine. La source locale les donne déjà (bilan de la
+ *        table) ; pour une source distante, les PID de 'liste' sont
+ *        mémorisés dans une table de hachage réutilisée d'une collecte à
+ *        l'autre (ni allocation ni tri tant que le nombre de processus ne
+ *        dépasse pas sa capacité).
+ * @return int : Nombre de changements (-1 si la mémoire manque).
+ */
+static int compter_changements(machine_info_t *machine,
+                               const collecte_t *collecte) {
+  int nb = 0;
+  int apparus = 0;
+  pid_t *echange;
+
+  if (source_peut(&machine->source, SOURCE_CAP_BILAN)) {
+    return collecte->nb_ajoutes + collecte->nb_termines;
+  }
+
+  for (const processus_t *p = collecte->liste; p != NULL; p = p->suivant) {
+    nb++;
+  }
+  if (nb * 2 > machine->taille_pids && agrandir_pids(machine, nb) != 0) {
+    return -1;
+  }
+
+  memset(machine->pids_courants, 0,
+         (size_t)machine->taille_pids * sizeof(pid_t));
+  nb = 0;
+  for (const processus_t *p = collecte->liste; p != NULL; p = p->suivant) {
+    if (p->pid > 0 &&
+        inserer_pid(machine->pids_courants, machine->taille_pids, p->pid)) {
+      nb++;
+      apparus += !contient_pid(machine->pids, machine->taille_pids, p->pid);
+    }
+  }
+
+  /* Disparus : PID précédents absents de la collecte */
+  int disparus = machine->nb_pids - (nb - apparus);
+
+  echange = machine->pids;
+  machine->pids = machine->pids_courants;
+  machine->pids_courants = echange;
+  machine->nb_pids = nb;
+  return apparus + disparus;
+}
+
+/**
+ * @brief Période de collecte voulue pour une machine : la sienne si son
+ *        onglet est affiché, sinon la période de fond, doublée à chaque
+ *        collecte sans changement de ses processus (jusqu'à
+ *        CADENCE_FOND_PALIERS fois). Un hôte non connecté garde sa
+ *        période : ses essais suivent leur propre attente.
+ */
+static int cadence_machine(const manager_state_t *state, int index) {
+  const machine_info_t *machine = &state->machines[index];
+  long long periode;
+  int paliers;
+
+  if (index == state->machine_courante ||
+      machine->connexion != CONNEXION_ETABLIE) {
+    return machine->periode_ms;
+  }
+
+  periode = state->delai_fond_ms > 0
+                ? state->delai_fond_ms
+                : (long long)machine->periode_ms * CADENCE_FOND_FACTEUR;
+  if (periode < machine->periode_ms) {
+    periode = machine->periode_ms;
+  }
+  paliers = machine->nb_stables < CADENCE_FOND_PALIERS
+                ? machine->nb_stables
+                : CADENCE_FOND_PALIERS;
+  periode <<= paliers;
+  return periode < BOUCLE_DELAI_MAX_MS ? (int)periode : BOUCLE_DELAI_MAX_MS;
+}
+
+/**
+ * @brief Applique au collecteur la période voulue pour une machine.
+ */
+static void ajuster_cadence(manager_state_t *state, int index) {
+  collecteur_changer_periode(&state->collecteur, state->machines[index].poste,
+                             cadence_machine(state, index));
+}
+
+/**
+ * @brief Retient le premier échec d'un envoi (ou l'erreur du processus
+ *        unique).
+ */
+static void noter_echec(envoi_signaux_t *envoi, int machine, pid_t pid,
+                        int erreur) {
+  if (envoi->erreur == 0) {
+    envoi->pid = pid;
+    envoi->erreur = erreur;
+    envoi->machine = machine;
+  }
+}
+
+/**
+ * @brief Affiche le bilan d'un envoi dont tous les lots sont revenus.
+ */
+static void afficher_bilan_envoi(manager_state_t *state) {
+  const envoi_signaux_t *envoi = &state->envoi;
+  char prefixe[MAX_HOSTNAME_LEN + 3] = "";
+  char msg[256];
+  size_t n;
+
+  if (state->vue_reseau && envoi->pid != 0) {
+    snprintf(prefixe, sizeof(prefixe), "[%s] ",
+             state->machines[envoi->machine].nom);
+  }
+
+  /* Processus sélectionné : un message par issue */
+  if (envoi->nom[0] != '\0') {
+    if (envoi->erreur == 0) {
+      n = (size_t)snprintf(msg, sizeof(msg), "%sPID %d (%s) %s", prefixe,
+                           envoi->pid, envoi->nom, envoi->libelle);
+      if (envoi->portee != PORTEE_PROCESSUS && n < sizeof(msg)) {
+        snprintf(msg + n, sizeof(msg) - n, " | %s : %d processus",
+                 portee_signal_nom(envoi->portee), envoi->nb_atteints);
+      }
+      ui_afficher_message(&state->ui_state, msg, 0);
+      return;
+    }
+    if (envoi->erreur == EPERM) {
+      snprintf(msg, sizeof(msg),
+               "ERREUR: %sPermission refusee pour PID %d. Utilisez sudo",
+               prefixe, envoi->pid);
+    } else if (envoi->erreur == ESRCH) {
+      snprintf(msg, sizeof(msg), "ERREUR: %sLe processus %d n'existe plus",
+               prefixe, envoi->pid);
+    } else if (envoi->erreur == EINVAL &&
+               envoi->portee != PORTEE_PROCESSUS) {
+      snprintf(msg, sizeof(msg),
+               "ERREUR: %sPortee %s indisponible pour PID %d", prefixe,
+               portee_signal_nom(envoi->portee), envoi->pid);
+    } else {
+      snprintf(msg, sizeof(msg),
+               "ERREUR: %sEchec signal vers PID %d (errno: %d)", prefixe,
+               envoi->pid, envoi->erreur);
+    }
+    ui_afficher_message(&state->ui_state, msg, 1);
+    return;
+  }
+
+  /* Processus marqués : décompte de chaque issue, premier échec */
+  n = (size_t)snprintf(msg, sizeof(msg), "%d/%d processus %s",
+                       envoi->nb_envoyes, envoi->nb_processus,
+                       envoi->libelle);
+  if (state->vue_reseau && n < sizeof(msg)) {
+    n += (size_t)snprintf(msg + n, sizeof(msg) - n, " (%d machine(s))",
+                          envoi->nb_machines);
+  }
+  if (envoi->portee != PORTEE_PROCESSUS && n < sizeof(msg)) {
+    n += (size_t)snprintf(msg + n, sizeof(msg) - n, " | %s : %d processus",
+                          portee_signal_nom(envoi->portee),
+                          envoi->nb_atteints);
+  }
+  if (envoi->nb_absents > 0 && n < sizeof(msg)) {
+    n += (size_t)snprintf(msg + n, sizeof(msg) - n, " | %d disparus",
+                          envoi->nb_absents);
+  }
+  if (envoi->nb_refuses > 0 && n < sizeof(msg)) {
+    n += (size_t)snprintf(msg + n, sizeof(msg) - n, " | %d refuses (sudo)",
+                          envoi->nb_refuses);
+  }
+  if (envoi->nb_echecs > 0 && n < sizeof(msg)) {
+    n += (size_t)snprintf(msg + n, sizeof(msg) - n, " | %d non envoyes",
+                          envoi->nb_echecs);
+  }
+  if (envoi->pid != 0 && n < sizeof(msg)) {
+    snprintf(msg + n, sizeof(msg) - n, " | 1er echec: %sPID %d", prefixe,
+             envoi->pid);
+  }
+  ui_afficher_message(&state->ui_state, msg,
+                      envoi->nb_refuses + envoi->nb_echecs > 0);
+}
+
+/**
+ * @brief Confie à une machine le lot de l'envoi en cours, avec la date de
+ *        démarrage relevée pour chaque PID (au marquage, ou sur la ligne
+ *        sélectionnée) : un PID réutilisé depuis sera refusé par la source.
+ * @return int : 0 si le lot est parti, -1 sinon (compté en échec).
+ */
+static int confier_lot(manager_state_t *state, int index, const pid_t *pids,
+                       const unsigned long long *starttimes, int nb,
+                       int signal) {
+  machine_info_t *machine = &state->machines[index];
+  envoi_signaux_t *envoi = &state->envoi;
+  int erreur = 0;
+
+  envoi->nb_machines++;
+  envoi->nb_processus += nb;
+
+  /* Le lot d'un envoi précédent appartient encore au poste (hôte lent) */
+  if (machine->lot_en_vol) {
+    erreur = EBUSY;
+  } else if (lot_signaux_preparer(&machine->lot, pids, starttimes, nb,
+                                  signal, envoi->portee) != 0) {
+    erreur = ENOMEM;
+  } else if (collecteur_signaler(&state->collecteur, machine->poste,
+                                 &machine->lot) != 0) {
+    erreur = ENOTSUP;
+  }
+  if (erreur != 0) {
+    envoi->nb_echecs += nb;
+    noter_echec(envoi, index, pids[0], erreur);
+    return -1;
+  }
+
+  machine->lot_en_vol = 1;
+  machine->lot_envoi = envoi->numero;
+  envoi->nb_attendus++;
+  return 0;
+}
+
+/**
+ * @brief Relève le lot revenu d'une machine et l'ajoute au bilan de son
+ *        envoi, affiché quand tous les lots sont revenus.
+ */
+static void recevoir_lot(manager_state_t *state, int index) {
+  machine_info_t *machine = &state->machines[index];
+  envoi_signaux_t *envoi = &state->envoi;
+
+  if (!machine->lot_en_vol ||
+      !collecteur_lot_envoye(&state->collecteur, machine->poste)) {
+    return;
+  }
+  machine->lot_en_vol = 0;
+  if (machine->lot_envoi != envoi->numero) {
+    /* Envoi précédent : son bilan est déjà affiché */
+    return;
+  }
+
+  envoi->nb_atteints += machine->lot.nb_atteints;
+  for (int i = 0; i < machine->lot.nb; i++) {
+    int erreur = machine->lot.erreurs[i];
+
+    if (erreur == 0) {
+      envoi->nb_envoyes++;
+      continue;
+    }
+    if (erreur == ESRCH) {
+      envoi->nb_absents++;
+    } else if (erreur == EPERM) {
+      envoi->nb_refuses++;
+    } else {
+      envoi->nb_echecs++;
+    }
+    noter_echec(envoi, index, machine->lot.pids[i], erreur);
+  }
+
+  envoi->nb_attendus--;
+  if (envoi->nb_attendus == 0) {
+    afficher_bilan_envoi(state);
+  }
+}
+
+/**
+ * @brief Échange les tampons des sources qui ont publié et met à jour l'état
+ *        (âge, retard) de chaque machine.
+ * @return int : Nombre de machines dont la liste a changé.
+ */
+static int recevoir_collectes(manager_state_t *state) {
+  /* Avant l'échange : l'ancienne liste retourne au collecteur */
+  pid_t suivi = pid_selectionne(state);
+  int nb_nouvelles = 0;
+
+  collecteur_vider(&state->collecteur);
+  for (int i = 0; i < state->nb_machines; i++) {
+    machine_info_t *machine = &state->machines[i];
+    collecte_t *collecte = collecteur_recuperer(&state->collecteur,
+                                                machine->poste);
+
+    if (collecte != NULL) {
+      machine->liste_brute = collecte->liste;
+      machine->index = &collecte->index;
+      if (source_peut(&machine->source, SOURCE_CAP_BILAN)) {
+        appliquer_collecte_locale(state, collecte);
+      }
+      if (state->mode_arbre && i == state->machine_courante) {
+        integrer_arbre(state);
+      }
+      publier_vue(state, i, suivi);
+      if (machine->is_local && state->mode_memoire &&
+          state->liste_processus != NULL) {
+        mesurer_memoire(state, state->liste_processus);
+      }
+      machine->instant_ms = collecte->instant_ms;
+      nb_nouvelles++;
+
+      /* Un onglet en arrière-plan dont les processus ne changent pas
+         ralentit encore */
+      int changements = compter_changements(machine, collecte);
+      if (changements >= 0 && changements <= CADENCE_FOND_TOLERANCE) {
+        machine->nb_stables++;
+      } else {
+        machine->nb_stables = 0;
+      }
+      ajuster_cadence(state, i);
+
+      /* Un PID disparu ou réutilisé perd sa marque (âge distant à la
+         seconde près : même tolérance que pour le CPU) */
+      marques_elaguer(&machine->marques, collecte->liste,
+                      machine->is_local
+                          ? 0
+                          : machine->ssh.cpu.tolerance_starttime);
+    }
+    machine->perimee = collecteur_perime(&state->collecteur, machine->poste);
+    if (source_peut(&machine->source, SOURCE_CAP_CONNEXION)) {
+      etat_connexion_t avant = machine->connexion;
+      machine->connexion = get_connection_state(
+          machine->ssh.hote, &machine->reessai_ms, machine->erreur_connexion,
+          sizeof(machine->erreur_connexion));
+      if (machine->connexion != avant) {
+        ajuster_cadence(state, i);
+      }
+    }
+    recevoir_lot(state, i);
+  }
+  return nb_nouvelles;
+}
+
+/**
+ * @brief Indique si la vue courante permet une fonction réservée à /proc
+ *        local (threads, PSS/USS), et sinon l'explique.
+ */
+static int vue_procfs_disponible(manager_state_t *state) {
+  const machine_info_t *machine = &state->machines[state->machine_courante];
+
+  if (state->vue_reseau || !source_peut(&machine->source, SOURCE_CAP_PROCFS)) {
+    ui_afficher_message(&state->ui_state,
+                        "ERREUR: Disponible en mode local uniquement", 1);
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * @brief Fait indexer les collectes tant qu'un filtre est saisi ou actif.
+ *        À l'activation, l'onglet affiché (toutes les machines en
+ *        recherche globale) n'attend pas sa période pour arriver indexé,
+ *        lignes de commande comprises.
+ */
+static void suivre_indexation(manager_state_t *state) {
+  int indexer = state->filtre.actif || state->ui_state.saisie_filtre;
+
+  if (indexer == state->collecteur.indexer) {
+    return;
+  }
+  collecteur_indexer(&state->collecteur, indexer);
+  if (indexer) {
+    collecteur_demander(&state->collecteur,
+                        state->filtre.toutes_machines
+                            ? -1
+                            : state->machines[state->machine_courante].poste);
+  }
+}
+
+/**
+ * @brief Applique le filtre saisi : vue de l'onglet affiché et, en recherche
+ *        globale, décompte des autres. La sélection reste sur le même
+ *        processus s'il correspond encore, sinon revient en tête.
+ */
+static void appliquer_filtre(manager_state_t *state) {
+  pid_t pid = pid_selectionne(state);
+
+  if (filtre_definir(&state->filtre, state->ui_state.filtre_saisi,
+                     state->filtre.mode) != 0) {
+    ui_afficher_message(&state->ui_state, "Regex invalide", 1);
+  }
+  suivre_indexation(state);
+
+  for (int i = 0; i < state->nb_machines; i++) {
+    publier_vue(state, i, i == state->machine_courante ? pid : 0);
+  }
+  if (pid == 0 || pid_selectionne(state) != pid) {
+    state->ui_state.selected_index = 0;
+    state->ui_state.scroll_offset = 0;
+  }
+}
+
+/**
+ * @brief Commence (ou reprend) la saisie du filtre.
+ */
+static void commencer_recherche(manager_state_t *state) {
+  state->ui_state.saisie_filtre = 1;
+  snprintf(state->ui_state.filtre_saisi, sizeof(state->ui_state.filtre_saisi),
+           "%s", state->filtre.actif ? state->filtre.motif : "");
+  suivre_indexation(state);
+}
+
+/**
+ * @brief Passe au mode de correspondance suivant.
+ */
+static void changer_mode_filtre(manager_state_t *state) {
+  char msg[64];
+
+  state->filtre.mode = (filtre_mode_t)((state->filtre.mode + 1) %
+                                       FILTRE_NB_MODES);
+  appliquer_filtre(state);
+  snprintf(msg, sizeof(msg), "Filtre: mode %s",
+           filtre_nom_mode(state->filtre.mode));
+  ui_afficher_message(&state->ui_state, msg, 0);
+}
+
+/**
+ * @brief Bascule la recherche entre l'onglet affiché et toutes les
+ *        machines.
+ */
+static void changer_portee_filtre(manager_state_t *state) {
+  state->filtre.toutes_machines = !state->filtre.toutes_machines;
+  if (state->filtre.toutes_machines && state->collecteur.indexer) {
+    collecteur_demander(&state->collecteur, -1);
+  }
+  appliquer_filtre(state);
+  ui_afficher_message(&state->ui_state,
+                      state->filtre.toutes_machines
+                          ? "Filtre: toutes les machines"
+                          : "Filtre: machine affichee",
+                      0);
+}
+
+/**
+ * @brief Passe à la portée suivante des signaux (processus seul,
+ *        sous-arbre, groupe, session).
+ */
+static void changer_portee_signaux(manager_state_t *state) {
+  char msg[128];
+
+  state->portee_signaux =
+      (portee_signal_t)((state->portee_signaux + 1) % PORTEE_NB);
+  if (state->portee_signaux == PORTEE_PROCESSUS) {
+    snprintf(msg, sizeof(msg), "Portee des signaux: processus seul");
+  } else {
+    snprintf(msg, sizeof(msg),
+             "Portee des signaux: %s (gel, signal puis reprise)",
+             portee_signal_nom(state->portee_signaux));
+  }
+  ui_afficher_message(&state->ui_state, msg, 0);
+}
+
+/**
+ * @brief Passe à l'onglet suivant (sens = 1) ou précédent (sens = -1).
+ */
+static void changer_onglet(manager_state_t *state, int sens) {
+  int ancienne = state->machine_courante;
+  char msg[256];
+
+  if (!state->vue_reseau) {
+    return;
+  }
+  state->machine_courante =
+      (state->machine_courante + sens + state->nb_machines) %
+      state->nb_machines;
+  state->ui_state.machine_courante = state->machine_courante;
+  state->ui_state.selected_index = 0;
+
+  /* L'onglet quitté reprend l'ordre de sa source (la vue triée est
+     réutilisée), l'onglet affiché est trié depuis le début */
+  state->ui_state.scroll_offset = 0;
+  publier_vue(state, ancienne, 0);
+  tri_oublier(&state->tri);
+  if (state->mode_arbre) {
+    arbre_oublier(&state->arbre);
+    integrer_arbre(state);
+  }
+  publier_vue(state, state->machine_courante, 0);
+
+  /* L'onglet quitté passe à la cadence de fond, l'onglet affiché reprend
+     la sienne et se rafraîchit tout de suite */
+  ajuster_cadence(state, ancienne);
+  ajuster_cadence(state, state->machine_courante);
+  collecteur_demander(&state->collecteur,
+                      state->machines[state->machine_courante].poste);
+  snprintf(msg, sizeof(msg), "Machine: %s",
+           state->machines[state->machine_courante].nom);
+  ui_afficher_message(&state->ui_state, msg, 0);
+}
+
+/**
+ * @brief Change la colonne ou le sens du tri de l'onglet affiché, en
+ *        gardant la sélection sur le même processus.
+ */
+static void changer_tri(manager_state_t *state, tri_cle_t cle,
+                        int decroissant) {
+  pid_t pid = pid_selectionne(state);
+  char msg[256];
+
+  tri_configurer(&state->tri, cle, decroissant);
+  publier_vue(state, state->machine_courante, pid);
+
+  if (cle == TRI_AUCUN) {
+    snprintf(msg, sizeof(msg), "Tri: ordre de la source");
+  } else {
+    snprintf(msg, sizeof(msg), "Tri: %s (%s)", tri_nom_cle(cle),
+             decroissant ? "decroissant" : "croissant");
+  }
+  ui_afficher_message(&state->ui_state, msg, 0);
+}
+
+/**
+ * @brief Nombre de processus marqués sur toutes les machines.
+ */
+static int compter_marques(const manager_state_t *state) {
+  int nb = 0;
+
+  for (int i = 0; i < state->nb_machines; i++) {
+    nb += state->machines[i].marques.nb;
+  }
+  return nb;
+}
+
+/**
+ * @brief Marque (ou démarque) le processus sélectionné, puis passe à la
+ *        ligne suivante.
+ */
+static void marquer_selection(manager_state_t *state) {
+  machine_info_t *machine = &state->machines[state->machine_courante];
+  pid_t pid = pid_selectionne(state);
+  ui_state_t *ui = &state->ui_state;
+
+  if (pid == 0) {
+    return;
+  }
+  if (marques_basculer(&machine->marques, pid,
+                       date_demarrage(machine, pid)) < 0) {
+    ui_afficher_message(ui, "ERREUR: Memoire insuffisante", 1);
+    return;
+  }
+  if (ui->selected_index < compter_processus(machine->liste_processus) - 1) {
+    ui->selected_index++;
+    if (ui->selected_index >=
+        ui->scroll_offset + ui_nb_lignes_visibles()) {
+      ui->scroll_offset++;
+    }
+  }
+}
+
+/**
+ * @brief Ajoute des marques à une machine.
+ * @return int : Nombre de nouvelles marques, -1 si la mémoire manque.
+ */
+static int ajouter_marques(machine_info_t *machine, const pid_t *pids,
+                           const unsigned long long *starttimes, int nb) {
+  int avant = machine->marques.nb;
+
+  if (marques_ajouter(&machine->marques, pids, starttimes, nb) != 0) {
+    return -1;
+  }
+  return machine->marques.nb - avant;
+}
+
+/**
+ * @brief Marque les processus qui correspondent au filtre : ceux de la vue
+ *        affichée et, en recherche globale, ceux des autres machines.
+ */
+static void marquer_filtre(manager_state_t *state) {
+  int nb_nouvelles = 0;
+  char msg[128];
+
+  if (!state->filtre.actif) {
+    ui_afficher_message(&state->ui_state,
+                        "ERREUR: Aucun filtre actif (F4 ou /)", 1);
+    return;
+  }
+
+  for (int i = 0; i < state->nb_machines; i++) {
+    machine_info_t *machine = &state->machines[i];
+    int courante = i == state->machine_courante;
+    int nb_max = compter_processus(machine->liste_brute);
+    pid_t *pids;
+    unsigned long long *starttimes;
+    int nb = 0;
+
+    if ((!courante && !state->filtre.toutes_machines) || nb_max == 0) {
+      continue;
+    }
+    pids = malloc((size_t)nb_max * sizeof(pid_t));
+    starttimes = malloc((size_t)nb_max * sizeof(unsigned long long));
+    if (pids == NULL || starttimes == NULL) {
+      free(pids);
+      free(starttimes);
+      ui_afficher_message(&state->ui_state, "ERREUR: Memoire insuffisante",
+                          1);
+      return;
+    }
+
+    if (courante) {
+      /* La vue affichée est déjà filtrée (hors lignes de threads) */
+      for (processus_t *p = machine->liste_processus; p != NULL && nb < nb_max;
+           p = p->suivant) {
+        if (!p->est_thread) {
+          starttimes[nb] = p->starttime;
+          pids[nb++] = p->pid;
+        }
+      }
+    } else {
+      int nb_trouves = filtre_chercher(&state->filtre, machine->liste_brute,
+                                       machine->index);
+      for (int k = 0; k < nb_trouves; k++) {
+        processus_t *p = get_processus_at_index(
+            machine->liste_brute, (int)state->filtre.resultats[k]);
+        starttimes[nb] = p->starttime;
+        pids[nb++] = p->pid;
+      }
+    }
+
+    int ajoutees = ajouter_marques(machine, pids, starttimes, nb);
+    free(pids);
+    free(starttimes);
+    if (ajoutees < 0) {
+      ui_afficher_message(&state->ui_state, "ERREUR: Memoire insuffisante",
+                          1);
+      return;
+    }
+    nb_nouvelles += ajoutees;
+  }
+
+  snprintf(msg, sizeof(msg), "%d processus marques (filtre), %d au total",
+           nb_nouvelles, compter_marques(state));
+  ui_afficher_message(&state->ui_state, msg, 0);
+}
+
+/**
+ * @brief Marque tous les processus de l'utilisateur du processus
+ *        sélectionné, filtre ou non (machine affichée).
+ */
+static void marquer_utilisateur(manager_state_t *state) {
+  machine_info_t *machine = &state->machines[state->machine_courante];
+  processus_t *selection = get_processus_at_index(
+      machine->liste_processus, state->ui_state.selected_index);
+  int nb_max = compter_processus(machine->liste_brute);
+  char utilisateur[MAX_USER_LEN];
+  char msg[128];
+  pid_t *pids;
+  unsigned long long *starttimes;
+  int nb = 0;
+
+  if (selection == NULL || nb_max == 0) {
+    return;
+  }
+  pids = malloc((size_t)nb_max * sizeof(pid_t));
+  starttimes = malloc((size_t)nb_max * sizeof(unsigned long long));
+  if (pids == NULL || starttimes == NULL) {
+    free(pids);
+    free(starttimes);
+    ui_afficher_message(&state->ui_state, "ERREUR: Memoire insuffisante", 1);
+    return;
+  }
+
+  /* Localement l'UID fait foi (nom résolu à l'affichage) ; une source
+     distante ne fournit que le nom */
+  for (processus_t *p = machine->liste_brute; p != NULL && nb < nb_max;
+       p = p->suivant) {
+    if (machine->is_local
+            ? p->uid == selection->uid
+            : strcmp(p->utilisateur, selection->utilisateur) == 0) {
+      starttimes[nb] = p->starttime;
+      pids[nb++] = p->pid;
+    }
+  }
+  int ajoutees = ajouter_marques(machine, pids, starttimes, nb);
+  free(pids);
+  free(starttimes);
+  if (ajoutees < 0) {
+    ui_afficher_message(&state->ui_state, "ERREUR: Memoire insuffisante", 1);
+    return;
+  }
+
+  if (selection->utilisateur[0] != '\0') {
+    snprintf(utilisateur, sizeof(utilisateur), "%s", selection->utilisateur);
+  } else {
+    recuperer_nom_utilisateur(selection->uid, utilisateur,
+                              sizeof(utilisateur));
+  }
+  snprintf(msg, sizeof(msg), "%d processus de %s marques, %d au total",
+           ajoutees, utilisateur, compter_marques(state));
+  ui_afficher_message(&state->ui_state, msg, 0);
+}
+
+/**
+ * @brief Retire les marques de toutes les machines.
+ */
+static void demarquer(manager_state_t *state) {
+  for (int i = 0; i < state->nb_machines; i++) {
+    marques_vider(&state->machines[i].marques);
+  }
+  ui_afficher_message(&state->ui_state, "Marques retirees", 0);
+}
+
+/**
+ * @brief Exécute une action clavier.
+ */
+static void gerer_action(manager_state_t *state, int action) {
+  if (action == ACTION_QUIT) {
+    state->running = 0;
+  } else if (action == ACTION_HELP) {
+    ui_afficher_aide();
+  } else if (action == ACTION_NEXT_TAB) {
+    changer_onglet(state, 1);
+  } else if (action == ACTION_PREV_TAB) {
+    changer_onglet(state, -1);
+  } else if (action == ACTION_SEARCH) {
+    commencer_recherche(state);
+  } else if (action == ACTION_FILTRE_MODIFIE ||
+             action == ACTION_FILTRE_ANNULER) {
+    appliquer_filtre(state);
+  } else if (action == ACTION_FILTRE_VALIDER) {
+    suivre_indexation(state);
+    if (!state->filtre.actif) {
+      ui_afficher_message(&state->ui_state, "Filtre efface", 0);
+    }
+  } else if (action == ACTION_FILTRE_MODE) {
+    changer_mode_filtre(state);
+  } else if (action == ACTION_FILTRE_PORTEE) {
+    changer_portee_filtre(state);
+  } else if (action == ACTION_TRI_SUIVANT || action == ACTION_TRI_PRECEDENT) {
+    int sens = action == ACTION_TRI_SUIVANT ? 1 : -1;
+    tri_cle_t cle = (tri_cle_t)((state->tri.cle + sens + TRI_NB_CLES) %
+                                TRI_NB_CLES);
+    changer_tri(state, cle, tri_decroissant_defaut(cle));
+  } else if (action == ACTION_TRI_INVERSER) {
+    if (state->tri.cle == TRI_AUCUN) {
+      ui_afficher_message(&state->ui_state, "Aucun tri actif (touches < >)",
+                          1);
+    } else {
+      changer_tri(state, state->tri.cle, !state->tri.decroissant);
+    }
+  } else if (action == ACTION_THREADS) {
+    if (vue_procfs_disponible(state)) {
+      basculer_mode_threads(state);
+    }
+  } else if (action == ACTION_ARBRE) {
+    basculer_mode_arbre(state);
+  } else if (action == ACTION_PORTEE_SIGNAUX) {
+    changer_portee_signaux(state);
+  } else if (action == ACTION_DEPLIER || action == ACTION_REPLIER) {
+    if (state->mode_arbre || vue_procfs_disponible(state)) {
+      deplier_selection(state, action == ACTION_DEPLIER);
+    }
+  } else if (action == ACTION_MEMOIRE) {
+    if (vue_procfs_disponible(state)) {
+      basculer_mode_memoire(state);
+    }
+  } else if (action == ACTION_MARQUER) {
+    marquer_selection(state);
+  } else if (action == ACTION_MARQUER_FILTRE) {
+    marquer_filtre(state);
+  } else if (action == ACTION_MARQUER_UTILISATEUR) {
+    marquer_utilisateur(state);
+  } else if (action == ACTION_DEMARQUER) {
+    demarquer(state);
+  } else if (action == ACTION_KILL || action == ACTION_PAUSE ||
+             action == ACTION_CONTINUE_SIGNAL ||
+             action == ACTION_FORCE_KILL) {
+    manager_gerer_action_processus(state, action);
+  }
+}
+
+/**
+ * @brief Boucle principale commune aux modes local et réseau : chaque
+ *        réveil (touche, publication d'une source, minuteur d'affichage,
+ *        signal, message expiré) se termine par un affichage.
+ * @return int : Code de retour (EXIT_SUCCESS ou EXIT_FAILURE).
+ */
+static int executer_boucle(manager_state_t *state, boucle_t *boucle) {
+  int evenements;
+  int action;
+
+  while (state->running) {
+    machine_info_t *machine_active = &state->machines[state->machine_courante];
+    int nb_processus = compter_processus(machine_active->liste_processus);
+
+    /* Ajuster la sélection si nécessaire */
+    if (state->ui_state.selected_index >= nb_processus) {
+      state->ui_state.selected_index = nb_processus - 1;
+    }
+    if (state->ui_state.selected_index < 0) {
+      state->ui_state.selected_index = 0;
+    }
+
+    /* Défilement au-delà des lignes triées : prolonger l'ordre complet */
+    if (!state->mode_arbre && state->tri.nb_tries < state->tri.nb_total &&
+        state->ui_state.scroll_offset + ui_nb_lignes_visibles() >
+            state->tri.nb_tries) {
+      publier_vue(state, state->machine_courante, 0);
+      machine_active = &state->machines[state->machine_courante];
+    }
+
+    /* A. Affichage */
+    state->ui_state.marques = &machine_active->marques;
+    state->ui_state.nb_marques = compter_marques(state);
+    state->ui_state.portee_signaux =
+        state->portee_signaux != PORTEE_PROCESSUS
+            ? portee_signal_nom(state->portee_signaux)
+            : NULL;
+    if (source_peut(&machine_active->source, SOURCE_CAP_PROCFS)) {
+      charger_lignes_visibles(state, machine_active->liste_processus);
+    }
+    clear();
+    if (state->vue_reseau) {
+      ui_afficher_processus_network(state->machines, state->nb_machines,
+                                    state->machine_courante, &state->ui_state);
+    } else {
+      ui_afficher_processus(state->liste_processus, &state->ui_state);
+    }
+    refresh();
+
+    /* B. Attente du prochain événement */
+    evenements = boucle_attendre(boucle, attente_message_ms(&state->ui_state));
+    if (evenements & BOUCLE_ARRET) {
+      state->running = 0;
+      break;
+    }
+    if (evenements & BOUCLE_REDIMENSION) {
+      ui_redimensionner();
+    }
+
+    /* C. Publications des sources (chacune à sa cadence) ; le minuteur ne
+       sert qu'à rafraîchir l'âge et le retard affichés */
+    if (evenements & (BOUCLE_SOURCE | BOUCLE_MINUTEUR)) {
+      if (recevoir_collectes(state) > 0) {
+        state->cycles++;
+      }
+
+      /* /proc illisible : la vue locale n'a plus de sens */
+      if (!state->vue_reseau &&
+          collecteur_echec(&state->collecteur, state->machines[0].poste)) {
+        ui_cleanup();
+        fprintf(stderr, "ERREUR FATALE: Impossible de lire /proc\n");
+        return EXIT_FAILURE;
+      }
+    }
+
+    /* D. Gestion de toutes les touches en attente */
+    if (evenements & BOUCLE_CLAVIER) {
+      while (state->running &&
+             (action = ui_gerer_evenements(
+                  &state->ui_state,
+                  compter_processus(
+                      state->machines[state->machine_courante]
+                          .liste_processus))) != ACTION_AUCUNE) {
+        gerer_action(state, action);
+      }
+    }
+  }
+
+  ui_cleanup();
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Démarre la boucle d'événements, l'interface et le collecteur, puis
+ *        exécute la boucle principale.
+ */
+static int demarrer(manager_state_t *state, boucle_t *boucle) {
+  int retour;
+
+  if (collecteur_demarrer(&state->collecteur) != 0) {
+    ui_cleanup();
+    fprintf(stderr, "ERREUR: Impossible de demarrer la collecte (%s)\n",
+            strerror(errno));
+    return EXIT_FAILURE;
+  }
+
+  /* Premières collectes (chaque source au plus jusqu'à son échéance), à la
+     période propre de chaque machine ; les onglets en arrière-plan
+     ralentissent ensuite */
+  recevoir_collectes(state);
+  for (int i = 0; i < state->nb_machines; i++) {
+    ajuster_cadence(state, i);
+    /* Les onglets distants affichent l'état de leur connexion */
+    if (state->machines[i].liste_processus == NULL && !state->vue_reseau) {
+      ui_cleanup();
+      fprintf(stderr, "ERREUR FATALE: Impossible de lire /proc\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  boucle_surveiller_source(boucle, collecteur_descripteur(&state->collecteur));
+  retour = executer_boucle(state, boucle);
+  return retour;
+}
+
+/**
+ * @brief Arrête le collecteur et libère l'état des sources distantes ; les
+ *        listes affichées appartenaient aux tampons du collecteur.
+ */
+static void arreter_sources(manager_state_t *state) {
+  collecteur_arreter(&state->collecteur);
+  state->liste_processus = NULL;
+  state->liste_collectee = NULL;
+  state->ui_state.cpu = NULL;
+
+  for (int i = 0; i < state->nb_machines; i++) {
+    state->machines[i].liste_brute = NULL;
+    state->machines[i].index = NULL;
+    state->machines[i].liste_processus = NULL;
+    free(state->machines[i].pids);
+    free(state->machines[i].pids_courants);
+    state->machines[i].pids = NULL;
+    state->machines[i].pids_courants = NULL;
+    state->machines[i].taille_pids = 0;
+    state->machines[i].nb_pids = 0;
+    /* Un lot en route est abandonné avec le thread de sa source */
+    marques_liberer(&state->machines[i].marques);
+    lot_signaux_liberer(&state->machines[i].lot);
+    state->machines[i].lot_en_vol = 0;
+    if (!state->machines[i].is_local) {
+      source_ssh_liberer(&state->machines[i].ssh);
+    }
+  }
+  state->nb_machines = 0;
+}
+
 /* Fonctions publiques */
 
 void manager_init(manager_state_t *state) {
   state->liste_processus = NULL;
+  state->liste_collectee = NULL;
+  source_locale_init(&state->locale);
+  snapshot_init(&state->snapshot_local);
+  filtre_init(&state->filtre);
+  snapshot_init(&state->snapshot_filtre);
+  tri_init(&state->tri, TRI_CPU, tri_decroissant_defaut(TRI_CPU));
+  snapshot_init(&state->snapshot_tri);
+  if (arbre_init(&state->arbre) != 0) {
+    fprintf(stderr, "AVERTISSEMENT: Vue arborescente indisponible\n");
+  }
+  snapshot_init(&state->snapshot_arbre);
+  state->mode_arbre = 0;
+  collecteur_init(&state->collecteur);
   state->running = 1;
   state->cycles = 0;
+  state->delai_ms = REFRESH_INTERVAL_MS;
+  state->delai_fond_ms = 0;
   state->nb_machines = 0;
   state->machine_courante = 0;
+  state->vue_reseau = 0;
 
   /* Initialiser toutes les machines */
   for (int i = 0; i < MAX_MACHINES; i++) {
+    state->machines[i].liste_brute = NULL;
+    state->machines[i].index = NULL;
+    state->machines[i].nb_trouves = -1;
     state->machines[i].liste_processus = NULL;
-    state->machines[i].remote_host = NULL;
     state->machines[i].is_local = 0;
+    state->machines[i].poste = -1;
+    state->machines[i].periode_ms = 0;
+    state->machines[i].pids = NULL;
+    state->machines[i].pids_courants = NULL;
+    state->machines[i].taille_pids = 0;
+    state->machines[i].nb_pids = 0;
+    state->machines[i].nb_stables = 0;
+    state->machines[i].instant_ms = 0;
+    state->machines[i].perimee = 0;
+    state->machines[i].connexion = CONNEXION_ETABLIE;
+    state->machines[i].reessai_ms = 0;
+    state->machines[i].erreur_connexion[0] = '\0';
+    marques_init(&state->machines[i].marques);
+    lot_signaux_init(&state->machines[i].lot);
+    state->machines[i].lot_en_vol = 0;
+    state->machines[i].lot_envoi = 0;
   }
+  memset(&state->envoi, 0, sizeof(state->envoi));
+  state->portee_signaux = PORTEE_PROCESSUS;
 
   ui_init_state(&state->ui_state);
+  state->ui_state.tri = &state->tri;
+  state->ui_state.filtre = &state->filtre;
+  if (details_init(&state->details_local) == 0) {
+    state->ui_state.details = &state->details_local;
+  }
+  state->mode_threads = 0;
+  taches_init(&state->taches_local);
+  state->mode_memoire = 0;
+  memoire_init(&state->memoire_local);
 }
 
-void manager_cleanup(manager_state_t *state) {
-  /* Mode local */
-  if (state->liste_processus != NULL) {
-    liberer_liste_processus(state->liste_processus);
-    state->liste_processus = NULL;
+int manager_activer_connecteur(manager_state_t *state) {
+  if (connecteur_ouvrir(&state->locale.connecteur) != 0) {
+    return -1;
   }
+  state->ui_state.nb_ephemeres = 0;
+  return 0;
+}
 
-  /* Mode réseau : nettoyer toutes les machines */
-  for (int i = 0; i < state->nb_machines; i++) {
-    if (state->machines[i].liste_processus != NULL) {
-      liberer_liste_processus(state->machines[i].liste_processus);
-      state->machines[i].liste_processus = NULL;
-    }
-  }
+void manager_cleanup(manager_state_t *state) {
+  arreter_sources(state);
+  source_locale_liberer(&state->locale);
+  snapshot_liberer(&state->snapshot_local);
+  filtre_liberer(&state->filtre);
+  snapshot_liberer(&state->snapshot_filtre);
+  tri_liberer(&state->tri);
+  snapshot_liberer(&state->snapshot_tri);
+  arbre_liberer(&state->arbre);
+  snapshot_liberer(&state->snapshot_arbre);
+  details_liberer(&state->details_local);
+  taches_liberer(&state->taches_local);
+  memoire_liberer(&state->memoire_local);
 }
 
 void manager_gerer_action_processus(manager_state_t *state, int action) {
+  machine_info_t *machine = &state->machines[state->machine_courante];
+  envoi_signaux_t *envoi = &state->envoi;
   processus_t *proc_selectionne;
+  unsigned long long starttime;
   int signal_to_send = -1;
-  char msg[256];
+  int nb_marques = compter_marques(state);
+  char msg[128];
   const char *action_name = "";
 
   /* Déterminer le signal à envoyer */
@@ -79,55 +1456,87 @@ void manager_gerer_action_processus(manager_state_t *state, int action) {
     return;
   }
 
-  /* Récupérer le processus sélectionné */
-  proc_selectionne = get_processus_at_index(state->liste_processus,
-                                            state->ui_state.selected_index);
-
-  if (proc_selectionne == NULL) {
-    ui_afficher_message(&state->ui_state,
-                        "ERREUR: Processus introuvable dans la liste", 1);
-    return;
-  }
+  /* Nouvel envoi : les lots encore en route de l'envoi précédent ne
+     compteront pas dans son bilan */
+  envoi->numero++;
+  envoi->libelle = action_name;
+  envoi->portee = state->portee_signaux;
+  envoi->nb_attendus = 0;
+  envoi->nb_machines = 0;
+  envoi->nb_processus = 0;
+  envoi->nb_envoyes = 0;
+  envoi->nb_absents = 0;
+  envoi->nb_refuses = 0;
+  envoi->nb_echecs = 0;
+  envoi->nb_atteints = 0;
+  envoi->pid = 0;
+  envoi->erreur = 0;
+  envoi->machine = state->machine_courante;
+  envoi->nom[0] = '\0';
+
+  if (nb_marques > 0) {
+    /* Un lot par machine, envoyés en même temps par les threads des
+       sources */
+    for (int i = 0; i < state->nb_machines; i++) {
+      machine_info_t *m = &state->machines[i];
+      if (m->marques.nb > 0) {
+        confier_lot(state, i, m->marques.pids, m->marques.starttimes,
+                    m->marques.nb, signal_to_send);
+      }
+    }
+  } else {
+    if (!source_peut(&machine->source, SOURCE_CAP_SIGNAUX)) {
+      ui_afficher_message(
+          &state->ui_state,
+          "ERREUR: Signaux non pris en charge par cette machine", 1);
+      return;
+    }
 
-  /* Vérifier que le processus existe encore */
-  char proc_path[64];
-  snprintf(proc_path, sizeof(proc_path), "/proc/%d", proc_selectionne->pid);
+    /* Récupérer le processus sélectionné */
+    proc_selectionne = get_processus_at_index(machine->liste_processus,
+                                              state->ui_state.selected_index);
+    if (proc_selectionne == NULL) {
+      ui_afficher_message(&state->ui_state,
+                          "ERREUR: Processus introuvable dans la liste", 1);
+      return;
+    }
 
-  if (access(proc_path, F_OK) != 0) {
-    snprintf(msg, sizeof(msg), "ERREUR: Le processus %d n'existe plus",
-             proc_selectionne->pid);
-    ui_afficher_message(&state->ui_state, msg, 1);
-    return;
+    /* Ligne d'un thread : son processus (le signal lui est destiné) */
+    envoi->pid = proc_selectionne->tgid;
+    starttime = proc_selectionne->est_thread
+                    ? date_demarrage(machine, envoi->pid)
+                    : proc_selectionne->starttime;
+    snprintf(envoi->nom, sizeof(envoi->nom), "%s",
+             proc_selectionne->nom_commande);
+    confier_lot(state, state->machine_courante, &envoi->pid, &starttime, 1,
+                signal_to_send);
   }
 
-  /* Envoyer le signal */
-  int resultat = envoyer_signal(proc_selectionne->pid, signal_to_send);
-
-  if (resultat == 0) {
-    snprintf(msg, sizeof(msg), "PID %d (%s) %s", proc_selectionne->pid,
-             proc_selectionne->nom_commande, action_name);
+  /* Bilan immédiat si aucun lot n'est parti, sinon au retour du dernier */
+  if (envoi->nb_attendus == 0) {
+    afficher_bilan_envoi(state);
+  } else if (nb_marques > 0) {
+    snprintf(msg, sizeof(msg), "Envoi a %d processus marques...",
+             envoi->nb_processus);
     ui_afficher_message(&state->ui_state, msg, 0);
-  } else {
-    /* Gestion des erreurs */
-    if (errno == EPERM) {
-      snprintf(msg, sizeof(msg),
-               "ERREUR: Permission refusee pour PID %d. Utilisez sudo",
-               proc_selectionne->pid);
-    } else if (errno == ESRCH) {
-      snprintf(msg, sizeof(msg), "ERREUR: Processus %d introuvable",
-               proc_selectionne->pid);
-    } else {
-      snprintf(msg, sizeof(msg), "ERREUR: Echec signal vers PID %d (errno: %d)",
-               proc_selectionne->pid, errno);
-    }
-    ui_afficher_message(&state->ui_state, msg, 1);
   }
 }
 
 int manager_run_local(manager_state_t *state) {
-  time_t last_refresh = time(NULL);
-  time_t current_time;
-  int action;
+  boucle_t boucle;
+  int retour;
+
+  /* Avant le démarrage des sources : leurs threads héritent du masque */
+  if (boucle_init(&boucle, AFFICHAGE_MAX_MS) != 0) {
+    fprintf(stderr, "ERREUR: Boucle d'evenements indisponible (%s)\n",
+            strerror(errno));
+    return EXIT_FAILURE;
+  }
+
+  if (manager_add_machine(state, "Local", 1, NULL) < 0) {
+    boucle_liberer(&boucle);
+    return EXIT_FAILURE;
+  }
 
   /* Initialisation de l'interface */
   ui_init();
@@ -136,107 +1545,9 @@ int manager_run_local(manager_state_t *state) {
   ui_afficher_message(&state->ui_state,
                       "Bienvenue dans MY_HTOP - F1:Aide Q:Quitter", 0);
 
-  /* Premier chargement des processus */
-  state->liste_processus = recuperer_processus_locaux();
-  if (state->liste_processus == NULL) {
-    ui_cleanup();
-    fprintf(stderr, "ERREUR FATALE: Impossible de lire /proc\n");
-    return EXIT_FAILURE;
-  }
-
-  /* Boucle principale */
-  while (state->running) {
-    current_time = time(NULL);
-
-    /* A. Collecte des données (si intervalle écoulé) */
-    if (difftime(current_time, last_refresh) >= REFRESH_INTERVAL) {
-      /* Libérer l'ancienne liste */
-      liberer_liste_processus(state->liste_processus);
-
-      /* Recharger les processus */
-      state->liste_processus = recuperer_processus_locaux();
-
-      if (state->liste_processus == NULL) {
-        ui_cleanup();
-        fprintf(stderr, "ERREUR FATALE: Impossible de lire /proc\n");
-        return EXIT_FAILURE;
-      }
-
-      last_refresh = current_time;
-      state->cycles++;
-    }
-
-    int nb_processus = compter_processus(state->liste_processus);
-
-    /* Ajuster la sélection si nécessaire */
-    if (state->ui_state.selected_index >= nb_processus) {
-      state->ui_state.selected_index = nb_processus - 1;
-    }
-    if (state->ui_state.selected_index < 0) {
-      state->ui_state.selected_index = 0;
-    }
-
-    /* B. Affichage */
-    clear();
-    ui_afficher_processus(state->liste_processus, &state->ui_state);
-    refresh();
-
-    /* C. Gestion des événements */
-    action = ui_gerer_evenements(&state->ui_state, nb_processus);
-
-    if (action == ACTION_QUIT) {
-      state->running = 0;
-    } else if (action == ACTION_HELP) {
-      ui_afficher_aide();
-    } else if (action == ACTION_SEARCH) {
-      char search_buffer[256];
-      if (ui_demander_saisie(&state->ui_state, "Rechercher (PID ou nom): ",
-                             search_buffer, sizeof(search_buffer))) {
-        int found = 0;
-        int search_pid = atoi(search_buffer);
-        processus_t *curr = state->liste_processus;
-        int index = 0;
-
-        while (curr != NULL) {
-          /* Recherche par PID ou nom de commande */
-          if ((search_pid > 0 && curr->pid == search_pid) ||
-              strcasecmp(curr->nom_commande, search_buffer) == 0 ||
-              strstr(curr->nom_commande, search_buffer) != NULL) {
-            state->ui_state.selected_index = index;
-            /* Ajuster le scroll pour que le résultat soit visible */
-            int max_visible = LINES - 8;
-            if (index < state->ui_state.scroll_offset ||
-                index >= state->ui_state.scroll_offset + max_visible) {
-              state->ui_state.scroll_offset = index - (max_visible / 2);
-              if (state->ui_state.scroll_offset < 0)
-                state->ui_state.scroll_offset = 0;
-            }
-            found = 1;
-            ui_afficher_message(&state->ui_state, "Processus trouve", 0);
-            break;
-          }
-          curr = curr->suivant;
-          index++;
-        }
-
-        if (!found) {
-          ui_afficher_message(&state->ui_state, "Processus non trouve", 1);
-        }
-      }
-    } else if (action == ACTION_KILL || action == ACTION_PAUSE ||
-               action == ACTION_CONTINUE_SIGNAL ||
-               action == ACTION_FORCE_KILL) {
-      manager_gerer_action_processus(state, action);
-    }
-
-    /* Petit délai pour ne pas surcharger le CPU */
-    usleep(50000);
-  }
-
-  /* Nettoyage */
-  ui_cleanup();
-
-  return EXIT_SUCCESS;
+  retour = demarrer(state, &boucle);
+  boucle_liberer(&boucle);
+  return retour;
 }
 
 int manager_add_machine(manager_state_t *state, const char *nom, int is_local,
@@ -247,11 +1558,50 @@ int manager_add_machine(manager_state_t *state, const char *nom, int is_local,
   }
 
   int index = state->nb_machines;
-  strncpy(state->machines[index].nom, nom, MAX_HOSTNAME_LEN - 1);
-  state->machines[index].nom[MAX_HOSTNAME_LEN - 1] = '\0';
-  state->machines[index].is_local = is_local;
-  state->machines[index].remote_host = host;
-  state->machines[index].liste_processus = NULL;
+  machine_info_t *machine = &state->machines[index];
+  strncpy(machine->nom, nom, MAX_HOSTNAME_LEN - 1);
+  machine->nom[MAX_HOSTNAME_LEN - 1] = '\0';
+  machine->is_local = is_local;
+  machine->liste_brute = NULL;
+  machine->index = NULL;
+  machine->nb_trouves = -1;
+  machine->liste_processus = NULL;
+  machine->instant_ms = 0;
+  machine->perimee = 0;
+  machine->connexion = is_local ? CONNEXION_ETABLIE : CONNEXION_EN_COURS;
+  machine->reessai_ms = 0;
+  machine->erreur_connexion[0] = '\0';
+  machine->pids = NULL;
+  machine->pids_courants = NULL;
+  machine->taille_pids = 0;
+  machine->nb_pids = 0;
+  machine->nb_stables = 0;
+  marques_init(&machine->marques);
+  lot_signaux_init(&machine->lot);
+  machine->lot_en_vol = 0;
+  machine->lot_envoi = 0;
+
+  /* Chaque machine est une source du collecteur, à sa propre cadence */
+  if (is_local) {
+    machine->periode_ms = state->delai_ms;
+    source_init(&machine->source, &source_locale_ops, &state->locale, nom,
+                machine->periode_ms);
+  } else {
+    machine->periode_ms =
+        host->periode_ms > 0 ? host->periode_ms : state->delai_ms;
+    source_ssh_init(&machine->ssh, host);
+    source_init(&machine->source, &source_ssh_ops, &machine->ssh, nom,
+                machine->periode_ms);
+  }
+
+  machine->poste = collecteur_ajouter(&state->collecteur, &machine->source);
+  if (machine->poste < 0) {
+    fprintf(stderr, "ERREUR: Nombre maximum de machines atteint\n");
+    if (!is_local) {
+      source_ssh_liberer(&machine->ssh);
+    }
+    return -1;
+  }
 
   state->nb_machines++;
   return index;
@@ -259,35 +1609,35 @@ int manager_add_machine(manager_state_t *state, const char *nom, int is_local,
 
 int manager_run_network(manager_state_t *state, network_config_t *config,
                         int include_local) {
-  time_t last_refresh = time(NULL);
-  time_t current_time;
-  int action;
+  boucle_t boucle;
+  int retour;
+
+  /* Avant le démarrage des sources : leurs threads héritent du masque */
+  if (boucle_init(&boucle, AFFICHAGE_MAX_MS) != 0) {
+    fprintf(stderr, "ERREUR: Boucle d'evenements indisponible (%s)\n",
+            strerror(errno));
+    return EXIT_FAILURE;
+  }
 
   /* Initialisation de l'interface */
   ui_init();
+  state->vue_reseau = 1;
 
   /* Ajouter la machine locale si demandé */
   if (include_local) {
     manager_add_machine(state, "Local", 1, NULL);
   }
 
-  /* Ajouter toutes les machines distantes */
+  /* Ajouter toutes les machines distantes : chacune se connecte dans le
+     thread de sa source, toutes en même temps, et se reconnecte après une
+     coupure ; l'onglet affiche l'état de sa connexion */
   for (int i = 0; i < config->nb_hosts; i++) {
-    /* Connexion SSH */
-    printf("Connexion à %s (%s)...\n", config->hosts[i].nom,
-           config->hosts[i].adresse);
-    if (connect_ssh(&config->hosts[i]) != 0) {
-      fprintf(stderr, "Échec de connexion à %s, machine ignorée\n",
-              config->hosts[i].nom);
-      continue;
-    }
-
     manager_add_machine(state, config->hosts[i].nom, 0, &config->hosts[i]);
-    printf("Connecté à %s\n", config->hosts[i].nom);
   }
 
   if (state->nb_machines == 0) {
     ui_cleanup();
+    boucle_liberer(&boucle);
     fprintf(stderr, "ERREUR: Aucune machine disponible\n");
     return EXIT_FAILURE;
   }
@@ -304,191 +1654,12 @@ int manager_run_network(manager_state_t *state, network_config_t *config,
            state->nb_machines);
   ui_afficher_message(&state->ui_state, msg, 0);
 
-  /* Premier chargement des processus */
-  for (int i = 0; i < state->nb_machines; i++) {
-    if (state->machines[i].is_local) {
-      state->machines[i].liste_processus = recuperer_processus_locaux();
-    } else {
-      state->machines[i].liste_processus =
-          get_remote_processes(state->machines[i].remote_host);
-    }
-
-    if (state->machines[i].liste_processus == NULL) {
-      fprintf(stderr,
-              "AVERTISSEMENT: Impossible de récupérer les processus de %s\n",
-              state->machines[i].nom);
-    }
-  }
-
-  /* Boucle principale */
-  while (state->running) {
-    current_time = time(NULL);
-
-    /* A. Collecte des données (si intervalle écoulé) */
-    if (difftime(current_time, last_refresh) >= REFRESH_INTERVAL) {
-      for (int i = 0; i < state->nb_machines; i++) {
-        /* Libérer l'ancienne liste */
-        if (state->machines[i].liste_processus != NULL) {
-          liberer_liste_processus(state->machines[i].liste_processus);
-        }
-
-        /* Recharger les processus */
-        if (state->machines[i].is_local) {
-          state->machines[i].liste_processus = recuperer_processus_locaux();
-        } else {
-          state->machines[i].liste_processus =
-              get_remote_processes(state->machines[i].remote_host);
-        }
-      }
-
-      last_refresh = current_time;
-      state->cycles++;
-    }
-
-    /* Obtenir la machine courante */
-    machine_info_t *machine_active = &state->machines[state->machine_courante];
-    int nb_processus = compter_processus(machine_active->liste_processus);
-
-    /* Ajuster la sélection si nécessaire */
-    if (state->ui_state.selected_index >= nb_processus) {
-      state->ui_state.selected_index = nb_processus - 1;
-    }
-    if (state->ui_state.selected_index < 0) {
-      state->ui_state.selected_index = 0;
-    }
-
-    /* B. Affichage */
-    clear();
-    ui_afficher_processus_network(state->machines, state->nb_machines,
-                                  state->machine_courante, &state->ui_state);
-    refresh();
-
-    /* C. Gestion des événements */
-    action = ui_gerer_evenements(&state->ui_state, nb_processus);
-
-    if (action == ACTION_QUIT) {
-      state->running = 0;
-    } else if (action == ACTION_HELP) {
-      ui_afficher_aide();
-    } else if (action == ACTION_NEXT_TAB) {
-      state->machine_courante =
-          (state->machine_courante + 1) % state->nb_machines;
-      state->ui_state.machine_courante = state->machine_courante;
-      state->ui_state.selected_index = 0;
-      snprintf(msg, sizeof(msg), "Machine: %s",
-               state->machines[state->machine_courante].nom);
-      ui_afficher_message(&state->ui_state, msg, 0);
-    } else if (action == ACTION_PREV_TAB) {
-      state->machine_courante =
-          (state->machine_courante - 1 + state->nb_machines) %
-          state->nb_machines;
-      state->ui_state.machine_courante = state->machine_courante;
-      state->ui_state.selected_index = 0;
-      snprintf(msg, sizeof(msg), "Machine: %s",
-               state->machines[state->machine_courante].nom);
-      ui_afficher_message(&state->ui_state, msg, 0);
-    } else if (action == ACTION_SEARCH) {
-      char search_buffer[256];
-      if (ui_demander_saisie(&state->ui_state, "Rechercher (PID ou nom): ",
-                             search_buffer, sizeof(search_buffer))) {
-        int found = 0;
-        int search_pid = atoi(search_buffer);
-        processus_t *curr = machine_active->liste_processus;
-        int index = 0;
-
-        while (curr != NULL) {
-          /* Recherche par PID ou nom de commande */
-          if ((search_pid > 0 && curr->pid == search_pid) ||
-              strcasecmp(curr->nom_commande, search_buffer) == 0 ||
-              strstr(curr->nom_commande, search_buffer) != NULL) {
-            state->ui_state.selected_index = index;
-            /* Ajuster le scroll pour que le résultat soit visible */
-            int max_visible = LINES - 8;
-            if (index < state->ui_state.scroll_offset ||
-                index >= state->ui_state.scroll_offset + max_visible) {
-              state->ui_state.scroll_offset = index - (max_visible / 2);
-              if (state->ui_state.scroll_offset < 0)
-                state->ui_state.scroll_offset = 0;
-            }
-            found = 1;
-            ui_afficher_message(&state->ui_state, "Processus trouve", 0);
-            break;
-          }
-          curr = curr->suivant;
-          index++;
-        }
-
-        if (!found) {
-          ui_afficher_message(&state->ui_state, "Processus non trouve", 1);
-        }
-      }
-    } else if (action == ACTION_KILL || action == ACTION_PAUSE ||
-               action == ACTION_CONTINUE_SIGNAL ||
-               action == ACTION_FORCE_KILL) {
-      /* Déterminer le signal à envoyer */
-      int signal_to_send = -1;
-      const char *action_name = "";
-
-      switch (action) {
-      case ACTION_KILL:
-        signal_to_send = SIGTERM;
-        action_name = "termine (SIGTERM)";
-        break;
-      case ACTION_PAUSE:
-        signal_to_send = SIGSTOP;
-        action_name = "mis en pause (SIGSTOP)";
-        break;
-      case ACTION_CONTINUE_SIGNAL:
-        signal_to_send = SIGCONT;
-        action_name = "repris (SIGCONT)";
-        break;
-      case ACTION_FORCE_KILL:
-        signal_to_send = SIGKILL;
-        action_name = "tue (SIGKILL)";
-        break;
-      }
-
-      /* Récupérer le processus sélectionné */
-      processus_t *proc_selectionne = get_processus_at_index(
-          machine_active->liste_processus, state->ui_state.selected_index);
-
-      if (proc_selectionne != NULL) {
-        int resultat;
-
-        if (machine_active->is_local) {
-          resultat = envoyer_signal(proc_selectionne->pid, signal_to_send);
-        } else {
-          resultat = send_remote_signal(machine_active->remote_host,
-                                        proc_selectionne->pid, signal_to_send);
-        }
-
-        if (resultat == 0) {
-          snprintf(msg, sizeof(msg), "[%s] PID %d (%s) %s", machine_active->nom,
-                   proc_selectionne->pid, proc_selectionne->nom_commande,
-                   action_name);
-          ui_afficher_message(&state->ui_state, msg, 0);
-        } else {
-          if (errno == EPERM) {
-            snprintf(msg, sizeof(msg),
-                     "ERREUR: Permission refusee pour PID %d sur %s",
-                     proc_selectionne->pid, machine_active->nom);
-          } else {
-            snprintf(msg, sizeof(msg),
-                     "ERREUR: Echec signal vers PID %d sur %s",
-                     proc_selectionne->pid, machine_active->nom);
-          }
-          ui_afficher_message(&state->ui_state, msg, 1);
-        }
-      }
-    }
-
-    /* Petit délai pour ne pas surcharger le CPU */
-    usleep(50000);
-  }
+  retour = demarrer(state, &boucle);
+  boucle_liberer(&boucle);
 
-  /* Nettoyage */
-  ui_cleanup();
+  /* Nettoyage : les sources utilisent encore les connexions SSH */
+  arreter_sources(state);
   cleanup_network_config(config);
 
-  return EXIT_SUCCESS;
-}
\ No newline at end of file
+  return retour;
+}
@@ -11,11 +11,31 @@
 #define MANAGER_H
 
 #include "network.h"
+#include "arbre.h"
+#include "boucle.h"
+#include "collecteur.h"
+#include "cpu.h"
+#include "details.h"
+#include "filtre.h"
+#include "marques.h"
+#include "memoire.h"
 #include "process.h"
+#include "snapshot.h"
+#include "source.h"
+#include "source_locale.h"
+#include "source_ssh.h"
+#include "taches.h"
+#include "tri.h"
 #include "ui.h"
 
-#define REFRESH_INTERVAL 2 // Rafraîchir toutes les 2 secondes
-#define MAX_MACHINES 33    // 1 locale + 32 distantes max
+#define REFRESH_INTERVAL_MS BOUCLE_DELAI_DEFAUT_MS // Rafraîchir toutes les 2 secondes
+#define MAX_MACHINES COLLECTEUR_MAX_SOURCES // 1 locale + 32 distantes max
+#define AFFICHAGE_MAX_MS 1000 /* Réaffichage minimal (âge des données) */
+#define CADENCE_FOND_FACTEUR 5 /* Onglet en arrière-plan : 5 x sa période */
+#define CADENCE_FOND_PALIERS 3 /* Doublements si stable : jusqu'à 8 x */
+#define CADENCE_FOND_TOLERANCE 8 /* PID apparus + disparus d'une machine
+                                    « stable » (dont la collecte elle-même :
+                                    ps, shell) */
 
 /**
  * @brief Structure représentant une machine (locale ou distante).
@@ -23,27 +43,106 @@
 typedef struct machine_info {
   char nom[MAX_HOSTNAME_LEN]; /* Nom d'affichage */
   int is_local;               /* 1 si machine locale, 0 si distante */
-  remote_host_t
-      *remote_host; /* Pointeur vers config distante (NULL si local) */
-  processus_t *liste_processus; /* Liste des processus de cette machine */
+  source_t source;            /* Collecte et signaux de cette machine */
+  source_ssh_t ssh;           /* État de la source (distante uniquement) */
+  int poste;                  /* Poste du collecteur */
+  int periode_ms;             /* Cadence de l'onglet actif (-d ou config) */
+  pid_t *pids;                /* PID de la dernière collecte distante
+                                 (table de hachage, 0 : case vide) */
+  pid_t *pids_courants;       /* Table de la collecte en cours de comptage */
+  int taille_pids;            /* Cases de chaque table (puissance de 2,
+                                 agrandie seulement si besoin) */
+  int nb_pids;
+  int nb_stables;             /* Collectes successives sans changement */
+  processus_t *liste_brute;     /* Dernière collecte, ordre de la source */
+  const index_texte_t *index;   /* Index de recherche de cette collecte */
+  int nb_trouves;               /* Correspondances du filtre (-1 : non
+                                   calculées) */
+  processus_t *liste_processus; /* Liste des processus de cette machine
+                                   (appartient à la collecte en cours de
+                                   lecture, ou à snapshot_local) */
+  long long instant_ms;         /* Date des données affichées */
+  int perimee;                  /* 1 : source en retard, données anciennes */
+  etat_connexion_t connexion;   /* Connexion de l'hôte (toujours établie
+                                   pour la machine locale) */
+  long long reessai_ms;         /* Délai avant le prochain essai */
+  char erreur_connexion[MAX_ERREUR_CONNEXION]; /* Cause du dernier échec,
+                                                ou avertissement de la
+                                                collecte */
+  marques_t marques;            /* PID marqués (oubliés à leur disparition) */
+  lot_signaux_t lot;            /* Dernier lot de signaux (au poste tant
+                                   que lot_en_vol) */
+  int lot_en_vol;               /* 1 : lot confié au poste */
+  unsigned int lot_envoi;       /* Envoi auquel appartient le lot */
 } machine_info_t;
 
+/**
+ * @brief Envoi d'un signal (un lot par machine) et bilan de ses résultats.
+ */
+typedef struct envoi_signaux {
+  unsigned int numero;          /* Envoi en cours (les lots d'un envoi
+                                   précédent sont ignorés au retour) */
+  const char *libelle;          /* "termine (SIGTERM)", ... */
+  portee_signal_t portee;       /* Processus visés autour de chaque PID */
+  int nb_attendus;              /* Lots pas encore revenus */
+  int nb_machines;              /* Machines visées */
+  int nb_processus;             /* Processus visés */
+  int nb_envoyes;
+  int nb_absents;               /* ESRCH */
+  int nb_refuses;               /* EPERM */
+  int nb_echecs;                /* Hôte muet, lot précédent en route... */
+  int nb_atteints;              /* Processus signalés, membres des portées
+                                   compris */
+  pid_t pid;                    /* Processus unique, sinon premier échec */
+  int erreur;                   /* errno de 'pid' (0 : envoyé) */
+  int machine;                  /* Machine de 'pid' */
+  char nom[MAX_CMD_LEN];        /* Nom du processus unique (vide : envoi
+                                   aux processus marqués) */
+} envoi_signaux_t;
+
 /**
  * @brief Structure d'état du gestionnaire.
  */
 typedef struct manager_state {
-  /* Mode local */
-  processus_t *liste_processus;
+  /* Machine locale */
+  processus_t *liste_processus;  /* Vue affichée (collecte ou snapshot_local) */
+  processus_t *liste_collectee;  /* Génération locale de la collecte lue */
+  source_locale_t locale;        /* Table, scanner, connecteur et CPU locaux
+                                    (thread de la source locale) */
+  snapshot_t snapshot_local;      /* Vue avec threads dépliés */
+  cache_details_t details_local;  /* Champs coûteux des lignes visibles */
+  taches_t taches_local;          /* Threads par processus (mode threads) */
+  int mode_threads;               /* 1 : vue avec les threads dépliés */
+  memoire_t memoire_local;        /* PSS/USS/swap (smaps_rollup) sous budget */
+  int mode_memoire;               /* 1 : colonnes PSS/USS/SWAP affichées */
 
-  /* Mode réseau */
+  /* Filtre, tri et arborescence de l'onglet affiché */
+  filtre_t filtre;
+  snapshot_t snapshot_filtre;     /* Vue filtrée de la machine courante */
+  tri_t tri;
+  snapshot_t snapshot_tri;        /* Vue triée de la machine courante */
+  arbre_t arbre;                  /* Liens parent/enfant de la machine
+                                     courante (mode arbre) */
+  snapshot_t snapshot_arbre;      /* Vue arborescente */
+  int mode_arbre;                 /* 1 : vue arborescente (sans tri) */
+
+  /* Signaux */
+  envoi_signaux_t envoi;
+  portee_signal_t portee_signaux; /* Portée des touches F5 à F8 */
+
+  /* Machines et collecte */
   machine_info_t machines[MAX_MACHINES];
   int nb_machines;
   int machine_courante;
+  int vue_reseau;                 /* 1 : onglets par machine */
+  collecteur_t collecteur;        /* Un thread par source */
 
   /* Commun */
   ui_state_t ui_state;
   int running;
   int cycles;
+  int delai_ms; /* Période de rafraîchissement (-d) */
+  int delai_fond_ms; /* Période des onglets en arrière-plan (0 : auto) */
 } manager_state_t;
 
 /**
@@ -59,6 +158,17 @@ void manager_init(manager_state_t *state);
  */
 int manager_run_local(manager_state_t *state);
 
+/**
+ * @brief Active le suivi des processus locaux par le connecteur proc.
+ *
+ * En cas d'échec (droits insuffisants, noyau sans connecteur), la collecte
+ * reste le parcours périodique de /proc.
+ *
+ * @param state : Pointeur vers l'état du gestionnaire.
+ * @return int : 0 si le connecteur est actif, -1 sinon (errno renseigné).
+ */
+int manager_activer_connecteur(manager_state_t *state);
+
 /**
  * @brief Nettoie et libère les ressources du gestionnaire.
  * @param state : Pointeur vers l'état du gestionnaire.
@@ -66,7 +176,10 @@ int manager_run_local(manager_state_t *state);
 void manager_cleanup(manager_state_t *state);
 
 /**
- * @brief Gère une action sur un processus (kill, pause, continue).
+ * @brief Gère une action sur un processus (kill, pause, continue) : envoie
+ *        le signal à tous les processus marqués, sinon à la sélection.
+ *        Le bilan s'affiche quand les lots de toutes les machines sont
+ *        revenus.
  * @param state : Pointeur vers l'état du gestionnaire.
  * @param action : Code d'action à effectuer.
  */
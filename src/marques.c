@@ -0,0 +1,280 @@
+/**
+ * @file marques.c
+ * @brief Implémentation des processus marqués et des lots de signaux
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#include "marques.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Fonctions privées */
+
+/**
+ * @brief Marque en cours d'ajout (tri conjoint du PID et de sa date).
+ */
+typedef struct marque {
+  pid_t pid;
+  unsigned long long starttime;
+  int rang; /* Ordre d'arrivée : la première marque d'un PID est gardée */
+} marque_t;
+
+static int comparer_marques(const void *a, const void *b) {
+  const marque_t *ma = a;
+  const marque_t *mb = b;
+
+  if (ma->pid != mb->pid) {
+    return (ma->pid > mb->pid) - (ma->pid < mb->pid);
+  }
+  return (ma->rang > mb->rang) - (ma->rang < mb->rang);
+}
+
+/**
+ * @brief Garantit la capacité de l'ensemble (doublement).
+ */
+static int reserver(marques_t *marques, int nb) {
+  int capacite = marques->capacite ? marques->capacite : 64;
+  pid_t *pids;
+  unsigned long long *starttimes;
+
+  if (nb <= marques->capacite) {
+    return 0;
+  }
+  while (capacite < nb) {
+    capacite *= 2;
+  }
+  pids = realloc(marques->pids, (size_t)capacite * sizeof(pid_t));
+  if (pids == NULL) {
+    return -1;
+  }
+  marques->pids = pids;
+  starttimes = realloc(marques->starttimes,
+                       (size_t)capacite * sizeof(unsigned long long));
+  if (starttimes == NULL) {
+    return -1;
+  }
+  marques->starttimes = starttimes;
+  marques->capacite = capacite;
+  return 0;
+}
+
+/**
+ * @brief Position de 'pid' dans l'ensemble, ou de son insertion.
+ */
+static int position(const marques_t *marques, pid_t pid) {
+  int bas = 0;
+  int haut = marques->nb;
+
+  while (bas < haut) {
+    int milieu = bas + (haut - bas) / 2;
+    if (marques->pids[milieu] < pid) {
+      bas = milieu + 1;
+    } else {
+      haut = milieu;
+    }
+  }
+  return bas;
+}
+
+/* Fonctions publiques */
+
+void marques_init(marques_t *marques) { memset(marques, 0, sizeof(*marques)); }
+
+void marques_liberer(marques_t *marques) {
+  free(marques->pids);
+  free(marques->starttimes);
+  marques_init(marques);
+}
+
+void marques_vider(marques_t *marques) { marques->nb = 0; }
+
+int marques_contient(const marques_t *marques, pid_t pid) {
+  int i = position(marques, pid);
+
+  return i < marques->nb && marques->pids[i] == pid;
+}
+
+int marques_basculer(marques_t *marques, pid_t pid,
+                     unsigned long long starttime) {
+  int i = position(marques, pid);
+
+  if (i < marques->nb && marques->pids[i] == pid) {
+    memmove(&marques->pids[i], &marques->pids[i + 1],
+            (size_t)(marques->nb - i - 1) * sizeof(pid_t));
+    memmove(&marques->starttimes[i], &marques->starttimes[i + 1],
+            (size_t)(marques->nb - i - 1) * sizeof(unsigned long long));
+    marques->nb--;
+    return 0;
+  }
+  if (reserver(marques, marques->nb + 1) != 0) {
+    return -1;
+  }
+  memmove(&marques->pids[i + 1], &marques->pids[i],
+          (size_t)(marques->nb - i) * sizeof(pid_t));
+  memmove(&marques->starttimes[i + 1], &marques->starttimes[i],
+          (size_t)(marques->nb - i) * sizeof(unsigned long long));
+  marques->pids[i] = pid;
+  marques->starttimes[i] = starttime;
+  marques->nb++;
+  return 1;
+}
+
+int marques_ajouter(marques_t *marques, const pid_t *pids,
+                    const unsigned long long *starttimes, int nb) {
+  int total = marques->nb + nb;
+  int gardes = 0;
+  marque_t *tri;
+
+  if (nb <= 0) {
+    return 0;
+  }
+  tri = malloc((size_t)total * sizeof(marque_t));
+  if (tri == NULL || reserver(marques, total) != 0) {
+    free(tri);
+    return -1;
+  }
+  /* Marques existantes d'abord : elles gardent leur date */
+  for (int i = 0; i < marques->nb; i++) {
+    tri[i].pid = marques->pids[i];
+    tri[i].starttime = marques->starttimes[i];
+    tri[i].rang = i;
+  }
+  for (int i = 0; i < nb; i++) {
+    tri[marques->nb + i].pid = pids[i];
+    tri[marques->nb + i].starttime = starttimes[i];
+    tri[marques->nb + i].rang = marques->nb + i;
+  }
+  qsort(tri, (size_t)total, sizeof(marque_t), comparer_marques);
+
+  /* Doublons : déjà marqués, ou présents deux fois dans 'pids' */
+  for (int i = 0; i < total; i++) {
+    if (gardes == 0 || marques->pids[gardes - 1] != tri[i].pid) {
+      marques->pids[gardes] = tri[i].pid;
+      marques->starttimes[gardes] = tri[i].starttime;
+      gardes++;
+    }
+  }
+  marques->nb = gardes;
+  free(tri);
+  return 0;
+}
+
+int marques_elaguer(marques_t *marques, const processus_t *liste,
+                    unsigned long long tolerance) {
+  unsigned char *vivantes;
+  int gardes = 0;
+
+  if (marques->nb == 0) {
+    return 0;
+  }
+  vivantes = calloc((size_t)marques->nb, 1);
+  if (vivantes == NULL) {
+    return -1;
+  }
+
+  /* Une marque survit si son PID est collecté avec la même date */
+  for (const processus_t *p = liste; p != NULL; p = p->suivant) {
+    int i;
+    if (p->est_thread) {
+      continue;
+    }
+    i = position(marques, p->pid);
+    if (i < marques->nb && marques->pids[i] == p->pid &&
+        marques->starttimes[i] + tolerance >= p->starttime &&
+        p->starttime + tolerance >= marques->starttimes[i]) {
+      vivantes[i] = 1;
+    }
+  }
+  for (int i = 0; i < marques->nb; i++) {
+    if (vivantes[i]) {
+      marques->pids[gardes] = marques->pids[i];
+      marques->starttimes[gardes] = marques->starttimes[i];
+      gardes++;
+    }
+  }
+  free(vivantes);
+
+  int retirees = marques->nb - gardes;
+  marques->nb = gardes;
+  return retirees;
+}
+
+void lot_signaux_init(lot_signaux_t *lot) { memset(lot, 0, sizeof(*lot)); }
+
+void lot_signaux_liberer(lot_signaux_t *lot) {
+  free(lot->pids);
+  free(lot->starttimes);
+  free(lot->erreurs);
+  lot_signaux_init(lot);
+}
+
+int lot_signaux_preparer(lot_signaux_t *lot, const pid_t *pids,
+                         const unsigned long long *starttimes, int nb,
+                         int signal, portee_signal_t portee) {
+  if (nb > lot->capacite) {
+    pid_t *nouveaux_pids = realloc(lot->pids, (size_t)nb * sizeof(pid_t));
+    if (nouveaux_pids == NULL) {
+      return -1;
+    }
+    lot->pids = nouveaux_pids;
+
+    unsigned long long *starttimes =
+        realloc(lot->starttimes, (size_t)nb * sizeof(unsigned long long));
+    if (starttimes == NULL) {
+      return -1;
+    }
+    lot->starttimes = starttimes;
+
+    int *erreurs = realloc(lot->erreurs, (size_t)nb * sizeof(int));
+    if (erreurs == NULL) {
+      return -1;
+    }
+    lot->erreurs = erreurs;
+    lot->capacite = nb;
+  }
+
+  memcpy(lot->pids, pids, (size_t)nb * sizeof(pid_t));
+  if (starttimes != NULL) {
+    memcpy(lot->starttimes, starttimes,
+           (size_t)nb * sizeof(unsigned long long));
+  } else {
+    memset(lot->starttimes, 0, (size_t)nb * sizeof(unsigned long long));
+  }
+  memset(lot->erreurs, 0, (size_t)nb * sizeof(int));
+  lot->nb = nb;
+  lot->nb_atteints = 0;
+  lot->signal = signal;
+  lot->portee = portee;
+  return 0;
+}
+
+void lot_signaux_dater(lot_signaux_t *lot, pid_t pid,
+                       unsigned long long starttime) {
+  int bas = 0;
+  int haut = lot->nb;
+
+  while (bas < haut) {
+    int milieu = bas + (haut - bas) / 2;
+    if (lot->pids[milieu] < pid) {
+      bas = milieu + 1;
+    } else {
+      haut = milieu;
+    }
+  }
+  if (bas < lot->nb && lot->pids[bas] == pid) {
+    lot->starttimes[bas] = starttime;
+  }
+}
+
+const char *portee_signal_nom(portee_signal_t portee) {
+  switch (portee) {
+  case PORTEE_SOUS_ARBRE:
+    return "sous-arbre";
+  case PORTEE_GROUPE:
+    return "groupe";
+  case PORTEE_SESSION:
+    return "session";
+  default:
+    return "processus";
+  }
+}
@@ -0,0 +1,172 @@
+/**
+ * @file marques.h
+ * @brief Processus marqués et lots de signaux
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Chaque machine garde l'ensemble (trié) des PID marqués par l'utilisateur,
+ * un par un, par correspondance du filtre ou par utilisateur, avec la date
+ * de démarrage relevée au marquage : un PID réutilisé par un autre
+ * processus perd sa marque et n'est jamais signalé à sa place. Une action
+ * sur les processus part alors vers tout l'ensemble en un seul lot par
+ * machine : un passage local, une seule commande distante par hôte, envoyée
+ * par le thread de chaque source (donc simultanément pour tous les hôtes).
+ * La source renseigne le résultat de chaque PID du lot.
+ *
+ * Un lot peut viser, pour chaque PID, le processus seul, son sous-arbre,
+ * son groupe ou sa session ; la date de démarrage de chaque PID permet à
+ * la source de refuser un PID réutilisé entre-temps.
+ */
+
+#ifndef MARQUES_H
+#define MARQUES_H
+
+#include "process.h"
+#include <sys/types.h>
+
+/**
+ * @brief Ensemble de PID marqués (triés, sans doublon).
+ */
+typedef struct marques {
+  pid_t *pids;
+  unsigned long long *starttimes; /* Date de démarrage de chaque PID au
+                                     marquage */
+  int nb;
+  int capacite;
+} marques_t;
+
+/**
+ * @brief Processus atteints par le signal de chaque PID d'un lot.
+ */
+typedef enum portee_signal {
+  PORTEE_PROCESSUS = 0, /* Le processus seul */
+  PORTEE_SOUS_ARBRE,    /* Le processus et ses descendants */
+  PORTEE_GROUPE,        /* Son groupe de processus */
+  PORTEE_SESSION,       /* Sa session */
+  PORTEE_NB
+} portee_signal_t;
+
+/**
+ * @brief Signal à envoyer à plusieurs processus d'une même machine.
+ */
+typedef struct lot_signaux {
+  int signal;
+  portee_signal_t portee;
+  pid_t *pids;    /* Triés (lot_signaux_dater) */
+  unsigned long long *starttimes; /* Date de démarrage attendue de chaque
+                                     PID (0 : non vérifiée) */
+  int *erreurs;   /* errno de chaque PID (0 : signal envoyé), rempli par la
+                     source */
+  int nb_atteints; /* Processus signalés, membres des portées compris,
+                      rempli par la source */
+  int nb;
+  int capacite;
+} lot_signaux_t;
+
+/**
+ * @brief Initialise un ensemble vide.
+ * @param marques : Ensemble à initialiser.
+ */
+void marques_init(marques_t *marques);
+
+/**
+ * @brief Libère un ensemble.
+ * @param marques : Ensemble à libérer.
+ */
+void marques_liberer(marques_t *marques);
+
+/**
+ * @brief Retire toutes les marques.
+ * @param marques : Ensemble concerné.
+ */
+void marques_vider(marques_t *marques);
+
+/**
+ * @brief Indique si un PID est marqué (recherche dichotomique).
+ * @param marques : Ensemble concerné.
+ * @param pid : PID cherché.
+ * @return int : 1 si marqué, 0 sinon.
+ */
+int marques_contient(const marques_t *marques, pid_t pid);
+
+/**
+ * @brief Marque un PID non marqué, ou retire sa marque.
+ * @param marques : Ensemble concerné.
+ * @param pid : PID à basculer.
+ * @param starttime : Date de démarrage du processus marqué.
+ * @return int : 1 si le PID est maintenant marqué, 0 s'il ne l'est plus,
+ *               -1 en cas d'erreur mémoire.
+ */
+int marques_basculer(marques_t *marques, pid_t pid,
+                     unsigned long long starttime);
+
+/**
+ * @brief Marque plusieurs PID en une fois (ajout puis un seul tri). Un PID
+ *        déjà marqué garde sa date de démarrage.
+ * @param marques : Ensemble concerné.
+ * @param pids : PID à marquer (dans n'importe quel ordre).
+ * @param starttimes : Date de démarrage de chaque PID.
+ * @param nb : Nombre de PID.
+ * @return int : 0 en cas de succès, -1 en cas d'erreur mémoire.
+ */
+int marques_ajouter(marques_t *marques, const pid_t *pids,
+                    const unsigned long long *starttimes, int nb);
+
+/**
+ * @brief Oublie les PID absents de la dernière collecte, ou dont le
+ *        processus n'a plus la date de démarrage relevée au marquage
+ *        (PID réutilisé).
+ * @param marques : Ensemble concerné.
+ * @param liste : Processus de la collecte (lignes de threads ignorées).
+ * @param tolerance : Écart toléré sur les dates (ticks ; 0 : exactes).
+ * @return int : Nombre de marques retirées, -1 en cas d'erreur mémoire
+ *               (marques inchangées).
+ */
+int marques_elaguer(marques_t *marques, const processus_t *liste,
+                    unsigned long long tolerance);
+
+/**
+ * @brief Initialise un lot vide.
+ * @param lot : Lot à initialiser.
+ */
+void lot_signaux_init(lot_signaux_t *lot);
+
+/**
+ * @brief Libère un lot.
+ * @param lot : Lot à libérer.
+ */
+void lot_signaux_liberer(lot_signaux_t *lot);
+
+/**
+ * @brief Prépare un lot (résultats remis à zéro).
+ * @param lot : Lot à remplir.
+ * @param pids : PID destinataires, triés.
+ * @param starttimes : Date de démarrage de chaque PID (NULL : non
+ *                     vérifiées).
+ * @param nb : Nombre de PID.
+ * @param signal : Signal à envoyer.
+ * @param portee : Processus visés autour de chaque PID.
+ * @return int : 0 en cas de succès, -1 en cas d'erreur mémoire.
+ */
+int lot_signaux_preparer(lot_signaux_t *lot, const pid_t *pids,
+                         const unsigned long long *starttimes, int nb,
+                         int signal, portee_signal_t portee);
+
+/**
+ * @brief Retient la date de démarrage d'un PID du lot (recherche
+ *        dichotomique, PID absents du lot ignorés).
+ * @param lot : Lot préparé.
+ * @param pid : PID de la collecte affichée.
+ * @param starttime : Sa date de démarrage.
+ */
+void lot_signaux_dater(lot_signaux_t *lot, pid_t pid,
+                       unsigned long long starttime);
+
+/**
+ * @brief Libellé d'une portée ("processus", "sous-arbre", "groupe",
+ *        "session").
+ * @param portee : Portée.
+ * @return const char* : Libellé.
+ */
+const char *portee_signal_nom(portee_signal_t portee);
+
+#endif /* MARQUES_H */
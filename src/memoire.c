@@ -0,0 +1,271 @@
+/**
+ * @file memoire.c
+ * @brief Implémentation du suivi PSS/USS/swap sous budget de temps
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "memoire.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Fonctions privées */
+
+static unsigned int hacher_pid(pid_t pid, int taille) {
+  return ((unsigned int)pid * 2654435761u) & (unsigned int)(taille - 1);
+}
+
+static long long maintenant_us(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Reconstruit l'index PID -> entrée (après ajout ou compactage).
+ */
+static int reconstruire_index(memoire_t *memoire) {
+  int taille = memoire->taille_index ? memoire->taille_index : 128;
+
+  while (taille < memoire->capacite * 2) {
+    taille *= 2;
+  }
+  if (taille != memoire->taille_index) {
+    int *index = malloc(sizeof(int) * taille);
+    if (index == NULL) {
+      return -1;
+    }
+    free(memoire->index);
+    memoire->index = index;
+    memoire->taille_index = taille;
+  }
+
+  memset(memoire->index, -1, sizeof(int) * memoire->taille_index);
+  for (int e = 0; e < memoire->nb; e++) {
+    unsigned int i =
+        hacher_pid(memoire->entrees[e].pid, memoire->taille_index);
+    while (memoire->index[i] != -1) {
+      i = (i + 1) & (unsigned int)(memoire->taille_index - 1);
+    }
+    memoire->index[i] = e;
+  }
+  return 0;
+}
+
+/**
+ * @brief Numéro de l'entrée d'un PID, ou -1.
+ */
+static int trouver_entree(const memoire_t *memoire, pid_t pid) {
+  if (memoire->taille_index == 0) {
+    return -1;
+  }
+
+  unsigned int masque = (unsigned int)(memoire->taille_index - 1);
+  unsigned int i = hacher_pid(pid, memoire->taille_index);
+  while (memoire->index[i] != -1) {
+    if (memoire->entrees[memoire->index[i]].pid == pid) {
+      return memoire->index[i];
+    }
+    i = (i + 1) & masque;
+  }
+  return -1;
+}
+
+/**
+ * @brief Retourne l'entrée du processus, créée (ou remise à zéro si le PID
+ *        a été réutilisé) au besoin.
+ */
+static memoire_processus_t *obtenir_entree(memoire_t *memoire,
+                                           const processus_t *proc) {
+  int numero = trouver_entree(memoire, proc->pid);
+  memoire_processus_t *e;
+
+  if (numero >= 0) {
+    e = &memoire->entrees[numero];
+    if (e->starttime == proc->starttime) {
+      return e;
+    }
+  } else {
+    if (memoire->nb == memoire->capacite) {
+      int capacite = memoire->capacite ? memoire->capacite * 2 : 128;
+      memoire_processus_t *entrees =
+          realloc(memoire->entrees, sizeof(memoire_processus_t) * capacite);
+      if (entrees == NULL) {
+        return NULL;
+      }
+      memoire->entrees = entrees;
+      memoire->capacite = capacite;
+    }
+
+    numero = memoire->nb++;
+    e = &memoire->entrees[numero];
+    e->pid = proc->pid;
+    if (memoire->taille_index < memoire->capacite * 2) {
+      if (reconstruire_index(memoire) != 0) {
+        memoire->nb--;
+        return NULL;
+      }
+    } else {
+      unsigned int i = hacher_pid(e->pid, memoire->taille_index);
+      while (memoire->index[i] != -1) {
+        i = (i + 1) & (unsigned int)(memoire->taille_index - 1);
+      }
+      memoire->index[i] = numero;
+    }
+  }
+
+  e->starttime = proc->starttime;
+  e->vu = 0;
+  e->lu = 0;
+  e->instant_ms = 0;
+  e->smaps.pss_ko = -1;
+  e->smaps.uss_ko = -1;
+  e->smaps.swap_ko = -1;
+  return e;
+}
+
+/**
+ * @brief Relit smaps_rollup pour une entrée ; une lecture refusée est
+ *        datée comme une autre pour ne pas être retentée à chaque passage.
+ */
+static void lire_entree(memoire_t *memoire, memoire_processus_t *e) {
+  if (procfs_lire_smaps_rollup(&memoire->lecteur, e->pid, &e->smaps) != 0) {
+    e->smaps.pss_ko = -1;
+    e->smaps.uss_ko = -1;
+    e->smaps.swap_ko = -1;
+  }
+  e->lu = memoire->rafraichissement;
+  e->instant_ms = maintenant_us() / 1000;
+  memoire->nb_lectures++;
+}
+
+/**
+ * @brief Lit la ligne 'proc' si elle n'a pas été lue à ce rafraîchissement.
+ */
+static void lire_ligne(memoire_t *memoire, const processus_t *proc) {
+  int numero;
+
+  if (proc->est_thread) {
+    return;
+  }
+  numero = trouver_entree(memoire, proc->pid);
+  if (numero < 0) {
+    return;
+  }
+
+  memoire_processus_t *e = &memoire->entrees[numero];
+  if (e->starttime == proc->starttime && e->lu != memoire->rafraichissement) {
+    lire_entree(memoire, e);
+  }
+}
+
+/* Fonctions publiques */
+
+int memoire_init(memoire_t *memoire) {
+  memset(memoire, 0, sizeof(*memoire));
+  memoire->rafraichissement = 1;
+  memoire->budget_us = MEMOIRE_BUDGET_US;
+  return procfs_ouvrir(&memoire->lecteur);
+}
+
+void memoire_liberer(memoire_t *memoire) {
+  procfs_fermer(&memoire->lecteur);
+  free(memoire->entrees);
+  free(memoire->index);
+  memset(memoire, 0, sizeof(*memoire));
+  memoire->lecteur.proc_fd = -1;
+}
+
+void memoire_rafraichir(memoire_t *memoire, const processus_t *liste,
+                        const processus_t *selection,
+                        const processus_t *visibles, int nb_visibles) {
+  unsigned int r = ++memoire->rafraichissement;
+  long long echeance = maintenant_us() + memoire->budget_us;
+
+  memoire->nb_lectures = 0;
+
+  for (const processus_t *p = liste; p != NULL; p = p->suivant) {
+    if (p->est_thread) {
+      continue;
+    }
+    memoire_processus_t *e = obtenir_entree(memoire, p);
+    if (e != NULL) {
+      e->vu = r;
+    }
+  }
+
+  /* Oublier les processus disparus */
+  for (int i = 0; i < memoire->nb;) {
+    if (memoire->entrees[i].vu == r) {
+      i++;
+      continue;
+    }
+    memoire->entrees[i] = memoire->entrees[--memoire->nb];
+  }
+  reconstruire_index(memoire);
+
+  /* Priorité : sélection, lignes visibles, puis le reste à tour de rôle */
+  if (selection != NULL) {
+    lire_ligne(memoire, selection);
+  }
+  for (int i = 0; visibles != NULL && i < nb_visibles; i++) {
+    if (maintenant_us() >= echeance) {
+      break;
+    }
+    lire_ligne(memoire, visibles);
+    visibles = visibles->suivant;
+  }
+
+  /* Au moins une lecture : le tour de rôle progresse même quand les lignes
+     prioritaires ont épuisé le budget */
+  int lus = 0;
+  for (int n = 0; n < memoire->nb; n++) {
+    if (lus > 0 && maintenant_us() >= echeance) {
+      break;
+    }
+    if (memoire->curseur >= memoire->nb) {
+      memoire->curseur = 0;
+    }
+    memoire_processus_t *e = &memoire->entrees[memoire->curseur++];
+    if (e->lu != r) {
+      lire_entree(memoire, e);
+      lus++;
+    }
+  }
+}
+
+void memoire_completer(memoire_t *memoire, const processus_t *visibles,
+                       int nb_visibles) {
+  long long echeance = maintenant_us() + memoire->budget_us;
+
+  for (int i = 0; visibles != NULL && i < nb_visibles; i++) {
+    if (maintenant_us() >= echeance) {
+      return;
+    }
+    int numero =
+        visibles->est_thread ? -1 : trouver_entree(memoire, visibles->pid);
+    if (numero >= 0 && memoire->entrees[numero].lu == 0 &&
+        memoire->entrees[numero].starttime == visibles->starttime) {
+      lire_entree(memoire, &memoire->entrees[numero]);
+    }
+    visibles = visibles->suivant;
+  }
+}
+
+const memoire_processus_t *memoire_chercher(const memoire_t *memoire,
+                                            const processus_t *proc) {
+  int numero = trouver_entree(memoire, proc->pid);
+
+  if (numero < 0 || memoire->entrees[numero].lu == 0 ||
+      memoire->entrees[numero].starttime != proc->starttime) {
+    return NULL;
+  }
+  return &memoire->entrees[numero];
+}
+
+int memoire_perimee(const memoire_processus_t *mesure) {
+  return maintenant_us() / 1000 - mesure->instant_ms > MEMOIRE_PERIMEE_MS;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file memoire.h
+ * @brief Mémoire proportionnelle (PSS), unique (USS) et swap par processus
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Le RSS compte chaque page partagée dans tous les processus qui la
+ * projettent. /proc/[PID]/smaps_rollup donne la part réelle de chacun, mais
+ * le noyau doit parcourir toutes les projections pour le produire : les
+ * lectures d'un rafraîchissement sont donc limitées par un budget de temps.
+ * Le processus sélectionné passe en premier, puis les lignes visibles, puis
+ * les autres à tour de rôle sur plusieurs rafraîchissements. Chaque mesure
+ * est datée pour signaler les valeurs anciennes.
+ */
+
+#ifndef MEMOIRE_H
+#define MEMOIRE_H
+
+#include "process.h"
+#include "procfs.h"
+
+#define MEMOIRE_BUDGET_US 20000  /* Temps de lecture de smaps_rollup par rafraîchissement */
+#define MEMOIRE_PERIMEE_MS 6000  /* Âge au-delà duquel une mesure est signalée */
+
+/**
+ * @brief Dernière mesure d'un processus.
+ */
+typedef struct memoire_processus {
+  pid_t pid;
+  unsigned long long starttime;
+  unsigned int vu;       /* Dernier rafraîchissement où le processus était vivant */
+  unsigned int lu;       /* Rafraîchissement de la dernière lecture (0 : jamais) */
+  long long instant_ms;  /* Date de la dernière lecture (horloge monotone) */
+  procfs_smaps_t smaps;  /* Valeurs lues (-1 : illisibles) */
+} memoire_processus_t;
+
+/**
+ * @brief Mesures de tous les processus suivis.
+ */
+typedef struct memoire {
+  memoire_processus_t *entrees; /* [0, nb[ : processus vivants */
+  int nb;
+  int capacite;
+  int *index;                   /* Hachage PID -> entrée (-1 si vide) */
+  int taille_index;             /* Puissance de 2 */
+  unsigned int rafraichissement;
+  int curseur;                  /* Prochaine entrée du tour de rôle */
+  long budget_us;
+  procfs_lecteur_t lecteur;
+  unsigned long nb_lectures;    /* Lectures au dernier rafraîchissement */
+} memoire_t;
+
+/**
+ * @brief Initialise le suivi de la mémoire.
+ * @param memoire : Structure à initialiser.
+ * @return int : 0 en cas de succès, -1 si /proc est inaccessible.
+ */
+int memoire_init(memoire_t *memoire);
+
+/**
+ * @brief Libère le suivi de la mémoire.
+ * @param memoire : Structure à libérer.
+ */
+void memoire_liberer(memoire_t *memoire);
+
+/**
+ * @brief Suit les processus de la génération et relit smaps_rollup dans
+ *        la limite du budget : sélection, lignes visibles, puis tour de rôle.
+ * @param memoire : Structure concernée.
+ * @param liste : Processus vivants (les lignes de threads sont ignorées).
+ * @param selection : Processus sélectionné (peut être NULL).
+ * @param visibles : Première ligne visible (peut être NULL).
+ * @param nb_visibles : Nombre de lignes visibles.
+ */
+void memoire_rafraichir(memoire_t *memoire, const processus_t *liste,
+                        const processus_t *selection,
+                        const processus_t *visibles, int nb_visibles);
+
+/**
+ * @brief Mesure les lignes visibles encore jamais lues (après un défilement),
+ *        dans la limite du budget.
+ * @param memoire : Structure concernée.
+ * @param visibles : Première ligne visible.
+ * @param nb_visibles : Nombre de lignes visibles.
+ */
+void memoire_completer(memoire_t *memoire, const processus_t *visibles,
+                       int nb_visibles);
+
+/**
+ * @brief Retourne la dernière mesure d'un processus.
+ * @param memoire : Structure concernée.
+ * @param proc : Processus recherché.
+ * @return const memoire_processus_t* : Mesure, ou NULL si jamais lue.
+ */
+const memoire_processus_t *memoire_chercher(const memoire_t *memoire,
+                                            const processus_t *proc);
+
+/**
+ * @brief Indique si une mesure est plus ancienne que MEMOIRE_PERIMEE_MS.
+ * @param mesure : Mesure à tester.
+ * @return int : 1 si la mesure est ancienne, 0 sinon.
+ */
+int memoire_perimee(const memoire_processus_t *mesure);
+
+#endif /* MEMOIRE_H */
@@ -9,16 +9,45 @@
 #include "network.h"
 #include <errno.h>
 #include <libssh/libssh.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
+#include <stdint.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Membres d'une portée distante ("a" : sous-arbre de $2, "g" : groupe $2,
+   "s" : session $2), hors shell de la commande, ses enfants et ses
+   ancêtres (la connexion SSH ne doit être ni gelée ni signalée) */
+#define SCRIPT_MEMBRES                                                         \
+  "M(){ ps -eo pid=,ppid=,pgid=,sid= | awk -v m=$1 -v c=$2 -v s=$$ "           \
+  "'{p[$1]=$2;g[$1]=$3;k[$1]=$4}END{y=s;while(y in p){a[y]=1;y=p[y]}"         \
+  "for(x in p){if(x in a)continue;y=x;while((y in p)&&y!=s)y=p[y];"           \
+  "if(y==s)continue;if(m==\"g\"&&g[x]!=c||m==\"s\"&&k[x]!=c)continue;"        \
+  "if(m==\"a\"){y=x;while((y in p)&&y!=c)y=p[y];if(y!=c)continue}"            \
+  "print x}}'; }; "
+
+/**
+ * @brief Requête en cours sur le shell persistant.
+ */
+typedef struct requete_shell {
+  flux_traiter_ligne_t traiter; /* Traitement des lignes de la commande */
+  void *contexte;
+  char debut[80];               /* Première ligne attendue */
+  char fin[80];                 /* Ligne de fin attendue */
+  int ouverte;                  /* 1 : ligne de début reçue */
+  int etat;                     /* État du traitement */
+  int nb_lignes;                /* Lignes reçues avant la fin */
+} requete_shell_t;
 
 /* Fonctions privées */
 
 /**
  * @brief Parse une ligne du fichier de configuration.
- * Format: nom:adresse:port:username:password:type
+ * Format: nom:adresse:port:username:password:type[:periode_ms]
  */
 static int parse_config_line(const char *line, remote_host_t *host) {
   char type_str[16];
@@ -28,11 +57,14 @@ static int parse_config_line(const char *line, remote_host_t *host) {
   line_copy[sizeof(line_copy) - 1] = '\0';
 
   /* Parser la ligne */
+  host->periode_ms = 0;
   int nb_fields = sscanf(
-      line_copy, "%255[^:]:%255[^:]:%d:%63[^:]:%127[^:]:%15s", host->nom,
-      host->adresse, &host->port, host->username, host->password, type_str);
+      line_copy, "%255[^:]:%255[^:]:%d:%63[^:]:%127[^:]:%15[^: \t\r\n]:%d",
+      host->nom, host->adresse, &host->port, host->username, host->password,
+      type_str, &host->periode_ms);
 
-  if (nb_fields != 6) {
+  /* Période de rafraîchissement propre à l'hôte : optionnelle */
+  if (nb_fields < 6 || host->periode_ms < 0) {
     return -1;
   }
 
@@ -45,136 +77,660 @@ static int parse_config_line(const char *line, remote_host_t *host) {
     return -1;
   }
 
-  host->session = NULL;
+  init_remote_host(host);
   return 0;
 }
 
 /**
- * @brief Exécute une commande SSH et retourne la sortie.
+ * @brief Horloge monotone en millisecondes.
  */
-static char *execute_ssh_command(ssh_session session, const char *command) {
-  ssh_channel channel;
-  int rc;
-  char buffer[4096];
+static long long maintenant_ms(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Change l'état de la connexion (lu par l'interface).
+ * @param erreur : Format de la cause (NULL : inchangée).
+ */
+static void changer_etat(remote_host_t *host, etat_connexion_t etat,
+                         const char *erreur, ...) {
+  va_list arguments;
+
+  pthread_mutex_lock(&host->verrou_etat);
+  host->etat = etat;
+  if (erreur != NULL) {
+    va_start(arguments, erreur);
+    vsnprintf(host->erreur, sizeof(host->erreur), erreur, arguments);
+    va_end(arguments);
+  }
+  pthread_mutex_unlock(&host->verrou_etat);
+}
+
+/**
+ * @brief Planifie le prochain essai après 'nb_echecs' échecs de suite :
+ *        SSH_RECONNEXION_MIN_MS doublé à chaque échec, plafonné, puis
+ *        tiré dans la seconde moitié de l'intervalle.
+ */
+static void planifier_essai(remote_host_t *host) {
+  long long attente = SSH_RECONNEXION_MAX_MS;
+
+  if (host->nb_echecs < 16) {
+    attente = (long long)SSH_RECONNEXION_MIN_MS << host->nb_echecs;
+    if (attente > SSH_RECONNEXION_MAX_MS) {
+      attente = SSH_RECONNEXION_MAX_MS;
+    }
+  }
+  attente = attente / 2 + rand_r(&host->graine) % (attente / 2 + 1);
+
+  pthread_mutex_lock(&host->verrou_etat);
+  host->prochaine_tentative_ms = maintenant_ms() + attente;
+  pthread_mutex_unlock(&host->verrou_etat);
+}
+
+/**
+ * @brief Connecte l'hôte s'il ne l'est pas et que son prochain essai est
+ *        dû (verrou tenu).
+ * @return int : 0 si la session est utilisable, -1 sinon.
+ */
+static int assurer_connexion(remote_host_t *host) {
+  etat_connexion_t etat;
+  long long prochaine;
+
+  if (host->session != NULL) {
+    return 0;
+  }
+
+  pthread_mutex_lock(&host->verrou_etat);
+  etat = host->etat;
+  prochaine = host->prochaine_tentative_ms;
+  pthread_mutex_unlock(&host->verrou_etat);
+  if (maintenant_ms() < prochaine) {
+    return -1;
+  }
+
+  if (etat != CONNEXION_EN_COURS) {
+    changer_etat(host, CONNEXION_REESSAI, NULL);
+  }
+  if (connect_ssh(host) != 0) {
+    planifier_essai(host);
+    host->nb_echecs++;
+    changer_etat(host, CONNEXION_ECHOUEE, NULL);
+    return -1;
+  }
+
+  host->nb_echecs = 0;
+  host->echecs_collecte = 0;
+  changer_etat(host, CONNEXION_ETABLIE, "");
+  return 0;
+}
+
+/**
+ * @brief Lit un canal dans host->flux jusqu'à la fin de la réponse.
+ *
+ * Les octets sont lus directement dans le tampon du flux et analysés au
+ * fil de l'eau ; un hôte muet ne bloque pas son thread indéfiniment.
+ * @return int : FLUX_FIN (réponse complète selon le traitement),
+ *               FLUX_CONTINUER (fin du canal atteinte) ou FLUX_ERREUR
+ *               (délai expiré, sortie tronquée, ligne refusée).
+ */
+static int lire_canal(remote_host_t *host, ssh_channel channel) {
+  flux_lignes_t *flux = &host->flux;
+  size_t disponible;
+  char *zone;
   int nbytes;
-  char *output = NULL;
-  int output_size = 0;
 
-  channel = ssh_channel_new(session);
+  while (flux->etat == FLUX_CONTINUER) {
+    zone = flux_zone(flux, &disponible);
+    if (zone == NULL) {
+      return FLUX_ERREUR;
+    }
+    nbytes = ssh_channel_read_timeout(channel, zone, (uint32_t)disponible, 0,
+                                      SSH_DELAI_LECTURE_MS);
+    if (nbytes <= 0) {
+      /* Délai expiré avant la fin de la sortie : résultat tronqué */
+      return ssh_channel_is_eof(channel) ? flux_terminer(flux) : FLUX_ERREUR;
+    }
+    flux_valider(flux, (size_t)nbytes);
+  }
+  return flux->etat;
+}
+
+/**
+ * @brief Écrit toutes les données sur un canal.
+ * @return int : 0 en cas de succès, -1 si le canal est fermé.
+ */
+static int ecrire_canal(ssh_channel channel, const char *donnees,
+                        size_t taille) {
+  while (taille > 0) {
+    int nbytes = ssh_channel_write(channel, donnees, (uint32_t)taille);
+    if (nbytes <= 0) {
+      return -1;
+    }
+    donnees += nbytes;
+    taille -= (size_t)nbytes;
+  }
+  return 0;
+}
+
+/**
+ * @brief Exécute une commande SSH sur un nouveau canal (shell persistant
+ *        indisponible) et traite sa sortie ligne par ligne.
+ * @return int : État final du flux (voir lire_canal()), FLUX_ERREUR si le
+ *               canal n'a pas pu être ouvert.
+ */
+static int executer_commande_canal(remote_host_t *host, const char *command,
+                                   flux_traiter_ligne_t traiter,
+                                   void *contexte) {
+  ssh_channel channel;
+  int etat;
+
+  channel = ssh_channel_new(host->session);
   if (channel == NULL) {
-    return NULL;
+    return FLUX_ERREUR;
   }
 
-  rc = ssh_channel_open_session(channel);
-  if (rc != SSH_OK) {
+  if (ssh_channel_open_session(channel) != SSH_OK) {
     ssh_channel_free(channel);
-    return NULL;
+    return FLUX_ERREUR;
   }
 
-  rc = ssh_channel_request_exec(channel, command);
-  if (rc != SSH_OK) {
+  if (ssh_channel_request_exec(channel, command) != SSH_OK) {
     ssh_channel_close(channel);
     ssh_channel_free(channel);
-    return NULL;
+    return FLUX_ERREUR;
   }
 
-  /* Lire la sortie */
-  while ((nbytes = ssh_channel_read(channel, buffer, sizeof(buffer) - 1, 0)) >
-         0) {
-    buffer[nbytes] = '\0';
+  flux_commencer(&host->flux, traiter, contexte);
+  etat = lire_canal(host, channel);
 
-    char *new_output = realloc(output, output_size + nbytes + 1);
-    if (new_output == NULL) {
-      free(output);
-      ssh_channel_close(channel);
-      ssh_channel_free(channel);
-      return NULL;
-    }
+  ssh_channel_send_eof(channel);
+  ssh_channel_close(channel);
+  ssh_channel_free(channel);
+  return etat;
+}
+
+static void fermer_shell(remote_host_t *host) {
+  if (host->canal_shell != NULL) {
+    ssh_channel_send_eof(host->canal_shell);
+    ssh_channel_close(host->canal_shell);
+    ssh_channel_free(host->canal_shell);
+    host->canal_shell = NULL;
+  }
+}
+
+/**
+ * @brief Tire un jeton hexadécimal dans /dev/urandom (rand_r en dernier
+ *        recours) : celui d'un nouveau shell, ou d'une requête /proc.
+ * @param dest : Reçoit le jeton, terminé par '\0'.
+ * @param taille : Taille de 'dest' (au plus SSH_TAILLE_JETON octets tirés).
+ */
+static void tirer_jeton(remote_host_t *host, char *dest, size_t taille) {
+  unsigned char octets[SSH_TAILLE_JETON];
+  size_t nb = (taille - 1) / 2;
+  FILE *f = fopen("/dev/urandom", "rb");
+  size_t lus = 0;
 
-    output = new_output;
-    if (output_size == 0) {
-      output[0] = '\0';
+  if (nb > sizeof(octets)) {
+    nb = sizeof(octets);
+  }
+  if (f != NULL) {
+    lus = fread(octets, 1, nb, f);
+    fclose(f);
+  }
+  dest[0] = '\0';
+  for (size_t i = 0; i < nb; i++) {
+    if (i >= lus) {
+      octets[i] = (unsigned char)rand_r(&host->graine);
     }
-    strcat(output, buffer);
-    output_size += nbytes;
+    snprintf(dest + 2 * i, 3, "%02x", octets[i]);
   }
+}
 
-  ssh_channel_send_eof(channel);
-  ssh_channel_close(channel);
-  ssh_channel_free(channel);
+/**
+ * @brief Ouvre le shell persistant de l'hôte, avec un nouveau jeton.
+ * @return int : 0 en cas de succès, -1 sinon.
+ */
+static int ouvrir_shell(remote_host_t *host) {
+  tirer_jeton(host, host->jeton_shell, sizeof(host->jeton_shell));
+  host->canal_shell = ssh_channel_new(host->session);
+  if (host->canal_shell == NULL) {
+    return -1;
+  }
+  if (ssh_channel_open_session(host->canal_shell) != SSH_OK) {
+    ssh_channel_free(host->canal_shell);
+    host->canal_shell = NULL;
+    return -1;
+  }
+  if (ssh_channel_request_exec(host->canal_shell, SSH_SHELL_COMMANDE) !=
+      SSH_OK) {
+    fermer_shell(host);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Traitement des lignes d'une requête du shell : la réponse doit
+ *        commencer par la ligne de début, la ligne de fin la termine, les
+ *        autres passent au traitement de la requête. Après un refus de ce
+ *        dernier, la réponse est lue jusqu'à sa fin pour que le canal reste
+ *        synchronisé.
+ * @return int : FLUX_ERREUR si la réponse ne commence pas par la ligne de
+ *               début (reste d'une réponse précédente : canal
+ *               désynchronisé).
+ */
+static int lire_ligne_shell(void *contexte, char *ligne, size_t longueur) {
+  requete_shell_t *requete = contexte;
 
-  return output;
+  if (!requete->ouverte) {
+    requete->ouverte = strcmp(ligne, requete->debut) == 0;
+    return requete->ouverte ? FLUX_CONTINUER : FLUX_ERREUR;
+  }
+  if (strcmp(ligne, requete->fin) == 0) {
+    return FLUX_FIN;
+  }
+  requete->nb_lignes++;
+  if (longueur > 0 && requete->etat == FLUX_CONTINUER) {
+    requete->etat = requete->traiter(requete->contexte, ligne, longueur);
+  }
+  return FLUX_CONTINUER;
 }
 
 /**
- * @brief Parse la sortie de 'ps aux' et construit une liste de processus.
+ * @brief Exécute une commande sur le shell persistant de l'hôte et traite
+ *        sa sortie ligne par ligne : un seul aller-retour, sans ouverture
+ *        de canal.
+ *
+ * La commande est encadrée ("echo <début>; { commande } ; echo <fin>") et
+ * sa réponse lue jusqu'à la ligne de fin ; début et fin portent le jeton
+ * aléatoire du shell et le numéro de la requête. Une réponse qui ne
+ * commence pas par la ligne de début ou qui se poursuit après la ligne de
+ * fin ferme le shell. Un shell mort (connexion coupée,
+ * shell terminé) est rouvert et la commande rejouée si elle n'avait rien
+ * produit ; un serveur qui refuse le shell reçoit une commande par canal.
+ * @return int : État final du traitement (FLUX_CONTINUER ou FLUX_FIN :
+ *               réponse complète), FLUX_ERREUR si la réponse est
+ *               incomplète ou refusée.
  */
-static processus_t *parse_ps_output(const char *output) {
-  processus_t *head = NULL;
-  processus_t *current = NULL;
-  char *output_copy = strdup(output);
-  char *line = strtok(output_copy, "\n");
-  int first_line = 1;
-
-  while (line != NULL) {
-    /* Ignorer la ligne d'en-tête */
-    if (first_line) {
-      first_line = 0;
-      line = strtok(NULL, "\n");
-      continue;
+static int executer_commande(remote_host_t *host, const char *command,
+                             flux_traiter_ligne_t traiter, void *contexte) {
+  requete_shell_t requete;
+  char prefixe[128];
+  char suffixe[128];
+  int longueur_prefixe, longueur;
+
+  for (int essai = 0; essai < 2; essai++) {
+    if (host->canal_shell == NULL &&
+        (host->shell_indisponible || ouvrir_shell(host) != 0)) {
+      host->shell_indisponible = 1;
+      return executer_commande_canal(host, command, traiter, contexte);
+    }
+
+    /* Entrée standard détachée : le shell lit ses requêtes sur la sienne */
+    host->sequence_shell++;
+    snprintf(requete.debut, sizeof(requete.debut), "%s %s %u",
+             SSH_SHELL_DEBUT, host->jeton_shell, host->sequence_shell);
+    snprintf(requete.fin, sizeof(requete.fin), "%s %s %u", SSH_SHELL_FIN,
+             host->jeton_shell, host->sequence_shell);
+    longueur_prefixe = snprintf(prefixe, sizeof(prefixe), "echo '%s'; { ",
+                                requete.debut);
+    longueur = snprintf(suffixe, sizeof(suffixe),
+                        "\n} </dev/null 2>/dev/null; echo; echo '%s'\n",
+                        requete.fin);
+    requete.traiter = traiter;
+    requete.contexte = contexte;
+    requete.ouverte = 0;
+    requete.etat = FLUX_CONTINUER;
+    requete.nb_lignes = 0;
+    flux_commencer(&host->flux, lire_ligne_shell, &requete);
+
+    int ecrit = ecrire_canal(host->canal_shell, prefixe,
+                             (size_t)longueur_prefixe) == 0 &&
+                ecrire_canal(host->canal_shell, command, strlen(command)) ==
+                    0 &&
+                ecrire_canal(host->canal_shell, suffixe, (size_t)longueur) ==
+                    0;
+    int etat = ecrit ? lire_canal(host, host->canal_shell) : FLUX_ERREUR;
+    if (etat == FLUX_FIN && host->flux.reste == 0) {
+      return requete.etat;
+    }
+
+    /* Réponse incomplète ou suivie d'autres octets : le canal est
+       désynchronisé ou mort */
+    int mort = !ecrit || ssh_channel_is_eof(host->canal_shell);
+    fermer_shell(host);
+    if (!mort || requete.nb_lignes > 0) {
+      break;
     }
+  }
+  return FLUX_ERREUR;
+}
 
-    processus_t *proc = malloc(sizeof(processus_t));
-    if (proc == NULL) {
-      free(output_copy);
-      liberer_liste_processus(head);
+/**
+ * @brief Collecte par une commande ('ps', /proc brut) analysée à la
+ *        réception.
+ * @return processus_t* : Liste dans 'dest', ou NULL en cas d'échec.
+ */
+static processus_t *collecter_par_commande(remote_host_t *host,
+                                           snapshot_t *dest,
+                                           const char *command,
+                                           flux_format_t format) {
+  char commande[sizeof(COMMANDE_PROCFS) + FLUX_TAILLE_JETON + 8];
+  flux_analyse_t analyse;
+  processus_t *liste;
+
+  flux_analyse_commencer(&analyse, dest, format);
+  if (format == FLUX_PROCFS) {
+    /* Jeton des lignes de section, nouveau à chaque requête */
+    tirer_jeton(host, analyse.jeton, sizeof(analyse.jeton));
+    if ((size_t)snprintf(commande, sizeof(commande), "J=%s; %s",
+                         analyse.jeton, command) >= sizeof(commande)) {
       return NULL;
     }
+    command = commande;
+  }
+  liste = flux_analyse_terminer(
+      &analyse,
+      executer_commande(host, command, flux_analyser_ligne, &analyse));
+  if (liste != NULL && format != FLUX_PS_AUX) {
+    host->uptime_ticks = analyse.uptime_ticks;
+    host->nb_coeurs = analyse.nb_coeurs;
+  }
+  return liste;
+}
+
+/**
+ * @brief Arrête l'agent d'un hôte (demande d'arrêt puis fermeture).
+ */
+static void arreter_agent(remote_host_t *host) {
+  if (host->canal_agent != NULL) {
+    ssh_channel_write(host->canal_agent, "Q\n", 2);
+    ssh_channel_send_eof(host->canal_agent);
+    ssh_channel_close(host->canal_agent);
+    ssh_channel_free(host->canal_agent);
+    host->canal_agent = NULL;
+  }
+}
+
+/**
+ * @brief Première ligne de l'agent : "MY_HTOP_AGENT <version>".
+ */
+static int lire_salut_agent(void *contexte, char *ligne, size_t longueur) {
+  int version;
+
+  (void)contexte;
+  (void)longueur;
+  return sscanf(ligne, AGENT_SALUT " %d", &version) == 1 &&
+                 version == AGENT_VERSION
+             ? FLUX_FIN
+             : FLUX_ERREUR;
+}
 
-    /* Parser la ligne: USER PID %CPU %MEM VSZ RSS TTY STAT START TIME COMMAND
-     */
-    float cpu, mem;
-    long vsz, rss;
-    char stat[16];
-
-    int nb = sscanf(line, "%31s %d %f %f %ld %ld %*s %15s %*s %*s %255[^\n]",
-                    proc->utilisateur, &proc->pid, &cpu, &mem, &vsz, &rss, stat,
-                    proc->nom_commande);
-
-    if (nb >= 7) {
-      proc->cpu_percent = cpu;
-      proc->vmem_size = vsz;
-      proc->rss_size = rss;
-      proc->etat = stat[0];
-      proc->utime = 0;
-      proc->stime = 0;
-      proc->suivant = NULL;
-
-      /* Ajouter à la liste */
-      if (head == NULL) {
-        head = proc;
-        current = proc;
+/**
+ * @brief Lance l'agent de l'hôte sur un canal dédié et attend son salut.
+ * @return int : 0 si l'agent répond, -1 sinon (canal fermé).
+ */
+static int demarrer_agent(remote_host_t *host) {
+  host->canal_agent = ssh_channel_new(host->session);
+  if (host->canal_agent == NULL) {
+    return -1;
+  }
+  if (ssh_channel_open_session(host->canal_agent) != SSH_OK) {
+    ssh_channel_free(host->canal_agent);
+    host->canal_agent = NULL;
+    return -1;
+  }
+  flux_commencer(&host->flux, lire_salut_agent, NULL);
+  if (ssh_channel_request_exec(host->canal_agent, host->commande_agent) !=
+          SSH_OK ||
+      lire_canal(host, host->canal_agent) != FLUX_FIN) {
+    arreter_agent(host);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Demande un instantané à l'agent et l'analyse à la réception.
+ * @return processus_t* : Liste dans 'dest', ou NULL si l'agent ne répond
+ *                        plus ou si sa réponse est invalide.
+ */
+static processus_t *collecter_agent(remote_host_t *host, snapshot_t *dest) {
+  flux_analyse_t analyse;
+  processus_t *liste;
+
+  if (ssh_channel_write(host->canal_agent, "S\n", 2) != 2) {
+    return NULL;
+  }
+
+  flux_analyse_commencer(&analyse, dest, FLUX_AGENT);
+  flux_commencer(&host->flux, flux_analyser_ligne, &analyse);
+  liste =
+      flux_analyse_terminer(&analyse, lire_canal(host, host->canal_agent));
+  if (liste != NULL) {
+    host->uptime_ticks = analyse.uptime_ticks;
+    host->nb_coeurs = analyse.nb_coeurs;
+  }
+  return liste;
+}
+
+/**
+ * @brief Affiche sur la ligne de la machine l'état de la collecte d'une
+ *        session établie (l'écran appartient à ncurses : rien sur stderr).
+ * @param echec : 1 si aucune commande n'a donné de liste ce cycle-ci.
+ */
+static void noter_collecte(remote_host_t *host, int echec) {
+  if (echec) {
+    changer_etat(host, host->etat, "Collecte impossible ('ps aux')");
+  } else if (host->agent_indisponible) {
+    changer_etat(host, host->etat,
+                 "Agent indisponible ('%s'), collecte sans agent",
+                 host->commande_agent);
+  } else {
+    changer_etat(host, host->etat, "");
+  }
+}
+
+/**
+ * @brief Collecte par l'agent de l'hôte, lancé au premier appel.
+ *
+ * Un agent qui ne démarre pas n'est plus essayé (repli sur 'ps') ; un
+ * agent qui cesse de répondre est relancé au cycle suivant.
+ * @return processus_t* : Liste, ou NULL pour passer par 'ps' ce cycle-ci.
+ */
+static processus_t *collecter_par_agent(remote_host_t *host,
+                                        snapshot_t *dest) {
+  processus_t *liste;
+
+  if (host->commande_agent[0] == '\0' || host->agent_indisponible) {
+    return NULL;
+  }
+  if (host->canal_agent == NULL && demarrer_agent(host) != 0) {
+    host->agent_indisponible = 1;
+    noter_collecte(host, 0);
+    return NULL;
+  }
+
+  liste = collecter_agent(host, dest);
+  if (liste == NULL) {
+    arreter_agent(host);
+  }
+  return liste;
+}
+
+/**
+ * @brief Ferme une session perdue (verrou tenu) ; la collecte suivante la
+ *        rétablit après une première attente. L'agent et le shell seront
+ *        de nouveau essayés sur la nouvelle session.
+ */
+static void perdre_session(remote_host_t *host) {
+  arreter_agent(host);
+  fermer_shell(host);
+  ssh_disconnect(host->session);
+  ssh_free(host->session);
+  host->session = NULL;
+  host->agent_indisponible = 0;
+  host->shell_indisponible = 0;
+  host->procfs_indisponible = 0;
+  host->echecs_collecte = 0;
+  host->nb_echecs = 0;
+  planifier_essai(host);
+  changer_etat(host, CONNEXION_ECHOUEE, "Connexion perdue");
+}
+
+/**
+ * @brief Réponse d'une commande de signaux en cours d'analyse.
+ */
+typedef struct reponse_signaux {
+  lot_signaux_t *lot;
+  int i;   /* Prochain PID attendu */
+  int fin; /* Fin de la tranche */
+} reponse_signaux_t;
+
+/**
+ * @brief Ligne "PID ok [atteints]|perm|absent" d'une commande de signaux.
+ */
+static int lire_reponse_signal(void *contexte, char *ligne, size_t longueur) {
+  reponse_signaux_t *reponse = contexte;
+  lot_signaux_t *lot = reponse->lot;
+  char etat[16];
+  int pid;
+  int atteints = 1;
+
+  (void)longueur;
+  if (sscanf(ligne, "%d %15s %d", &pid, etat, &atteints) >= 2) {
+    while (reponse->i < reponse->fin && lot->pids[reponse->i] != pid) {
+      reponse->i++;
+    }
+    if (reponse->i < reponse->fin) {
+      if (strcmp(etat, "ok") == 0) {
+        lot->erreurs[reponse->i] = 0;
+        lot->nb_atteints += atteints;
+      } else if (strcmp(etat, "perm") == 0) {
+        lot->erreurs[reponse->i] = EPERM;
       } else {
-        current->suivant = proc;
-        current = proc;
+        lot->erreurs[reponse->i] = ESRCH;
       }
-    } else {
-      free(proc);
+      reponse->i++;
+    }
+  }
+  return reponse->i < reponse->fin ? FLUX_CONTINUER : FLUX_FIN;
+}
+
+/**
+ * @brief Réponse de l'agent à une requête "K".
+ */
+typedef struct reponse_agent {
+  lot_signaux_t *lot;
+  int i;      /* Prochain PID attendu */
+  int entete; /* 1 : "R <atteints>" reçu */
+} reponse_agent_t;
+
+/**
+ * @brief Lignes "R <atteints>", "<pid> <errno>" puis "F" de l'agent.
+ */
+static int lire_reponse_agent(void *contexte, char *ligne, size_t longueur) {
+  reponse_agent_t *reponse = contexte;
+  lot_signaux_t *lot = reponse->lot;
+  int pid, erreur;
+
+  if (!reponse->entete) {
+    reponse->entete = 1;
+    return sscanf(ligne, "R %d", &lot->nb_atteints) == 1 ? FLUX_CONTINUER
+                                                         : FLUX_ERREUR;
+  }
+  if (ligne[0] == 'F' && longueur == 1) {
+    return FLUX_FIN;
+  }
+  if (sscanf(ligne, "%d %d", &pid, &erreur) == 2) {
+    while (reponse->i < lot->nb && lot->pids[reponse->i] != pid) {
+      reponse->i++;
     }
+    if (reponse->i < lot->nb) {
+      lot->erreurs[reponse->i++] = erreur;
+    }
+  }
+  return FLUX_CONTINUER;
+}
+
+/**
+ * @brief Envoie un lot par le canal de l'agent, qui le traite comme la
+ *        source locale (pidfd, dates de démarrage vérifiées).
+ * @return int : 0 si l'agent a répondu, 1 si le canal est mort avant toute
+ *               réponse (lot à renvoyer autrement), -1 sinon.
+ */
+static int envoyer_par_agent(remote_host_t *host, lot_signaux_t *lot) {
+  size_t taille = 64 + (size_t)lot->nb * 32;
+  char *requete = malloc(taille);
+  reponse_agent_t reponse = {lot, 0, 0};
+  size_t longueur;
+  int etat;
+
+  if (requete == NULL) {
+    return -1;
+  }
 
-    line = strtok(NULL, "\n");
+  /* Dates exactes seulement si la liste affichée vient de l'agent ('ps'
+     ne donne l'âge qu'à la seconde près) */
+  longueur = (size_t)snprintf(requete, taille, "K %d %d %d\n", lot->signal,
+                              (int)lot->portee, lot->nb);
+  for (int i = 0; i < lot->nb; i++) {
+    longueur += (size_t)snprintf(
+        requete + longueur, taille - longueur, "%d %llu\n", lot->pids[i],
+        host->collecte_agent ? lot->starttimes[i] : 0ULL);
   }
 
-  free(output_copy);
-  return head;
+  flux_commencer(&host->flux, lire_reponse_agent, &reponse);
+  etat = ecrire_canal(host->canal_agent, requete, longueur) == 0
+             ? lire_canal(host, host->canal_agent)
+             : FLUX_ERREUR;
+  free(requete);
+  if (etat == FLUX_FIN) {
+    return 0;
+  }
+  return reponse.entete ? -1 : 1;
 }
 
 /* Fonctions publiques */
 
+void init_remote_host(remote_host_t *host) {
+  host->delai_connexion_s = SSH_DELAI_CONNEXION_S;
+  host->delai_auth_s = SSH_DELAI_AUTH_S;
+  host->session = NULL;
+  pthread_mutex_init(&host->verrou, NULL);
+  pthread_mutex_init(&host->verrou_etat, NULL);
+  host->etat = CONNEXION_EN_COURS;
+  host->erreur[0] = '\0';
+  host->prochaine_tentative_ms = 0;
+  host->nb_echecs = 0;
+  host->echecs_collecte = 0;
+  host->graine = (unsigned int)time(NULL) ^ (unsigned int)getpid() ^
+                 (unsigned int)(uintptr_t)host;
+  host->uptime_ticks = 0;
+  host->nb_coeurs = 0;
+  snprintf(host->commande_agent, sizeof(host->commande_agent), "%s",
+           AGENT_COMMANDE_DEFAUT);
+  host->canal_agent = NULL;
+  host->agent_indisponible = 0;
+  host->canal_shell = NULL;
+  host->shell_indisponible = 0;
+  host->sequence_shell = 0;
+  host->jeton_shell[0] = '\0';
+  host->collecte_agent = 0;
+  host->procfs_indisponible = 0;
+  flux_init(&host->flux);
+}
+
 void init_network_config(network_config_t *config) {
   config->nb_hosts = 0;
   for (int i = 0; i < MAX_HOSTS; i++) {
     config->hosts[i].session = NULL;
+    config->hosts[i].uptime_ticks = 0;
+    config->hosts[i].nb_coeurs = 0;
+    config->hosts[i].periode_ms = 0;
   }
 }
 
@@ -249,35 +805,40 @@ int parse_config_file(const char *filename, network_config_t *config) {
 }
 
 int connect_ssh(remote_host_t *host) {
+  long delai;
   int rc;
 
   /* Créer la session SSH */
   host->session = ssh_new();
   if (host->session == NULL) {
-    fprintf(stderr, "ERREUR: Impossible de créer la session SSH\n");
+    changer_etat(host, host->etat, "Impossible de creer la session SSH");
     return -1;
   }
 
-  /* Configurer la session */
+  /* Configurer la session ; le délai borne chaque opération bloquante */
+  delai = host->delai_connexion_s;
   ssh_options_set(host->session, SSH_OPTIONS_HOST, host->adresse);
   ssh_options_set(host->session, SSH_OPTIONS_PORT, &host->port);
   ssh_options_set(host->session, SSH_OPTIONS_USER, host->username);
+  ssh_options_set(host->session, SSH_OPTIONS_TIMEOUT, &delai);
 
   /* Connecter */
   rc = ssh_connect(host->session);
   if (rc != SSH_OK) {
-    fprintf(stderr, "ERREUR: Connexion SSH échouée vers %s: %s\n",
-            host->adresse, ssh_get_error(host->session));
+    changer_etat(host, host->etat, "Connexion echouee: %s",
+                 ssh_get_error(host->session));
     ssh_free(host->session);
     host->session = NULL;
     return -1;
   }
 
   /* Authentification par mot de passe */
+  delai = host->delai_auth_s;
+  ssh_options_set(host->session, SSH_OPTIONS_TIMEOUT, &delai);
   rc = ssh_userauth_password(host->session, NULL, host->password);
   if (rc != SSH_AUTH_SUCCESS) {
-    fprintf(stderr, "ERREUR: Authentification échouée pour %s@%s\n",
-            host->username, host->adresse);
+    changer_etat(host, host->etat, "Authentification echouee pour %s",
+                 host->username);
     ssh_disconnect(host->session);
     ssh_free(host->session);
     host->session = NULL;
@@ -288,6 +849,9 @@ int connect_ssh(remote_host_t *host) {
 }
 
 void disconnect_ssh(remote_host_t *host) {
+  arreter_agent(host);
+  fermer_shell(host);
+  flux_liberer(&host->flux);
   if (host->session != NULL) {
     ssh_disconnect(host->session);
     ssh_free(host->session);
@@ -295,64 +859,207 @@ void disconnect_ssh(remote_host_t *host) {
   }
 }
 
-processus_t *get_remote_processes(remote_host_t *host) {
-  char *output;
+etat_connexion_t get_connection_state(remote_host_t *host,
+                                      long long *attente_ms, char *erreur,
+                                      size_t taille) {
+  etat_connexion_t etat;
+  long long maintenant = maintenant_ms();
+
+  pthread_mutex_lock(&host->verrou_etat);
+  etat = host->etat;
+  if (attente_ms != NULL) {
+    *attente_ms = host->prochaine_tentative_ms > maintenant
+                      ? host->prochaine_tentative_ms - maintenant
+                      : 0;
+  }
+  if (erreur != NULL && taille > 0) {
+    snprintf(erreur, taille, "%s", host->erreur);
+  }
+  pthread_mutex_unlock(&host->verrou_etat);
+  return etat;
+}
+
+processus_t *collect_remote_processes(remote_host_t *host, snapshot_t *dest) {
   processus_t *liste;
 
-  if (host->session == NULL) {
-    fprintf(stderr, "ERREUR: Pas de session SSH active pour %s\n", host->nom);
+  /* La session est partagée avec l'envoi de signaux */
+  pthread_mutex_lock(&host->verrou);
+
+  /* Connexion au premier appel, puis après chaque perte (avec attente) */
+  if (assurer_connexion(host) != 0) {
+    pthread_mutex_unlock(&host->verrou);
     return NULL;
   }
 
-  /* Exécuter 'ps aux' sur la machine distante */
-  output = execute_ssh_command(host->session, "ps aux");
-  if (output == NULL) {
-    fprintf(stderr, "ERREUR: Impossible d'exécuter 'ps aux' sur %s\n",
-            host->nom);
-    return NULL;
+  /* Agent résident : un aller-retour sur son canal, sans nouveau processus */
+  liste = collecter_par_agent(host, dest);
+  host->collecte_agent = liste != NULL;
+
+  /* Sans agent : /proc brut, analysé comme en local */
+  if (liste == NULL && !host->procfs_indisponible) {
+    liste =
+        collecter_par_commande(host, dest, COMMANDE_PROCFS, FLUX_PROCFS);
+  }
+
+  /* Temps CPU cumulé et âge des processus pour un calcul par intervalle */
+  if (liste == NULL) {
+    liste = collecter_par_commande(host, dest, COMMANDE_PS_DELTA,
+                                   FLUX_PS_DELTA);
+
+    /* L'hôte répond mais n'a pas de /proc lisible : 'ps' désormais */
+    if (liste != NULL && !host->procfs_indisponible) {
+      host->procfs_indisponible = 1;
+    }
   }
 
-  /* Parser la sortie */
-  liste = parse_ps_output(output);
-  free(output);
+  /* Repli : 'ps aux' (pourcentage moyen sur la vie du processus) */
+  if (liste == NULL) {
+    host->nb_coeurs = 0;
+    liste = collecter_par_commande(host, dest, "ps aux", FLUX_PS_AUX);
+    if (liste == NULL) {
+      noter_collecte(host, 1);
+    }
+  }
+
+  /* Connexion coupée, ou hôte muet à plusieurs reprises : la session est
+     refaite plutôt que de rester morte */
+  if (liste != NULL) {
+    if (host->echecs_collecte > 0) {
+      noter_collecte(host, 0);
+    }
+    host->echecs_collecte = 0;
+  } else if (!ssh_is_connected(host->session) ||
+             ++host->echecs_collecte >= SSH_ECHECS_SESSION) {
+    perdre_session(host);
+  }
 
+  pthread_mutex_unlock(&host->verrou);
   return liste;
 }
 
-int send_remote_signal(remote_host_t *host, pid_t pid, int signal) {
-  char command[128];
-  char *output;
+processus_t *get_remote_processes(remote_host_t *host) {
+  snapshot_t *snapshot = snapshot_creer_autonome();
+  processus_t *liste;
 
-  if (host->session == NULL) {
-    return -1;
+  if (snapshot == NULL) {
+    return NULL;
+  }
+
+  /* Arène autonome ; elle est libérée avec liberer_liste_processus() */
+  liste = collect_remote_processes(host, snapshot);
+  if (liste == NULL) {
+    snapshot_liberer(snapshot);
+    free(snapshot);
   }
+  return liste;
+}
 
-  /* Construire la commande kill */
-  snprintf(command, sizeof(command), "kill -%d %d 2>&1", signal, pid);
+int send_remote_signals(remote_host_t *host, lot_signaux_t *lot) {
+  int retour = 0;
 
-  /* Exécuter la commande */
-  output = execute_ssh_command(host->session, command);
-  if (output == NULL) {
+  lot->nb_atteints = 0;
+  for (int i = 0; i < lot->nb; i++) {
+    lot->erreurs[i] = EIO;
+  }
+  if (host->session == NULL) {
     return -1;
   }
 
-  /* Vérifier si erreur dans la sortie */
-  int retour = 0;
-  if (strstr(output, "No such process") != NULL) {
-    errno = ESRCH;
-    retour = -1;
-  } else if (strstr(output, "Operation not permitted") != NULL) {
-    errno = EPERM;
-    retour = -1;
+  /* Canal de l'agent : un aller-retour, signaux envoyés sur place */
+  pthread_mutex_lock(&host->verrou);
+  if (host->canal_agent != NULL && lot->nb <= AGENT_SIGNAUX_MAX) {
+    int envoi = envoyer_par_agent(host, lot);
+    if (envoi != 0) {
+      /* Relancé à la prochaine collecte */
+      arreter_agent(host);
+    }
+    if (envoi <= 0) {
+      pthread_mutex_unlock(&host->verrou);
+      return envoi;
+    }
+    lot->nb_atteints = 0;
+  }
+  pthread_mutex_unlock(&host->verrou);
+
+  /* Sans agent : script shell, par tranches */
+  for (int debut = 0; debut < lot->nb; debut += SSH_SIGNAUX_PAR_COMMANDE) {
+    int fin = debut + SSH_SIGNAUX_PAR_COMMANDE < lot->nb
+                  ? debut + SSH_SIGNAUX_PAR_COMMANDE
+                  : lot->nb;
+    size_t taille = 1024 + (size_t)(fin - debut) * 12;
+    char *command = malloc(taille);
+    reponse_signaux_t reponse = {lot, debut, fin};
+    size_t longueur;
+    int etat;
+
+    if (command == NULL) {
+      return -1;
+    }
+
+    /* Une ligne "PID ok [atteints]|perm|absent" par processus, dans
+       l'ordre du lot */
+    longueur = (size_t)snprintf(
+        command, taille, "%sfor p in",
+        lot->portee != PORTEE_PROCESSUS ? SCRIPT_MEMBRES : "");
+    for (int i = debut; i < fin; i++) {
+      longueur += (size_t)snprintf(command + longueur, taille - longueur,
+                                   " %d", lot->pids[i]);
+    }
+    if (lot->portee == PORTEE_PROCESSUS) {
+      snprintf(command + longueur, taille - longueur,
+               "; do if kill -%d $p 2>/dev/null; then echo \"$p ok\"; "
+               "elif [ -d /proc/$p ]; then echo \"$p perm\"; "
+               "else echo \"$p absent\"; fi; done",
+               lot->signal);
+    } else {
+      /* Même gel que la source locale : SIGSTOP à chaque nouveau membre
+         jusqu'à un parcours sans nouveau membre, le signal, puis SIGCONT */
+      int geler = lot->signal != SIGCONT;
+      const char *mode = lot->portee == PORTEE_GROUPE     ? "g"
+                         : lot->portee == PORTEE_SESSION ? "s"
+                                                         : "a";
+      const char *cle = lot->portee == PORTEE_GROUPE     ? "pgid"
+                        : lot->portee == PORTEE_SESSION ? "sid"
+                                                        : "pid";
+
+      snprintf(
+          command + longueur, taille - longueur,
+          "; do c=$(ps -o %s= -p $p 2>/dev/null | tr -d ' '); "
+          "if [ -z \"$c\" ]; then echo \"$p absent\"; continue; fi; "
+          "v=' '; i=0; while [ $i -lt %d ]; do n=0; "
+          "for q in $(M %s $c); do case \"$v\" in *\" $q \"*) ;; "
+          "*) v=\"$v$q \"; n=1; %s;; esac; done; "
+          "[ $n = 0 ] && break; i=$((i+1)); done; "
+          "t=0; for q in $v; do kill -%d $q 2>/dev/null && t=$((t+1)); done; "
+          "%s"
+          "if [ $t -gt 0 ]; then echo \"$p ok $t\"; "
+          "elif [ -d /proc/$p ]; then echo \"$p perm\"; "
+          "else echo \"$p absent\"; fi; done",
+          cle, geler ? SSH_SIGNAUX_TOURS_MAX : 1, mode,
+          geler ? "kill -STOP $q 2>/dev/null" : ":", lot->signal,
+          geler && lot->signal != SIGSTOP && lot->signal != SIGKILL
+              ? "for q in $v; do kill -CONT $q 2>/dev/null; done; "
+              : "");
+    }
+
+    /* Les PID sans réponse (sortie tronquée) gardent EIO */
+    pthread_mutex_lock(&host->verrou);
+    etat = executer_commande(host, command, lire_reponse_signal, &reponse);
+    pthread_mutex_unlock(&host->verrou);
+    free(command);
+    if (etat == FLUX_ERREUR) {
+      retour = -1;
+    }
   }
 
-  free(output);
   return retour;
 }
 
 void cleanup_network_config(network_config_t *config) {
   for (int i = 0; i < config->nb_hosts; i++) {
     disconnect_ssh(&config->hosts[i]);
+    pthread_mutex_destroy(&config->hosts[i].verrou);
+    pthread_mutex_destroy(&config->hosts[i].verrou_etat);
   }
   config->nb_hosts = 0;
 }
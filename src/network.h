@@ -11,8 +11,12 @@
 #ifndef NETWORK_H
 #define NETWORK_H
 
+#include "agent.h"
+#include "flux.h"
+#include "marques.h"
 #include "process.h"
 #include <libssh/libssh.h>
+#include <pthread.h>
 
 /* Constantes */
 #define MAX_HOSTNAME_LEN 256
@@ -22,6 +26,48 @@
 #define DEFAULT_SSH_PORT 22
 #define DEFAULT_TELNET_PORT 23
 #define CONFIG_FILE_DEFAULT ".config"
+#define REMOTE_TICKS_PAR_SECONDE 100 /* Unité des ticks distants */
+#define SSH_DELAI_LECTURE_MS 5000     /* Silence maximal d'une commande distante */
+#define SSH_SIGNAUX_PAR_COMMANDE 2048 /* PID par commande 'kill' groupée */
+#define SSH_SIGNAUX_TOURS_MAX 16      /* Parcours de ps pour geler une portée */
+#define MAX_COMMANDE_AGENT 256
+#define SSH_SHELL_COMMANDE "sh"       /* Shell persistant des commandes */
+#define SSH_SHELL_DEBUT "MY_HTOP_DEBUT" /* Préfixe de la première ligne
+                                           d'une réponse du shell */
+#define SSH_SHELL_FIN "MY_HTOP_FIN"   /* Préfixe de la ligne de fin d'une
+                                         requête du shell */
+#define SSH_TAILLE_JETON 16           /* Octets aléatoires des lignes de
+                                         début et de fin */
+#define SSH_DELAI_CONNEXION_S 10      /* Connexion TCP et échange de clés */
+#define SSH_DELAI_AUTH_S 10           /* Authentification */
+#define SSH_RECONNEXION_MIN_MS 1000   /* Attente avant le premier nouvel essai */
+#define SSH_RECONNEXION_MAX_MS 60000  /* Plafond de l'attente exponentielle */
+#define SSH_ECHECS_SESSION 3          /* Collectes échouées de suite avant de
+                                         tenir la session pour perdue */
+#define MAX_ERREUR_CONNEXION 128
+
+/* Commande distante : uptime, nombre de cœurs, puis temps CPU cumulé et âge */
+#define COMMANDE_PS_DELTA                                                      \
+  "cat /proc/uptime && getconf _NPROCESSORS_ONLN && "                          \
+  "ps -eo user,pid,ppid,stat,vsz,rss,times,etimes,args"
+
+/* Commande distante : /proc brut en une lecture groupée (des 'grep', 'stat'
+   par lots, analysés comme en local), précédée de "J=<jeton>; ". Les trois
+   sections développent le même motif [0-9]* sous LC_ALL=C, donc dans le
+   même ordre d'octets : la jointure par PID de flux.c en dépend. Le motif
+   est passé à 'printf' (intégré au shell) puis à 'xargs', qui découpe les
+   lots sous ARG_MAX quel que soit le nombre de processus. 'grep' préfixe
+   chaque ligne de /proc par son fichier : un '\n' dans un nom ou un
+   argument ne peut pas imiter la ligne de section "X $J", tirée à chaque
+   requête. Sous-shell : ni la locale ni le répertoire du shell persistant
+   ne changent. */
+#define COMMANDE_PROCFS                                                        \
+  "(export LC_ALL=C; cat /proc/uptime && getconf _NPROCESSORS_ONLN && "       \
+  "getconf PAGESIZE && getconf CLK_TCK && cd /proc && echo \"S $J\" && "      \
+  "printf '%s/stat\\n' [0-9]* | xargs grep -a '' /dev/null; "                \
+  "echo \"U $J\"; printf '%s\\n' [0-9]* | xargs stat -c '%n %u %U'; "        \
+  "echo \"C $J\"; printf '%s/cmdline\\n' [0-9]* | "                          \
+  "xargs grep -a '' /dev/null | tr '\\000' ' ' | cut -c 1-4096)"
 
 /* Types de connexion */
 typedef enum {
@@ -29,6 +75,15 @@ typedef enum {
     CONN_TELNET
 } connection_type_t;
 
+/* États de la connexion d'un hôte */
+typedef enum {
+    CONNEXION_EN_COURS,   /* Première tentative en cours */
+    CONNEXION_ETABLIE,
+    CONNEXION_ECHOUEE,    /* Dernier essai échoué ou session perdue ; nouvel
+                             essai à prochaine_tentative_ms */
+    CONNEXION_REESSAI     /* Nouvel essai en cours */
+} etat_connexion_t;
+
 /**
  * @brief Structure représentant un hôte distant
  */
@@ -39,7 +94,48 @@ typedef struct remote_host {
     char username[MAX_USERNAME_LEN];      /* Nom d'utilisateur */
     char password[MAX_PASSWORD_LEN];      /* Mot de passe */
     connection_type_t type;               /* Type de connexion */
+    int periode_ms;                       /* Période de collecte (0 : -d) */
+    int delai_connexion_s;                /* Délai de connexion (secondes) */
+    int delai_auth_s;                     /* Délai d'authentification */
     ssh_session session;                  /* Session SSH (NULL si non connecté) */
+    pthread_mutex_t verrou;               /* Sérialise l'usage de la session
+                                             (collecte et signaux) */
+
+    /* État de la connexion, lu par l'interface (sous verrou_etat) */
+    pthread_mutex_t verrou_etat;
+    etat_connexion_t etat;
+    char erreur[MAX_ERREUR_CONNEXION];    /* Cause du dernier échec, ou
+                                             avertissement de la collecte
+                                             (session établie) */
+    long long prochaine_tentative_ms;     /* Horloge monotone */
+    int nb_echecs;                        /* Essais échoués de suite */
+    int echecs_collecte;                  /* Collectes échouées de suite (sous
+                                             verrou) */
+    unsigned int graine;                  /* Tirage de l'attente (rand_r) */
+
+    /* Métadonnées du dernier échantillon (pour le moteur CPU) */
+    unsigned long long uptime_ticks;      /* Uptime distant en ticks (1/100 s) */
+    int nb_coeurs;                        /* Nombre de cœurs distants */
+
+    /* Agent de collecte résident (agent.h) */
+    char commande_agent[MAX_COMMANDE_AGENT]; /* Vide : pas d'agent */
+    ssh_channel canal_agent;              /* Canal de l'agent (NULL : arrêté) */
+    int agent_indisponible;               /* 1 : échec au démarrage, 'ps' */
+    int collecte_agent;                   /* 1 : dernière liste de l'agent
+                                             (dates de démarrage exactes) */
+    int procfs_indisponible;              /* 1 : /proc brut illisible, 'ps' */
+
+    /* Shell persistant : commandes 'ps' et signaux sans agent */
+    ssh_channel canal_shell;              /* NULL : fermé (rouvert au besoin) */
+    int shell_indisponible;               /* 1 : refusé, un canal par commande */
+    unsigned int sequence_shell;          /* Numéro de la dernière requête */
+    char jeton_shell[2 * SSH_TAILLE_JETON + 1]; /* Tiré à l'ouverture du
+                                             shell (hexadécimal) : une
+                                             sortie distante ne peut pas
+                                             imiter la ligne de fin */
+
+    flux_lignes_t flux;                   /* Réception des réponses (sous
+                                             verrou), tampon réutilisé */
 } remote_host_t;
 
 /**
@@ -67,8 +163,21 @@ int parse_config_file(const char *filename, network_config_t *config);
  */
 int check_config_file_permissions(const char *filename);
 
+/**
+ * @brief Initialise un hôte non connecté : agent, délais et état par
+ *        défaut, verrous. Nom, adresse, port, identifiants, type et période
+ *        ne sont pas modifiés.
+ * @param host : Pointeur vers la structure de l'hôte
+ */
+void init_remote_host(remote_host_t *host);
+
 /**
  * @brief Établit une connexion SSH vers un hôte distant.
+ *
+ * La connexion (TCP et échange de clés) et l'authentification sont
+ * bornées par host->delai_connexion_s et host->delai_auth_s ; en cas
+ * d'échec, la cause est dans host->erreur.
+ *
  * @param host : Pointeur vers la structure de l'hôte
  * @return int : 0 en cas de succès, -1 en cas d'erreur
  */
@@ -80,21 +189,74 @@ int connect_ssh(remote_host_t *host);
  */
 void disconnect_ssh(remote_host_t *host);
 
+/**
+ * @brief État de la connexion d'un hôte (appelable depuis tout thread).
+ * @param host : Pointeur vers l'hôte distant
+ * @param attente_ms : Reçoit le délai avant le prochain essai
+ *                     (CONNEXION_ECHOUEE), peut être NULL
+ * @param erreur : Reçoit la cause du dernier échec (vide : aucune), peut
+ *                 être NULL
+ * @param taille : Taille de 'erreur'
+ * @return etat_connexion_t : État courant.
+ */
+etat_connexion_t get_connection_state(remote_host_t *host,
+                                      long long *attente_ms, char *erreur,
+                                      size_t taille);
+
 /**
  * @brief Récupère la liste des processus d'un hôte distant via SSH.
- * @param host : Pointeur vers l'hôte distant (déjà connecté)
+ *
+ * Le temps CPU cumulé et l'âge de chaque processus sont relevés avec
+ * l'uptime distant (host->uptime_ticks, host->nb_coeurs) pour permettre
+ * un calcul par intervalle ; les champs cpu_percent sont laissés à 0.
+ * L'agent de l'hôte (host->commande_agent) est lancé au premier appel
+ * puis interrogé sur son canal. Sans agent, /proc est lu tel quel à chaque
+ * appel (COMMANDE_PROCFS) sur le shell persistant de l'hôte et analysé
+ * par le lecteur local (procfs_parser_stat : mêmes champs, mêmes unités,
+ * temps CPU au tick près) ; sur un hôte sans /proc, 'ps -eo' le remplace,
+ * puis 'ps aux' en dernier recours (pourcentage moyen sur la vie du
+ * processus). Dans tous les cas, un rafraîchissement coûte un
+ * aller-retour.
+ *
+ * Un hôte non connecté est connecté au premier appel ; une session perdue
+ * (coupée, ou SSH_ECHECS_SESSION collectes échouées de suite) est fermée
+ * puis rétablie par les appels suivants, après une attente exponentielle
+ * (SSH_RECONNEXION_MIN_MS à SSH_RECONNEXION_MAX_MS, tirée au hasard dans
+ * sa seconde moitié pour que des hôtes coupés ensemble ne reviennent pas
+ * ensemble). Avant l'échéance, l'appel échoue aussitôt.
+ *
+ * @param host : Pointeur vers l'hôte distant
  * @return processus_t* : Liste chaînée des processus, ou NULL en cas d'erreur
  */
 processus_t *get_remote_processes(remote_host_t *host);
 
 /**
- * @brief Envoie un signal à un processus distant via SSH.
+ * @brief Comme get_remote_processes(), mais les processus sont écrits
+ *        directement dans 'dest' au fil de la réception (aucune copie de
+ *        la sortie ni de la liste).
  * @param host : Pointeur vers l'hôte distant
- * @param pid : PID du processus cible
- * @param signal : Signal à envoyer
- * @return int : 0 en cas de succès, -1 en cas d'erreur
+ * @param dest : Snapshot destination (remis à zéro)
+ * @return processus_t* : Tête de liste dans 'dest', ou NULL en cas d'erreur
+ */
+processus_t *collect_remote_processes(remote_host_t *host, snapshot_t *dest);
+
+/**
+ * @brief Envoie le signal d'un lot aux processus distants en une seule
+ *        requête.
+ *
+ * Avec un agent, le lot passe par son canal et l'agent l'envoie comme la
+ * source locale (pidfd, dates de démarrage vérifiées si la liste affichée
+ * vient de lui). Sinon, un script shell par tranche de
+ * SSH_SIGNAUX_PAR_COMMANDE PID, sur le shell persistant, gèle puis
+ * signale les portées ; les dates n'y sont pas vérifiées.
+ *
+ * @param host : Pointeur vers l'hôte distant
+ * @param lot : Lot à envoyer ; reçoit l'errno de chaque PID (0 : envoyé,
+ *              ESRCH : absent, EPERM : refusé, EIO : pas de réponse) et le
+ *              nombre de processus atteints
+ * @return int : 0 si toutes les commandes ont abouti, -1 sinon
  */
-int send_remote_signal(remote_host_t *host, pid_t pid, int signal);
+int send_remote_signals(remote_host_t *host, lot_signaux_t *lot);
 
 /**
  * @brief Initialise une structure network_config_t.
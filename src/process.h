@@ -10,6 +10,7 @@
 #ifndef PROCESS_H
 #define PROCESS_H
 
+#include <stddef.h>
 #include <sys/types.h>
 
 /* Constantes */
@@ -22,46 +23,71 @@
  */
 typedef struct processus {
     pid_t pid;
+    pid_t tgid;       /* Processus d'appartenance (== pid pour un processus) */
+    pid_t ppid;       /* Processus parent (0 : aucun ou inconnu) */
+    pid_t pgrp;       /* Groupe de processus (0 : inconnu) */
+    pid_t session;    /* Session (0 : inconnue) */
     char nom_commande[MAX_CMD_LEN];
     char utilisateur[MAX_USER_LEN];
+    uid_t uid;
     char etat;
+    int nb_threads;   /* Threads du processus (0 si inconnu) */
+    char est_thread;  /* 1 : ligne d'un thread (mode threads) */
+    unsigned long long starttime; /* Date de démarrage (ticks depuis le boot) */
     long long utime;
     long long stime;
     long vmem_size;
-    long rss_size;
-    float cpu_percent;
+    long rss_ko;      /* Mémoire résidente (Ko) */
+    float cpu_percent;         /* CPU sur le dernier intervalle (100% = un cœur) */
+    float cpu_percent_machine; /* CPU sur le dernier intervalle (100% = machine) */
     struct processus *suivant;
+    struct snapshot_processus *snapshot; /* Arène d'appartenance (NULL si nœud alloué seul) */
 } processus_t;
 
 /* Prototypes des fonctions publiques */
 
 /**
  * @brief Parcourt /proc et construit la liste chaînée des processus actifs.
+ *
+ * La liste est stockée dans un snapshot contigu (une seule allocation qui
+ * grandit) : compter_processus() et get_processus_at_index() y sont en O(1).
+ *
  * @return processus_t* : Pointeur vers le début de la liste, ou NULL si erreur.
  */
 processus_t *recuperer_processus_locaux(void);
 
 /**
  * @brief Libère la mémoire allouée pour la liste de processus.
+ *
+ * Une liste issue d'un snapshot autonome est libérée en une fois ; une
+ * liste appartenant à un snapshot ou à une table gérés ailleurs est ignorée.
  * @param head : Pointeur vers le premier élément de la liste.
  */
 void liberer_liste_processus(processus_t *head);
 
 /**
- * @brief Compte le nombre de processus dans la liste.
+ * @brief Compte le nombre de processus dans la liste (O(1) sur un snapshot).
  * @param head : Pointeur vers le début de la liste.
  * @return int : Nombre de processus.
  */
 int compter_processus(processus_t *head);
 
 /**
- * @brief Récupère le processus à l'index donné.
+ * @brief Récupère le processus à l'index donné (O(1) sur un snapshot).
  * @param head : Pointeur vers le début de la liste.
  * @param index : Index du processus recherché.
  * @return processus_t* : Pointeur vers le processus, ou NULL si non trouvé.
  */
 processus_t *get_processus_at_index(processus_t *head, int index);
 
+/**
+ * @brief Convertit un UID en nom d'utilisateur (ou UID numérique si inconnu).
+ * @param uid : UID à convertir.
+ * @param username : Buffer de destination.
+ * @param size : Taille du buffer.
+ */
+void recuperer_nom_utilisateur(uid_t uid, char *username, size_t size);
+
 /**
  * @brief Envoie un signal à un processus.
  * @param pid : PID du processus cible.
@@ -0,0 +1,405 @@
+/**
+ * @file procfs.c
+ * @brief Implémentation du lecteur rapide de /proc
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "procfs.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Fonctions privées */
+
+/**
+ * @brief Lit un entier signé et avance le curseur (pas d'errno, pas de locale).
+ */
+static const char *lire_entier(const char *p, const char *fin,
+                               long long *valeur) {
+  int negatif = 0;
+  long long v = 0;
+
+  if (p < fin && *p == '-') {
+    negatif = 1;
+    p++;
+  }
+  if (p >= fin || *p < '0' || *p > '9') {
+    return NULL;
+  }
+  while (p < fin && *p >= '0' && *p <= '9') {
+    v = v * 10 + (*p - '0');
+    p++;
+  }
+
+  *valeur = negatif ? -v : v;
+  return p;
+}
+
+/**
+ * @brief Saute un champ et les espaces qui le suivent.
+ */
+static const char *sauter_champ(const char *p, const char *fin) {
+  while (p < fin && *p != ' ') {
+    p++;
+  }
+  while (p < fin && *p == ' ') {
+    p++;
+  }
+  return p;
+}
+
+/**
+ * @brief Écrit un entier positif en décimal sans snprintf.
+ * @return char* : Position suivant le dernier chiffre.
+ */
+static char *ecrire_entier(char *dest, unsigned int v) {
+  char chiffres[16];
+  int n = 0;
+
+  do {
+    chiffres[n++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v > 0);
+
+  while (n > 0) {
+    *dest++ = chiffres[--n];
+  }
+  return dest;
+}
+
+/**
+ * @brief Convertit un PID en chemin relatif "<pid>/<fichier>" sans snprintf.
+ */
+static void construire_chemin(pid_t pid, const char *fichier, char *chemin) {
+  chemin = ecrire_entier(chemin, (unsigned int)pid);
+  *chemin++ = '/';
+  strcpy(chemin, fichier);
+}
+
+/**
+ * @brief Lit et analyse un fichier stat désigné par un chemin relatif à /proc.
+ */
+static int lire_stat_chemin(procfs_lecteur_t *lecteur, const char *chemin,
+                            processus_t *proc, uid_t *uid) {
+  struct stat st;
+  ssize_t lus;
+  int fd;
+
+  fd = openat(lecteur->proc_fd, chemin, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+
+  /* Le propriétaire de /proc/[PID]/stat est l'UID effectif du processus */
+  if (uid != NULL) {
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      return -1;
+    }
+    *uid = st.st_uid;
+  }
+
+  lus = read(fd, lecteur->buffer, sizeof(lecteur->buffer) - 1);
+  close(fd);
+
+  if (lus <= 0) {
+    return -1;
+  }
+  lecteur->buffer[lus] = '\0';
+
+  return procfs_parser_stat(lecteur->buffer, (size_t)lus, lecteur->page_ko,
+                            proc);
+}
+
+/**
+ * @brief Lit entièrement un petit fichier de /proc/[PID] dans le buffer.
+ * @return ssize_t : Nombre d'octets lus, -1 si le processus a disparu.
+ */
+static ssize_t lire_fichier(procfs_lecteur_t *lecteur, pid_t pid,
+                            const char *fichier) {
+  char chemin[48];
+  ssize_t total = 0;
+  ssize_t lus;
+  int fd;
+
+  construire_chemin(pid, fichier, chemin);
+  fd = openat(lecteur->proc_fd, chemin, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+
+  while (total < (ssize_t)sizeof(lecteur->buffer) - 1 &&
+         (lus = read(fd, lecteur->buffer + total,
+                     sizeof(lecteur->buffer) - 1 - (size_t)total)) > 0) {
+    total += lus;
+  }
+  close(fd);
+
+  lecteur->buffer[total] = '\0';
+  return total;
+}
+
+/**
+ * @brief Retourne la valeur numérique d'une ligne "Cle:\t valeur" de status.
+ */
+static long valeur_status(const char *contenu, const char *cle) {
+  size_t taille_cle = strlen(cle);
+  const char *ligne = contenu;
+  long long valeur;
+
+  while (ligne != NULL && *ligne != '\0') {
+    if (strncmp(ligne, cle, taille_cle) == 0 && ligne[taille_cle] == ':') {
+      const char *p = ligne + taille_cle + 1;
+      while (*p == ' ' || *p == '\t') {
+        p++;
+      }
+      if (lire_entier(p, p + strlen(p), &valeur) != NULL) {
+        return (long)valeur;
+      }
+      return -1;
+    }
+    ligne = strchr(ligne, '\n');
+    if (ligne != NULL) {
+      ligne++;
+    }
+  }
+  return -1;
+}
+
+/* Fonctions publiques */
+
+int procfs_ouvrir(procfs_lecteur_t *lecteur) {
+  long taille_page = sysconf(_SC_PAGESIZE);
+
+  lecteur->page_ko = taille_page > 0 ? taille_page / 1024 : 4;
+  lecteur->proc_fd = open(PROC_DIR, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  return (lecteur->proc_fd < 0) ? -1 : 0;
+}
+
+void procfs_fermer(procfs_lecteur_t *lecteur) {
+  if (lecteur->proc_fd >= 0) {
+    close(lecteur->proc_fd);
+    lecteur->proc_fd = -1;
+  }
+}
+
+int procfs_parser_stat(const char *buffer, size_t len, long page_ko,
+                       processus_t *proc) {
+  const char *p = buffer;
+  const char *fin = buffer + len;
+  const char *ouvrante;
+  const char *fermante;
+  long long valeur;
+  int champ;
+
+  /* Champ 1 : PID */
+  p = lire_entier(p, fin, &valeur);
+  if (p == NULL) {
+    return -1;
+  }
+  proc->pid = (pid_t)valeur;
+  proc->tgid = proc->pid;
+  proc->est_thread = 0;
+
+  /* Champ 2 : (comm), délimité par la dernière ')' */
+  ouvrante = memchr(p, '(', (size_t)(fin - p));
+  if (ouvrante == NULL) {
+    return -1;
+  }
+  fermante = fin - 1;
+  while (fermante > ouvrante && *fermante != ')') {
+    fermante--;
+  }
+  if (fermante == ouvrante) {
+    return -1;
+  }
+
+  size_t taille_nom = (size_t)(fermante - ouvrante - 1);
+  if (taille_nom >= MAX_CMD_LEN) {
+    taille_nom = MAX_CMD_LEN - 1;
+  }
+  memcpy(proc->nom_commande, ouvrante + 1, taille_nom);
+  proc->nom_commande[taille_nom] = '\0';
+
+  /* Champ 3 : état */
+  p = fermante + 1;
+  while (p < fin && *p == ' ') {
+    p++;
+  }
+  if (p >= fin) {
+    return -1;
+  }
+  proc->etat = *p;
+  p = sauter_champ(p, fin);
+
+  /* Champs 4 à 24 : on ne garde que ppid, pgrp, session, utime, stime,
+     num_threads, starttime, vsize et rss */
+  for (champ = 4; champ <= 24; champ++) {
+    switch (champ) {
+    case 4:
+    case 5:
+    case 6:
+    case 14:
+    case 15:
+    case 20:
+    case 22:
+    case 23:
+    case 24:
+      p = lire_entier(p, fin, &valeur);
+      if (p == NULL) {
+        return -1;
+      }
+      if (champ == 4) {
+        proc->ppid = (pid_t)valeur;
+      } else if (champ == 5) {
+        proc->pgrp = (pid_t)valeur;
+      } else if (champ == 6) {
+        proc->session = (pid_t)valeur;
+      } else if (champ == 14) {
+        proc->utime = valeur;
+      } else if (champ == 15) {
+        proc->stime = valeur;
+      } else if (champ == 20) {
+        proc->nb_threads = (int)valeur;
+      } else if (champ == 22) {
+        proc->starttime = (unsigned long long)valeur;
+      } else if (champ == 23) {
+        proc->vmem_size = (long)valeur;
+      } else {
+        proc->rss_ko = (long)valeur * page_ko;
+      }
+      while (p < fin && *p == ' ') {
+        p++;
+      }
+      break;
+    default:
+      if (p >= fin) {
+        return -1;
+      }
+      p = sauter_champ(p, fin);
+      break;
+    }
+  }
+
+  return 0;
+}
+
+int procfs_lire_stat(procfs_lecteur_t *lecteur, pid_t pid, processus_t *proc,
+                     uid_t *uid) {
+  char chemin[32];
+
+  construire_chemin(pid, "stat", chemin);
+  return lire_stat_chemin(lecteur, chemin, proc, uid);
+}
+
+int procfs_lire_stat_tache(procfs_lecteur_t *lecteur, pid_t pid, pid_t tid,
+                           processus_t *proc, uid_t *uid) {
+  char chemin[48];
+  char *p;
+
+  construire_chemin(pid, "task/", chemin);
+  p = ecrire_entier(chemin + strlen(chemin), (unsigned int)tid);
+  memcpy(p, "/stat", sizeof("/stat"));
+
+  if (lire_stat_chemin(lecteur, chemin, proc, uid) != 0) {
+    return -1;
+  }
+  proc->tgid = pid;
+  proc->est_thread = 1;
+  return 0;
+}
+
+int procfs_lister_taches(procfs_lecteur_t *lecteur, pid_t pid, pid_t **tids,
+                         int *capacite) {
+  char chemin[32];
+  struct dirent *entree;
+  DIR *dir;
+  int nb = 0;
+  int fd;
+
+  construire_chemin(pid, "task", chemin);
+  fd = openat(lecteur->proc_fd, chemin, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  dir = fdopendir(fd); /* Le descripteur appartient désormais à dir */
+  if (dir == NULL) {
+    close(fd);
+    return -1;
+  }
+
+  while ((entree = readdir(dir)) != NULL) {
+    if (entree->d_name[0] < '0' || entree->d_name[0] > '9') {
+      continue;
+    }
+    if (nb == *capacite) {
+      int nouvelle = *capacite ? *capacite * 2 : 64;
+      pid_t *agrandi = realloc(*tids, sizeof(pid_t) * nouvelle);
+      if (agrandi == NULL) {
+        break;
+      }
+      *tids = agrandi;
+      *capacite = nouvelle;
+    }
+    (*tids)[nb++] = (pid_t)atoi(entree->d_name);
+  }
+
+  closedir(dir);
+  return nb;
+}
+
+int procfs_lire_cmdline(procfs_lecteur_t *lecteur, pid_t pid, char *dest,
+                        size_t taille) {
+  ssize_t lus = lire_fichier(lecteur, pid, "cmdline");
+  size_t n;
+
+  if (lus < 0 || taille == 0) {
+    return -1;
+  }
+
+  /* Arguments séparés par des '\0' : remplacés par des espaces */
+  while (lus > 0 && lecteur->buffer[lus - 1] == '\0') {
+    lus--;
+  }
+  n = (size_t)lus < taille - 1 ? (size_t)lus : taille - 1;
+  for (size_t i = 0; i < n; i++) {
+    char c = lecteur->buffer[i];
+    dest[i] = (c == '\0' || c == '\n' || c == '\t') ? ' ' : c;
+  }
+  dest[n] = '\0';
+  return 0;
+}
+
+int procfs_lire_status(procfs_lecteur_t *lecteur, pid_t pid,
+                       procfs_status_t *status) {
+  if (lire_fichier(lecteur, pid, "status") < 0) {
+    return -1;
+  }
+
+  status->nb_threads = (int)valeur_status(lecteur->buffer, "Threads");
+  status->vm_swap_ko = valeur_status(lecteur->buffer, "VmSwap");
+  status->vm_pic_ko = valeur_status(lecteur->buffer, "VmHWM");
+  return 0;
+}
+
+int procfs_lire_smaps_rollup(procfs_lecteur_t *lecteur, pid_t pid,
+                             procfs_smaps_t *smaps) {
+  long propre, modifie;
+
+  if (lire_fichier(lecteur, pid, "smaps_rollup") < 0) {
+    return -1;
+  }
+
+  smaps->pss_ko = valeur_status(lecteur->buffer, "Pss");
+  smaps->swap_ko = valeur_status(lecteur->buffer, "Swap");
+  propre = valeur_status(lecteur->buffer, "Private_Clean");
+  modifie = valeur_status(lecteur->buffer, "Private_Dirty");
+  smaps->uss_ko = (propre >= 0 && modifie >= 0) ? propre + modifie : -1;
+  return 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file procfs.h
+ * @brief Lecteur rapide des fichiers /proc/[PID]/stat, task, cmdline, status
+ *        et smaps_rollup
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Ce module remplace le couple fopen/fscanf par une lecture directe :
+ * les fichiers sont ouverts relativement à un descripteur sur /proc,
+ * lus dans un buffer réutilisé, puis analysés par un scanner écrit à la main.
+ */
+
+#ifndef PROCFS_H
+#define PROCFS_H
+
+#include "process.h"
+#include <stddef.h>
+#include <sys/types.h>
+
+#define PROCFS_TAILLE_BUFFER 4096
+
+/**
+ * @brief Lecteur réutilisable de /proc (un par thread de collecte).
+ */
+typedef struct procfs_lecteur {
+  int proc_fd;                        /* Descripteur ouvert sur /proc */
+  long page_ko;                       /* Taille d'une page (Ko), pour le RSS */
+  char buffer[PROCFS_TAILLE_BUFFER];  /* Buffer de lecture réutilisé */
+} procfs_lecteur_t;
+
+/**
+ * @brief Champs retenus de /proc/[PID]/status (-1 si absents).
+ */
+typedef struct procfs_status {
+  int nb_threads;  /* Threads */
+  long vm_swap_ko; /* VmSwap (absent pour les threads noyau) */
+  long vm_pic_ko;  /* VmHWM : pic de RSS */
+} procfs_status_t;
+
+/**
+ * @brief Mémoire comptée par /proc/[PID]/smaps_rollup, en Ko (-1 si absente).
+ */
+typedef struct procfs_smaps {
+  long pss_ko;  /* Pss : pages partagées divisées entre leurs utilisateurs */
+  long uss_ko;  /* Private_Clean + Private_Dirty : libéré à la fin du processus */
+  long swap_ko; /* Swap */
+} procfs_smaps_t;
+
+/**
+ * @brief Ouvre le descripteur sur /proc et relève la taille des pages.
+ * @param lecteur : Lecteur à initialiser.
+ * @return int : 0 en cas de succès, -1 en cas d'erreur.
+ */
+int procfs_ouvrir(procfs_lecteur_t *lecteur);
+
+/**
+ * @brief Ferme le descripteur sur /proc.
+ * @param lecteur : Lecteur à fermer.
+ */
+void procfs_fermer(procfs_lecteur_t *lecteur);
+
+/**
+ * @brief Lit /proc/[PID]/stat et remplit les champs du processus.
+ * @param lecteur : Lecteur ouvert.
+ * @param pid : PID du processus.
+ * @param proc : Structure à remplir.
+ * @param uid : Reçoit l'UID propriétaire (fstat du même descripteur), peut être NULL.
+ * @return int : 0 en cas de succès, -1 si le processus a disparu ou si le format est invalide.
+ */
+int procfs_lire_stat(procfs_lecteur_t *lecteur, pid_t pid, processus_t *proc,
+                     uid_t *uid);
+
+/**
+ * @brief Lit /proc/[PID]/task/[TID]/stat (même chemin d'analyse que le
+ *        processus) ; proc->pid reçoit le TID et proc->tgid le PID.
+ * @param lecteur : Lecteur ouvert.
+ * @param pid : PID du processus.
+ * @param tid : TID du thread.
+ * @param proc : Structure à remplir.
+ * @param uid : Reçoit l'UID propriétaire, peut être NULL.
+ * @return int : 0 en cas de succès, -1 si le thread a disparu.
+ */
+int procfs_lire_stat_tache(procfs_lecteur_t *lecteur, pid_t pid, pid_t tid,
+                           processus_t *proc, uid_t *uid);
+
+/**
+ * @brief Liste les TID de /proc/[PID]/task.
+ * @param lecteur : Lecteur ouvert.
+ * @param pid : PID du processus.
+ * @param tids : Tableau réutilisé, agrandi si nécessaire.
+ * @param capacite : Capacité du tableau (mise à jour).
+ * @return int : Nombre de TID, -1 si le processus a disparu.
+ */
+int procfs_lister_taches(procfs_lecteur_t *lecteur, pid_t pid, pid_t **tids,
+                         int *capacite);
+
+/**
+ * @brief Analyse le contenu d'un fichier stat déjà en mémoire.
+ *
+ * Le nom de commande est délimité par la première '(' et la dernière ')',
+ * ce qui accepte les noms contenant des espaces ou des parenthèses.
+ *
+ * @param buffer : Contenu du fichier (pas forcément terminé par '\0').
+ * @param len : Longueur du contenu.
+ * @param page_ko : Taille d'une page en Ko (le RSS de stat est en pages).
+ * @param proc : Structure à remplir.
+ * @return int : 0 en cas de succès, -1 si le format est invalide.
+ */
+int procfs_parser_stat(const char *buffer, size_t len, long page_ko,
+                       processus_t *proc);
+
+/**
+ * @brief Lit /proc/[PID]/cmdline, arguments séparés par des espaces.
+ * @param lecteur : Lecteur ouvert.
+ * @param pid : PID du processus.
+ * @param dest : Buffer destination (chaîne vide pour un thread noyau).
+ * @param taille : Taille du buffer.
+ * @return int : 0 en cas de succès, -1 si le processus a disparu.
+ */
+int procfs_lire_cmdline(procfs_lecteur_t *lecteur, pid_t pid, char *dest,
+                        size_t taille);
+
+/**
+ * @brief Lit /proc/[PID]/status.
+ * @param lecteur : Lecteur ouvert.
+ * @param pid : PID du processus.
+ * @param status : Structure à remplir.
+ * @return int : 0 en cas de succès, -1 si le processus a disparu.
+ */
+int procfs_lire_status(procfs_lecteur_t *lecteur, pid_t pid,
+                       procfs_status_t *status);
+
+/**
+ * @brief Lit /proc/[PID]/smaps_rollup.
+ *
+ * Le noyau parcourt toutes les projections du processus pour produire ce
+ * fichier : son coût croît avec la taille de l'espace d'adressage.
+ *
+ * @param lecteur : Lecteur ouvert.
+ * @param pid : PID du processus.
+ * @param smaps : Structure à remplir (champs à -1 pour un thread noyau).
+ * @return int : 0 en cas de succès, -1 si le processus a disparu ou si
+ *               la lecture est refusée.
+ */
+int procfs_lire_smaps_rollup(procfs_lecteur_t *lecteur, pid_t pid,
+                             procfs_smaps_t *smaps);
+
+#endif /* PROCFS_H */
@@ -0,0 +1,279 @@
+/**
+ * @file scanner.c
+ * @brief Implémentation du parcours parallèle de /proc
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "scanner.h"
+#include "procfs.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Fonctions privées */
+
+/**
+ * @brief Liste les PID de /proc dans scanner->pids.
+ */
+static int lister_pids(scanner_t *scanner) {
+  DIR *dir = opendir(PROC_DIR);
+  struct dirent *entree;
+
+  if (dir == NULL) {
+    return -1;
+  }
+
+  scanner->nb_pids = 0;
+  while ((entree = readdir(dir)) != NULL) {
+    if (!isdigit((unsigned char)entree->d_name[0])) {
+      continue;
+    }
+
+    if (scanner->nb_pids == scanner->capacite_pids) {
+      int capacite = scanner->capacite_pids ? scanner->capacite_pids * 2 : 1024;
+      pid_t *pids = realloc(scanner->pids, sizeof(pid_t) * capacite);
+      if (pids == NULL) {
+        closedir(dir);
+        return -1;
+      }
+      scanner->pids = pids;
+      scanner->capacite_pids = capacite;
+    }
+    scanner->pids[scanner->nb_pids++] = (pid_t)atoi(entree->d_name);
+  }
+
+  closedir(dir);
+  return 0;
+}
+
+/**
+ * @brief Lit la tranche [debut, fin[ des PID dans un snapshot privé.
+ */
+static void lire_tranche(const pid_t *pids, int debut, int fin,
+                         snapshot_t *tampon) {
+  procfs_lecteur_t lecteur;
+
+  snapshot_reinitialiser(tampon);
+  if (procfs_ouvrir(&lecteur) != 0) {
+    return;
+  }
+
+  for (int i = debut; i < fin; i++) {
+    processus_t *proc = snapshot_ajouter(tampon);
+    if (proc == NULL) {
+      break;
+    }
+    if (procfs_lire_stat(&lecteur, pids[i], proc, &proc->uid) != 0) {
+      snapshot_annuler_dernier(tampon);
+      continue;
+    }
+    proc->utilisateur[0] = '\0';
+    proc->cpu_percent = 0.0f;
+    proc->cpu_percent_machine = 0.0f;
+  }
+
+  procfs_fermer(&lecteur);
+}
+
+/**
+ * @brief Bornes de la tranche d'un thread.
+ */
+static void bornes_tranche(const scanner_t *scanner, int numero, int *debut,
+                           int *fin) {
+  int nb = scanner->nb_actifs;
+  *debut = (int)((long long)scanner->nb_pids * numero / nb);
+  *fin = (int)((long long)scanner->nb_pids * (numero + 1) / nb);
+}
+
+/**
+ * @brief Boucle d'un thread du groupe : attend une passe, lit sa tranche.
+ */
+static void *boucle_travailleur(void *arg) {
+  scanner_travailleur_t *travailleur = arg;
+  scanner_t *scanner = travailleur->scanner;
+  unsigned int passe_vue = 0;
+
+  pthread_mutex_lock(&scanner->verrou);
+  for (;;) {
+    while (!scanner->arret && scanner->passe == passe_vue) {
+      pthread_cond_wait(&scanner->cond_travail, &scanner->verrou);
+    }
+    if (scanner->arret) {
+      break;
+    }
+    passe_vue = scanner->passe;
+
+    if (travailleur->numero >= scanner->nb_actifs) {
+      continue;
+    }
+
+    int debut, fin;
+    bornes_tranche(scanner, travailleur->numero, &debut, &fin);
+    pthread_mutex_unlock(&scanner->verrou);
+
+    lire_tranche(scanner->pids, debut, fin, &travailleur->tampon);
+
+    pthread_mutex_lock(&scanner->verrou);
+    if (--scanner->restants == 0) {
+      pthread_cond_signal(&scanner->cond_fin);
+    }
+  }
+  pthread_mutex_unlock(&scanner->verrou);
+  return NULL;
+}
+
+/**
+ * @brief Démarre les threads manquants (le thread appelant est le n°0).
+ */
+static void demarrer_groupe(scanner_t *scanner) {
+  if (scanner->nb_demarres == 0) {
+    pthread_mutex_init(&scanner->verrou, NULL);
+    pthread_cond_init(&scanner->cond_travail, NULL);
+    pthread_cond_init(&scanner->cond_fin, NULL);
+    scanner->nb_demarres = 1;
+  }
+
+  while (scanner->nb_demarres < scanner->nb_threads) {
+    scanner_travailleur_t *travailleur =
+        &scanner->travailleurs[scanner->nb_demarres];
+    if (pthread_create(&travailleur->thread, NULL, boucle_travailleur,
+                       travailleur) != 0) {
+      break;
+    }
+    scanner->nb_demarres++;
+  }
+}
+
+/**
+ * @brief Lit les PID de scanner->pids dans 'dest' (en parallèle au-delà du seuil).
+ */
+static int lire_pids(scanner_t *scanner, snapshot_t *dest) {
+  /* Petit nombre de PID : lecture directe dans la destination */
+  if (scanner->nb_threads <= 1 || scanner->nb_pids < scanner->seuil_parallele) {
+    lire_tranche(scanner->pids, 0, scanner->nb_pids, dest);
+    return 0;
+  }
+
+  demarrer_groupe(scanner);
+
+  /* Lancer la passe : chaque thread lit sa tranche dans son tampon privé */
+  pthread_mutex_lock(&scanner->verrou);
+  scanner->nb_actifs = scanner->nb_demarres;
+  scanner->restants = scanner->nb_actifs - 1;
+  scanner->passe++;
+  pthread_cond_broadcast(&scanner->cond_travail);
+  pthread_mutex_unlock(&scanner->verrou);
+
+  int debut, fin;
+  bornes_tranche(scanner, 0, &debut, &fin);
+  lire_tranche(scanner->pids, debut, fin, &scanner->travailleurs[0].tampon);
+
+  pthread_mutex_lock(&scanner->verrou);
+  while (scanner->restants > 0) {
+    pthread_cond_wait(&scanner->cond_fin, &scanner->verrou);
+  }
+  pthread_mutex_unlock(&scanner->verrou);
+
+  /* Fusion : concaténation des tampons dans l'ordre des tranches */
+  snapshot_reinitialiser(dest);
+  for (int t = 0; t < scanner->nb_actifs; t++) {
+    snapshot_t *tampon = &scanner->travailleurs[t].tampon;
+    if (snapshot_reserver(dest, dest->nb + tampon->nb) != 0) {
+      return -1;
+    }
+    memcpy(&dest->elements[dest->nb], tampon->elements,
+           sizeof(processus_t) * tampon->nb);
+    dest->nb += tampon->nb;
+  }
+
+  return 0;
+}
+
+/* Fonctions publiques */
+
+int scanner_threads_automatique(void) {
+  long nb = sysconf(_SC_NPROCESSORS_ONLN);
+
+  if (nb < 1) {
+    nb = 1;
+  }
+  if (nb > SCANNER_THREADS_DEFAUT_MAX) {
+    nb = SCANNER_THREADS_DEFAUT_MAX;
+  }
+  return (int)nb;
+}
+
+void scanner_init(scanner_t *scanner, int nb_threads) {
+  memset(scanner, 0, sizeof(*scanner));
+
+  scanner_configurer_threads(scanner, nb_threads);
+  scanner->seuil_parallele = SCANNER_SEUIL_PARALLELE;
+  for (int i = 0; i < SCANNER_MAX_THREADS; i++) {
+    scanner->travailleurs[i].scanner = scanner;
+    scanner->travailleurs[i].numero = i;
+    snapshot_init(&scanner->travailleurs[i].tampon);
+  }
+}
+
+void scanner_configurer_threads(scanner_t *scanner, int nb_threads) {
+  if (nb_threads <= 0) {
+    nb_threads = scanner_threads_automatique();
+  }
+  if (nb_threads > SCANNER_MAX_THREADS) {
+    nb_threads = SCANNER_MAX_THREADS;
+  }
+  scanner->nb_threads = nb_threads;
+}
+
+void scanner_liberer(scanner_t *scanner) {
+  if (scanner->nb_demarres > 0) {
+    pthread_mutex_lock(&scanner->verrou);
+    scanner->arret = 1;
+    pthread_cond_broadcast(&scanner->cond_travail);
+    pthread_mutex_unlock(&scanner->verrou);
+
+    for (int i = 1; i < scanner->nb_demarres; i++) {
+      pthread_join(scanner->travailleurs[i].thread, NULL);
+    }
+
+    pthread_mutex_destroy(&scanner->verrou);
+    pthread_cond_destroy(&scanner->cond_travail);
+    pthread_cond_destroy(&scanner->cond_fin);
+    scanner->nb_demarres = 0;
+  }
+
+  for (int i = 0; i < SCANNER_MAX_THREADS; i++) {
+    snapshot_liberer(&scanner->travailleurs[i].tampon);
+  }
+  free(scanner->pids);
+  scanner->pids = NULL;
+  scanner->nb_pids = 0;
+  scanner->capacite_pids = 0;
+}
+
+int scanner_collecter(scanner_t *scanner, snapshot_t *dest) {
+  if (lister_pids(scanner) != 0) {
+    return -1;
+  }
+  return lire_pids(scanner, dest);
+}
+
+int scanner_collecter_pids(scanner_t *scanner, const pid_t *pids, int nb,
+                           snapshot_t *dest) {
+  if (nb > scanner->capacite_pids) {
+    pid_t *copie = realloc(scanner->pids, sizeof(pid_t) * nb);
+    if (copie == NULL) {
+      return -1;
+    }
+    scanner->pids = copie;
+    scanner->capacite_pids = nb;
+  }
+  memcpy(scanner->pids, pids, sizeof(pid_t) * nb);
+  scanner->nb_pids = nb;
+  return lire_pids(scanner, dest);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file scanner.h
+ * @brief Parcours parallèle de /proc pour les machines à très grand nombre de PID
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Les PID listés dans /proc sont répartis en tranches contiguës entre un
+ * groupe fixe de threads. Chaque thread remplit son propre snapshot privé
+ * avec son propre lecteur procfs, sans verrou sur le chemin critique ;
+ * les tampons sont ensuite concaténés dans le snapshot de destination.
+ * Sous un seuil de PID, le parcours reste mono-thread.
+ */
+
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include "snapshot.h"
+#include <pthread.h>
+
+#define SCANNER_MAX_THREADS 64
+#define SCANNER_THREADS_DEFAUT_MAX 8 /* Plafond du réglage automatique */
+#define SCANNER_SEUIL_PARALLELE 2048 /* Nombre de PID minimal pour paralléliser */
+
+struct scanner;
+
+/**
+ * @brief Contexte d'un thread du groupe.
+ */
+typedef struct scanner_travailleur {
+  struct scanner *scanner;
+  int numero;
+  pthread_t thread;
+  snapshot_t tampon; /* Lignes lues par ce thread */
+} scanner_travailleur_t;
+
+/**
+ * @brief Scanner de /proc (réutilisable d'un rafraîchissement à l'autre).
+ */
+typedef struct scanner {
+  int nb_threads;      /* Threads utilisés (1 = mono-thread) */
+  int seuil_parallele; /* Sous ce nombre de PID, pas de parallélisme */
+
+  pid_t *pids;         /* PID listés lors du dernier parcours */
+  int nb_pids;
+  int capacite_pids;
+
+  /* Groupe de threads (démarré à la première collecte parallèle) */
+  scanner_travailleur_t travailleurs[SCANNER_MAX_THREADS];
+  int nb_demarres;
+  int nb_actifs;           /* Threads participant à la passe en cours */
+  unsigned int passe;      /* Incrémenté à chaque passe */
+  int restants;            /* Threads n'ayant pas fini la passe */
+  int arret;
+  pthread_mutex_t verrou;
+  pthread_cond_t cond_travail;
+  pthread_cond_t cond_fin;
+} scanner_t;
+
+/**
+ * @brief Initialise un scanner.
+ * @param scanner : Scanner à initialiser.
+ * @param nb_threads : Nombre de threads (<= 0 : automatique).
+ */
+void scanner_init(scanner_t *scanner, int nb_threads);
+
+/**
+ * @brief Change le nombre de threads (avant la première collecte parallèle).
+ * @param scanner : Scanner concerné.
+ * @param nb_threads : Nombre de threads (<= 0 : automatique).
+ */
+void scanner_configurer_threads(scanner_t *scanner, int nb_threads);
+
+/**
+ * @brief Arrête le groupe de threads et libère la mémoire.
+ * @param scanner : Scanner à libérer.
+ */
+void scanner_liberer(scanner_t *scanner);
+
+/**
+ * @brief Lit /proc et remplit le snapshot avec les champs de /proc/[PID]/stat.
+ *
+ * Les noms d'utilisateur ne sont pas résolus (utilisateur[0] == '\0') ;
+ * l'UID est renseigné. cpu_percent vaut 0.
+ *
+ * @param scanner : Scanner à utiliser.
+ * @param dest : Snapshot destination (remis à zéro).
+ * @return int : 0 en cas de succès, -1 si /proc est illisible.
+ */
+int scanner_collecter(scanner_t *scanner, snapshot_t *dest);
+
+/**
+ * @brief Relit une liste de PID donnée (sans lister /proc).
+ *
+ * Les PID disparus entre-temps sont simplement absents du résultat.
+ *
+ * @param scanner : Scanner à utiliser.
+ * @param pids : PID à lire.
+ * @param nb : Nombre de PID.
+ * @param dest : Snapshot destination (remis à zéro).
+ * @return int : 0 en cas de succès, -1 en cas d'erreur mémoire.
+ */
+int scanner_collecter_pids(scanner_t *scanner, const pid_t *pids, int nb,
+                           snapshot_t *dest);
+
+/**
+ * @brief Retourne le nombre de threads automatique (cœurs en ligne, plafonné).
+ * @return int : Nombre de threads.
+ */
+int scanner_threads_automatique(void);
+
+#endif /* SCANNER_H */
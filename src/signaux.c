@@ -0,0 +1,527 @@
+/**
+ * @file signaux.c
+ * @brief Implémentation de l'envoi local des signaux (pidfd, portées gelées)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "signaux.h"
+#include <dirent.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* Numéros absents des en-têtes antérieurs à Linux 5.3 */
+#ifndef __NR_pidfd_open
+#define __NR_pidfd_open 434
+#endif
+#ifndef __NR_pidfd_send_signal
+#define __NR_pidfd_send_signal 424
+#endif
+
+/* Fonctions privées */
+
+static unsigned int hacher_pid(pid_t pid, int taille) {
+  return ((unsigned int)pid * 2654435761u) & (unsigned int)(taille - 1);
+}
+
+static void fermer_membre(signaux_membre_t *membre) {
+  if (membre->pidfd >= 0) {
+    close(membre->pidfd);
+    membre->pidfd = -1;
+  }
+}
+
+/**
+ * @brief Ouvre un processus et vérifie qu'il est bien celui affiché.
+ *
+ * La date de démarrage est relue après pidfd_open() : si elle correspond,
+ * le PID n'a pas changé de propriétaire depuis l'affichage et le pidfd
+ * désigne ce processus jusqu'à sa fermeture.
+ *
+ * @param starttime : Date attendue (0 : non vérifiée).
+ * @param proc : Reçoit le contenu de /proc/[PID]/stat.
+ * @return int : 0, ou ESRCH si le processus a disparu ou a été remplacé.
+ */
+static int ouvrir_membre(signaux_locaux_t *signaux, pid_t pid,
+                         unsigned long long starttime, processus_t *proc,
+                         signaux_membre_t *membre) {
+  membre->pid = pid;
+  membre->pidfd = -1;
+  membre->deja_arrete = 0;
+
+  if (signaux->pidfd_disponible) {
+    membre->pidfd = (int)syscall(__NR_pidfd_open, pid, 0);
+    if (membre->pidfd < 0) {
+      if (errno == ESRCH) {
+        return ESRCH;
+      }
+      if (errno == ENOSYS) {
+        signaux->pidfd_disponible = 0;
+      }
+      /* Descripteurs épuisés... : kill() après vérification */
+    }
+  }
+
+  if (procfs_lire_stat(&signaux->lecteur, pid, proc, NULL) != 0 ||
+      (starttime != 0 && proc->starttime != starttime)) {
+    fermer_membre(membre);
+    return ESRCH;
+  }
+  membre->starttime = proc->starttime;
+  membre->deja_arrete = proc->etat == 'T' || proc->etat == 't';
+  return 0;
+}
+
+/**
+ * @brief Signale un membre par son pidfd, ou par kill() si sa date de
+ *        démarrage n'a pas changé.
+ * @return int : 0 ou errno.
+ */
+static int signaler_membre(signaux_locaux_t *signaux,
+                           const signaux_membre_t *membre, int signal) {
+  processus_t proc;
+
+  if (membre->pidfd >= 0) {
+    return syscall(__NR_pidfd_send_signal, membre->pidfd, signal, NULL, 0) ==
+                   0
+               ? 0
+               : errno;
+  }
+
+  signaux->nb_sans_pidfd++;
+  if (procfs_lire_stat(&signaux->lecteur, membre->pid, &proc, NULL) != 0 ||
+      proc.starttime != membre->starttime) {
+    return ESRCH;
+  }
+  return kill(membre->pid, signal) == 0 ? 0 : errno;
+}
+
+static int est_exclu(const signaux_locaux_t *signaux, pid_t pid) {
+  for (int i = 0; i < signaux->nb_exclus; i++) {
+    if (signaux->exclus[i] == pid) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int chercher_entree(const signaux_locaux_t *signaux, pid_t pid) {
+  unsigned int masque = (unsigned int)signaux->taille_index - 1;
+  unsigned int i;
+
+  if (signaux->taille_index == 0) {
+    return -1;
+  }
+  for (i = hacher_pid(pid, signaux->taille_index); signaux->index[i] >= 0;
+       i = (i + 1) & masque) {
+    if (signaux->entrees[signaux->index[i]].pid == pid) {
+      return signaux->index[i];
+    }
+  }
+  return -1;
+}
+
+static int chercher_membre(const signaux_locaux_t *signaux, pid_t pid) {
+  unsigned int masque = (unsigned int)signaux->taille_index_membres - 1;
+  unsigned int i;
+
+  if (signaux->taille_index_membres == 0) {
+    return -1;
+  }
+  for (i = hacher_pid(pid, signaux->taille_index_membres);
+       signaux->index_membres[i] >= 0; i = (i + 1) & masque) {
+    if (signaux->membres[signaux->index_membres[i]].pid == pid) {
+      return signaux->index_membres[i];
+    }
+  }
+  return -1;
+}
+
+static void indexer_membre(signaux_locaux_t *signaux, int n) {
+  unsigned int masque = (unsigned int)signaux->taille_index_membres - 1;
+  unsigned int i =
+      hacher_pid(signaux->membres[n].pid, signaux->taille_index_membres);
+
+  while (signaux->index_membres[i] >= 0) {
+    i = (i + 1) & masque;
+  }
+  signaux->index_membres[i] = n;
+}
+
+/**
+ * @brief Ajoute un membre à la portée en cours (le pidfd lui appartient
+ *        désormais).
+ * @return int : 0, ou -1 en cas d'erreur mémoire.
+ */
+static int ajouter_membre(signaux_locaux_t *signaux,
+                          const signaux_membre_t *membre) {
+  if (signaux->nb_membres == signaux->capacite_membres) {
+    int capacite = signaux->capacite_membres ? signaux->capacite_membres * 2
+                                             : 64;
+    signaux_membre_t *membres =
+        realloc(signaux->membres, (size_t)capacite * sizeof(*membres));
+    if (membres == NULL) {
+      return -1;
+    }
+    signaux->membres = membres;
+    signaux->capacite_membres = capacite;
+  }
+
+  /* Index au plus à moitié plein */
+  if (2 * (signaux->nb_membres + 1) > signaux->taille_index_membres) {
+    int taille = signaux->taille_index_membres ? signaux->taille_index_membres
+                                               : 128;
+    while (2 * (signaux->nb_membres + 1) > taille) {
+      taille *= 2;
+    }
+    int *index = realloc(signaux->index_membres, (size_t)taille * sizeof(int));
+    if (index == NULL) {
+      return -1;
+    }
+    signaux->index_membres = index;
+    signaux->taille_index_membres = taille;
+    memset(index, -1, (size_t)taille * sizeof(int));
+    for (int n = 0; n < signaux->nb_membres; n++) {
+      indexer_membre(signaux, n);
+    }
+  }
+
+  signaux->membres[signaux->nb_membres] = *membre;
+  indexer_membre(signaux, signaux->nb_membres);
+  signaux->nb_membres++;
+  return 0;
+}
+
+static void vider_membres(signaux_locaux_t *signaux) {
+  for (int n = 0; n < signaux->nb_membres; n++) {
+    fermer_membre(&signaux->membres[n]);
+  }
+  signaux->nb_membres = 0;
+  if (signaux->index_membres != NULL) {
+    memset(signaux->index_membres, -1,
+           (size_t)signaux->taille_index_membres * sizeof(int));
+  }
+}
+
+/**
+ * @brief Garantit la place de 'nb' entrées (tableaux du parcours).
+ */
+static int reserver_entrees(signaux_locaux_t *signaux, int nb) {
+  int capacite = signaux->capacite_entrees ? signaux->capacite_entrees : 256;
+
+  if (nb <= signaux->capacite_entrees) {
+    return 0;
+  }
+  while (capacite < nb) {
+    capacite *= 2;
+  }
+
+  signaux_entree_t *entrees =
+      realloc(signaux->entrees, (size_t)capacite * sizeof(*entrees));
+  if (entrees == NULL) {
+    return -1;
+  }
+  signaux->entrees = entrees;
+
+  signed char *appartenance =
+      realloc(signaux->appartenance, (size_t)capacite);
+  if (appartenance == NULL) {
+    return -1;
+  }
+  signaux->appartenance = appartenance;
+
+  int *chemin = realloc(signaux->chemin, (size_t)capacite * sizeof(int));
+  if (chemin == NULL) {
+    return -1;
+  }
+  signaux->chemin = chemin;
+  signaux->capacite_entrees = capacite;
+  return 0;
+}
+
+/**
+ * @brief Relève pid, ppid, pgrp, session et date de démarrage de chaque
+ *        processus de /proc (sauf les exclus), puis les indexe par PID.
+ * @return int : 0 en cas de succès, -1 en cas d'erreur.
+ */
+static int parcourir_proc(signaux_locaux_t *signaux) {
+  struct dirent *entree;
+  processus_t proc;
+  DIR *dir = opendir(PROC_DIR);
+
+  if (dir == NULL) {
+    return -1;
+  }
+
+  signaux->nb_entrees = 0;
+  while ((entree = readdir(dir)) != NULL) {
+    pid_t pid = 0;
+    const char *c = entree->d_name;
+
+    if (*c < '1' || *c > '9') {
+      continue;
+    }
+    for (; *c >= '0' && *c <= '9'; c++) {
+      pid = pid * 10 + (*c - '0');
+    }
+    if (*c != '\0' || est_exclu(signaux, pid) ||
+        procfs_lire_stat(&signaux->lecteur, pid, &proc, NULL) != 0) {
+      continue;
+    }
+    if (reserver_entrees(signaux, signaux->nb_entrees + 1) != 0) {
+      closedir(dir);
+      return -1;
+    }
+
+    signaux_entree_t *e = &signaux->entrees[signaux->nb_entrees++];
+    e->pid = pid;
+    e->ppid = proc.ppid;
+    e->pgrp = proc.pgrp;
+    e->session = proc.session;
+    e->starttime = proc.starttime;
+    e->etat = proc.etat;
+  }
+  closedir(dir);
+
+  /* Index au plus à moitié plein, reconstruit à chaque parcours */
+  int taille = signaux->taille_index ? signaux->taille_index : 512;
+  while (2 * signaux->nb_entrees > taille) {
+    taille *= 2;
+  }
+  if (taille != signaux->taille_index) {
+    int *index = realloc(signaux->index, (size_t)taille * sizeof(int));
+    if (index == NULL) {
+      return -1;
+    }
+    signaux->index = index;
+    signaux->taille_index = taille;
+  }
+  memset(signaux->index, -1, (size_t)taille * sizeof(int));
+  for (int n = 0; n < signaux->nb_entrees; n++) {
+    unsigned int masque = (unsigned int)taille - 1;
+    unsigned int i = hacher_pid(signaux->entrees[n].pid, taille);
+    while (signaux->index[i] >= 0) {
+      i = (i + 1) & masque;
+    }
+    signaux->index[i] = n;
+  }
+  if (signaux->nb_entrees > 0) {
+    memset(signaux->appartenance, 0, (size_t)signaux->nb_entrees);
+  }
+  return 0;
+}
+
+/**
+ * @brief Indique si une entrée descend d'un membre, en remontant ses
+ *        ancêtres ; le résultat est retenu pour tout le chemin parcouru.
+ */
+static int descend_d_un_membre(signaux_locaux_t *signaux, int n) {
+  int longueur = 0;
+  signed char resultat = -1;
+
+  while (signaux->appartenance[n] == 0) {
+    const signaux_entree_t *e = &signaux->entrees[n];
+
+    if (chercher_membre(signaux, e->pid) >= 0) {
+      resultat = 1;
+      break;
+    }
+    signaux->appartenance[n] = 2; /* Sur le chemin : garde contre un cycle */
+    signaux->chemin[longueur++] = n;
+
+    n = e->ppid != e->pid ? chercher_entree(signaux, e->ppid) : -1;
+    if (n < 0) {
+      break;
+    }
+  }
+  if (n >= 0 && signaux->appartenance[n] != 2 && resultat != 1) {
+    resultat = signaux->appartenance[n];
+  }
+
+  for (int i = 0; i < longueur; i++) {
+    signaux->appartenance[signaux->chemin[i]] = resultat;
+  }
+  return resultat == 1;
+}
+
+static int appartient(signaux_locaux_t *signaux, int n,
+                      portee_signal_t portee, pid_t cle) {
+  switch (portee) {
+  case PORTEE_SOUS_ARBRE:
+    return descend_d_un_membre(signaux, n);
+  case PORTEE_GROUPE:
+    return signaux->entrees[n].pgrp == cle;
+  case PORTEE_SESSION:
+    return signaux->entrees[n].session == cle;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * @brief Gèle la portée d'un processus (SIGSTOP à chaque nouveau membre,
+ *        jusqu'à un parcours sans nouveau membre), lui envoie le signal,
+ *        puis la relance. SIGCONT se contente d'un parcours.
+ * @param cible : Processus visé, ouvert (son pidfd est repris).
+ * @param cle : Groupe ou session de la cible.
+ * @param atteints : Incrémenté de chaque membre signalé.
+ * @return int : errno du signal de la cible (0 : envoyé).
+ */
+static int signaler_portee(signaux_locaux_t *signaux,
+                           signaux_membre_t *cible, portee_signal_t portee,
+                           pid_t cle, int signal, int *atteints) {
+  int geler = signal != SIGCONT;
+  int erreur;
+
+  vider_membres(signaux);
+  if (ajouter_membre(signaux, cible) != 0) {
+    fermer_membre(cible);
+    return ENOMEM;
+  }
+  if (geler) {
+    erreur = signaler_membre(signaux, &signaux->membres[0], SIGSTOP);
+    if (erreur != 0) {
+      vider_membres(signaux);
+      return erreur;
+    }
+  }
+
+  signaux->nb_gels++;
+  for (int tour = 0; tour < SIGNAUX_TOURS_MAX; tour++) {
+    int nouveaux = 0;
+
+    signaux->nb_tours++;
+    if (parcourir_proc(signaux) != 0) {
+      break;
+    }
+    for (int n = 0; n < signaux->nb_entrees; n++) {
+      const signaux_entree_t *e = &signaux->entrees[n];
+      signaux_membre_t membre;
+      processus_t proc;
+
+      if (chercher_membre(signaux, e->pid) >= 0 ||
+          !appartient(signaux, n, portee, cle) ||
+          ouvrir_membre(signaux, e->pid, e->starttime, &proc, &membre) != 0) {
+        continue;
+      }
+      if (ajouter_membre(signaux, &membre) != 0) {
+        fermer_membre(&membre);
+        continue;
+      }
+      if (geler) {
+        signaler_membre(signaux, &membre, SIGSTOP);
+      }
+      nouveaux++;
+    }
+    if (nouveaux == 0 || !geler) {
+      break;
+    }
+  }
+
+  /* Portée figée : le signal, puis la reprise */
+  erreur = signaler_membre(signaux, &signaux->membres[0], signal);
+  for (int n = 0; n < signaux->nb_membres; n++) {
+    if ((n == 0 ? erreur
+                : signaler_membre(signaux, &signaux->membres[n], signal)) ==
+        0) {
+      (*atteints)++;
+    }
+  }
+  if (geler && signal != SIGSTOP && signal != SIGKILL) {
+    for (int n = 0; n < signaux->nb_membres; n++) {
+      if (!signaux->membres[n].deja_arrete) {
+        signaler_membre(signaux, &signaux->membres[n], SIGCONT);
+      }
+    }
+  }
+
+  vider_membres(signaux);
+  return erreur;
+}
+
+/* Fonctions publiques */
+
+void signaux_init(signaux_locaux_t *signaux) {
+  memset(signaux, 0, sizeof(*signaux));
+  /* Sans /proc, seuls les processus seuls restent signalables (kill()) */
+  procfs_ouvrir(&signaux->lecteur);
+  signaux->pidfd_disponible = 1;
+  signaux->exclus[signaux->nb_exclus++] = getpid();
+}
+
+void signaux_exclure_ancetres(signaux_locaux_t *signaux) {
+  processus_t proc;
+  pid_t pid = getppid();
+
+  /* init (PID 1) ne peut de toute façon pas être arrêté */
+  while (pid > 1 && signaux->nb_exclus < SIGNAUX_EXCLUS_MAX &&
+         procfs_lire_stat(&signaux->lecteur, pid, &proc, NULL) == 0) {
+    signaux->exclus[signaux->nb_exclus++] = pid;
+    pid = proc.ppid;
+  }
+}
+
+void signaux_liberer(signaux_locaux_t *signaux) {
+  vider_membres(signaux);
+  procfs_fermer(&signaux->lecteur);
+  free(signaux->entrees);
+  free(signaux->index);
+  free(signaux->appartenance);
+  free(signaux->chemin);
+  free(signaux->membres);
+  free(signaux->index_membres);
+  memset(signaux, 0, sizeof(*signaux));
+  signaux->lecteur.proc_fd = -1;
+}
+
+int signaux_envoyer(signaux_locaux_t *signaux, lot_signaux_t *lot) {
+  lot->nb_atteints = 0;
+
+  for (int i = 0; i < lot->nb; i++) {
+    signaux_membre_t cible;
+    processus_t proc;
+    int erreur;
+
+    if (signaux->lecteur.proc_fd < 0) {
+      erreur = lot->portee != PORTEE_PROCESSUS ? ENOTSUP
+               : kill(lot->pids[i], lot->signal) == 0 ? 0
+                                                      : errno;
+      lot->nb_atteints += erreur == 0;
+      lot->erreurs[i] = erreur;
+      continue;
+    }
+
+    erreur = ouvrir_membre(signaux, lot->pids[i], lot->starttimes[i], &proc,
+                           &cible);
+    if (erreur != 0) {
+      lot->erreurs[i] = erreur;
+      continue;
+    }
+
+    if (lot->portee == PORTEE_PROCESSUS) {
+      erreur = signaler_membre(signaux, &cible, lot->signal);
+      fermer_membre(&cible);
+      lot->nb_atteints += erreur == 0;
+    } else {
+      pid_t cle = lot->portee == PORTEE_GROUPE     ? proc.pgrp
+                  : lot->portee == PORTEE_SESSION ? proc.session
+                                                  : cible.pid;
+
+      /* Threads noyau (ni groupe ni session), my_htop ou un ancêtre exclu */
+      if (cle <= 0 || est_exclu(signaux, cible.pid)) {
+        fermer_membre(&cible);
+        erreur = EINVAL;
+      } else {
+        erreur = signaler_portee(signaux, &cible, lot->portee, cle,
+                                 lot->signal, &lot->nb_atteints);
+      }
+    }
+    lot->erreurs[i] = erreur;
+  }
+  return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file signaux.h
+ * @brief Envoi local des signaux : pidfd, sous-arbre, groupe et session
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Chaque processus visé est ouvert par pidfd_open() puis sa date de
+ * démarrage est relue dans /proc/[PID]/stat : si elle correspond à celle
+ * affichée, le pidfd désigne bien ce processus et pidfd_send_signal() ne
+ * peut plus atteindre un PID réutilisé entre-temps. Sans pidfd (noyau
+ * antérieur à 5.3, descripteurs épuisés), la date est revérifiée juste
+ * avant kill().
+ *
+ * Un sous-arbre, un groupe ou une session est d'abord gelé : ses membres
+ * reçoivent SIGSTOP au fur et à mesure des parcours de /proc, jusqu'à un
+ * parcours sans nouveau membre. Le noyau annulant un fork() en cours quand
+ * un signal arrive, un membre arrêté ne crée plus d'enfant : aucun
+ * processus né pendant l'opération n'échappe au signal. Les membres
+ * reçoivent ensuite le signal, puis SIGCONT (sauf ceux qui étaient déjà
+ * arrêtés). my_htop lui-même n'est jamais membre ; l'agent distant
+ * (agent.h) en exclut aussi ses ancêtres, qui portent sa connexion SSH.
+ */
+
+#ifndef SIGNAUX_H
+#define SIGNAUX_H
+
+#include "marques.h"
+#include "procfs.h"
+
+#define SIGNAUX_TOURS_MAX 16 /* Parcours de /proc pour geler une portée */
+#define SIGNAUX_EXCLUS_MAX 32 /* my_htop et ses ancêtres */
+
+/**
+ * @brief Processus relevé lors d'un parcours de /proc.
+ */
+typedef struct signaux_entree {
+  pid_t pid;
+  pid_t ppid;
+  pid_t pgrp;
+  pid_t session;
+  unsigned long long starttime;
+  char etat;
+} signaux_entree_t;
+
+/**
+ * @brief Processus gelé ou signalé.
+ */
+typedef struct signaux_membre {
+  pid_t pid;
+  unsigned long long starttime;
+  int pidfd;              /* -1 : kill() après vérification */
+  int deja_arrete;        /* 1 : arrêté avant l'opération (pas de SIGCONT) */
+} signaux_membre_t;
+
+/**
+ * @brief État de l'envoi local (thread de la source locale).
+ */
+typedef struct signaux_locaux {
+  procfs_lecteur_t lecteur;
+  int pidfd_disponible;         /* 0 : pidfd_open() absent du noyau */
+  pid_t exclus[SIGNAUX_EXCLUS_MAX]; /* Jamais membres d'une portée */
+  int nb_exclus;
+
+  signaux_entree_t *entrees;    /* Dernier parcours de /proc */
+  int nb_entrees;
+  int capacite_entrees;
+  int *index;                   /* Hachage PID -> entrée (-1 si vide) */
+  int taille_index;             /* Puissance de 2 */
+  signed char *appartenance;    /* Sous-arbre : 0 inconnue, 1 oui, -1 non */
+  int *chemin;                  /* Ancêtres en cours d'examen */
+
+  signaux_membre_t *membres;    /* Portée en cours */
+  int nb_membres;
+  int capacite_membres;
+  int *index_membres;           /* Hachage PID -> membre (-1 si vide) */
+  int taille_index_membres;
+
+  /* Statistiques */
+  unsigned long nb_gels;        /* Portées gelées */
+  unsigned long nb_tours;       /* Parcours de /proc pour ces gels */
+  unsigned long nb_sans_pidfd;  /* Signaux envoyés par kill() */
+} signaux_locaux_t;
+
+/**
+ * @brief Initialise l'état de l'envoi local.
+ * @param signaux : État à initialiser.
+ */
+void signaux_init(signaux_locaux_t *signaux);
+
+/**
+ * @brief Libère l'état de l'envoi local.
+ * @param signaux : État à libérer.
+ */
+void signaux_liberer(signaux_locaux_t *signaux);
+
+/**
+ * @brief Exclut aussi des portées les ancêtres de my_htop (agent distant :
+ *        sa session SSH ne doit être ni gelée ni signalée).
+ * @param signaux : État de l'envoi local.
+ */
+void signaux_exclure_ancetres(signaux_locaux_t *signaux);
+
+/**
+ * @brief Envoie le signal d'un lot à chacun de ses PID, selon sa portée.
+ *        L'erreur d'un PID est celle du processus visé lui-même (ESRCH
+ *        s'il a disparu ou si sa date de démarrage ne correspond plus).
+ * @param signaux : État de l'envoi local.
+ * @param lot : Lot à envoyer (erreurs et nb_atteints remplis).
+ * @return int : 0 (les échecs sont notés dans le lot).
+ */
+int signaux_envoyer(signaux_locaux_t *signaux, lot_signaux_t *lot);
+
+#endif /* SIGNAUX_H */
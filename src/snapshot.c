@@ -0,0 +1,106 @@
+/**
+ * @file snapshot.c
+ * @brief Implémentation de l'instantané contigu des processus
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#include "snapshot.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Fonctions publiques */
+
+void snapshot_init(snapshot_t *snapshot) {
+  snapshot->elements = NULL;
+  snapshot->nb = 0;
+  snapshot->capacite = 0;
+  snapshot->generation = 0;
+  snapshot->possede_liste = 0;
+}
+
+void snapshot_liberer(snapshot_t *snapshot) {
+  free(snapshot->elements);
+  snapshot->elements = NULL;
+  snapshot->nb = 0;
+  snapshot->capacite = 0;
+}
+
+snapshot_t *snapshot_creer_autonome(void) {
+  snapshot_t *snapshot = malloc(sizeof(snapshot_t));
+
+  if (snapshot != NULL) {
+    snapshot_init(snapshot);
+    snapshot->possede_liste = 1;
+  }
+  return snapshot;
+}
+
+void snapshot_reinitialiser(snapshot_t *snapshot) {
+  snapshot->nb = 0;
+  snapshot->generation++;
+}
+
+int snapshot_reserver(snapshot_t *snapshot, int capacite) {
+  int nouvelle = snapshot->capacite ? snapshot->capacite
+                                    : SNAPSHOT_CAPACITE_INITIALE;
+
+  if (capacite <= snapshot->capacite) {
+    return 0;
+  }
+  while (nouvelle < capacite) {
+    nouvelle *= 2;
+  }
+
+  processus_t *elements =
+      realloc(snapshot->elements, sizeof(processus_t) * nouvelle);
+  if (elements == NULL) {
+    return -1;
+  }
+  snapshot->elements = elements;
+  snapshot->capacite = nouvelle;
+  return 0;
+}
+
+processus_t *snapshot_ajouter(snapshot_t *snapshot) {
+  if (snapshot->nb == snapshot->capacite &&
+      snapshot_reserver(snapshot, snapshot->nb + 1) != 0) {
+    return NULL;
+  }
+
+  return &snapshot->elements[snapshot->nb++];
+}
+
+void snapshot_annuler_dernier(snapshot_t *snapshot) {
+  if (snapshot->nb > 0) {
+    snapshot->nb--;
+  }
+}
+
+processus_t *snapshot_finaliser(snapshot_t *snapshot) {
+  if (snapshot->nb == 0) {
+    return NULL;
+  }
+
+  for (int i = 0; i < snapshot->nb; i++) {
+    snapshot->elements[i].snapshot = snapshot;
+    snapshot->elements[i].suivant =
+        (i + 1 < snapshot->nb) ? &snapshot->elements[i + 1] : NULL;
+  }
+  return &snapshot->elements[0];
+}
+
+processus_t *snapshot_copier_liste(snapshot_t *snapshot,
+                                   const processus_t *liste) {
+  snapshot_reinitialiser(snapshot);
+
+  for (const processus_t *courant = liste; courant != NULL;
+       courant = courant->suivant) {
+    processus_t *copie = snapshot_ajouter(snapshot);
+    if (copie == NULL) {
+      break;
+    }
+    memcpy(copie, courant, sizeof(processus_t));
+  }
+
+  return snapshot_finaliser(snapshot);
+}
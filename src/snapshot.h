@@ -0,0 +1,93 @@
+/**
+ * @file snapshot.h
+ * @brief Instantané contigu des processus avec accès indexé en O(1)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Un snapshot stocke les processus d'une génération dans un tableau
+ * unique (arène) réutilisé d'une génération à l'autre : la remise à zéro
+ * se fait en une seule opération et le comptage comme l'accès par index
+ * sont en O(1). Les éléments restent chaînés par 'suivant', de sorte que
+ * le code qui parcourt une liste processus_t continue de fonctionner.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "process.h"
+
+#define SNAPSHOT_CAPACITE_INITIALE 512
+
+/**
+ * @brief Arène de processus pour une génération.
+ */
+typedef struct snapshot_processus {
+  processus_t *elements;   /* Tableau contigu des processus */
+  int nb;                  /* Nombre d'éléments valides */
+  int capacite;            /* Nombre d'éléments alloués */
+  unsigned int generation; /* Incrémentée à chaque remise à zéro */
+  int possede_liste;       /* 1 : liberer_liste_processus() libère le snapshot */
+} snapshot_t;
+
+/**
+ * @brief Initialise un snapshot vide (aucune allocation).
+ * @param snapshot : Snapshot à initialiser.
+ */
+void snapshot_init(snapshot_t *snapshot);
+
+/**
+ * @brief Libère l'arène d'un snapshot.
+ * @param snapshot : Snapshot à libérer.
+ */
+void snapshot_liberer(snapshot_t *snapshot);
+
+/**
+ * @brief Alloue un snapshot sur le tas, libéré par liberer_liste_processus().
+ * @return snapshot_t* : Nouveau snapshot, ou NULL en cas d'erreur.
+ */
+snapshot_t *snapshot_creer_autonome(void);
+
+/**
+ * @brief Vide le snapshot en une opération et ouvre une nouvelle génération.
+ * @param snapshot : Snapshot concerné.
+ */
+void snapshot_reinitialiser(snapshot_t *snapshot);
+
+/**
+ * @brief Réserve la place d'un processus à la fin de l'arène.
+ * @param snapshot : Snapshot concerné.
+ * @return processus_t* : Élément à remplir, ou NULL en cas d'erreur mémoire.
+ *         Valable jusqu'au prochain appel (l'arène peut être déplacée).
+ */
+processus_t *snapshot_ajouter(snapshot_t *snapshot);
+
+/**
+ * @brief Garantit une capacité minimale (sans changer le nombre d'éléments).
+ * @param snapshot : Snapshot concerné.
+ * @param capacite : Capacité minimale souhaitée.
+ * @return int : 0 en cas de succès, -1 en cas d'erreur mémoire.
+ */
+int snapshot_reserver(snapshot_t *snapshot, int capacite);
+
+/**
+ * @brief Retire le dernier élément réservé (ligne invalide).
+ * @param snapshot : Snapshot concerné.
+ */
+void snapshot_annuler_dernier(snapshot_t *snapshot);
+
+/**
+ * @brief Chaîne les éléments et retourne la tête de liste.
+ * @param snapshot : Snapshot concerné.
+ * @return processus_t* : Premier élément, ou NULL si le snapshot est vide.
+ */
+processus_t *snapshot_finaliser(snapshot_t *snapshot);
+
+/**
+ * @brief Copie une liste de processus dans le snapshot (après remise à zéro).
+ * @param snapshot : Snapshot destination.
+ * @param liste : Liste source.
+ * @return processus_t* : Tête de la liste copiée, ou NULL si vide ou erreur.
+ */
+processus_t *snapshot_copier_liste(snapshot_t *snapshot,
+                                   const processus_t *liste);
+
+#endif /* SNAPSHOT_H */
@@ -0,0 +1,23 @@
+/**
+ * @file source.c
+ * @brief Fonctions communes aux sources de processus
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#include "source.h"
+#include <stdio.h>
+
+/* Fonctions publiques */
+
+void source_init(source_t *source, const source_ops_t *ops, void *donnees,
+                 const char *nom, int periode_ms) {
+  source->ops = ops;
+  source->donnees = donnees;
+  snprintf(source->nom, sizeof(source->nom), "%s", nom);
+  source->periode_ms = periode_ms;
+  source->max_en_vol = 1;
+}
+
+int source_peut(const source_t *source, int capacite) {
+  return (source->ops->capacites & capacite) == capacite;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file source.h
+ * @brief Interface commune des sources de processus (locale, SSH, ...)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Une source sait collecter un instantané de ses processus, envoyer un
+ * signal à un lot de processus et décrire ce qu'elle sait faire. Le collecteur les exécute toutes
+ * de la même façon, chacune à sa propre cadence : ajouter un type de
+ * machine revient à fournir une table de fonctions, sans toucher à la
+ * boucle principale.
+ */
+
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include "cpu.h"
+#include "index_texte.h"
+#include "marques.h"
+#include "process.h"
+#include "snapshot.h"
+#include <sys/types.h>
+
+/* Capacités d'une source (combinables) */
+#define SOURCE_CAP_SIGNAUX 0x1 /* envoyer_signaux disponible */
+#define SOURCE_CAP_BILAN 0x2   /* Bilan ajouts/terminés et CPU par cœur */
+#define SOURCE_CAP_PROCFS 0x4  /* /proc lisible par l'interface : threads,
+                                  ligne de commande, PSS/USS */
+#define SOURCE_CAP_CONNEXION 0x8 /* Se connecte dans son thread : sa première
+                                    collecte n'est pas attendue au
+                                    démarrage */
+
+#define SOURCE_NOM_MAX 256
+
+/**
+ * @brief Résultat d'une collecte.
+ *
+ * Une fois publiée, une collecte n'est plus modifiée que par l'interface,
+ * qui en devient seule propriétaire jusqu'au prochain échange.
+ */
+typedef struct collecte {
+  snapshot_t arene;      /* Copie contiguë, réutilisée d'une collecte à l'autre */
+  processus_t *liste;    /* Tête dans arene */
+
+  /* Bilan (sources SOURCE_CAP_BILAN uniquement) */
+  int nb_ajoutes;
+  int nb_termines;
+  int nb_modifies;
+  int nb_ephemeres;      /* -1 : non suivi */
+  cpu_utilisation_t cpu;
+
+  index_texte_t index;   /* Index de recherche (valide si demandé) */
+  long long instant_ms;  /* Fin de la collecte (horloge monotone) */
+} collecte_t;
+
+/**
+ * @brief Opérations d'un type de source.
+ */
+typedef struct source_ops {
+  const char *type; /* "local", "ssh", ... */
+  int capacites;    /* SOURCE_CAP_* */
+
+  /**
+   * @brief Remplit 'dest' (appelée dans le thread de la source).
+   * @return int : 0 en cas de succès, -1 sinon (dest n'est pas publiée).
+   */
+  int (*collecter)(void *donnees, collecte_t *dest);
+
+  /**
+   * @brief Envoie le signal du lot à chacun de ses processus, en un seul
+   *        aller-retour pour une source distante (thread de la source).
+   * @return int : 0 si tout le lot a été traité, -1 sinon ; lot->erreurs
+   *               est renseigné pour chaque PID dans les deux cas.
+   */
+  int (*envoyer_signaux)(void *donnees, lot_signaux_t *lot);
+
+  /**
+   * @brief Ligne de commande complète d'un processus de la dernière
+   *        collecte, pour l'index (thread de la source ; NULL si la liste
+   *        la contient déjà).
+   */
+  index_commande_fn ligne_commande;
+} source_ops_t;
+
+/**
+ * @brief Source configurée : type, état propre et cadence.
+ */
+typedef struct source {
+  const source_ops_t *ops;
+  void *donnees;        /* État propre au type de source */
+  char nom[SOURCE_NOM_MAX];
+  int periode_ms;       /* Cadence de rafraîchissement (une fois démarrée,
+                           modifiée par collecteur_changer_periode) */
+  int max_en_vol;       /* Collectes en attente ou en cours (>= 1) */
+} source_t;
+
+/**
+ * @brief Prépare une source.
+ * @param source : Source à remplir.
+ * @param ops : Opérations du type de source.
+ * @param donnees : État propre au type.
+ * @param nom : Nom d'affichage.
+ * @param periode_ms : Cadence de rafraîchissement.
+ */
+void source_init(source_t *source, const source_ops_t *ops, void *donnees,
+                 const char *nom, int periode_ms);
+
+/**
+ * @brief Indique si une source a une capacité.
+ * @param source : Source concernée.
+ * @param capacite : SOURCE_CAP_*.
+ * @return int : 1 si oui, 0 sinon.
+ */
+int source_peut(const source_t *source, int capacite);
+
+#endif /* SOURCE_H */
@@ -0,0 +1,126 @@
+/**
+ * @file source_locale.c
+ * @brief Implémentation de la source locale (/proc)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "source_locale.h"
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Fonctions privées */
+
+/**
+ * @brief Met à jour la table : par les événements du connecteur proc s'il
+ *        est actif, sinon (ou lors d'une réconciliation) en listant /proc.
+ *        nb_ephemeres reçoit le bilan du connecteur (-1 s'il est inactif).
+ */
+static int collecter_table(source_locale_t *locale, int *nb_ephemeres) {
+  connecteur_t *connecteur = &locale->connecteur;
+  time_t maintenant = time(NULL);
+  int reconcilier;
+  int retour;
+
+  *nb_ephemeres = -1;
+  if (!connecteur_actif(connecteur)) {
+    return table_processus_rafraichir(&locale->table, &locale->scanner);
+  }
+
+  if (connecteur_lire(connecteur) < 0) {
+    /* Socket inutilisable : retour définitif au parcours de /proc */
+    connecteur_fermer(connecteur);
+    return table_processus_rafraichir(&locale->table, &locale->scanner);
+  }
+
+  reconcilier = connecteur_reconciliation_due(connecteur, maintenant);
+  if (reconcilier) {
+    retour = table_processus_rafraichir(&locale->table, &locale->scanner);
+  } else {
+    int nb;
+    const pid_t *pids = connecteur_pids(
+        connecteur, table_processus_liste(&locale->table), &nb);
+    retour = pids == NULL ? -1
+                          : table_processus_rafraichir_pids(
+                                &locale->table, &locale->scanner, pids, nb);
+  }
+
+  connecteur_fin_intervalle(connecteur, reconcilier && retour == 0, maintenant);
+  *nb_ephemeres = connecteur->nb_ephemeres;
+  return retour;
+}
+
+/**
+ * @brief Rafraîchit la table locale et en publie une copie avec son bilan.
+ */
+static int collecter_locale(void *donnees, collecte_t *dest) {
+  source_locale_t *locale = donnees;
+  processus_t *liste;
+
+  moteur_cpu_echantillonner_local(&locale->cpu);
+  if (collecter_table(locale, &dest->nb_ephemeres) != 0) {
+    return -1;
+  }
+
+  const table_delta_t *delta = table_processus_delta(&locale->table);
+  dest->nb_ajoutes = delta->ajoutes.nb;
+  dest->nb_termines = delta->termines.nb;
+  dest->nb_modifies = delta->modifies.nb;
+
+  liste = table_processus_liste(&locale->table);
+  moteur_cpu_calculer(&locale->cpu, liste);
+  moteur_cpu_copier_utilisation(&locale->cpu, &dest->cpu);
+
+  /* Copie contiguë (index en O(1)) : la table reste au thread de la source */
+  dest->liste = snapshot_copier_liste(&dest->arene, liste);
+  commandes_nouvelle_generation(&locale->commandes);
+  return dest->liste != NULL ? 0 : -1;
+}
+
+static const char *ligne_commande_locale(void *donnees,
+                                         const processus_t *proc) {
+  source_locale_t *locale = donnees;
+
+  return commandes_lire(&locale->commandes, proc);
+}
+
+/**
+ * @brief Un seul passage sur le lot, par pidfd vérifiés : un PID réutilisé
+ *        depuis l'affichage est signalé absent (ESRCH).
+ */
+static int envoyer_signaux_local(void *donnees, lot_signaux_t *lot) {
+  source_locale_t *locale = donnees;
+
+  return signaux_envoyer(&locale->signaux, lot);
+}
+
+/* Fonctions publiques */
+
+const source_ops_t source_locale_ops = {
+    "local",
+    SOURCE_CAP_SIGNAUX | SOURCE_CAP_BILAN | SOURCE_CAP_PROCFS,
+    collecter_locale,
+    envoyer_signaux_local,
+    ligne_commande_locale,
+};
+
+void source_locale_init(source_locale_t *locale) {
+  table_processus_init(&locale->table);
+  scanner_init(&locale->scanner, 0);
+  connecteur_init(&locale->connecteur);
+  moteur_cpu_init(&locale->cpu);
+  /* Sans /proc, les lignes de commande restent vides (nom seul indexé) */
+  commandes_init(&locale->commandes);
+  signaux_init(&locale->signaux);
+}
+
+void source_locale_liberer(source_locale_t *locale) {
+  table_processus_liberer(&locale->table);
+  scanner_liberer(&locale->scanner);
+  connecteur_fermer(&locale->connecteur);
+  moteur_cpu_liberer(&locale->cpu);
+  commandes_liberer(&locale->commandes);
+  signaux_liberer(&locale->signaux);
+}
@@ -0,0 +1,48 @@
+/**
+ * @file source_locale.h
+ * @brief Source des processus de la machine locale (/proc)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * La table persistante, le scanner de /proc, le connecteur proc et le
+ * moteur CPU locaux appartiennent au thread de la source ; chaque collecte
+ * en publie une copie contiguë avec son bilan et l'utilisation CPU.
+ */
+
+#ifndef SOURCE_LOCALE_H
+#define SOURCE_LOCALE_H
+
+#include "commandes.h"
+#include "connecteur.h"
+#include "cpu.h"
+#include "scanner.h"
+#include "signaux.h"
+#include "source.h"
+#include "table.h"
+
+/**
+ * @brief État de la source locale.
+ */
+typedef struct source_locale {
+  table_processus_t table; /* Processus locaux persistants */
+  scanner_t scanner;       /* Parcours (éventuellement parallèle) de /proc */
+  connecteur_t connecteur; /* Événements fork/exit (inactif par défaut) */
+  moteur_cpu_t cpu;        /* CPU par intervalle */
+  commandes_t commandes;   /* Lignes de commande (index de recherche) */
+  signaux_locaux_t signaux; /* Envoi par pidfd, portées gelées */
+} source_locale_t;
+
+extern const source_ops_t source_locale_ops;
+
+/**
+ * @brief Initialise l'état de la source locale.
+ * @param locale : État à initialiser.
+ */
+void source_locale_init(source_locale_t *locale);
+
+/**
+ * @brief Libère l'état de la source locale (source arrêtée).
+ * @param locale : État à libérer.
+ */
+void source_locale_liberer(source_locale_t *locale);
+
+#endif /* SOURCE_LOCALE_H */
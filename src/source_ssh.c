@@ -0,0 +1,62 @@
+/**
+ * @file source_ssh.c
+ * @brief Implémentation de la source SSH
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#include "source_ssh.h"
+
+/* Fonctions privées */
+
+/**
+ * @brief Récupère les processus de l'hôte et calcule leur CPU sur
+ *        l'intervalle écoulé depuis l'échantillon précédent.
+ */
+static int collecter_ssh(void *donnees, collecte_t *dest) {
+  source_ssh_t *ssh = donnees;
+  remote_host_t *hote = ssh->hote;
+  /* Analysés à la réception, directement dans l'arène de la collecte */
+  processus_t *liste = collect_remote_processes(hote, &dest->arene);
+
+  if (liste == NULL) {
+    return -1;
+  }
+
+  /* nb_coeurs vaut 0 si seul le format 'ps aux' est disponible */
+  if (hote->nb_coeurs > 0) {
+    moteur_cpu_echantillonner_distant(&ssh->cpu, hote->uptime_ticks,
+                                      hote->nb_coeurs);
+    moteur_cpu_calculer(&ssh->cpu, liste);
+  }
+
+  dest->liste = liste;
+  return 0;
+}
+
+static int envoyer_signaux_ssh(void *donnees, lot_signaux_t *lot) {
+  source_ssh_t *ssh = donnees;
+
+  return send_remote_signals(ssh->hote, lot);
+}
+
+/* Fonctions publiques */
+
+const source_ops_t source_ssh_ops = {
+    "ssh",
+    SOURCE_CAP_SIGNAUX | SOURCE_CAP_CONNEXION,
+    collecter_ssh,
+    envoyer_signaux_ssh,
+    NULL, /* 'ps -eo args' : le nom est déjà la ligne de commande */
+};
+
+void source_ssh_init(source_ssh_t *ssh, remote_host_t *hote) {
+  ssh->hote = hote;
+  moteur_cpu_init(&ssh->cpu);
+  /* L'âge distant est à la seconde près : starttime varie d'un échantillon à l'autre */
+  ssh->cpu.tolerance_starttime = 2 * REMOTE_TICKS_PAR_SECONDE;
+}
+
+void source_ssh_liberer(source_ssh_t *ssh) {
+  moteur_cpu_liberer(&ssh->cpu);
+  ssh->hote = NULL;
+}
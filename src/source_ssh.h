@@ -0,0 +1,38 @@
+/**
+ * @file source_ssh.h
+ * @brief Source des processus d'une machine distante (SSH)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#ifndef SOURCE_SSH_H
+#define SOURCE_SSH_H
+
+#include "cpu.h"
+#include "network.h"
+#include "source.h"
+
+/**
+ * @brief État d'une source SSH.
+ */
+typedef struct source_ssh {
+  remote_host_t *hote; /* Connexion (appartient à la configuration réseau) */
+  moteur_cpu_t cpu;    /* CPU par intervalle */
+} source_ssh_t;
+
+extern const source_ops_t source_ssh_ops;
+
+/**
+ * @brief Initialise une source SSH ; l'hôte est connecté (et reconnecté)
+ *        par ses collectes.
+ * @param ssh : État à initialiser.
+ * @param hote : Hôte distant.
+ */
+void source_ssh_init(source_ssh_t *ssh, remote_host_t *hote);
+
+/**
+ * @brief Libère l'état d'une source SSH (source arrêtée).
+ * @param ssh : État à libérer.
+ */
+void source_ssh_liberer(source_ssh_t *ssh);
+
+#endif /* SOURCE_SSH_H */
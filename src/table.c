@@ -0,0 +1,357 @@
+/**
+ * @file table.c
+ * @brief Implémentation de la table persistante des processus
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TABLE_TAILLE_INDEX_INITIALE 1024
+
+/* Fonctions privées */
+
+static table_entree_t *entree_at(table_processus_t *table, int numero) {
+  return &table->blocs[numero / TABLE_TAILLE_BLOC][numero % TABLE_TAILLE_BLOC];
+}
+
+static unsigned int hacher_pid(pid_t pid, int taille) {
+  return ((unsigned int)pid * 2654435761u) & (unsigned int)(taille - 1);
+}
+
+/**
+ * @brief Ajoute un PID à un ensemble (n'alloue que si la capacité est dépassée).
+ */
+static void ensemble_ajouter(table_ensemble_t *ensemble, pid_t pid) {
+  if (ensemble->nb == ensemble->capacite) {
+    int capacite = ensemble->capacite ? ensemble->capacite * 2 : 256;
+    pid_t *pids = realloc(ensemble->pids, sizeof(pid_t) * capacite);
+    if (pids == NULL) {
+      return;
+    }
+    ensemble->pids = pids;
+    ensemble->capacite = capacite;
+  }
+  ensemble->pids[ensemble->nb++] = pid;
+}
+
+/**
+ * @brief Retourne la case d'index contenant le PID, ou -1.
+ */
+static int index_trouver(table_processus_t *table, pid_t pid) {
+  unsigned int masque = (unsigned int)(table->taille_index - 1);
+  unsigned int i = hacher_pid(pid, table->taille_index);
+
+  while (table->index[i] != -1) {
+    if (entree_at(table, table->index[i])->proc.pid == pid) {
+      return (int)i;
+    }
+    i = (i + 1) & masque;
+  }
+  return -1;
+}
+
+static void index_inserer(table_processus_t *table, int numero) {
+  unsigned int masque = (unsigned int)(table->taille_index - 1);
+  unsigned int i =
+      hacher_pid(entree_at(table, numero)->proc.pid, table->taille_index);
+
+  while (table->index[i] != -1) {
+    i = (i + 1) & masque;
+  }
+  table->index[i] = numero;
+}
+
+/**
+ * @brief Supprime une case (sondage linéaire avec décalage arrière).
+ */
+static void index_supprimer(table_processus_t *table, int case_vide) {
+  unsigned int masque = (unsigned int)(table->taille_index - 1);
+  unsigned int i = (unsigned int)case_vide;
+  unsigned int j = i;
+
+  for (;;) {
+    j = (j + 1) & masque;
+    if (table->index[j] == -1) {
+      break;
+    }
+    unsigned int k =
+        hacher_pid(entree_at(table, table->index[j])->proc.pid,
+                   table->taille_index);
+    /* Déplacer j vers i si sa position d'origine k n'est pas dans ]i, j] */
+    if ((i <= j) ? (k <= i || k > j) : (k <= i && k > j)) {
+      table->index[i] = table->index[j];
+      i = j;
+    }
+  }
+  table->index[i] = -1;
+}
+
+/**
+ * @brief Double la taille de l'index et réinsère les entrées vivantes.
+ */
+static int index_agrandir(table_processus_t *table) {
+  int nouvelle_taille = table->taille_index * 2;
+  int *nouvel_index = malloc(sizeof(int) * nouvelle_taille);
+
+  if (nouvel_index == NULL) {
+    return -1;
+  }
+
+  free(table->index);
+  table->index = nouvel_index;
+  table->taille_index = nouvelle_taille;
+  for (int i = 0; i < nouvelle_taille; i++) {
+    table->index[i] = -1;
+  }
+
+  for (int b = 0; b < table->nb_blocs; b++) {
+    for (int i = 0; i < TABLE_TAILLE_BLOC; i++) {
+      if (table->blocs[b][i].occupee) {
+        index_inserer(table, b * TABLE_TAILLE_BLOC + i);
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Ajoute un bloc d'entrées libres.
+ */
+static int ajouter_bloc(table_processus_t *table) {
+  table_entree_t **blocs =
+      realloc(table->blocs, sizeof(table_entree_t *) * (table->nb_blocs + 1));
+  if (blocs == NULL) {
+    return -1;
+  }
+  table->blocs = blocs;
+
+  table_entree_t *bloc = calloc(TABLE_TAILLE_BLOC, sizeof(table_entree_t));
+  if (bloc == NULL) {
+    return -1;
+  }
+  table->blocs[table->nb_blocs] = bloc;
+
+  /* Chaîner les nouvelles entrées dans la liste libre */
+  int base = table->nb_blocs * TABLE_TAILLE_BLOC;
+  for (int i = TABLE_TAILLE_BLOC - 1; i >= 0; i--) {
+    bloc[i].libre_suivante = table->libre;
+    table->libre = base + i;
+  }
+  table->nb_blocs++;
+  return 0;
+}
+
+/**
+ * @brief Indique si les colonnes affichées d'un processus ont changé.
+ */
+static int processus_modifie(const processus_t *avant,
+                             const processus_t *apres) {
+  return avant->etat != apres->etat || avant->ppid != apres->ppid ||
+         avant->utime != apres->utime ||
+         avant->stime != apres->stime || avant->rss_ko != apres->rss_ko ||
+         avant->vmem_size != apres->vmem_size || avant->uid != apres->uid ||
+         strcmp(avant->nom_commande, apres->nom_commande) != 0;
+}
+
+/**
+ * @brief Copie les données lues dans une entrée en conservant le nom
+ *        d'utilisateur déjà résolu quand l'UID n'a pas changé.
+ *
+ * Les noms absents ne sont pas résolus ici : c'est un niveau coûteux,
+ * chargé à la demande pour les lignes affichées (voir details.h).
+ */
+static void copier_donnees(processus_t *dest, const processus_t *lu,
+                           int connu) {
+  int garder_nom = connu && lu->utilisateur[0] == '\0' && dest->uid == lu->uid;
+  char nom[MAX_USER_LEN];
+
+  if (garder_nom) {
+    memcpy(nom, dest->utilisateur, MAX_USER_LEN);
+  }
+  *dest = *lu;
+  if (garder_nom) {
+    memcpy(dest->utilisateur, nom, MAX_USER_LEN);
+  }
+  dest->suivant = NULL;
+  dest->snapshot = NULL;
+}
+
+/**
+ * @brief Intègre les lignes lues par le scanner en une génération complète.
+ */
+static void integrer_brut(table_processus_t *table) {
+  table_processus_debut_generation(table);
+  for (int i = 0; i < table->brut.nb; i++) {
+    table_processus_integrer(table, &table->brut.elements[i], NULL);
+  }
+  table_processus_fin_generation(table);
+}
+
+/* Fonctions publiques */
+
+void table_processus_init(table_processus_t *table) {
+  memset(table, 0, sizeof(*table));
+  table->libre = -1;
+  snapshot_init(&table->brut);
+}
+
+void table_processus_liberer(table_processus_t *table) {
+  for (int b = 0; b < table->nb_blocs; b++) {
+    free(table->blocs[b]);
+  }
+  free(table->blocs);
+  free(table->index);
+  free(table->delta.ajoutes.pids);
+  free(table->delta.termines.pids);
+  free(table->delta.modifies.pids);
+  snapshot_liberer(&table->brut);
+  table_processus_init(table);
+}
+
+void table_processus_debut_generation(table_processus_t *table) {
+  table->generation++;
+  table->delta.ajoutes.nb = 0;
+  table->delta.termines.nb = 0;
+  table->delta.modifies.nb = 0;
+}
+
+processus_t *table_processus_integrer(table_processus_t *table,
+                                      const processus_t *lu, int *nouveau) {
+  table_entree_t *entree;
+  int case_index;
+
+  if (nouveau != NULL) {
+    *nouveau = 0;
+  }
+
+  if (table->index == NULL) {
+    table->taille_index = TABLE_TAILLE_INDEX_INITIALE;
+    table->index = malloc(sizeof(int) * table->taille_index);
+    if (table->index == NULL) {
+      return NULL;
+    }
+    for (int i = 0; i < table->taille_index; i++) {
+      table->index[i] = -1;
+    }
+  }
+
+  case_index = index_trouver(table, lu->pid);
+  if (case_index >= 0) {
+    entree = entree_at(table, table->index[case_index]);
+
+    if (entree->proc.starttime == lu->starttime) {
+      /* Même processus : mise à jour sur place */
+      if (processus_modifie(&entree->proc, lu)) {
+        ensemble_ajouter(&table->delta.modifies, lu->pid);
+      }
+      copier_donnees(&entree->proc, lu, 1);
+    } else {
+      /* PID réutilisé : l'ancien processus est terminé */
+      ensemble_ajouter(&table->delta.termines, lu->pid);
+      ensemble_ajouter(&table->delta.ajoutes, lu->pid);
+      copier_donnees(&entree->proc, lu, 0);
+      if (nouveau != NULL) {
+        *nouveau = 1;
+      }
+    }
+    entree->generation = table->generation;
+    return &entree->proc;
+  }
+
+  /* Nouveau processus */
+  if ((table->nb_vivants + 1) * 2 > table->taille_index &&
+      index_agrandir(table) != 0) {
+    return NULL;
+  }
+  if (table->libre == -1 && ajouter_bloc(table) != 0) {
+    return NULL;
+  }
+
+  int numero = table->libre;
+  entree = entree_at(table, numero);
+  table->libre = entree->libre_suivante;
+
+  copier_donnees(&entree->proc, lu, 0);
+  entree->occupee = 1;
+  entree->generation = table->generation;
+  entree->libre_suivante = -1;
+  index_inserer(table, numero);
+  table->nb_vivants++;
+
+  ensemble_ajouter(&table->delta.ajoutes, lu->pid);
+  if (nouveau != NULL) {
+    *nouveau = 1;
+  }
+  return &entree->proc;
+}
+
+void table_processus_fin_generation(table_processus_t *table) {
+  processus_t **queue = &table->tete;
+
+  for (int b = 0; b < table->nb_blocs; b++) {
+    for (int i = 0; i < TABLE_TAILLE_BLOC; i++) {
+      table_entree_t *entree = &table->blocs[b][i];
+
+      if (!entree->occupee) {
+        continue;
+      }
+
+      if (entree->generation != table->generation) {
+        /* Processus terminé : retirer de l'index et recycler l'entrée */
+        ensemble_ajouter(&table->delta.termines, entree->proc.pid);
+        index_supprimer(table, index_trouver(table, entree->proc.pid));
+        entree->occupee = 0;
+        entree->libre_suivante = table->libre;
+        table->libre = b * TABLE_TAILLE_BLOC + i;
+        table->nb_vivants--;
+        continue;
+      }
+
+      *queue = &entree->proc;
+      queue = &entree->proc.suivant;
+    }
+  }
+  *queue = NULL;
+}
+
+int table_processus_rafraichir(table_processus_t *table, scanner_t *scanner) {
+  if (scanner_collecter(scanner, &table->brut) != 0) {
+    return -1;
+  }
+  integrer_brut(table);
+  return 0;
+}
+
+int table_processus_rafraichir_pids(table_processus_t *table,
+                                    scanner_t *scanner, const pid_t *pids,
+                                    int nb) {
+  if (scanner_collecter_pids(scanner, pids, nb, &table->brut) != 0) {
+    return -1;
+  }
+  integrer_brut(table);
+  return 0;
+}
+
+processus_t *table_processus_chercher(table_processus_t *table, pid_t pid) {
+  if (table->index == NULL) {
+    return NULL;
+  }
+  int case_index = index_trouver(table, pid);
+  if (case_index < 0) {
+    return NULL;
+  }
+  return &entree_at(table, table->index[case_index])->proc;
+}
+
+processus_t *table_processus_liste(table_processus_t *table) {
+  return table->tete;
+}
+
+const table_delta_t *table_processus_delta(const table_processus_t *table) {
+  return &table->delta;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file table.h
+ * @brief Table persistante des processus indexée par (PID, starttime)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Ce module conserve les processus d'un rafraîchissement à l'autre :
+ * les entrées existantes sont mises à jour sur place, les nouvelles
+ * sont insérées et celles des processus terminés sont recyclées.
+ * Chaque génération produit le bilan des processus ajoutés, terminés
+ * et modifiés. En régime établi, aucune allocation n'a lieu.
+ */
+
+#ifndef TABLE_H
+#define TABLE_H
+
+#include "process.h"
+#include "scanner.h"
+#include "snapshot.h"
+
+#define TABLE_TAILLE_BLOC 1024 /* Entrées par bloc (adresses stables) */
+
+/**
+ * @brief Entrée de la table (un processus suivi).
+ */
+typedef struct table_entree {
+  processus_t proc;        /* Données courantes (proc.suivant chaîne les vivants) */
+  unsigned int generation; /* Dernière génération où le processus a été vu */
+  int occupee;             /* 1 si l'entrée est utilisée */
+  int libre_suivante;      /* Index de la prochaine entrée libre, ou -1 */
+} table_entree_t;
+
+/**
+ * @brief Ensemble de PID réutilisé d'une génération à l'autre.
+ */
+typedef struct table_ensemble {
+  pid_t *pids;
+  int nb;
+  int capacite;
+} table_ensemble_t;
+
+/**
+ * @brief Bilan d'une génération.
+ */
+typedef struct table_delta {
+  table_ensemble_t ajoutes;  /* Processus apparus */
+  table_ensemble_t termines; /* Processus disparus (ou PID réutilisé) */
+  table_ensemble_t modifies; /* Processus dont l'état, le temps CPU ou la mémoire a changé */
+} table_delta_t;
+
+/**
+ * @brief Table persistante des processus.
+ */
+typedef struct table_processus {
+  table_entree_t **blocs; /* Blocs d'entrées, jamais déplacés */
+  int nb_blocs;
+  int libre;              /* Tête de la liste des entrées libres, ou -1 */
+  int nb_vivants;
+
+  int *index;             /* Hachage PID -> numéro d'entrée (-1 si vide) */
+  int taille_index;       /* Puissance de 2 */
+
+  unsigned int generation;
+  processus_t *tete;      /* Liste chaînée des processus vivants */
+  table_delta_t delta;
+  snapshot_t brut;        /* Lignes lues par le scanner (réutilisé) */
+} table_processus_t;
+
+/**
+ * @brief Initialise une table vide.
+ * @param table : Table à initialiser.
+ */
+void table_processus_init(table_processus_t *table);
+
+/**
+ * @brief Libère toute la mémoire de la table.
+ * @param table : Table à libérer.
+ */
+void table_processus_liberer(table_processus_t *table);
+
+/**
+ * @brief Ouvre une nouvelle génération et vide le bilan précédent.
+ * @param table : Table concernée.
+ */
+void table_processus_debut_generation(table_processus_t *table);
+
+/**
+ * @brief Intègre un processus lu pendant la génération courante.
+ *
+ * Si (PID, starttime) est déjà connu, l'entrée est mise à jour sur place ;
+ * si le PID est connu avec un autre starttime, l'ancien processus est
+ * considéré terminé et remplacé.
+ *
+ * @param table : Table concernée.
+ * @param lu : Données fraîchement lues.
+ * @param nouveau : Reçoit 1 si le processus vient d'apparaître, peut être NULL.
+ * @return processus_t* : Entrée de la table, ou NULL en cas d'erreur mémoire.
+ */
+processus_t *table_processus_integrer(table_processus_t *table,
+                                      const processus_t *lu, int *nouveau);
+
+/**
+ * @brief Clôt la génération : retire les processus non revus et chaîne les vivants.
+ * @param table : Table concernée.
+ */
+void table_processus_fin_generation(table_processus_t *table);
+
+/**
+ * @brief Parcourt /proc et met la table à jour (une génération complète).
+ * @param table : Table concernée.
+ * @param scanner : Scanner utilisé pour lire /proc (éventuellement parallèle).
+ * @return int : 0 en cas de succès, -1 si /proc est illisible.
+ */
+int table_processus_rafraichir(table_processus_t *table, scanner_t *scanner);
+
+/**
+ * @brief Met la table à jour en ne relisant que les PID donnés.
+ *
+ * Les processus de la table absents de la liste sont considérés terminés.
+ *
+ * @param table : Table concernée.
+ * @param scanner : Scanner utilisé pour lire /proc.
+ * @param pids : PID à relire (connus et nouveaux).
+ * @param nb : Nombre de PID.
+ * @return int : 0 en cas de succès, -1 en cas d'erreur mémoire.
+ */
+int table_processus_rafraichir_pids(table_processus_t *table,
+                                    scanner_t *scanner, const pid_t *pids,
+                                    int nb);
+
+/**
+ * @brief Recherche un processus vivant par PID.
+ * @param table : Table concernée.
+ * @param pid : PID recherché.
+ * @return processus_t* : Entrée trouvée, ou NULL.
+ */
+processus_t *table_processus_chercher(table_processus_t *table, pid_t pid);
+
+/**
+ * @brief Retourne la liste chaînée des processus vivants (appartient à la table).
+ * @param table : Table concernée.
+ * @return processus_t* : Tête de liste, à ne pas libérer.
+ */
+processus_t *table_processus_liste(table_processus_t *table);
+
+/**
+ * @brief Retourne le bilan de la dernière génération.
+ * @param table : Table concernée.
+ * @return const table_delta_t* : Bilan (ajoutés, terminés, modifiés).
+ */
+const table_delta_t *table_processus_delta(const table_processus_t *table);
+
+#endif /* TABLE_H */
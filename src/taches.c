@@ -0,0 +1,335 @@
+/**
+ * @file taches.c
+ * @brief Implémentation du mode threads
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "taches.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Fonctions privées */
+
+static unsigned int hacher_pid(pid_t pid, int taille) {
+  return ((unsigned int)pid * 2654435761u) & (unsigned int)(taille - 1);
+}
+
+/**
+ * @brief Ticks depuis le boot (même origine que starttime).
+ */
+static unsigned long long ticks_depuis_boot(const taches_t *taches) {
+  struct timespec ts;
+  unsigned long long hz = (unsigned long long)taches->ticks_par_seconde;
+
+  clock_gettime(CLOCK_BOOTTIME, &ts);
+  return (unsigned long long)ts.tv_sec * hz +
+         (unsigned long long)ts.tv_nsec / (1000000000ULL / hz);
+}
+
+static int comparer_tids(const void *a, const void *b) {
+  pid_t x = *(const pid_t *)a;
+  pid_t y = *(const pid_t *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Reconstruit l'index PID -> groupe (après ajout ou compactage).
+ */
+static int reconstruire_index(taches_t *taches) {
+  int taille = taches->taille_index ? taches->taille_index : 64;
+
+  while (taille < taches->capacite * 2) {
+    taille *= 2;
+  }
+  if (taille != taches->taille_index) {
+    int *index = malloc(sizeof(int) * taille);
+    if (index == NULL) {
+      return -1;
+    }
+    free(taches->index);
+    taches->index = index;
+    taches->taille_index = taille;
+  }
+
+  memset(taches->index, -1, sizeof(int) * taches->taille_index);
+  for (int g = 0; g < taches->nb; g++) {
+    unsigned int i = hacher_pid(taches->groupes[g].pid, taches->taille_index);
+    while (taches->index[i] != -1) {
+      i = (i + 1) & (unsigned int)(taches->taille_index - 1);
+    }
+    taches->index[i] = g;
+  }
+  return 0;
+}
+
+/**
+ * @brief Numéro du groupe d'un PID, ou -1.
+ */
+static int trouver_groupe(const taches_t *taches, pid_t pid) {
+  if (taches->taille_index == 0) {
+    return -1;
+  }
+
+  unsigned int masque = (unsigned int)(taches->taille_index - 1);
+  unsigned int i = hacher_pid(pid, taches->taille_index);
+  while (taches->index[i] != -1) {
+    if (taches->groupes[taches->index[i]].pid == pid) {
+      return taches->index[i];
+    }
+    i = (i + 1) & masque;
+  }
+  return -1;
+}
+
+/**
+ * @brief Retourne le groupe du processus, créé (ou réinitialisé si le PID
+ *        a été réutilisé) au besoin.
+ */
+static taches_groupe_t *obtenir_groupe(taches_t *taches,
+                                       const processus_t *proc) {
+  int numero = trouver_groupe(taches, proc->pid);
+  taches_groupe_t *g;
+
+  if (numero >= 0) {
+    g = &taches->groupes[numero];
+    if (g->starttime == proc->starttime) {
+      return g;
+    }
+  } else {
+    if (taches->nb == taches->capacite) {
+      int capacite = taches->capacite ? taches->capacite * 2 : 64;
+      taches_groupe_t *groupes =
+          realloc(taches->groupes, sizeof(taches_groupe_t) * capacite);
+      if (groupes == NULL) {
+        return NULL;
+      }
+      for (int i = taches->capacite; i < capacite; i++) {
+        snapshot_init(&groupes[i].courant);
+        snapshot_init(&groupes[i].precedent);
+      }
+      taches->groupes = groupes;
+      taches->capacite = capacite;
+    }
+
+    /* Les groupes au-delà de nb gardent leurs arènes : pas d'allocation */
+    numero = taches->nb++;
+    g = &taches->groupes[numero];
+    g->pid = proc->pid;
+    if (taches->taille_index < taches->capacite * 2) {
+      if (reconstruire_index(taches) != 0) {
+        taches->nb--;
+        return NULL;
+      }
+    } else {
+      unsigned int i = hacher_pid(g->pid, taches->taille_index);
+      while (taches->index[i] != -1) {
+        i = (i + 1) & (unsigned int)(taches->taille_index - 1);
+      }
+      taches->index[i] = numero;
+    }
+  }
+
+  g->starttime = proc->starttime;
+  g->vu = 0;
+  g->dernier_scan = 0;
+  g->deplie = 0;
+  g->nb_actifs = 0;
+  g->instant = 0;
+  snapshot_reinitialiser(&g->courant);
+  snapshot_reinitialiser(&g->precedent);
+  return g;
+}
+
+/**
+ * @brief Relit /proc/[PID]/task et calcule le CPU de chaque thread par
+ *        jointure avec le parcours précédent (tous deux triés par TID).
+ */
+static int parcourir_groupe(taches_t *taches, taches_groupe_t *g) {
+  unsigned long long maintenant = ticks_depuis_boot(taches);
+  unsigned long long ecoule = maintenant - g->instant;
+  int nb_tids;
+  int j = 0;
+
+  nb_tids = procfs_lister_taches(&taches->lecteur, g->pid, &taches->tids,
+                                 &taches->capacite_tids);
+  if (nb_tids < 0) {
+    return -1;
+  }
+  for (int i = 1; i < nb_tids; i++) {
+    if (taches->tids[i - 1] > taches->tids[i]) {
+      qsort(taches->tids, (size_t)nb_tids, sizeof(pid_t), comparer_tids);
+      break;
+    }
+  }
+
+  /* L'ancien parcours devient la référence */
+  snapshot_t tmp = g->precedent;
+  g->precedent = g->courant;
+  g->courant = tmp;
+  snapshot_reinitialiser(&g->courant);
+  g->nb_actifs = 0;
+
+  for (int i = 0; i < nb_tids; i++) {
+    processus_t *t = snapshot_ajouter(&g->courant);
+    if (t == NULL) {
+      break;
+    }
+    if (procfs_lire_stat_tache(&taches->lecteur, g->pid, taches->tids[i], t,
+                               &t->uid) != 0) {
+      snapshot_annuler_dernier(&g->courant);
+      continue;
+    }
+    t->utilisateur[0] = '\0';
+    if (t->etat == 'R') {
+      g->nb_actifs++;
+    }
+
+    /* Delta de ticks depuis le parcours précédent */
+    long long ticks = t->utime + t->stime;
+    long long delta = 0;
+    while (j < g->precedent.nb && g->precedent.elements[j].pid < t->pid) {
+      j++;
+    }
+    if (j < g->precedent.nb && g->precedent.elements[j].pid == t->pid &&
+        g->precedent.elements[j].starttime == t->starttime) {
+      processus_t *avant = &g->precedent.elements[j];
+      delta = ticks - (avant->utime + avant->stime);
+    } else if (g->dernier_scan != 0 && t->starttime >= g->instant) {
+      delta = ticks; /* Thread né pendant l'intervalle */
+    }
+
+    if (g->dernier_scan != 0 && ecoule > 0 && delta > 0) {
+      t->cpu_percent = (float)((double)delta * 100.0 / (double)ecoule);
+    } else {
+      t->cpu_percent = 0.0f;
+    }
+    t->cpu_percent_machine =
+        taches->nb_coeurs > 0 ? t->cpu_percent / taches->nb_coeurs
+                              : t->cpu_percent;
+  }
+
+  g->instant = maintenant;
+  g->dernier_scan = taches->rafraichissement;
+  taches->threads_lus += (unsigned long)g->courant.nb;
+  return 0;
+}
+
+/* Fonctions publiques */
+
+int taches_init(taches_t *taches) {
+  memset(taches, 0, sizeof(*taches));
+  taches->rafraichissement = 1;
+  taches->nb_coeurs = 1;
+  taches->ticks_par_seconde = sysconf(_SC_CLK_TCK);
+  if (taches->ticks_par_seconde <= 0) {
+    taches->ticks_par_seconde = 100;
+  }
+  return procfs_ouvrir(&taches->lecteur);
+}
+
+void taches_liberer(taches_t *taches) {
+  for (int i = 0; i < taches->capacite; i++) {
+    snapshot_liberer(&taches->groupes[i].courant);
+    snapshot_liberer(&taches->groupes[i].precedent);
+  }
+  free(taches->groupes);
+  free(taches->index);
+  free(taches->tids);
+  procfs_fermer(&taches->lecteur);
+  memset(taches, 0, sizeof(*taches));
+  taches->lecteur.proc_fd = -1;
+}
+
+void taches_rafraichir(taches_t *taches, const processus_t *liste,
+                       int nb_coeurs) {
+  long budget = TACHES_BUDGET_REPLIES;
+  unsigned int r = ++taches->rafraichissement;
+
+  taches->nb_coeurs = nb_coeurs > 0 ? nb_coeurs : 1;
+  taches->threads_lus = 0;
+
+  for (const processus_t *p = liste; p != NULL; p = p->suivant) {
+    if (p->nb_threads <= 1) {
+      continue;
+    }
+    taches_groupe_t *g = obtenir_groupe(taches, p);
+    if (g == NULL) {
+      continue;
+    }
+    g->vu = r;
+
+    if (g->deplie) {
+      parcourir_groupe(taches, g);
+    } else if ((g->dernier_scan == 0 ||
+                r - g->dernier_scan >= TACHES_PERIODE_REPLIES) &&
+               budget >= p->nb_threads) {
+      /* Repliés : échantillonnés moins souvent, dans la limite du budget */
+      parcourir_groupe(taches, g);
+      budget -= p->nb_threads;
+    }
+  }
+
+  /* Oublier les processus disparus (le groupe est recyclé en fin de tableau) */
+  for (int i = 0; i < taches->nb;) {
+    if (taches->groupes[i].vu == r) {
+      i++;
+      continue;
+    }
+    taches_groupe_t mort = taches->groupes[i];
+    taches->groupes[i] = taches->groupes[taches->nb - 1];
+    taches->groupes[taches->nb - 1] = mort;
+    taches->nb--;
+  }
+  reconstruire_index(taches);
+}
+
+processus_t *taches_construire_vue(const taches_t *taches,
+                                   const processus_t *liste, snapshot_t *vue) {
+  snapshot_reinitialiser(vue);
+
+  for (const processus_t *p = liste; p != NULL; p = p->suivant) {
+    processus_t *copie = snapshot_ajouter(vue);
+    if (copie == NULL) {
+      break;
+    }
+    memcpy(copie, p, sizeof(processus_t));
+
+    const taches_groupe_t *g =
+        p->nb_threads > 1 ? taches_chercher(taches, p->pid) : NULL;
+    if (g == NULL || !g->deplie || g->starttime != p->starttime) {
+      continue;
+    }
+    if (snapshot_reserver(vue, vue->nb + g->courant.nb) != 0) {
+      break;
+    }
+    memcpy(&vue->elements[vue->nb], g->courant.elements,
+           sizeof(processus_t) * g->courant.nb);
+    vue->nb += g->courant.nb;
+  }
+
+  return snapshot_finaliser(vue);
+}
+
+int taches_deplier(taches_t *taches, const processus_t *proc, int deplie) {
+  int numero = trouver_groupe(taches, proc->tgid);
+
+  if (numero < 0) {
+    return -1;
+  }
+
+  taches_groupe_t *g = &taches->groupes[numero];
+  g->deplie = deplie;
+  if (deplie && g->dernier_scan != taches->rafraichissement) {
+    parcourir_groupe(taches, g);
+  }
+  return 0;
+}
+
+const taches_groupe_t *taches_chercher(const taches_t *taches, pid_t pid) {
+  int numero = trouver_groupe(taches, pid);
+  return numero >= 0 ? &taches->groupes[numero] : NULL;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file taches.h
+ * @brief Mode threads : collecte de /proc/[PID]/task et agrégation par processus
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Chaque processus multi-thread possède un groupe qui conserve ses threads
+ * (triés par TID) sur deux échantillons, pour calculer le CPU de chaque
+ * thread sur l'intervalle. Un parcours des threads peut être 10 à 100 fois
+ * plus gros qu'un parcours des processus : seuls les processus dépliés sont
+ * relus à chaque rafraîchissement, les autres sont échantillonnés moins
+ * souvent et dans la limite d'un budget de threads par rafraîchissement.
+ */
+
+#ifndef TACHES_H
+#define TACHES_H
+
+#include "process.h"
+#include "procfs.h"
+#include "snapshot.h"
+
+#define TACHES_PERIODE_REPLIES 5    /* Rafraîchissements entre deux parcours d'un groupe replié */
+#define TACHES_BUDGET_REPLIES 4096  /* Threads lus au plus par rafraîchissement (groupes repliés) */
+
+/**
+ * @brief Threads d'un processus.
+ */
+typedef struct taches_groupe {
+  pid_t pid;
+  unsigned long long starttime;
+  unsigned int vu;           /* Dernier rafraîchissement où le processus était vivant */
+  unsigned int dernier_scan; /* Dernier rafraîchissement où task/ a été lu (0 : jamais) */
+  int deplie;                /* 1 : threads affichés et relus à chaque rafraîchissement */
+  int nb_actifs;             /* Threads en état R au dernier parcours */
+  unsigned long long instant; /* Ticks depuis le boot au dernier parcours */
+  snapshot_t courant;        /* Threads du dernier parcours, triés par TID */
+  snapshot_t precedent;      /* Threads du parcours d'avant (référence CPU) */
+} taches_groupe_t;
+
+/**
+ * @brief Ensemble des groupes du mode threads.
+ */
+typedef struct taches {
+  taches_groupe_t *groupes; /* [0, nb[ vivants ; au-delà, groupes recyclables */
+  int nb;
+  int capacite;
+  int *index;               /* Hachage PID -> groupe (-1 si vide) */
+  int taille_index;         /* Puissance de 2 */
+  unsigned int rafraichissement;
+  int nb_coeurs;
+  long ticks_par_seconde;
+  procfs_lecteur_t lecteur;
+  pid_t *tids;              /* TID listés, réutilisé */
+  int capacite_tids;
+  unsigned long threads_lus; /* Threads lus au dernier rafraîchissement */
+} taches_t;
+
+/**
+ * @brief Initialise le mode threads.
+ * @param taches : Structure à initialiser.
+ * @return int : 0 en cas de succès, -1 si /proc est inaccessible.
+ */
+int taches_init(taches_t *taches);
+
+/**
+ * @brief Libère tous les groupes.
+ * @param taches : Structure à libérer.
+ */
+void taches_liberer(taches_t *taches);
+
+/**
+ * @brief Relit les threads des groupes dus (dépliés, ou repliés selon la
+ *        période et le budget) et oublie les processus disparus.
+ * @param taches : Structure concernée.
+ * @param liste : Processus vivants de la génération.
+ * @param nb_coeurs : Nombre de cœurs (CPU en % de la machine).
+ */
+void taches_rafraichir(taches_t *taches, const processus_t *liste,
+                       int nb_coeurs);
+
+/**
+ * @brief Construit la vue : chaque processus suivi de ses threads s'il est déplié.
+ * @param taches : Structure concernée.
+ * @param liste : Processus vivants.
+ * @param vue : Snapshot destination (remis à zéro).
+ * @return processus_t* : Tête de la vue, ou NULL si vide.
+ */
+processus_t *taches_construire_vue(const taches_t *taches,
+                                   const processus_t *liste, snapshot_t *vue);
+
+/**
+ * @brief Déplie ou replie un processus ; un groupe déplié est relu aussitôt
+ *        s'il ne l'a pas été pendant ce rafraîchissement.
+ * @param taches : Structure concernée.
+ * @param proc : Processus (ou l'un de ses threads).
+ * @param deplie : 1 pour déplier, 0 pour replier.
+ * @return int : 0 en cas de succès, -1 si le processus n'a qu'un thread.
+ */
+int taches_deplier(taches_t *taches, const processus_t *proc, int deplie);
+
+/**
+ * @brief Retourne le groupe d'un processus.
+ * @param taches : Structure concernée.
+ * @param pid : PID du processus.
+ * @return const taches_groupe_t* : Groupe, ou NULL si non suivi.
+ */
+const taches_groupe_t *taches_chercher(const taches_t *taches, pid_t pid);
+
+#endif /* TACHES_H */
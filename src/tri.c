@@ -0,0 +1,435 @@
+/**
+ * @file tri.c
+ * @brief Implémentation du tri des processus par colonne
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "tri.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *noms_options[TRI_NB_CLES] = {"aucun", "pid", "user",
+                                                "cpu",   "mem", "time"};
+static const char *libelles[TRI_NB_CLES] = {"aucun", "PID",      "USER",
+                                            "CPU%",  "MEM(RSS)", "TIME"};
+
+/* Fonctions privées */
+
+#define COMPARER(a, b) (((a) > (b)) - ((a) < (b)))
+
+/**
+ * @brief Ordre de deux processus : < 0 si 'a' vient avant 'b'. À valeurs
+ *        égales, le PID croissant départage (ordre stable à l'écran).
+ */
+static int comparer(const tri_t *tri, const processus_t *a,
+                    const processus_t *b) {
+  int resultat = 0;
+
+  switch (tri->cle) {
+  case TRI_PID:
+    resultat = COMPARER(a->pid, b->pid);
+    break;
+  case TRI_UTILISATEUR:
+    resultat = strcmp(a->utilisateur, b->utilisateur);
+    break;
+  case TRI_CPU:
+    resultat = COMPARER(a->cpu_percent, b->cpu_percent);
+    break;
+  case TRI_MEMOIRE:
+    resultat = COMPARER(a->rss_ko, b->rss_ko);
+    break;
+  case TRI_TEMPS:
+    resultat = COMPARER(a->utime + a->stime, b->utime + b->stime);
+    break;
+  default:
+    break;
+  }
+
+  if (tri->decroissant) {
+    resultat = -resultat;
+  }
+  return resultat != 0 ? resultat : COMPARER(a->pid, b->pid);
+}
+
+/**
+ * @brief Résout les noms d'utilisateur manquants (listes locales : le nom
+ *        n'est sinon chargé que pour les lignes visibles).
+ */
+static void preparer(const tri_t *tri, processus_t *liste) {
+  if (tri->cle != TRI_UTILISATEUR) {
+    return;
+  }
+  for (processus_t *p = liste; p != NULL; p = p->suivant) {
+    if (p->utilisateur[0] == '\0') {
+      recuperer_nom_utilisateur(p->uid, p->utilisateur, MAX_USER_LEN);
+    }
+  }
+}
+
+/**
+ * @brief Agrandit un tableau à au moins 'nb' éléments de 'taille' octets.
+ */
+static int reserver(void **tableau, int *capacite, int nb, size_t taille) {
+  if (nb <= *capacite) {
+    return 0;
+  }
+
+  int nouvelle = *capacite > 0 ? *capacite : 256;
+  while (nouvelle < nb) {
+    nouvelle *= 2;
+  }
+  void *agrandi = realloc(*tableau, (size_t)nouvelle * taille);
+  if (agrandi == NULL) {
+    return -1;
+  }
+  *tableau = agrandi;
+  *capacite = nouvelle;
+  return 0;
+}
+
+static void echanger(processus_t **t, int i, int j) {
+  processus_t *tmp = t[i];
+  t[i] = t[j];
+  t[j] = tmp;
+}
+
+/**
+ * @brief Tri par insertion de t[debut, fin). Abandonne au-delà de
+ *        'budget' déplacements (budget < 0 : sans limite).
+ * @return int : 0 si trié, -1 si abandonné.
+ */
+static int trier_insertion(const tri_t *tri, processus_t **t, int debut,
+                           int fin, long budget) {
+  for (int i = debut + 1; i < fin; i++) {
+    processus_t *x = t[i];
+    int j = i;
+
+    while (j > debut && comparer(tri, x, t[j - 1]) < 0) {
+      t[j] = t[j - 1];
+      j--;
+      if (budget >= 0 && --budget < 0) {
+        /* Remettre x quelque part : la plage reste une permutation */
+        t[j] = x;
+        return -1;
+      }
+    }
+    t[j] = x;
+  }
+  return 0;
+}
+
+/**
+ * @brief Partitionne t[debut, fin) autour de la médiane de trois éléments.
+ * @return int : Position finale du pivot.
+ */
+static int partitionner(const tri_t *tri, processus_t **t, int debut,
+                        int fin) {
+  int milieu = debut + (fin - debut) / 2;
+  int dernier = fin - 1;
+
+  if (comparer(tri, t[milieu], t[debut]) < 0) {
+    echanger(t, milieu, debut);
+  }
+  if (comparer(tri, t[dernier], t[debut]) < 0) {
+    echanger(t, dernier, debut);
+  }
+  if (comparer(tri, t[dernier], t[milieu]) < 0) {
+    echanger(t, dernier, milieu);
+  }
+  echanger(t, milieu, dernier);
+
+  processus_t *pivot = t[dernier];
+  int position = debut;
+  for (int i = debut; i < dernier; i++) {
+    if (comparer(tri, t[i], pivot) < 0) {
+      echanger(t, i, position++);
+    }
+  }
+  echanger(t, position, dernier);
+  return position;
+}
+
+/**
+ * @brief Met dans l'ordre complet les 'k' premiers éléments de t[debut, fin)
+ *        (tri rapide partiel : O(n + k log k)), le reste après eux.
+ */
+static void trier_prefixe(const tri_t *tri, processus_t **t, int debut,
+                          int fin, int k) {
+  while (fin - debut > TRI_SEUIL_INSERTION && debut < k) {
+    int pivot = partitionner(tri, t, debut, fin);
+
+    if (pivot + 1 >= k) {
+      /* Seule la partie gauche contient des lignes demandées */
+      fin = pivot;
+    } else if (pivot - debut < fin - pivot) {
+      /* Récursion sur la plus petite partie : pile en O(log n) */
+      trier_prefixe(tri, t, debut, pivot, k);
+      debut = pivot + 1;
+    } else {
+      trier_prefixe(tri, t, pivot + 1, fin, k);
+      fin = pivot;
+    }
+  }
+  if (debut < k) {
+    trier_insertion(tri, t, debut, fin, -1);
+  }
+}
+
+/**
+ * @brief Index d'un PID dans la table de hachage des éléments (-1 : absent).
+ */
+static int chercher(const tri_t *tri, pid_t pid) {
+  unsigned int masque = (unsigned int)tri->capacite_table - 1;
+  unsigned int h = ((unsigned int)pid * 2654435761U) & masque;
+
+  while (tri->table[h] != 0) {
+    int index = tri->table[h] - 1;
+    if (tri->elements[index] != NULL && tri->elements[index]->pid == pid) {
+      return index;
+    }
+    h = (h + 1) & masque;
+  }
+  return -1;
+}
+
+/**
+ * @brief Repart de l'ordre précédent : ses processus encore présents sont
+ *        placés en tête et remis en ordre par insertion, puis les autres
+ *        devenus meilleurs que le dernier d'entre eux y sont insérés.
+ * @return int : Longueur du préfixe trié (>= k), ou -1 si l'ordre a trop
+ *               changé (le tableau reste une permutation des éléments).
+ */
+static int reutiliser_ordre(tri_t *tri, processus_t **travail, int n, int k) {
+  int capacite = 1;
+  int m = 0;
+  int reste;
+
+  if (tri->nb_ordre < k) {
+    return -1;
+  }
+
+  while (capacite < 2 * n) {
+    capacite *= 2;
+  }
+  if (reserver((void **)&tri->table, &tri->capacite_table, capacite,
+               sizeof(int)) != 0) {
+    return -1;
+  }
+  tri->capacite_table = capacite;
+  memset(tri->table, 0, (size_t)capacite * sizeof(int));
+  for (int i = 0; i < n; i++) {
+    unsigned int h =
+        ((unsigned int)tri->elements[i]->pid * 2654435761U) & (capacite - 1);
+    while (tri->table[h] != 0) {
+      h = (h + 1) & (capacite - 1);
+    }
+    tri->table[h] = i + 1;
+  }
+
+  /* Préfixe précédent, dans son ordre ; les éléments pris sont retirés */
+  for (int i = 0; i < tri->nb_ordre; i++) {
+    int index = chercher(tri, tri->ordre[i]);
+    if (index >= 0) {
+      travail[m++] = tri->elements[index];
+      tri->elements[index] = NULL;
+    }
+  }
+  reste = m;
+  for (int i = 0; i < n; i++) {
+    if (tri->elements[i] != NULL) {
+      travail[reste++] = tri->elements[i];
+    }
+  }
+  if (m < k) {
+    return -1;
+  }
+
+  /* Valeurs peu changées : peu d'inversions à corriger */
+  if (trier_insertion(tri, travail, 0, m, 8L * m + 256) != 0) {
+    return -1;
+  }
+
+  /* Processus passés devant le dernier du préfixe */
+  int nb_intrus = 0;
+  for (int i = m; i < n; i++) {
+    if (comparer(tri, travail[i], travail[m - 1]) >= 0) {
+      continue;
+    }
+    if (++nb_intrus > m / 4 + 8) {
+      return -1;
+    }
+
+    processus_t *intrus = travail[i];
+    int bas = 0;
+    int haut = m - 1;
+    while (bas < haut) {
+      int milieu = (bas + haut) / 2;
+      if (comparer(tri, travail[milieu], intrus) < 0) {
+        bas = milieu + 1;
+      } else {
+        haut = milieu;
+      }
+    }
+    travail[i] = travail[m - 1];
+    memmove(&travail[bas + 1], &travail[bas],
+            (size_t)(m - 1 - bas) * sizeof(processus_t *));
+    travail[bas] = intrus;
+  }
+  return m;
+}
+
+/* Fonctions publiques */
+
+void tri_init(tri_t *tri, tri_cle_t cle, int decroissant) {
+  memset(tri, 0, sizeof(*tri));
+  tri->cle = cle;
+  tri->decroissant = decroissant;
+}
+
+void tri_liberer(tri_t *tri) {
+  free(tri->ordre);
+  free(tri->elements);
+  free(tri->table);
+  free(tri->marques);
+  tri_init(tri, tri->cle, tri->decroissant);
+}
+
+void tri_configurer(tri_t *tri, tri_cle_t cle, int decroissant) {
+  tri->cle = cle;
+  tri->decroissant = decroissant;
+  tri_oublier(tri);
+}
+
+void tri_oublier(tri_t *tri) {
+  tri->nb_ordre = 0;
+  tri->nb_tries = 0;
+  tri->nb_total = 0;
+}
+
+int tri_rang(tri_t *tri, processus_t *liste, pid_t pid) {
+  const processus_t *cible = NULL;
+  int rang = 0;
+
+  if (tri->cle == TRI_AUCUN) {
+    return -1;
+  }
+  for (const processus_t *p = liste; p != NULL; p = p->suivant) {
+    if (p->pid == pid) {
+      cible = p;
+      break;
+    }
+  }
+  if (cible == NULL) {
+    return -1;
+  }
+
+  preparer(tri, liste);
+  for (const processus_t *p = liste; p != NULL; p = p->suivant) {
+    rang += comparer(tri, p, cible) < 0;
+  }
+  return rang;
+}
+
+processus_t *tri_appliquer(tri_t *tri, processus_t *liste, int nb_min,
+                           snapshot_t *vue) {
+  int n = compter_processus(liste);
+  int k = nb_min < n ? nb_min : n;
+  int nb_tries;
+  processus_t **travail;
+
+  if (tri->cle == TRI_AUCUN || n == 0) {
+    tri->nb_tries = n;
+    tri->nb_total = n;
+    return liste;
+  }
+
+  /* elements : ordre de la source ; travail : ordre construit */
+  if (reserver((void **)&tri->elements, &tri->capacite_elements, 2 * n,
+               sizeof(processus_t *)) != 0) {
+    return liste;
+  }
+  travail = tri->elements + n;
+  int i = 0;
+  for (processus_t *p = liste; p != NULL && i < n; p = p->suivant) {
+    tri->elements[i++] = p;
+  }
+  preparer(tri, liste);
+
+  nb_tries = reutiliser_ordre(tri, travail, n, k);
+  if (nb_tries >= 0) {
+    tri->nb_reutilisations++;
+  } else {
+    /* Ordre trop changé (ou premier tri) : sélection partielle */
+    nb_tries = k + TRI_MARGE < n ? k + TRI_MARGE : n;
+    i = 0;
+    for (processus_t *p = liste; p != NULL && i < n; p = p->suivant) {
+      travail[i++] = p;
+    }
+    trier_prefixe(tri, travail, 0, n, nb_tries);
+    tri->nb_selections++;
+  }
+
+  /* Mémoriser l'ordre pour le prochain rafraîchissement (borné : la
+     correction par insertion reste peu coûteuse) */
+  int nb_ordre = nb_tries < k + TRI_MARGE ? nb_tries : k + TRI_MARGE;
+  if (reserver((void **)&tri->ordre, &tri->capacite_ordre, nb_ordre,
+               sizeof(pid_t)) == 0) {
+    for (i = 0; i < nb_ordre; i++) {
+      tri->ordre[i] = travail[i]->pid;
+    }
+    tri->nb_ordre = nb_ordre;
+  } else {
+    tri->nb_ordre = 0;
+  }
+
+  /* Copie contiguë : le préfixe dans l'ordre construit, puis le reste */
+  snapshot_reinitialiser(vue);
+  if (snapshot_reserver(vue, n) != 0) {
+    tri_oublier(tri);
+    return liste;
+  }
+  for (i = 0; i < nb_tries; i++) {
+    memcpy(snapshot_ajouter(vue), travail[i], sizeof(processus_t));
+  }
+  if (liste->snapshot != NULL &&
+      reserver((void **)&tri->marques, &tri->capacite_marques, n, 1) == 0) {
+    /* Liste contiguë : le reste, dont l'ordre est libre, est recopié dans
+       l'ordre de la mémoire (lecture séquentielle) */
+    memset(tri->marques, 0, (size_t)n);
+    for (i = 0; i < nb_tries; i++) {
+      tri->marques[travail[i] - liste] = 1;
+    }
+    for (i = 0; i < n; i++) {
+      if (!tri->marques[i]) {
+        memcpy(snapshot_ajouter(vue), &liste[i], sizeof(processus_t));
+      }
+    }
+  } else {
+    for (i = nb_tries; i < n; i++) {
+      memcpy(snapshot_ajouter(vue), travail[i], sizeof(processus_t));
+    }
+  }
+  tri->nb_tries = nb_tries;
+  tri->nb_total = n;
+  return snapshot_finaliser(vue);
+}
+
+int tri_decroissant_defaut(tri_cle_t cle) {
+  return cle == TRI_CPU || cle == TRI_MEMOIRE || cle == TRI_TEMPS;
+}
+
+const char *tri_nom_cle(tri_cle_t cle) {
+  return (int)cle >= 0 && cle < TRI_NB_CLES ? libelles[cle] : "?";
+}
+
+int tri_cle_depuis_nom(const char *nom, tri_cle_t *cle) {
+  for (int i = 0; i < TRI_NB_CLES; i++) {
+    if (strcmp(nom, noms_options[i]) == 0) {
+      *cle = (tri_cle_t)i;
+      return 0;
+    }
+  }
+  return -1;
+}
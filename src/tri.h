@@ -0,0 +1,141 @@
+/**
+ * @file tri.h
+ * @brief Tri des processus par colonne (ordre partiel des premières lignes)
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Seules les premières lignes (écran, ou jusqu'au processus suivi) sont
+ * mises dans l'ordre complet ; les suivantes sont seulement placées après
+ * elles. D'un rafraîchissement à l'autre, l'ordre précédent sert de point
+ * de départ : tant que les valeurs ont peu bougé, il est corrigé par
+ * insertion au lieu d'être refait.
+ *
+ * La vue triée est une copie dans un snapshot : l'accès par index reste en
+ * O(1) et la liste d'origine n'est pas modifiée (hors noms d'utilisateur
+ * résolus pour le tri par utilisateur).
+ */
+
+#ifndef TRI_H
+#define TRI_H
+
+#include "process.h"
+#include "snapshot.h"
+
+#define TRI_MARGE 64             /* Lignes triées au-delà de l'écran */
+#define TRI_SEUIL_INSERTION 16   /* Plages triées par insertion */
+
+/**
+ * @brief Colonnes de tri.
+ */
+typedef enum tri_cle {
+  TRI_AUCUN = 0, /* Ordre de la source (readdir, ps) */
+  TRI_PID,
+  TRI_UTILISATEUR,
+  TRI_CPU,
+  TRI_MEMOIRE,
+  TRI_TEMPS,
+  TRI_NB_CLES
+} tri_cle_t;
+
+/**
+ * @brief État du tri (ordre précédent et tableaux de travail réutilisés).
+ */
+typedef struct tri {
+  tri_cle_t cle;
+  int decroissant;
+
+  /* Ordre du préfixe trié précédent */
+  pid_t *ordre;
+  int nb_ordre;
+  int capacite_ordre;
+
+  /* Travail */
+  processus_t **elements;
+  int capacite_elements;
+  int *table;              /* PID -> index + 1 (adressage ouvert) */
+  int capacite_table;
+  unsigned char *marques;  /* Éléments de la source déjà copiés */
+  int capacite_marques;
+
+  /* Dernière vue */
+  int nb_tries;            /* Lignes dans l'ordre complet */
+  int nb_total;
+
+  /* Statistiques */
+  unsigned long nb_reutilisations; /* Ordre précédent corrigé */
+  unsigned long nb_selections;     /* Sélection partielle complète */
+} tri_t;
+
+/**
+ * @brief Initialise un tri.
+ * @param tri : Tri à initialiser.
+ * @param cle : Colonne de tri.
+ * @param decroissant : 1 pour l'ordre décroissant.
+ */
+void tri_init(tri_t *tri, tri_cle_t cle, int decroissant);
+
+/**
+ * @brief Libère les tableaux d'un tri.
+ * @param tri : Tri à libérer.
+ */
+void tri_liberer(tri_t *tri);
+
+/**
+ * @brief Change la colonne ou le sens du tri (oublie l'ordre précédent).
+ * @param tri : Tri concerné.
+ * @param cle : Colonne de tri.
+ * @param decroissant : 1 pour l'ordre décroissant.
+ */
+void tri_configurer(tri_t *tri, tri_cle_t cle, int decroissant);
+
+/**
+ * @brief Oublie l'ordre précédent (la prochaine liste vient d'ailleurs).
+ * @param tri : Tri concerné.
+ */
+void tri_oublier(tri_t *tri);
+
+/**
+ * @brief Rang qu'aura un processus dans l'ordre complet (O(n)).
+ * @param tri : Tri concerné.
+ * @param liste : Liste des processus.
+ * @param pid : PID recherché.
+ * @return int : Rang (à partir de 0), ou -1 si absent ou sans tri.
+ */
+int tri_rang(tri_t *tri, processus_t *liste, pid_t pid);
+
+/**
+ * @brief Construit la vue triée d'une liste.
+ * @param tri : Tri concerné.
+ * @param liste : Liste des processus (ordre de la source).
+ * @param nb_min : Nombre de premières lignes à mettre dans l'ordre complet.
+ * @param vue : Snapshot recevant la vue.
+ * @return processus_t* : Vue triée, ou 'liste' elle-même sans tri (ou si la
+ *         mémoire manque).
+ */
+processus_t *tri_appliquer(tri_t *tri, processus_t *liste, int nb_min,
+                           snapshot_t *vue);
+
+/**
+ * @brief Sens par défaut d'une colonne (décroissant pour CPU, mémoire,
+ *        temps).
+ * @param cle : Colonne.
+ * @return int : 1 si décroissant.
+ */
+int tri_decroissant_defaut(tri_cle_t cle);
+
+/**
+ * @brief Libellé d'une colonne, tel qu'affiché dans l'en-tête.
+ * @param cle : Colonne.
+ * @return const char* : Libellé.
+ */
+const char *tri_nom_cle(tri_cle_t cle);
+
+/**
+ * @brief Lit une colonne depuis son nom ('cpu', 'mem', 'time', 'pid',
+ *        'user', 'aucun').
+ * @param nom : Nom lu.
+ * @param cle : Colonne reconnue.
+ * @return int : 0 si reconnue, -1 sinon.
+ */
+int tri_cle_depuis_nom(const char *nom, tri_cle_t *cle);
+
+#endif /* TRI_H */
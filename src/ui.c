@@ -4,10 +4,14 @@
  * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
  */
 
+#define _DEFAULT_SOURCE
+
 #include "ui.h"
 #include "manager.h"
 #include <ncurses.h>
+#include <stdio.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <sys/sysinfo.h>
 #include <time.h>
 #include <unistd.h>
@@ -20,6 +24,233 @@
 #define COLOR_ERROR_MSG 5
 #define COLOR_HELP_BAR 6
 
+/* Fonctions privées */
+
+/**
+ * @brief Retourne la ligne de commande chargée, sinon le nom de commande.
+ */
+static const char *commande_affichee(const details_processus_t *details,
+                                     const processus_t *proc) {
+  if (details != NULL && details->ligne_commande[0] != '\0') {
+    return details->ligne_commande;
+  }
+  return proc->nom_commande;
+}
+
+/**
+ * @brief Formate la colonne COMMAND (arborescence du mode threads, ou des
+ *        processus avec les totaux de chaque sous-arbre en mode arbre).
+ */
+static void formater_commande(const ui_state_t *state,
+                              const details_processus_t *details,
+                              const processus_t *proc, char *dest,
+                              size_t taille) {
+  const taches_groupe_t *groupe;
+  const arbre_noeud_t *noeud;
+
+  if (proc->est_thread) {
+    snprintf(dest, taille, "  `- %s", proc->nom_commande);
+    return;
+  }
+  if (state->arbre != NULL &&
+      (noeud = arbre_chercher(state->arbre, proc->pid)) != NULL) {
+    size_t n;
+
+    arbre_dessiner(state->arbre, noeud, dest,
+                   taille < ARBRE_PREFIXE_MAX ? taille : ARBRE_PREFIXE_MAX);
+    n = strlen(dest);
+    if (noeud->nb_descendants > 0 && n < taille) {
+      /* Descendants, CPU% et RSS (MB) du sous-arbre */
+      int ecrits = snprintf(dest + n, taille - n, "[%d %.1f%% %.1fM] ",
+                            noeud->nb_descendants, noeud->cpu_total,
+                            (float)noeud->rss_total_ko / 1024);
+      n += ecrits > 0 ? (size_t)ecrits : 0;
+    }
+    if (n < taille) {
+      snprintf(dest + n, taille - n, "%s", commande_affichee(details, proc));
+    }
+    return;
+  }
+  if (state->taches == NULL || proc->nb_threads <= 1) {
+    snprintf(dest, taille, "%s", commande_affichee(details, proc));
+    return;
+  }
+
+  groupe = taches_chercher(state->taches, proc->pid);
+  if (groupe != NULL && groupe->deplie) {
+    snprintf(dest, taille, "[-] %s", commande_affichee(details, proc));
+  } else if (groupe != NULL && groupe->dernier_scan != 0) {
+    /* Replié : dernier échantillon, éventuellement ancien */
+    snprintf(dest, taille, "[+] %s (%d thr, %d R)",
+             commande_affichee(details, proc), proc->nb_threads,
+             groupe->nb_actifs);
+  } else {
+    snprintf(dest, taille, "[+] %s (%d thr)", commande_affichee(details, proc),
+             proc->nb_threads);
+  }
+}
+
+/**
+ * @brief Formate une valeur de smaps_rollup en MB, suivie de '*' si la
+ *        mesure est ancienne ("-" si absente ou illisible).
+ */
+static void formater_smaps(const memoire_processus_t *mesure, long valeur_ko,
+                           char *dest, size_t taille) {
+  if (mesure == NULL || valeur_ko < 0) {
+    snprintf(dest, taille, "-");
+    return;
+  }
+  snprintf(dest, taille, "%.1f%s", (float)valeur_ko / 1024,
+           memoire_perimee(mesure) ? "*" : "");
+}
+
+/**
+ * @brief Âge en secondes de données datées de 'instant_ms' (0 : inconnu).
+ */
+static float age_donnees(long long instant_ms) {
+  if (instant_ms == 0) {
+    return 0;
+  }
+  return (float)(collecteur_maintenant_ms() - instant_ms) / 1000;
+}
+
+/**
+ * @brief Libellé court de la connexion d'une machine pour son onglet
+ *        (NULL : établie).
+ */
+static const char *libelle_connexion(const machine_info_t *machine,
+                                     char *buffer, size_t taille) {
+  switch (machine->connexion) {
+  case CONNEXION_EN_COURS:
+    return "connexion...";
+  case CONNEXION_REESSAI:
+    return "reconnexion...";
+  case CONNEXION_ECHOUEE:
+    snprintf(buffer, taille, "echec, essai %llds",
+             (machine->reessai_ms + 999) / 1000);
+    return buffer;
+  default:
+    return NULL;
+  }
+}
+
+/**
+ * @brief Libellé du tri affiché ("CPU% desc", "aucun").
+ */
+static const char *libelle_tri(const ui_state_t *state, char *buffer,
+                               size_t taille) {
+  if (state->arbre != NULL) {
+    return "arbre";
+  }
+  if (state->tri == NULL || state->tri->cle == TRI_AUCUN) {
+    return "aucun";
+  }
+  snprintf(buffer, taille, "%s %s", tri_nom_cle(state->tri->cle),
+           state->tri->decroissant ? "desc" : "asc");
+  return buffer;
+}
+
+/**
+ * @brief Commence une ligne de processus : '>' pour la sélection, '*' pour
+ *        un processus marqué, et sa couleur.
+ * @return int : Attributs à retirer en fin de ligne.
+ */
+static int commencer_ligne(const ui_state_t *state, const processus_t *proc,
+                           int index, int ligne) {
+  int marque = state->marques != NULL && !proc->est_thread &&
+               marques_contient(state->marques, proc->pid);
+  int attributs = 0;
+
+  if (index == state->selected_index) {
+    attributs = COLOR_PAIR(COLOR_SELECTED) | A_BOLD;
+  } else if (marque) {
+    attributs = COLOR_PAIR(COLOR_INFO_MSG) | A_BOLD;
+  }
+  attron(attributs);
+  mvprintw(ligne, 0, "%c",
+           marque ? '*' : (index == state->selected_index ? '>' : ' '));
+  return attributs;
+}
+
+/**
+ * @brief Édite le filtre en cours de saisie.
+ * @return int : Action du filtre, ou ACTION_AUCUNE si la touche n'en est
+ *               pas une (navigation, touches de fonction).
+ */
+static int gerer_saisie_filtre(ui_state_t *state, int touche) {
+  size_t longueur = strlen(state->filtre_saisi);
+
+  switch (touche) {
+  case '\n':
+  case '\r':
+  case KEY_ENTER:
+    state->saisie_filtre = 0;
+    return ACTION_FILTRE_VALIDER;
+  case 27: /* Échap */
+    state->saisie_filtre = 0;
+    state->filtre_saisi[0] = '\0';
+  state->marques = NULL;
+  state->nb_marques = 0;
+    return ACTION_FILTRE_ANNULER;
+  case '\t':
+    return ACTION_FILTRE_MODE;
+  case 1: /* Ctrl-A */
+    return ACTION_FILTRE_PORTEE;
+  case KEY_BACKSPACE:
+  case 127:
+  case 8:
+    if (longueur > 0) {
+      state->filtre_saisi[longueur - 1] = '\0';
+    }
+    return ACTION_FILTRE_MODIFIE;
+  default:
+    if (touche >= ' ' && touche <= '~') {
+      if (longueur + 1 < sizeof(state->filtre_saisi)) {
+        state->filtre_saisi[longueur] = (char)touche;
+        state->filtre_saisi[longueur + 1] = '\0';
+      }
+      return ACTION_FILTRE_MODIFIE;
+    }
+    return ACTION_AUCUNE;
+  }
+}
+
+/**
+ * @brief Affiche la saisie du filtre (deux dernières lignes), ou le filtre
+ *        actif dans la barre d'aide.
+ */
+static void afficher_filtre(const ui_state_t *state) {
+  const filtre_t *filtre = state->filtre;
+
+  if (filtre == NULL) {
+    return;
+  }
+
+  if (state->saisie_filtre) {
+    attron(COLOR_PAIR(COLOR_HELP_BAR) | A_BOLD);
+    mvprintw(LINES - 2, 0, "%*s", COLS, "");
+    mvprintw(LINES - 2, 2,
+             "Tab:Mode ^A:Toutes machines Entree:Garder Echap:Effacer "
+             "Fleches:Naviguer");
+    attroff(COLOR_PAIR(COLOR_HELP_BAR) | A_BOLD);
+
+    move(LINES - 1, 0);
+    clrtoeol();
+    attron(COLOR_PAIR(COLOR_INFO_MSG) | A_BOLD);
+    mvprintw(LINES - 1, 2, "Filtre (%s%s): %s_", filtre_nom_mode(filtre->mode),
+             filtre->toutes_machines ? ", toutes machines" : "",
+             state->filtre_saisi);
+    attroff(COLOR_PAIR(COLOR_INFO_MSG) | A_BOLD);
+  } else if (filtre->actif && COLS > 40) {
+    attron(COLOR_PAIR(COLOR_HELP_BAR) | A_BOLD);
+    mvprintw(LINES - 2, COLS - 40, " Filtre (%s): %.*s ",
+             filtre_nom_mode(filtre->mode), 18, filtre->motif);
+    attroff(COLOR_PAIR(COLOR_HELP_BAR) | A_BOLD);
+  }
+}
+
+/* Fonctions publiques */
+
 void ui_init(void) {
   initscr();
   cbreak();
@@ -27,6 +258,7 @@ void ui_init(void) {
   curs_set(0);
   keypad(stdscr, TRUE);
   timeout(REFRESH_TIMEOUT);
+  set_escdelay(25); /* Échap seul (saisie du filtre) sans attendre 1 s */
 
   if (has_colors()) {
     start_color();
@@ -48,6 +280,22 @@ void ui_init_state(ui_state_t *state) {
   state->message_type = 0;
   state->show_help = 0;
   state->message_time = 0;
+  state->nb_ajoutes = 0;
+  state->nb_termines = 0;
+  state->nb_modifies = 0;
+  state->nb_ephemeres = -1;
+  state->cpu = NULL;
+  state->instant_collecte_ms = 0;
+  state->details = NULL;
+  state->taches = NULL;
+  state->memoire = NULL;
+  state->tri = NULL;
+  state->filtre = NULL;
+  state->saisie_filtre = 0;
+  state->filtre_saisi[0] = '\0';
+  state->marques = NULL;
+  state->nb_marques = 0;
+  state->portee_signaux = NULL;
   state->nb_machines = 0;
   state->machine_courante = 0;
 }
@@ -86,13 +334,24 @@ void ui_afficher_aide(void) {
   mvprintw(ligne++, 8, "F6 ou k             - Arreter (SIGTERM)");
   mvprintw(ligne++, 8, "F7 ou 9             - Tuer (SIGKILL)");
   mvprintw(ligne++, 8, "F8 ou c             - Reprendre/Redemarrer (SIGCONT)");
+  mvprintw(ligne++, 8, "Espace              - Marquer/demarquer (signaux envoyes aux marques)");
+  mvprintw(ligne++, 8, "a / u / U           - Marquer le filtre / l'utilisateur / tout demarquer");
+  mvprintw(ligne++, 8, "g ou G              - Portee : processus, sous-arbre, groupe, session");
   ligne++;
 
   attron(A_BOLD);
   mvprintw(ligne++, 5, "Autres :");
   attroff(A_BOLD);
   mvprintw(ligne++, 8, "F1 ou h             - Afficher cette aide");
-  mvprintw(ligne++, 8, "F4 ou /             - Rechercher (non implemente)");
+  mvprintw(ligne++, 8, "F4 ou /             - Filtrer (PID, utilisateur, commande)");
+  mvprintw(ligne++, 8, "  Tab / ^A          - Mode (sous-chaine, prefixe, regex) / toutes machines");
+  mvprintw(ligne++, 8, "  Entree / Echap    - Garder / effacer le filtre");
+  mvprintw(ligne++, 8, "t ou T              - Mode threads (local)");
+  mvprintw(ligne++, 8, "v ou V              - Vue arborescente [descendants CPU%% RSS]");
+  mvprintw(ligne++, 8, "+ / -               - Deplier / replier les threads ou le sous-arbre");
+  mvprintw(ligne++, 8, "m ou M              - Colonnes PSS/USS/SWAP (* : ancien)");
+  mvprintw(ligne++, 8, "< / >               - Colonne de tri precedente/suivante");
+  mvprintw(ligne++, 8, "r ou R              - Inverser le sens du tri");
   mvprintw(ligne++, 8, "q ou Q              - Quitter");
   ligne += 2;
 
@@ -115,9 +374,10 @@ void ui_afficher_aide(void) {
 }
 
 void ui_afficher_processus(processus_t *head, ui_state_t *state) {
-  processus_t *courant = head;
+  processus_t *courant;
   int ligne = 0;
   int nb_processus = compter_processus(head);
+  int i;
 
   // Récupération des infos système
   struct sysinfo si;
@@ -128,70 +388,137 @@ void ui_afficher_processus(processus_t *head, ui_state_t *state) {
   struct tm *t = localtime(&now);
   char time_str[32];
   strftime(time_str, sizeof(time_str), "%H:%M:%S", t);
+  char tri[32];
 
   /* 1. Barre de titre */
   attron(COLOR_PAIR(COLOR_HEADER) | A_BOLD);
   mvprintw(ligne, 0, "%*s", COLS, "");
   mvprintw(ligne, 2, "MY_HTOP - Moniteur de Processus Local");
+  mvprintw(ligne, COLS - 50, "Tri: %s", libelle_tri(state, tri, sizeof(tri)));
+  mvprintw(ligne, COLS - 30, "Donnees: %.1fs", age_donnees(state->instant_collecte_ms));
   mvprintw(ligne, COLS - 12, "%s", time_str);
   attroff(COLOR_PAIR(COLOR_HEADER) | A_BOLD);
   ligne++;
 
   /* 2. Statistiques système */
-  mvprintw(ligne++, 2,
-           "Processus actifs: %d | Uptime: %ld min | Memoire libre: %.1f MB",
-           nb_processus, si.uptime / 60, (float)si.freeram / (1024 * 1024));
+  /* En mode threads, la liste contient aussi les lignes des threads dépliés */
+  int nb_lignes_processus = nb_processus;
+  if (state->taches != NULL) {
+    for (courant = head; courant != NULL; courant = courant->suivant) {
+      nb_lignes_processus -= courant->est_thread;
+    }
+  }
+  mvprintw(ligne, 2,
+           "Processus actifs: %d (+%d -%d ~%d) | Uptime: %ld min | Memoire "
+           "libre: %.1f MB",
+           nb_lignes_processus, state->nb_ajoutes, state->nb_termines,
+           state->nb_modifies, si.uptime / 60,
+           (float)si.freeram / (1024 * 1024));
+  /* Processus trop brefs pour être vus (connecteur proc uniquement) */
+  if (state->nb_ephemeres >= 0) {
+    printw(" | Ephemeres: %d", state->nb_ephemeres);
+  }
+  ligne++;
+
+  /* Utilisation CPU globale et par cœur sur le dernier intervalle */
+  if (state->cpu != NULL && state->cpu->nb_echantillons >= 2) {
+    const cpu_utilisation_t *cpu = state->cpu;
+    int x = 2;
+    mvprintw(ligne, x, "CPU: %5.1f%% |", cpu->globale);
+    x += 14;
+    for (i = 0; i < cpu->nb_coeurs && x + 10 < COLS; i++) {
+      mvprintw(ligne, x, " %d:%3.0f%%", i, cpu->coeurs[i]);
+      x += (i < 10) ? 7 : 8;
+    }
+  }
   ligne++;
 
   /* 3. En-tête du tableau */
   attron(COLOR_PAIR(COLOR_TABLE_HEADER) | A_BOLD);
-  mvprintw(ligne, 0, "%-8s %-12s %-6s %-10s %-10s %-10s %s", "PID", "USER",
-           "STATE", "CPU%", "MEM(RSS)", "TIME", "COMMAND");
+  if (state->memoire != NULL) {
+    mvprintw(ligne, 0, "%-8s %-12s %-6s %-10s %-10s %-9s %-9s %-9s %-10s %s",
+             "PID", "USER", "STATE", "CPU%", "MEM(RSS)", "PSS", "USS", "SWAP",
+             "TIME", "COMMAND");
+  } else {
+    mvprintw(ligne, 0, "%-8s %-12s %-6s %-10s %-10s %-4s %-8s %-10s %s",
+             "PID", "USER", "STATE", "CPU%", "MEM(RSS)", "THR", "SWAP", "TIME",
+             "COMMAND");
+  }
   attroff(COLOR_PAIR(COLOR_TABLE_HEADER) | A_BOLD);
   ligne++;
 
   /* 4. Ligne de séparation */
-  int i;
   for (i = 0; i < COLS; i++) {
     mvaddch(ligne, i, '-');
   }
   ligne++;
 
   /* 5. Affichage des processus */
-  int max_lignes_affichage = LINES - ligne - 3;
+  int max_lignes_affichage = LINES - ligne - UI_LIGNES_PIED;
   int index = 0;
   int lignes_affichees = 0;
 
-  for (i = 0; i < state->scroll_offset && courant != NULL; i++) {
-    courant = courant->suivant;
-    index++;
-  }
+  /* Accès direct à la première ligne visible (O(1) sur un snapshot) */
+  courant = get_processus_at_index(head, state->scroll_offset);
+  index = state->scroll_offset;
 
   // Afficher les processus visibles
   while (courant != NULL && lignes_affichees < max_lignes_affichage) {
-    // Mise en surbrillance du processus sélectionné
-    if (index == state->selected_index) {
-      attron(COLOR_PAIR(COLOR_SELECTED) | A_BOLD);
-      mvprintw(ligne, 0, ">");
-    } else {
-      mvprintw(ligne, 0, " ");
-    }
+    // Mise en surbrillance du processus sélectionné ou marqué
+    int attributs = commencer_ligne(state, courant, index, ligne);
 
     // Conversion de la mémoire RSS en MB
-    float mem_mb = (float)(courant->rss_size * 4096) / (1024 * 1024);
+    float mem_mb = (float)courant->rss_ko / 1024;
 
     // Calcul du temps total
     long long total_time =
         (courant->utime + courant->stime) / sysconf(_SC_CLK_TCK);
 
-    mvprintw(ligne, 1, "%-8d %-12s %-6c %-10.1f %-10.1f %-10lld %s",
-             courant->pid, courant->utilisateur, courant->etat,
-             courant->cpu_percent, mem_mb, total_time, courant->nom_commande);
+    /* Niveaux coûteux : chargés par le gestionnaire pour les lignes visibles */
+    const details_processus_t *details =
+        (state->details && !courant->est_thread)
+            ? details_chercher(state->details, courant)
+            : NULL;
+    char threads[12] = "-";
+    char swap[16] = "-";
+    if (details != NULL && details->status.nb_threads >= 0) {
+      snprintf(threads, sizeof(threads), "%d", details->status.nb_threads);
+    }
+    if (details != NULL && details->status.vm_swap_ko >= 0) {
+      snprintf(swap, sizeof(swap), "%.1f",
+               (float)details->status.vm_swap_ko / 1024);
+    }
 
-    if (index == state->selected_index) {
-      attroff(COLOR_PAIR(COLOR_SELECTED) | A_BOLD);
+    char commande[DETAILS_TAILLE_CMDLINE + ARBRE_PREFIXE_MAX + 48];
+    formater_commande(state, details, courant, commande, sizeof(commande));
+
+    if (state->memoire != NULL) {
+      /* Dernière mesure de smaps_rollup, éventuellement ancienne */
+      const memoire_processus_t *mesure =
+          courant->est_thread ? NULL
+                              : memoire_chercher(state->memoire, courant);
+      char pss[16], uss[16], swap_smaps[16];
+      formater_smaps(mesure, mesure ? mesure->smaps.pss_ko : -1, pss,
+                     sizeof(pss));
+      formater_smaps(mesure, mesure ? mesure->smaps.uss_ko : -1, uss,
+                     sizeof(uss));
+      formater_smaps(mesure, mesure ? mesure->smaps.swap_ko : -1, swap_smaps,
+                     sizeof(swap_smaps));
+      mvprintw(ligne, 1,
+               "%-8d %-12s %-6c %-10.1f %-10.1f %-9s %-9s %-9s %-10lld %s",
+               courant->pid, courant->utilisateur, courant->etat,
+               courant->cpu_percent, mem_mb, pss, uss, swap_smaps, total_time,
+               commande);
+    } else {
+      mvprintw(ligne, 1,
+               "%-8d %-12s %-6c %-10.1f %-10.1f %-4s %-8s %-10lld %s",
+               courant->pid, courant->utilisateur, courant->etat,
+               courant->cpu_percent, mem_mb, threads, swap, total_time,
+               commande);
     }
 
+    attroff(attributs);
+
     courant = courant->suivant;
     ligne++;
     index++;
@@ -203,11 +530,17 @@ void ui_afficher_processus(processus_t *head, ui_state_t *state) {
   mvprintw(LINES - 2, 0, "%*s", COLS, "");
   mvprintw(LINES - 2, 2,
            "F1:Aide F5:Pause F6:Kill F7:ForceKill F8:Continue Q:Quit");
+  if (state->portee_signaux != NULL) {
+    printw("  G:Signaux=%s", state->portee_signaux); /* Hors processus seul */
+  }
   attroff(COLOR_PAIR(COLOR_HELP_BAR) | A_BOLD);
 
   /* 7. Ligne d'information et messages */
   mvprintw(LINES - 1, 2, "Processus %d/%d", state->selected_index + 1,
            nb_processus);
+  if (state->nb_marques > 0) {
+    printw(" *%d", state->nb_marques); /* Marques, toutes machines */
+  }
 
   // Affichage du message si présent et pas expiré
   if (state->message_buffer[0] != '\0') {
@@ -232,46 +565,36 @@ void ui_afficher_processus(processus_t *head, ui_state_t *state) {
       state->message_buffer[0] = '\0';
     }
   }
-}
 
-int ui_demander_saisie(ui_state_t *state, const char *prompt, char *buffer,
-                       int max_len) {
-  int ret = 0;
-
-  /* Effacer la ligne de message */
-  move(LINES - 1, 0);
-  clrtoeol();
+  /* 8. Filtre (saisie ou actif) */
+  afficher_filtre(state);
+}
 
-  /* Afficher le prompt */
-  attron(COLOR_PAIR(COLOR_INFO_MSG) | A_BOLD);
-  mvprintw(LINES - 1, 2, "%s", prompt);
-  attroff(COLOR_PAIR(COLOR_INFO_MSG) | A_BOLD);
-  refresh();
+int ui_nb_lignes_visibles(void) {
+  return LINES - UI_LIGNES_ENTETE - UI_LIGNES_PIED;
+}
 
-  /* Activer l'écho et le curseur temporairement */
-  echo();
-  curs_set(1);
+void ui_redimensionner(void) {
+  struct winsize taille;
 
-  /* Saisie */
-  if (getnstr(buffer, max_len - 1) == OK) {
-    if (strlen(buffer) > 0) {
-      ret = 1;
-    }
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &taille) == 0 && taille.ws_row > 0 &&
+      taille.ws_col > 0) {
+    resizeterm(taille.ws_row, taille.ws_col);
   }
-
-  /* Restaurer l'état */
-  noecho();
-  curs_set(0);
-
-  return ret;
 }
 
 int ui_gerer_evenements(ui_state_t *state, int nb_processus) {
   int key_input = getch();
-  int max_visible = LINES - 8;
+  int max_visible = ui_nb_lignes_visibles();
 
   if (key_input == ERR) {
-    return ACTION_CONTINUE;
+    return ACTION_AUCUNE;
+  }
+  if (state->saisie_filtre) {
+    int action = gerer_saisie_filtre(state, key_input);
+    if (action != ACTION_AUCUNE) {
+      return action;
+    }
   }
 
   switch (key_input) {
@@ -343,6 +666,51 @@ int ui_gerer_evenements(ui_state_t *state, int nb_processus) {
     }
     return ACTION_CONTINUE;
 
+  case ' ':
+    return ACTION_MARQUER;
+
+  case 'a':
+  case 'A':
+    return ACTION_MARQUER_FILTRE;
+
+  case 'u':
+    return ACTION_MARQUER_UTILISATEUR;
+
+  case 'U':
+    return ACTION_DEMARQUER;
+
+  case 't':
+  case 'T':
+    return ACTION_THREADS;
+
+  case 'v':
+  case 'V':
+    return ACTION_ARBRE;
+
+  case 'g':
+  case 'G':
+    return ACTION_PORTEE_SIGNAUX;
+
+  case '+':
+    return ACTION_DEPLIER;
+
+  case '-':
+    return ACTION_REPLIER;
+
+  case 'm':
+  case 'M':
+    return ACTION_MEMOIRE;
+
+  case '>':
+    return ACTION_TRI_SUIVANT;
+
+  case '<':
+    return ACTION_TRI_PRECEDENT;
+
+  case 'r':
+  case 'R':
+    return ACTION_TRI_INVERSER;
+
   case KEY_F(2):
     return ACTION_NEXT_TAB;
 
@@ -365,21 +733,70 @@ void ui_afficher_processus_network(machine_info_t *machines, int nb_machines,
   mvprintw(ligne, 0, "%*s", COLS, "");
   int tab_x = 2;
   for (int i = 0; i < nb_machines; i++) {
+    char onglet[MAX_HOSTNAME_LEN + 48];
+    char connexion[32];
+    const char *etat = libelle_connexion(&machines[i], connexion,
+                                         sizeof(connexion));
+
+    /* Âge des données de chaque onglet ; '*' : hôte en retard, son dernier
+       instantané est affiché */
+    char trouves[16] = "";
+
+    /* Correspondances du filtre (onglet affiché, ou tous en recherche
+       globale) */
+    if (machines[i].nb_trouves >= 0) {
+      snprintf(trouves, sizeof(trouves), " [%d]", machines[i].nb_trouves);
+    }
+    if (etat != NULL) {
+      /* Hôte non connecté : état de sa connexion à la place de l'âge */
+      snprintf(onglet, sizeof(onglet), " %s %s%s ", machines[i].nom, etat,
+               trouves);
+    } else {
+      snprintf(onglet, sizeof(onglet), " %s %.0fs%s%s ", machines[i].nom,
+               age_donnees(machines[i].instant_ms),
+               machines[i].perimee ? "*" : "", trouves);
+    }
     if (i == machine_courante) {
       attron(A_REVERSE);
     }
-    mvprintw(ligne, tab_x, " %s ", machines[i].nom);
+    mvprintw(ligne, tab_x, "%s", onglet);
     if (i == machine_courante) {
       attroff(A_REVERSE);
     }
-    tab_x += strlen(machines[i].nom) + 3;
+    tab_x += strlen(onglet) + 1;
   }
   attroff(COLOR_PAIR(COLOR_HEADER) | A_BOLD);
   ligne++;
 
   /* 2. Informations de la machine courante */
-  mvprintw(ligne++, 2, "Machine: %s | Processus actifs: %d",
-           machines[machine_courante].nom, nb_processus);
+  const machine_info_t *courante = &machines[machine_courante];
+  char tri[32];
+  char connexion[MAX_ERREUR_CONNEXION + 48];
+
+  switch (courante->connexion) {
+  case CONNEXION_EN_COURS:
+    snprintf(connexion, sizeof(connexion), " | Connexion en cours...");
+    break;
+  case CONNEXION_REESSAI:
+    snprintf(connexion, sizeof(connexion), " | Reconnexion en cours (%s)",
+             courante->erreur_connexion);
+    break;
+  case CONNEXION_ECHOUEE:
+    snprintf(connexion, sizeof(connexion), " | %s, nouvel essai dans %llds",
+             courante->erreur_connexion, (courante->reessai_ms + 999) / 1000);
+    break;
+  default:
+    /* Session établie : avertissement éventuel de la collecte */
+    snprintf(connexion, sizeof(connexion), "%s%s%s",
+             courante->perimee ? " (hote en retard)" : "",
+             courante->erreur_connexion[0] != '\0' ? " | " : "",
+             courante->erreur_connexion);
+    break;
+  }
+  mvprintw(ligne++, 2,
+           "Machine: %s | Processus actifs: %d | Tri: %s | Donnees: %.1fs%s",
+           courante->nom, nb_processus, libelle_tri(state, tri, sizeof(tri)),
+           age_donnees(courante->instant_ms), connexion);
   ligne++;
 
   /* 3. En-tête du tableau */
@@ -396,41 +813,39 @@ void ui_afficher_processus_network(machine_info_t *machines, int nb_machines,
   ligne++;
 
   /* 5. Affichage des processus */
-  int max_lignes_affichage = LINES - ligne - 3;
+  int max_lignes_affichage = LINES - ligne - UI_LIGNES_PIED;
   int index = 0;
   int lignes_affichees = 0;
-  processus_t *courant = head;
-
-  /* Sauter au scroll offset */
-  for (int i = 0; i < state->scroll_offset && courant != NULL; i++) {
-    courant = courant->suivant;
-    index++;
-  }
+  /* Sauter au scroll offset (O(1) sur un snapshot) */
+  processus_t *courant = get_processus_at_index(head, state->scroll_offset);
+  index = state->scroll_offset;
 
   /* Afficher les processus visibles */
   while (courant != NULL && lignes_affichees < max_lignes_affichage) {
-    /* Mise en surbrillance du processus sélectionné */
-    if (index == state->selected_index) {
-      attron(COLOR_PAIR(COLOR_SELECTED) | A_BOLD);
-      mvprintw(ligne, 0, ">");
-    } else {
-      mvprintw(ligne, 0, " ");
-    }
+    /* Mise en surbrillance du processus sélectionné ou marqué */
+    int attributs = commencer_ligne(state, courant, index, ligne);
 
     /* Conversion de la mémoire RSS en MB */
-    float mem_mb = (float)(courant->rss_size * 4096) / (1024 * 1024);
+    float mem_mb = (float)courant->rss_ko / 1024;
 
     /* Calcul du temps total */
     long long total_time =
         (courant->utime + courant->stime) / sysconf(_SC_CLK_TCK);
 
+    /* Ligne de commande complète pour l'onglet local uniquement */
+    const details_processus_t *details =
+        (state->details && machines[machine_courante].is_local)
+            ? details_chercher(state->details, courant)
+            : NULL;
+
+    char commande[DETAILS_TAILLE_CMDLINE + ARBRE_PREFIXE_MAX + 48];
+    formater_commande(state, details, courant, commande, sizeof(commande));
+
     mvprintw(ligne, 1, "%-8d %-12s %-6c %-10.1f %-10.1f %-10lld %s",
              courant->pid, courant->utilisateur, courant->etat,
-             courant->cpu_percent, mem_mb, total_time, courant->nom_commande);
+             courant->cpu_percent, mem_mb, total_time, commande);
 
-    if (index == state->selected_index) {
-      attroff(COLOR_PAIR(COLOR_SELECTED) | A_BOLD);
-    }
+    attroff(attributs);
 
     courant = courant->suivant;
     ligne++;
@@ -444,11 +859,17 @@ void ui_afficher_processus_network(machine_info_t *machines, int nb_machines,
   mvprintw(
       LINES - 2, 2,
       "F1:Aide F2/F3:Onglets F5:Pause F6:Kill F7:ForceKill F8:Continue Q:Quit");
+  if (state->portee_signaux != NULL) {
+    printw("  G:Signaux=%s", state->portee_signaux); /* Hors processus seul */
+  }
   attroff(COLOR_PAIR(COLOR_HELP_BAR) | A_BOLD);
 
   /* 7. Ligne d'information et messages */
   mvprintw(LINES - 1, 2, "Processus %d/%d", state->selected_index + 1,
            nb_processus);
+  if (state->nb_marques > 0) {
+    printw(" *%d", state->nb_marques); /* Marques, toutes machines */
+  }
 
   /* Affichage du message si présent et pas expiré */
   if (state->message_buffer[0] != '\0') {
@@ -471,4 +892,7 @@ void ui_afficher_processus_network(machine_info_t *machines, int nb_machines,
       state->message_buffer[0] = '\0';
     }
   }
+
+  /* 8. Filtre (saisie ou actif) */
+  afficher_filtre(state);
 }
\ No newline at end of file
@@ -10,17 +10,28 @@
 #ifndef UI_H
 #define UI_H
 
+#include "arbre.h"
+#include "cpu.h"
+#include "details.h"
+#include "filtre.h"
+#include "marques.h"
+#include "memoire.h"
 #include "process.h"
+#include "taches.h"
+#include "tri.h"
 #include <time.h>
 
 /* Forward declaration */
 typedef struct machine_info machine_info_t;
 
-#define REFRESH_TIMEOUT 100
+#define REFRESH_TIMEOUT 0 /* getch non bloquant : l'attente se fait dans poll() */
 #define MESSAGE_DISPLAY_DURATION                                               \
   5 // Durée d'affichage des messages d'action (peut etre modifié)
+#define UI_LIGNES_ENTETE 5 /* Titre, statistiques, CPU, en-tête, séparateur */
+#define UI_LIGNES_PIED 3   /* Lignes réservées sous la liste */
 
 // Codes de retour pour les actions utilisateur
+#define ACTION_AUCUNE -1 /* Plus aucune touche en attente */
 #define ACTION_CONTINUE 1
 #define ACTION_QUIT 0
 #define ACTION_HELP 2
@@ -32,6 +43,26 @@ typedef struct machine_info machine_info_t;
 #define ACTION_SEARCH 8
 #define ACTION_NEXT_TAB 9
 #define ACTION_PREV_TAB 10
+#define ACTION_THREADS 11
+#define ACTION_DEPLIER 12
+#define ACTION_REPLIER 13
+#define ACTION_MEMOIRE 14
+#define ACTION_TRI_SUIVANT 15
+#define ACTION_TRI_PRECEDENT 16
+#define ACTION_TRI_INVERSER 17
+#define ACTION_FILTRE_MODIFIE 18 /* Saisie du filtre : texte changé */
+#define ACTION_FILTRE_VALIDER 19 /* Entrée : garder le filtre */
+#define ACTION_FILTRE_ANNULER 20 /* Échap : effacer le filtre */
+#define ACTION_FILTRE_MODE 21    /* Tab : mode suivant */
+#define ACTION_FILTRE_PORTEE 22  /* Ctrl-A : toutes les machines ou non */
+#define ACTION_MARQUER 23         /* Espace : marquer la sélection */
+#define ACTION_MARQUER_FILTRE 24  /* Marquer les correspondances du filtre */
+#define ACTION_MARQUER_UTILISATEUR 25 /* Marquer les processus de
+                                         l'utilisateur sélectionné */
+#define ACTION_DEMARQUER 26       /* Retirer toutes les marques */
+#define ACTION_ARBRE 27           /* Vue arborescente */
+#define ACTION_PORTEE_SIGNAUX 28  /* Processus seul, sous-arbre, groupe,
+                                     session */
 
 /**
  * @brief Structure pour stocker l'état de l'interface.
@@ -44,6 +75,27 @@ typedef struct ui_state {
   int show_help;       /* 1 si fenêtre d'aide affichée */
   time_t message_time; /* Timestamp du message pour durée d'affichage */
 
+  /* Bilan du dernier rafraîchissement local */
+  int nb_ajoutes;  /* Processus apparus */
+  int nb_termines; /* Processus terminés */
+  int nb_modifies; /* Processus modifiés */
+  int nb_ephemeres; /* Nés et terminés dans l'intervalle (-1 : non suivi) */
+  const cpu_utilisation_t *cpu;   /* Utilisation CPU locale (peut être NULL) */
+  long long instant_collecte_ms;  /* Fin de la collecte affichée (0 : aucune) */
+  const cache_details_t *details; /* Champs coûteux locaux (peut être NULL) */
+  const taches_t *taches;         /* Mode threads (NULL si désactivé) */
+  const memoire_t *memoire;       /* Colonnes PSS/USS (NULL si désactivées) */
+  const tri_t *tri;               /* Colonne de tri (NULL : ordre de la source) */
+  const arbre_t *arbre;           /* Vue arborescente (NULL si désactivée) */
+  const filtre_t *filtre;         /* Filtre de recherche (peut être NULL) */
+  int saisie_filtre;              /* 1 : les touches éditent le filtre */
+  char filtre_saisi[FILTRE_TAILLE_MOTIF];
+  const marques_t *marques;       /* Marques de l'onglet affiché (peut être
+                                     NULL) */
+  int nb_marques;                 /* Marques de toutes les machines */
+  const char *portee_signaux;     /* Portée des signaux (NULL : processus
+                                     seul) */
+
   /* Pour mode réseau */
   int nb_machines;      /* Nombre total de machines */
   int machine_courante; /* Index de la machine courante */
@@ -90,21 +142,23 @@ void ui_afficher_aide(void);
 void ui_afficher_message(ui_state_t *state, const char *msg, int type);
 
 /**
- * @brief Demande une saisie à l'utilisateur en bas de l'écran.
- * @param state : État de l'interface.
- * @param prompt : Message d'invite.
- * @param buffer : Buffer pour stocker la saisie.
- * @param max_len : Taille maximale du buffer.
- * @return int : 1 si une saisie a été faite, 0 si annulé.
+ * @brief Nombre de lignes de processus visibles dans le terminal.
+ * @return int : LINES moins les lignes d'en-tête et de pied.
+ */
+int ui_nb_lignes_visibles(void);
+
+/**
+ * @brief Adapte ncurses à la nouvelle taille du terminal (après SIGWINCH).
  */
-int ui_demander_saisie(ui_state_t *state, const char *prompt, char *buffer,
-                       int max_len);
+void ui_redimensionner(void);
 
 /**
- * @brief Gère les événements clavier et la navigation.
+ * @brief Gère une touche en attente (sans bloquer) et la navigation. En
+ *        saisie du filtre, les caractères éditent state->filtre_saisi.
  * @param state : État de l'interface.
  * @param nb_processus : Nombre total de processus.
- * @return int : Code d'action (ACTION_CONTINUE, ACTION_QUIT, etc.).
+ * @return int : Code d'action (ACTION_CONTINUE, ACTION_QUIT, etc.), ou
+ *               ACTION_AUCUNE si aucune touche n'est en attente.
  */
 int ui_gerer_evenements(ui_state_t *state, int nb_processus);
 
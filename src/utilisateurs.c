@@ -0,0 +1,204 @@
+/**
+ * @file utilisateurs.c
+ * @brief Implémentation du cache UID -> nom d'utilisateur
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "utilisateurs.h"
+#include "process.h"
+#include <pthread.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define CACHE_TAILLE_INITIALE 64
+
+/**
+ * @brief Entrée du cache.
+ */
+typedef struct cache_entree {
+  uid_t uid;
+  int occupee;
+  char nom[MAX_USER_LEN];
+} cache_entree_t;
+
+/* État du cache (commun à tout le programme, sous verrou : les threads
+   des sources résolvent aussi des noms) */
+static pthread_mutex_t cache_verrou = PTHREAD_MUTEX_INITIALIZER;
+static cache_entree_t *cache_cases = NULL;
+static int cache_taille = 0; /* Puissance de 2 */
+static int cache_nb = 0;
+static int cache_ttl = UTILISATEURS_TTL_DEFAUT;
+static time_t cache_date_remplissage = 0;
+static time_t cache_dernier_controle = 0;
+static struct stat cache_passwd; /* Dernier état connu de /etc/passwd */
+static int cache_passwd_connu = 0;
+static cache_utilisateurs_stats_t cache_stats = {0, 0, 0, 0};
+
+/* Fonctions privées */
+
+static unsigned int hacher_uid(uid_t uid, int taille) {
+  return ((unsigned int)uid * 2654435761u) & (unsigned int)(taille - 1);
+}
+
+static void vider(void) {
+  if (cache_nb > 0) {
+    memset(cache_cases, 0, sizeof(cache_entree_t) * cache_taille);
+    cache_nb = 0;
+    cache_stats.invalidations++;
+  }
+}
+
+/**
+ * @brief Vide le cache si /etc/passwd a changé ou si le TTL a expiré.
+ *        Le contrôle est fait au plus une fois par seconde.
+ */
+static void controler_validite(void) {
+  time_t maintenant = time(NULL);
+  struct stat st;
+
+  if (maintenant == cache_dernier_controle) {
+    return;
+  }
+  cache_dernier_controle = maintenant;
+
+  if (stat(PASSWD_FILE, &st) == 0) {
+    if (cache_passwd_connu && (st.st_mtime != cache_passwd.st_mtime ||
+                               st.st_ino != cache_passwd.st_ino ||
+                               st.st_dev != cache_passwd.st_dev)) {
+      vider();
+    }
+    cache_passwd = st;
+    cache_passwd_connu = 1;
+  }
+
+  if (cache_ttl > 0 && cache_nb > 0 &&
+      difftime(maintenant, cache_date_remplissage) >= cache_ttl) {
+    vider();
+  }
+  if (cache_nb == 0) {
+    cache_date_remplissage = maintenant;
+  }
+}
+
+static int agrandir(void) {
+  int ancienne_taille = cache_taille;
+  cache_entree_t *anciennes = cache_cases;
+  int nouvelle_taille = cache_taille ? cache_taille * 2 : CACHE_TAILLE_INITIALE;
+
+  cache_cases = calloc(nouvelle_taille, sizeof(cache_entree_t));
+  if (cache_cases == NULL) {
+    cache_cases = anciennes;
+    return -1;
+  }
+  cache_taille = nouvelle_taille;
+  cache_nb = 0;
+
+  for (int i = 0; i < ancienne_taille; i++) {
+    if (anciennes[i].occupee) {
+      unsigned int j = hacher_uid(anciennes[i].uid, cache_taille);
+      while (cache_cases[j].occupee) {
+        j = (j + 1) & (unsigned int)(cache_taille - 1);
+      }
+      cache_cases[j] = anciennes[i];
+      cache_nb++;
+    }
+  }
+
+  free(anciennes);
+  return 0;
+}
+
+/**
+ * @brief Nom associé à un UID (verrou tenu).
+ */
+static const char *chercher_nom(uid_t uid) {
+  static char nom_secours[MAX_USER_LEN];
+  struct passwd *pw;
+  unsigned int i;
+
+  controler_validite();
+
+  if (cache_taille > 0) {
+    i = hacher_uid(uid, cache_taille);
+    while (cache_cases[i].occupee) {
+      if (cache_cases[i].uid == uid) {
+        cache_stats.succes++;
+        return cache_cases[i].nom;
+      }
+      i = (i + 1) & (unsigned int)(cache_taille - 1);
+    }
+  }
+
+  /* Absent du cache : une seule résolution NSS pour cet UID */
+  cache_stats.echecs++;
+  if ((cache_nb + 1) * 2 > cache_taille && agrandir() != 0) {
+    pw = getpwuid(uid);
+    if (pw) {
+      snprintf(nom_secours, sizeof(nom_secours), "%s", pw->pw_name);
+    } else {
+      snprintf(nom_secours, sizeof(nom_secours), "%d", (int)uid);
+    }
+    return nom_secours;
+  }
+
+  i = hacher_uid(uid, cache_taille);
+  while (cache_cases[i].occupee) {
+    i = (i + 1) & (unsigned int)(cache_taille - 1);
+  }
+
+  pw = getpwuid(uid);
+  if (pw) {
+    strncpy(cache_cases[i].nom, pw->pw_name, MAX_USER_LEN - 1);
+    cache_cases[i].nom[MAX_USER_LEN - 1] = '\0';
+  } else {
+    snprintf(cache_cases[i].nom, MAX_USER_LEN, "%d", (int)uid);
+  }
+  cache_cases[i].uid = uid;
+  cache_cases[i].occupee = 1;
+  cache_nb++;
+
+  return cache_cases[i].nom;
+}
+
+/* Fonctions publiques */
+
+void cache_utilisateurs_configurer_ttl(int secondes) {
+  pthread_mutex_lock(&cache_verrou);
+  cache_ttl = (secondes > 0) ? secondes : 0;
+  pthread_mutex_unlock(&cache_verrou);
+}
+
+void cache_utilisateurs_copier_nom(uid_t uid, char *dest, size_t taille) {
+  pthread_mutex_lock(&cache_verrou);
+  strncpy(dest, chercher_nom(uid), taille - 1);
+  pthread_mutex_unlock(&cache_verrou);
+  dest[taille - 1] = '\0';
+}
+
+void cache_utilisateurs_invalider(void) {
+  pthread_mutex_lock(&cache_verrou);
+  vider();
+  pthread_mutex_unlock(&cache_verrou);
+}
+
+void cache_utilisateurs_statistiques(cache_utilisateurs_stats_t *stats) {
+  pthread_mutex_lock(&cache_verrou);
+  *stats = cache_stats;
+  stats->nb_entrees = cache_nb;
+  pthread_mutex_unlock(&cache_verrou);
+}
+
+void cache_utilisateurs_liberer(void) {
+  pthread_mutex_lock(&cache_verrou);
+  free(cache_cases);
+  cache_cases = NULL;
+  cache_taille = 0;
+  cache_nb = 0;
+  pthread_mutex_unlock(&cache_verrou);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file utilisateurs.h
+ * @brief Cache UID -> nom d'utilisateur
+ * @author Abir Islam, Mellouk Mohamed-Amine, Issam Fallani
+ *
+ * Ce module évite un appel à getpwuid() par processus et par
+ * rafraîchissement (coûteux avec NSS/sssd). Le cache, commun à tout le
+ * programme, est rempli à la demande et vidé quand /etc/passwd change
+ * (date de modification ou inode) ou quand sa durée de vie expire.
+ */
+
+#ifndef UTILISATEURS_H
+#define UTILISATEURS_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#define UTILISATEURS_TTL_DEFAUT 300 /* Durée de vie du cache (secondes) */
+#define PASSWD_FILE "/etc/passwd"
+
+/**
+ * @brief Compteurs d'utilisation du cache.
+ */
+typedef struct cache_utilisateurs_stats {
+  unsigned long succes;         /* Noms trouvés dans le cache */
+  unsigned long echecs;         /* Appels à getpwuid() */
+  unsigned long invalidations;  /* Vidages du cache */
+  int nb_entrees;               /* Entrées actuellement en cache */
+} cache_utilisateurs_stats_t;
+
+/**
+ * @brief Règle la durée de vie du cache.
+ * @param secondes : Durée en secondes (0 = pas d'expiration).
+ */
+void cache_utilisateurs_configurer_ttl(int secondes);
+
+/**
+ * @brief Copie le nom associé à un UID (ou l'UID en texte si inconnu).
+ *        Utilisable depuis plusieurs threads.
+ * @param uid : UID recherché.
+ * @param dest : Buffer de destination.
+ * @param taille : Taille du buffer.
+ */
+void cache_utilisateurs_copier_nom(uid_t uid, char *dest, size_t taille);
+
+/**
+ * @brief Vide le cache.
+ */
+void cache_utilisateurs_invalider(void);
+
+/**
+ * @brief Lit les compteurs du cache.
+ * @param stats : Structure à remplir.
+ */
+void cache_utilisateurs_statistiques(cache_utilisateurs_stats_t *stats);
+
+/**
+ * @brief Libère la mémoire du cache.
+ */
+void cache_utilisateurs_liberer(void);
+
+#endif /* UTILISATEURS_H */